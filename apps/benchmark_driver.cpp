@@ -0,0 +1,182 @@
+#include "mdfh/benchmark_harness.hpp"
+#include "mdfh/encoding.hpp"
+#include <CLI/CLI.hpp>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace mdfh;
+
+namespace {
+
+// Replaces a matrix dimension with the values given on the command line
+template <typename T, typename Parse>
+void override_dimension(std::vector<T>& dimension, const std::vector<std::string>& names, Parse parse) {
+    if (names.empty()) {
+        return;
+    }
+    dimension.clear();
+    for (const auto& name : names) {
+        dimension.push_back(parse(name));
+    }
+}
+
+// With pinning, also shows where each thread actually ran (sched_getaffinity)
+void print_result(const ScenarioResult& result, bool show_placement) {
+    std::cout << std::left << std::setw(96) << result.id << std::right;
+    if (!result.skipped.empty()) {
+        std::cout << "  skipped: " << result.skipped << std::endl;
+        return;
+    }
+    std::cout << std::fixed << std::setprecision(2)
+              << std::setw(9) << result.throughput.mean / 1e6 << " ±" << std::setw(6) << result.throughput.ci95 / 1e6
+              << " Mmsg/s" << std::setprecision(3)
+              << std::setw(9) << result.drop_rate.mean * 100.0 << "% drop" << std::setprecision(0)
+              << "  p50 " << result.p50.mean << "  p99 " << result.p99.mean
+              << "  p99.9 " << result.p999.mean << "  p99.99 " << result.p9999.mean << " ns" << std::endl;
+    if (show_placement && !result.runs.empty()) {
+        std::cout << "    placement: " << result.runs.front().placement << std::endl;
+    }
+}
+
+} // namespace
+
+// Runs a declared scenario matrix (ring capacity x batch size x producers x
+// encoding x backend x wait strategy), writes JSON/CSV reports and, given a
+// baseline report, exits with status 2 if any scenario regressed
+int main(int argc, char* argv[]) {
+    std::string matrix_file;
+    std::vector<std::uint64_t> capacities;
+    std::vector<std::uint32_t> batch_sizes;
+    std::vector<std::uint32_t> producers;
+    std::vector<std::string> encodings;
+    std::vector<std::string> backends;
+    std::vector<std::string> waits;
+    std::vector<int> cores;
+    std::uint64_t messages = 0;
+    std::uint64_t warmup = 0;
+    std::uint32_t repeats = 0;
+    std::uint64_t rate = 0;
+    std::string json_file;
+    std::string csv_file;
+    std::string baseline_file;
+    double tolerance = 0.05;
+    bool list_only = false;
+
+    CLI::App app{"Benchmark scenario matrix driver"};
+
+    app.add_option("--matrix,-m", matrix_file, "Matrix file (see config/benchmark_matrix.yaml)");
+    app.add_option("--capacity", capacities, "Ring capacities to sweep (overrides the matrix file)");
+    app.add_option("--batch-size", batch_sizes, "Batch sizes to sweep");
+    app.add_option("--producers", producers, "Producer counts to sweep");
+    app.add_option("--encoding", encodings, "Encodings to sweep (binary, fix, itch)");
+    app.add_option("--backend", backends, "Backends to sweep (memory, asio, io_uring)");
+    app.add_option("--wait-strategy", waits, "Consumer wait strategies to sweep (spin, yield, park)");
+    app.add_option("--messages", messages, "Messages per producer per run (0 = matrix file or default)");
+    app.add_option("--warmup", warmup, "Unmeasured messages per producer at the start of each run");
+    app.add_option("--repeats,-r", repeats, "Measured runs per scenario (0 = matrix file or default)");
+    app.add_option("--rate", rate, "Messages/s per producer (0 = unthrottled)");
+    app.add_option("--cores", cores, "CPUs for the consumer, then producers, then senders");
+    app.add_option("--json", json_file, "Write the JSON report (also the baseline format) to this file");
+    app.add_option("--csv", csv_file, "Write a CSV summary to this file");
+    app.add_option("--baseline", baseline_file, "Compare against a JSON report from an earlier run");
+    app.add_option("--tolerance", tolerance, "Relative change tolerated before a metric counts as regressed")
+        ->default_val(tolerance);
+    app.add_flag("--list", list_only, "Print the expanded matrix and exit");
+
+    CLI11_PARSE(app, argc, argv);
+
+    try {
+        BenchmarkPlan plan = matrix_file.empty() ? BenchmarkPlan{} : BenchmarkPlan::from_yaml(matrix_file);
+
+        if (!capacities.empty()) {
+            plan.matrix.capacities = capacities;
+        }
+        if (!batch_sizes.empty()) {
+            plan.matrix.batch_sizes = batch_sizes;
+        }
+        if (!producers.empty()) {
+            plan.matrix.producers = producers;
+        }
+        override_dimension(plan.matrix.encodings, encodings, parse_encoding_type);
+        override_dimension(plan.matrix.backends, backends, parse_benchmark_backend);
+        override_dimension(plan.matrix.waits, waits, parse_wait_strategy_type);
+        if (messages > 0) {
+            plan.run.messages = messages;
+        }
+        if (warmup > 0) {
+            plan.run.warmup_messages = warmup;
+        }
+        if (repeats > 0) {
+            plan.run.repeats = repeats;
+        }
+        if (rate > 0) {
+            plan.run.rate = rate;
+        }
+        if (!cores.empty()) {
+            plan.run.cores = cores;
+        }
+
+        if (!plan.matrix.is_valid() || !plan.run.is_valid()) {
+            std::cerr << "Error: invalid matrix (capacities must be powers of 2, messages > warm-up, repeats > 0)"
+                      << std::endl;
+            return 1;
+        }
+
+        auto scenarios = plan.matrix.expand();
+        std::cout << scenarios.size() << " scenarios, " << plan.run.repeats << " runs each of "
+                  << plan.run.messages << " messages per producer (" << plan.run.warmup_messages << " warm-up)";
+        if (plan.run.rate > 0) {
+            std::cout << " at " << plan.run.rate << " msg/s";
+        }
+        std::cout << "\n" << std::endl;
+
+        if (list_only) {
+            for (const auto& scenario : scenarios) {
+                std::cout << scenario.id() << "\n";
+            }
+            return 0;
+        }
+
+        std::vector<ScenarioResult> results;
+        for (const auto& scenario : scenarios) {
+            results.push_back(run_benchmark_repeats(scenario, plan.run));
+            print_result(results.back(), !plan.run.cores.empty());
+        }
+
+        if (!json_file.empty()) {
+            std::ofstream out(json_file);
+            write_benchmark_json(out, results, plan.run);
+            std::cout << "\nJSON report written to " << json_file << std::endl;
+        }
+        if (!csv_file.empty()) {
+            std::ofstream out(csv_file);
+            write_benchmark_csv(out, results);
+            std::cout << "CSV report written to " << csv_file << std::endl;
+        }
+
+        if (!baseline_file.empty()) {
+            auto regressions = compare_to_baseline(results, load_benchmark_baseline(baseline_file), tolerance);
+            std::cout << "\n=== Comparison with " << baseline_file << " (tolerance " << tolerance * 100.0
+                      << "%) ===" << std::endl;
+            if (regressions.empty()) {
+                std::cout << "No regressions" << std::endl;
+                return 0;
+            }
+            std::cout << std::setprecision(2);
+            for (const auto& regression : regressions) {
+                std::cout << "REGRESSION " << regression.id << " " << regression.metric << ": "
+                          << regression.baseline << " -> " << regression.current << " ("
+                          << regression.change * 100.0 << "% worse)" << std::endl;
+            }
+            return 2;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,6 +1,8 @@
 #include "mdfh/kernel_bypass.hpp"
 #include "mdfh/ring_buffer.hpp"
 #include "mdfh/ingestion.hpp"
+#include "mdfh/multicast_receiver.hpp"
+#include "mdfh/metrics.hpp"
 #include "mdfh/timing.hpp"
 #include <CLI/CLI.hpp>
 #include <iostream>
@@ -21,14 +23,23 @@ struct BenchmarkConfig {
     std::string backend = "asio";           // asio, dpdk, solarflare
     std::uint32_t rx_ring_size = 2048;
     std::uint32_t batch_size = 32;
-    std::uint32_t cpu_core = 0;
+    int cpu_core = -1;                      // -1 = unpinned
     bool enable_zero_copy = true;
     bool enable_numa_awareness = true;
+    std::string huge_pages = "none";        // none, thp, 2mb, 1gb
     
     // Performance settings
     std::uint32_t buffer_capacity = 65536;
     std::uint32_t poll_timeout_us = 100;
     std::uint32_t zero_copy_threshold = 64;
+    std::string encoding = "binary";        // binary, fix, itch
+    std::string transport = "tcp";          // tcp, multicast
+    std::string multicast_interface = "0.0.0.0";
+    std::string rx_timestamps = "kernel";   // userspace, kernel, hardware (multicast)
+    bool io_uring_sqpoll = true;
+    std::uint32_t io_uring_buffer_size = 4096;
+    std::string wait_strategy = "park";    // spin, yield, park (reception and consumer loops)
+    std::uint32_t spin_iterations = 100;
     
     // Performance tracking settings
     bool enable_hardware_timestamps = true;
@@ -40,6 +51,10 @@ struct BenchmarkConfig {
     std::uint32_t max_seconds = 60;
     std::uint64_t max_messages = 0;
     
+    // Metrics export
+    std::uint16_t metrics_port = 0;         // Prometheus scrape port (0 = off)
+    std::string metrics_push;               // host:port for UDP snapshots (empty = off)
+    
     // Output settings
     bool verbose = false;
     bool show_latency_histogram = false;
@@ -56,7 +71,16 @@ std::ostream& operator<<(std::ostream& os, const BenchmarkConfig& cfg) {
     os << "  CPU Core: " << cfg.cpu_core << "\n";
     os << "  Zero-copy: " << (cfg.enable_zero_copy ? "enabled" : "disabled") << "\n";
     os << "  NUMA Awareness: " << (cfg.enable_numa_awareness ? "enabled" : "disabled") << "\n";
+    os << "  Huge Pages: " << cfg.huge_pages << "\n";
     os << "  Buffer Capacity: " << cfg.buffer_capacity << " slots\n";
+    os << "  Wait Strategy: " << cfg.wait_strategy << " (spin " << cfg.spin_iterations
+       << ", park " << cfg.poll_timeout_us << "us)\n";
+    os << "  Encoding: " << cfg.encoding << "\n";
+    os << "  Transport: " << cfg.transport << "\n";
+    if (parse_transport_type(cfg.transport) == TransportType::UDP_MULTICAST) {
+        os << "  Multicast Interface: " << cfg.multicast_interface << "\n";
+        os << "  RX Timestamps: " << cfg.rx_timestamps << "\n";
+    }
     if (cfg.max_seconds > 0) {
         os << "  Max Duration: " << cfg.max_seconds << " seconds\n";
     }
@@ -73,6 +97,8 @@ BypassBackend parse_backend(const std::string& backend_str) {
         return BypassBackend::DPDK;
     } else if (backend_str == "solarflare" || backend_str == "ef_vi") {
         return BypassBackend::SOLARFLARE_VI;
+    } else if (backend_str == "io_uring" || backend_str == "uring") {
+        return BypassBackend::IO_URING;
     } else {
         std::cerr << "Unknown backend: " << backend_str << ", using Boost.Asio" << std::endl;
         return BypassBackend::BOOST_ASIO;
@@ -84,16 +110,22 @@ private:
     BenchmarkConfig config_;
     BypassConfig bypass_config_;
     RingBuffer ring_;
+    WaitSignal consumer_signal_;
     IngestionStats stats_;
     BypassIngestionClient client_;
+    MetricsRegistry metrics_;
+    MetricsExporter exporter_;              // Console progress and metrics export, off the data path
     std::atomic<bool> should_stop_{false};
     Timer benchmark_timer_;
     
 public:
     explicit BypassBenchmark(BenchmarkConfig config) 
         : config_(std::move(config))
-        , ring_(config_.buffer_capacity)
-        , client_(create_bypass_config()) {
+        , bypass_config_(create_bypass_config())
+        , ring_(config_.buffer_capacity, bypass_config_.memory_placement())
+        , client_(bypass_config_)
+        , exporter_(metrics_, create_metrics_config()) {
+        ring_.set_consumer_signal(&consumer_signal_);
     }
     
     void run() {
@@ -115,6 +147,9 @@ public:
         
         std::cout << "Connected successfully, starting ingestion..." << std::endl;
         
+        register_metrics();
+        exporter_.start();
+        
         // Start ingestion
         client_.start_ingestion(ring_, stats_);
         
@@ -124,12 +159,41 @@ public:
         // Stop ingestion
         client_.stop_ingestion();
         client_.disconnect();
+        exporter_.stop();
         
         // Print final statistics
         print_final_stats();
     }
     
 private:
+    MetricsConfig create_metrics_config() const {
+        MetricsConfig metrics;
+        metrics.http_port = config_.metrics_port;
+        metrics.push_address = config_.metrics_push;
+        return metrics;
+    }
+    
+    void register_metrics() {
+        stats_.register_metrics(metrics_);
+        metrics_.counter_fn("mdfh_packets_received_total", "Packets delivered by the bypass backend", {},
+                            [this]() { return static_cast<double>(client_.packets_received()); });
+        metrics_.counter_fn("mdfh_packet_bytes_total", "Packet bytes delivered by the bypass backend", {},
+                            [this]() { return static_cast<double>(client_.bytes_received()); });
+        metrics_.counter_fn("mdfh_packets_dropped_total", "Packets dropped by the bypass backend", {},
+                            [this]() { return static_cast<double>(client_.packets_dropped()); });
+        if (auto* tracker = client_.performance_tracker()) {
+            tracker->register_metrics(metrics_);
+        }
+        
+        exporter_.add_reporter(std::chrono::seconds(1), [this]() { stats_.print_periodic_stats(); });
+        if (config_.verbose) {
+            exporter_.add_reporter(std::chrono::seconds(1), [this]() {
+                std::cout << "  Packets: " << client_.packets_received()
+                          << " | Dropped: " << client_.packets_dropped() << std::endl;
+            });
+        }
+    }
+    
     BypassConfig create_bypass_config() {
         BypassConfig bypass_cfg;
         bypass_cfg.backend = parse_backend(config_.backend);
@@ -140,9 +204,21 @@ private:
         bypass_cfg.batch_size = config_.batch_size;
         bypass_cfg.cpu_core = config_.cpu_core;
         bypass_cfg.enable_numa_awareness = config_.enable_numa_awareness;
+        bypass_cfg.huge_pages = parse_huge_page_mode(config_.huge_pages);
         bypass_cfg.enable_zero_copy = config_.enable_zero_copy;
         bypass_cfg.zero_copy_threshold = config_.zero_copy_threshold;
         bypass_cfg.poll_timeout_us = config_.poll_timeout_us;
+        bypass_cfg.encoding = parse_encoding_type(config_.encoding);
+        bypass_cfg.transport = parse_transport_type(config_.transport);
+        bypass_cfg.multicast_interface = config_.multicast_interface;
+        bypass_cfg.io_uring_sqpoll = config_.io_uring_sqpoll;
+        bypass_cfg.io_uring_buffer_size = config_.io_uring_buffer_size;
+        bypass_cfg.wait_strategy = parse_wait_strategy_type(config_.wait_strategy);
+        bypass_cfg.spin_iterations = config_.spin_iterations;
+        
+        auto rx_timestamps = parse_rx_timestamp_source(config_.rx_timestamps);
+        bypass_cfg.kernel_timestamps = rx_timestamps != RxTimestampSource::USERSPACE;
+        bypass_cfg.hardware_timestamps = rx_timestamps == RxTimestampSource::HARDWARE;
         
         // Set up performance tracking configuration
         bypass_cfg.perf_config.enable_hardware_timestamps = config_.enable_hardware_timestamps;
@@ -154,42 +230,50 @@ private:
     }
     
     void consumer_loop() {
-        Slot slot;
         std::uint64_t messages_processed = 0;
-        std::uint64_t empty_polls = 0;
+        
+        // Same policy as the reception loop; parsed commits wake it when parked
+        WaitConfig wait;
+        wait.type = parse_wait_strategy_type(config_.wait_strategy);
+        wait.spin_iterations = config_.spin_iterations;
+        wait.park_timeout_us = config_.poll_timeout_us;
+        WaitStrategy waiter(wait, &consumer_signal_);
+        auto* tracker = client_.performance_tracker();
+        auto* counters = tracker ? tracker->attach_thread("consumer") : nullptr;
         
         while (should_continue()) {
-            bool found_message = false;
+            // Process a batch of messages in place to reduce overhead
+            auto first_pos = ring_.read_position();
+            auto slots = ring_.peek(100);
+            bool found_message = !slots.empty();
+            
+            // Stamp the batch only when it holds a sampled packet's message
+            bool traced = tracker && found_message && tracker->trace_due(first_pos + slots.size());
+            std::uint64_t ring_pop = traced ? get_timestamp_ns() : 0;
+            
+            for (const auto& slot : slots) {
+                stats_.record_message_processed(slot);
+            }
+            messages_processed += slots.size();
+            if (traced) {
+                tracker->complete_traces(first_pos, slots.size(), ring_pop, get_timestamp_ns());
+            }
+            ring_.release(slots.size());
             
-            // Process multiple messages in a batch to reduce overhead
-            for (int i = 0; i < 100 && should_continue(); ++i) {
-                if (ring_.try_pop(slot)) {
-                    stats_.record_message_processed(slot);
-                    messages_processed++;
-                    found_message = true;
-                    
-                    if (config_.verbose && messages_processed % 1000000 == 0) {
-                        std::cout << "Processed " << messages_processed << " messages" << std::endl;
-                    }
-                } else {
-                    break; // No more messages available
-                }
+            if (counters) {
+                counters->maybe_sample(messages_processed);
             }
             
-            if (!found_message) {
-                empty_polls++;
-                // Brief yield to prevent 100% CPU usage when no messages available
-                if (empty_polls % 1000 == 0) {
-                    std::this_thread::yield();
-                }
+            if (found_message) {
+                waiter.reset();
             } else {
-                empty_polls = 0; // Reset counter when we find messages
+                waiter.idle();
             }
-            
-            // Periodic statistics reporting
-            stats_.check_periodic_flush();
         }
         
+        if (counters) {
+            counters->sample(messages_processed);
+        }
         std::cout << "Consumer loop finished, processed " << messages_processed << " messages" << std::endl;
     }
     
@@ -228,7 +312,11 @@ private:
         std::cout << "Packet rate: " << (packets_recv / elapsed) << " packets/s" << std::endl;
         std::cout << "Network bandwidth: " << (packet_bytes / elapsed / 1024 / 1024) << " MB/s" << std::endl;
         if (cpu_util > 0) {
-            std::cout << "CPU utilization: " << (cpu_util * 100) << "%" << std::endl;
+            std::cout << "CPU utilization: " << (cpu_util * 100) << "% (reception thread)" << std::endl;
+            if (msgs_recv > 0) {
+                // Comparable across backends: receive-path CPU spent per message
+                std::cout << "Reception CPU per message: " << (cpu_util * elapsed * 1e9 / msgs_recv) << " ns" << std::endl;
+            }
         }
         
         std::cout << "\n--- Application Layer Statistics ---" << std::endl;
@@ -280,26 +368,44 @@ int main(int argc, char* argv[]) {
         ->default_val(config.port);
     app.add_option("--interface,-i", config.interface, "Network interface name")
         ->default_val(config.interface);
+    app.add_option("--transport", config.transport, "Transport (tcp, multicast); multicast joins --host")
+        ->default_val(config.transport);
+    app.add_option("--mcast-interface", config.multicast_interface, "Local interface address for the multicast join")
+        ->default_val(config.multicast_interface);
+    app.add_option("--rx-timestamps", config.rx_timestamps, "Multicast receive timestamps (userspace, kernel, hardware)")
+        ->default_val(config.rx_timestamps);
     
     // Kernel bypass settings
-    app.add_option("--backend,-b", config.backend, "Kernel bypass backend (asio, dpdk, solarflare)")
+    app.add_option("--backend,-b", config.backend, "Kernel bypass backend (asio, io_uring, dpdk, solarflare)")
         ->default_val(config.backend);
     app.add_option("--rx-ring-size", config.rx_ring_size, "RX ring buffer size (power of 2)")
         ->default_val(config.rx_ring_size);
     app.add_option("--batch-size", config.batch_size, "Packet batch processing size")
         ->default_val(config.batch_size);
-    app.add_option("--cpu-core", config.cpu_core, "CPU core for networking thread")
+    app.add_option("--cpu-core", config.cpu_core, "CPU core for networking thread (-1 = unpinned)")
         ->default_val(config.cpu_core);
     app.add_flag("--no-zero-copy", "Disable zero-copy packet processing")
         ->default_val(false);
     app.add_flag("--no-numa", "Disable NUMA-aware memory allocation")
         ->default_val(false);
+    app.add_option("--huge-pages", config.huge_pages, "Ring and sample buffer backing (none, thp, 2mb, 1gb)")
+        ->default_val(config.huge_pages);
+    app.add_flag("--no-sqpoll", "io_uring: submit with io_uring_enter instead of an SQPOLL thread")
+        ->default_val(false);
+    app.add_option("--uring-buffer-size", config.io_uring_buffer_size, "io_uring: bytes per provided receive buffer")
+        ->default_val(config.io_uring_buffer_size);
     
     // Performance settings
     app.add_option("--buffer-capacity", config.buffer_capacity, "Ring buffer capacity")
         ->default_val(config.buffer_capacity);
     app.add_option("--poll-timeout", config.poll_timeout_us, "Polling timeout (microseconds)")
         ->default_val(config.poll_timeout_us);
+    app.add_option("--wait-strategy", config.wait_strategy, "Idle wait strategy (spin, yield, park)")
+        ->default_val(config.wait_strategy);
+    app.add_option("--spin-iterations", config.spin_iterations, "Empty polls spent spinning before yielding/parking")
+        ->default_val(config.spin_iterations);
+    app.add_option("--encoding,-e", config.encoding, "Wire format to decode (binary, fix, itch)")
+        ->default_val(config.encoding);
     app.add_option("--zero-copy-threshold", config.zero_copy_threshold, "Min packet size for zero-copy")
         ->default_val(config.zero_copy_threshold);
     
@@ -330,8 +436,13 @@ int main(int argc, char* argv[]) {
     app.add_option("--max-messages,-m", config.max_messages, "Max messages to process (0 = infinite)")
         ->default_val(config.max_messages);
     
+    // Metrics export
+    app.add_option("--metrics-port", config.metrics_port, "Serve Prometheus metrics on this port (0 = off)")
+        ->default_val(config.metrics_port);
+    app.add_option("--metrics-push", config.metrics_push, "Push metrics snapshots over UDP to host:port");
+    
     // Output settings
-    app.add_flag("--verbose,-v", config.verbose, "Enable verbose output");
+    app.add_flag("--verbose,-v", config.verbose, "Print packet counters with each progress line");
     app.add_flag("--latency-histogram", config.show_latency_histogram, "Show latency histogram");
     
     CLI11_PARSE(app, argc, argv);
@@ -343,6 +454,9 @@ int main(int argc, char* argv[]) {
     if (app.count("--no-numa")) {
         config.enable_numa_awareness = false;
     }
+    if (app.count("--no-sqpoll")) {
+        config.io_uring_sqpoll = false;
+    }
     
     // Validate configuration
     if (config.rx_ring_size == 0 || (config.rx_ring_size & (config.rx_ring_size - 1)) != 0) {
@@ -0,0 +1,290 @@
+#include "mdfh/batch_decoder.hpp"
+#include "mdfh/decoding.hpp"
+#include "mdfh/performance_tracker.hpp"
+#include "mdfh/pipeline.hpp"
+#include "mdfh/timing.hpp"
+#include <CLI/CLI.hpp>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <bit>
+
+using namespace mdfh;
+
+struct DecoderBenchConfig {
+    std::uint64_t messages_per_buffer = 204;    // ~4KB socket read
+    std::uint64_t iterations = 200'000;
+    double invalid_ratio = 0.0;                 // Fraction of records failing Msg::is_valid
+    std::uint32_t seed = 42;
+};
+
+// Builds one wire buffer of back-to-back packed Msg records
+std::vector<std::uint8_t> make_wire_buffer(const DecoderBenchConfig& cfg) {
+    std::mt19937 rng(cfg.seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<std::uint8_t> wire(cfg.messages_per_buffer * sizeof(Msg));
+
+    for (std::uint64_t i = 0; i < cfg.messages_per_buffer; ++i) {
+        Msg msg(i + 1, 100.0 + unit(rng), static_cast<std::int32_t>(unit(rng) * 1000) + 1);
+        if (unit(rng) < cfg.invalid_ratio) {
+            msg.qty = 0;
+        }
+        std::memcpy(wire.data() + i * sizeof(Msg), &msg, sizeof(Msg));
+    }
+    return wire;
+}
+
+// Previous parser behaviour: memcpy plus a timestamp per message, no validation
+DecodeResult decode_legacy(const std::uint8_t* data, std::size_t count, Slot* out) {
+    for (std::size_t i = 0; i < count; ++i) {
+        std::memcpy(&out[i].raw, data + i * sizeof(Msg), sizeof(Msg));
+        out[i].rx_ts = get_timestamp_ns();
+    }
+    return {count, 0};
+}
+
+template<typename DecodeOnce>
+double measure(const DecoderBenchConfig& cfg, DecodeOnce&& decode_once) {
+    Timer timer;
+    for (std::uint64_t iter = 0; iter < cfg.iterations; ++iter) {
+        decode_once();
+    }
+    return static_cast<double>(cfg.messages_per_buffer * cfg.iterations) / timer.elapsed_seconds();
+}
+
+struct PathResult {
+    double rate;                    // msgs/sec
+    double instructions;            // Retired per message (0 = not counted)
+};
+
+// Times the path like measure() and counts the instructions it retires,
+// scaled to the enabled time if the counter group was multiplexed
+template<typename RunOnce>
+PathResult measure_path(const DecoderBenchConfig& cfg, const PerfCounterGroup& counters, RunOnce&& run_once) {
+    constexpr auto INSTRUCTIONS = static_cast<std::size_t>(PerfEvent::INSTRUCTIONS);
+    auto before = counters.read();
+    auto before_times = counters.times();
+    double rate = measure(cfg, run_once);
+    auto after = counters.read();
+    auto after_times = counters.times();
+
+    PerfTimes times{after_times.enabled - before_times.enabled, after_times.running - before_times.running};
+    double instructions = 0.0;
+    if (counters.available(PerfEvent::INSTRUCTIONS) && times.counted()) {
+        instructions = static_cast<double>(after[INSTRUCTIONS] - before[INSTRUCTIONS]) / times.fraction() /
+                       static_cast<double>(cfg.messages_per_buffer * cfg.iterations);
+    }
+    return {rate, instructions};
+}
+
+// Statically composed path: concrete decoder, inlined sink and stats policy
+template<typename Stats>
+PathResult measure_pipeline(const DecoderBenchConfig& cfg, const PerfCounterGroup& counters, EncodingType encoding,
+                            const std::vector<std::uint8_t>& stream, RingBuffer& ring, Stats stats,
+                            std::uint64_t& checksum) {
+    return with_decoder(encoding, [&](auto decoder_type) {
+        auto sink = [&checksum](const Slot& slot) { checksum += slot.raw.seq; };
+        Pipeline pipeline(BufferSource({PacketDesc(stream.data(), stream.size())}, 1), decoder_type,
+                          ring, sink, stats);
+        return measure_path(cfg, counters, [&]() {
+            pipeline.produce();
+            while (pipeline.consume(cfg.messages_per_buffer) > 0) {
+            }
+        });
+    });
+}
+
+void print_row(const std::string& name, double rate, double baseline) {
+    std::cout << std::fixed << std::setprecision(2)
+              << std::setw(10) << name
+              << std::setw(14) << rate / 1e6
+              << std::setw(12) << (rate / baseline) << "x" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    DecoderBenchConfig config;
+
+    CLI::App app{"Binary Msg batch decoder benchmark"};
+
+    app.add_option("--messages,-m", config.messages_per_buffer, "Messages per wire buffer")
+        ->default_val(config.messages_per_buffer);
+    app.add_option("--iterations,-i", config.iterations, "Buffers decoded per variant")
+        ->default_val(config.iterations);
+    app.add_option("--invalid-ratio", config.invalid_ratio, "Fraction of invalid records (0.0-1.0)")
+        ->default_val(config.invalid_ratio);
+    app.add_option("--seed", config.seed, "Random seed")
+        ->default_val(config.seed);
+
+    CLI11_PARSE(app, argc, argv);
+
+    if (config.messages_per_buffer == 0 || config.invalid_ratio < 0.0 || config.invalid_ratio > 1.0) {
+        std::cerr << "Error: invalid configuration" << std::endl;
+        return 1;
+    }
+
+    auto wire = make_wire_buffer(config);
+    const std::size_t count = config.messages_per_buffer;
+    std::vector<Slot> reference(count);
+    std::vector<Slot> output(count);
+
+    auto expected = BinaryBatchDecoder(DecoderIsa::SCALAR).decode(wire.data(), count, reference.data(), 1);
+
+    std::cout << "Decoding " << count << " msgs/buffer x " << config.iterations
+              << " buffers (detected ISA: " << detect_decoder_isa() << ")\n\n";
+    std::cout << std::setw(10) << "Decoder" << std::setw(14) << "Mmsg/s" << std::setw(13) << "Speedup" << "\n";
+
+    double baseline = measure(config, [&]() {
+        decode_legacy(wire.data(), count, output.data());
+    });
+    print_row("legacy", baseline, baseline);
+
+    bool ok = true;
+    for (auto isa : {DecoderIsa::SCALAR, DecoderIsa::AVX2, DecoderIsa::AVX512}) {
+        if (!is_decoder_isa_supported(isa)) {
+            continue;
+        }
+
+        BinaryBatchDecoder decoder(isa);
+
+        // Every kernel must produce exactly the scalar output
+        auto result = decoder.decode(wire.data(), count, output.data(), 1);
+        bool matches = result.valid == expected.valid && result.invalid == expected.invalid;
+        for (std::size_t i = 0; matches && i < result.valid; ++i) {
+            matches = std::memcmp(&output[i].raw, &reference[i].raw, sizeof(Msg)) == 0
+                   && output[i].rx_ts == reference[i].rx_ts;
+        }
+        if (!matches) {
+            std::cerr << "ERROR: " << isa << " output differs from scalar decoder" << std::endl;
+            ok = false;
+            continue;
+        }
+
+        double rate = measure(config, [&]() {
+            decoder.decode(wire.data(), count, output.data(), get_timestamp_ns());
+        });
+        std::ostringstream name;
+        name << isa;
+        print_row(name.str(), rate, baseline);
+    }
+
+    std::cout << "\nValid: " << expected.valid << ", invalid: " << expected.invalid << " per buffer" << std::endl;
+
+    // Full stream decoders (framing + parse + ring publish) for each wire format
+    std::cout << "\nStream decoders (" << count << " msgs/read):\n";
+    std::cout << std::setw(10) << "Encoding" << std::setw(14) << "Mmsg/s" << std::setw(14) << "MB/s" << "\n";
+
+    std::vector<Msg> msgs(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::memcpy(&msgs[i], wire.data() + i * sizeof(Msg), sizeof(Msg));
+        if (!msgs[i].is_valid()) {
+            msgs[i].qty = 1;
+        }
+    }
+
+    for (auto encoding : {EncodingType::BINARY, EncodingType::ITCH, EncodingType::FIX}) {
+        auto stream = create_encoder(encoding)->encode(msgs);
+        auto decoder = create_decoder(encoding);
+        RingBuffer ring(std::bit_ceil(count * 2));
+        std::size_t decoded = 0;
+        std::size_t rejected = 0;
+        auto discard = [](const Slot&) {};
+
+        double rate = measure(config, [&]() {
+            auto counts = decoder->decode(stream.data(), stream.size(), get_timestamp_ns(), ring);
+            decoded += counts.decoded;
+            rejected += counts.dropped + counts.malformed;
+            while (ring.consume_batch(discard, count) > 0) {
+            }
+        });
+
+        if (decoded != count * config.iterations || rejected != 0) {
+            std::cerr << "ERROR: " << encoding << " decoder lost messages" << std::endl;
+            ok = false;
+        }
+
+        double bytes_per_msg = static_cast<double>(stream.size()) / count;
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(10) << encoding
+                  << std::setw(14) << rate / 1e6
+                  << std::setw(14) << rate * bytes_per_msg / 1024 / 1024 << std::endl;
+    }
+
+    // Whole ingestion path (decode -> ring -> consume with stats): the runtime
+    // polymorphic path against Pipeline specializations; only the adapter row
+    // does the same work as the virtual row
+    PerfCounterGroup counters;
+    counters.open();
+    std::cout << "\nIngestion path (" << count << " msgs/read, decode -> ring -> consume):\n";
+    std::cout << "  virtual and pipeline+adapter both record IngestionStats per message (clock read\n"
+              << "  included) and are the like-for-like pair; pipeline+counting and pipeline+null\n"
+              << "  do less per-message work and bound what the statistics cost\n";
+    std::cout << std::setw(10) << "Encoding" << std::setw(20) << "Path" << std::setw(14) << "Mmsg/s"
+              << std::setw(14) << "Instr/msg" << "\n";
+
+    std::uint64_t seq_sum = 0;
+    for (const auto& msg : msgs) {
+        seq_sum += msg.seq;
+    }
+
+    for (auto encoding : {EncodingType::BINARY, EncodingType::ITCH, EncodingType::FIX}) {
+        auto stream = create_encoder(encoding)->encode(msgs);
+        RingBuffer ring(std::bit_ceil(count * 2));
+
+        auto print_path = [&](const char* name, const PathResult& result, std::uint64_t checksum) {
+            if (checksum != seq_sum * config.iterations) {
+                std::cerr << "ERROR: " << encoding << " " << name << " path lost messages" << std::endl;
+                ok = false;
+            }
+            std::cout << std::fixed << std::setprecision(2)
+                      << std::setw(10) << encoding << std::setw(20) << name
+                      << std::setw(14) << result.rate / 1e6 << std::setw(14);
+            if (result.instructions > 0.0) {
+                std::cout << std::setprecision(1) << result.instructions << std::endl;
+            } else {
+                std::cout << "n/a" << std::endl;
+            }
+        };
+
+        // Virtual decoder and stats behind base pointers, std::function sink
+        {
+            std::unique_ptr<IngestionStats> stats = std::make_unique<IngestionStats>();
+            MessageParser parser(encoding);
+            std::uint64_t checksum = 0;
+            std::function<void(const Slot&)> sink = [&checksum](const Slot& slot) { checksum += slot.raw.seq; };
+            auto process = [&](const Slot& slot) {
+                stats->record_message_processed(slot);
+                sink(slot);
+            };
+            auto result = measure_path(config, counters, [&]() {
+                parser.parse_bytes(stream.data(), stream.size(), get_timestamp_ns(), ring, *stats);
+                while (ring.consume_batch(process, count) > 0) {
+                }
+            });
+            print_path("virtual", result, checksum);
+        }
+
+        {
+            IngestionStats stats;
+            std::uint64_t checksum = 0;
+            auto result = measure_pipeline(config, counters, encoding, stream, ring, IngestionStatsAdapter(stats), checksum);
+            print_path("pipeline+adapter", result, checksum);
+        }
+        {
+            PipelineCounters pipeline_counters;
+            std::uint64_t checksum = 0;
+            auto result = measure_pipeline(config, counters, encoding, stream, ring, CountingStats(pipeline_counters), checksum);
+            print_path("pipeline+counting", result, checksum);
+        }
+        {
+            std::uint64_t checksum = 0;
+            auto result = measure_pipeline(config, counters, encoding, stream, ring, NullStats{}, checksum);
+            print_path("pipeline+null", result, checksum);
+        }
+    }
+
+    return ok ? 0 : 1;
+}
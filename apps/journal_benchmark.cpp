@@ -0,0 +1,146 @@
+#include "mdfh/journal.hpp"
+#include "mdfh/timing.hpp"
+#include <CLI/CLI.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace mdfh;
+
+struct JournalBenchConfig {
+    std::string directory = "journal_bench";
+    std::uint64_t messages = 10'000'000;
+    std::uint64_t batch = 256;
+    std::uint32_t origins = 4;
+    std::uint64_t segment_mb = 64;
+    std::uint32_t flush_interval_ms = 10;
+    bool keep = false;
+};
+
+double percentile(std::vector<std::uint64_t>& samples, double p) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    auto k = static_cast<std::size_t>(p * static_cast<double>(samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(k), samples.end());
+    return static_cast<double>(samples[k]);
+}
+
+int main(int argc, char* argv[]) {
+    JournalBenchConfig config;
+
+    CLI::App app{"Tick journal append benchmark"};
+
+    app.add_option("--dir,-d", config.directory, "Journal directory")
+        ->default_val(config.directory);
+    app.add_option("--messages,-m", config.messages, "Records to append")
+        ->default_val(config.messages);
+    app.add_option("--batch,-b", config.batch, "Records per append call")
+        ->default_val(config.batch);
+    app.add_option("--origins", config.origins, "Interleaved feed origins")
+        ->default_val(config.origins);
+    app.add_option("--segment-mb", config.segment_mb, "Segment file size in MB")
+        ->default_val(config.segment_mb);
+    app.add_option("--flush-ms", config.flush_interval_ms, "Background msync interval")
+        ->default_val(config.flush_interval_ms);
+    app.add_flag("--keep", config.keep, "Keep the journal files after the run");
+
+    CLI11_PARSE(app, argc, argv);
+
+    if (config.batch == 0 || config.origins == 0 || config.origins > 65536) {
+        std::cerr << "Error: batch must be positive and origins between 1 and 65536" << std::endl;
+        return 1;
+    }
+    if (std::filesystem::exists(config.directory) && !std::filesystem::is_empty(config.directory)) {
+        std::cerr << "Error: " << config.directory << " is not empty" << std::endl;
+        return 1;
+    }
+
+    JournalConfig journal_config;
+    journal_config.directory = config.directory;
+    journal_config.segment_bytes = config.segment_mb << 20;
+    journal_config.flush_interval_ms = config.flush_interval_ms;
+
+    try {
+        std::vector<JournalRecord> batch(config.batch);
+        std::vector<std::uint64_t> latencies;
+        latencies.reserve(config.messages / config.batch + 1);
+        std::vector<std::uint64_t> next_seq(config.origins, 1);
+
+        JournalWriter writer(journal_config);
+        Timer timer;
+
+        std::uint64_t written = 0;
+        std::uint32_t origin = 0;
+        while (written < config.messages) {
+            auto n = std::min(config.batch, config.messages - written);
+            for (std::uint64_t i = 0; i < n; ++i) {
+                auto& record = batch[i];
+                record.raw = Msg(next_seq[origin]++, 100.0, 1);
+                record.origin_id = static_cast<std::uint16_t>(origin);
+                record.rx_ts = written + i;
+                origin = origin + 1 == config.origins ? 0 : origin + 1;
+            }
+
+            auto start = get_timestamp_ns();
+            writer.append(std::span<const JournalRecord>(batch.data(), n));
+            latencies.push_back(get_timestamp_ns() - start);
+            written += n;
+        }
+        double append_seconds = timer.elapsed_seconds();
+
+        writer.close();
+        double total_seconds = timer.elapsed_seconds();
+
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "Appended " << written << " records in batches of " << config.batch << "\n";
+        std::cout << "  Append rate:      " << written / append_seconds / 1e6 << " M records/s ("
+                  << written * sizeof(JournalRecord) / append_seconds / (1 << 20) << " MB/s)\n";
+        std::cout << "  Durable rate:     " << written / total_seconds / 1e6 << " M records/s\n";
+        std::cout << "  Append latency:   p50 " << percentile(latencies, 0.50) << " ns, p99 "
+                  << percentile(latencies, 0.99) << " ns, p99.9 " << percentile(latencies, 0.999)
+                  << " ns, max " << percentile(latencies, 1.0) << " ns\n";
+        std::cout << "  Segments rolled:  " << writer.segments_rolled()
+                  << " (" << writer.roll_stalls() << " stalled)\n";
+        std::cout << "  Syncs:            " << writer.syncs() << "\n";
+
+        // Read back and check every origin's sequence is intact and indexed
+        JournalReader reader(config.directory);
+        std::vector<std::uint64_t> expected(config.origins, 1);
+        std::uint64_t mismatches = 0;
+        reader.for_each([&](const JournalRecord& record) {
+            if (record.raw.seq != expected[record.origin_id]++) {
+                ++mismatches;
+            }
+        });
+
+        std::uint64_t found = 0;
+        std::uint64_t probes = 0;
+        Timer lookup_timer;
+        for (std::uint32_t o = 0; o < config.origins; ++o) {
+            for (std::uint64_t seq = 1; seq < next_seq[o]; seq += std::max<std::uint64_t>(1, next_seq[o] / 64)) {
+                ++probes;
+                if (auto pos = reader.find(static_cast<std::uint16_t>(o), seq)) {
+                    const auto& record = reader.records(pos->segment)[pos->record];
+                    found += record.origin_id == o && record.raw.seq == seq;
+                }
+            }
+        }
+        double lookup_us = lookup_timer.elapsed_seconds() * 1e6 / std::max<std::uint64_t>(probes, 1);
+
+        std::cout << "Read back " << reader.total_records() << " records from " << reader.segment_count()
+                  << " segments, " << mismatches << " out of sequence\n";
+        std::cout << "  Index lookups:    " << found << "/" << probes << " found, " << lookup_us << " us each\n";
+
+        bool ok = reader.total_records() == written && mismatches == 0 && found == probes;
+        if (!config.keep) {
+            std::filesystem::remove_all(config.directory);
+        }
+        return ok ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
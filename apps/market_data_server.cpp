@@ -1,4 +1,6 @@
 #include "mdfh/core.hpp"
+#include "mdfh/fanout.hpp"
+#include "mdfh/replay.hpp"
 #include <boost/asio.hpp>
 #include <CLI/CLI.hpp>
 #include <iostream>
@@ -7,7 +9,7 @@
 #include <vector>
 #include <atomic>
 #include <random>
-#include <mutex>
+#include <cstring>
 
 using namespace mdfh;
 using namespace boost::asio;
@@ -15,7 +17,7 @@ using tcp = ip::tcp;
 
 struct ServerConfig {
     std::string host = "127.0.0.1";
-    std::uint16_t port = 9001;
+    std::vector<std::uint16_t> ports = {9001};  // One feed per port, each with its own sequence
     std::uint32_t rate = 50000;        // messages per second
     std::uint32_t batch_size = 100;    // messages per batch
     std::uint32_t max_seconds = 0;     // 0 = infinite
@@ -24,16 +26,27 @@ struct ServerConfig {
     double base_price = 100.0;
     double price_jitter = 0.05;
     std::uint32_t max_quantity = 1000;
+    ReplayConfig replay;               // Recorded traffic instead of generated messages
+    FanoutConfig fanout;               // Per-client queue bound and slow-consumer policy
 };
 
 std::ostream& operator<<(std::ostream& os, const ServerConfig& cfg) {
     os << "Market Data Server Configuration:\n";
-    os << "  Listen: " << cfg.host << ":" << cfg.port << "\n";
+    os << "  Listen: " << cfg.host << " port";
+    for (auto port : cfg.ports) {
+        os << " " << port;
+    }
+    os << "\n";
     os << "  Rate: " << cfg.rate << " msgs/sec\n";
     os << "  Batch Size: " << cfg.batch_size << " msgs\n";
     os << "  Base Price: $" << cfg.base_price << "\n";
     os << "  Price Jitter: ±$" << cfg.price_jitter << "\n";
     os << "  Max Quantity: " << cfg.max_quantity << "\n";
+    os << "  Client Queue: " << cfg.fanout.max_queued_batches << " batches (slow consumers: "
+       << cfg.fanout.policy << ")\n";
+    if (cfg.replay.enabled()) {
+        os << "  Replay: " << cfg.replay << "\n";
+    }
     if (cfg.max_seconds > 0) {
         os << "  Max Duration: " << cfg.max_seconds << " seconds\n";
     }
@@ -45,11 +58,15 @@ std::ostream& operator<<(std::ostream& os, const ServerConfig& cfg) {
 
 class MarketDataServer {
 private:
+    // One listening port: its subscribers and its own message sequence
+    struct Feed {
+        std::unique_ptr<FanoutFeed> fanout;
+        std::uint64_t sequence = 1;
+    };
+    
     ServerConfig config_;
     io_context ctx_;
-    tcp::acceptor acceptor_;
-    std::vector<std::shared_ptr<tcp::socket>> clients_;
-    std::mutex clients_mutex_;  // Protect clients_ vector
+    std::vector<Feed> feeds_;
     std::atomic<bool> running_{false};
     std::thread server_thread_;
     
@@ -59,17 +76,29 @@ private:
     std::uniform_int_distribution<std::uint32_t> qty_dist_;
     std::uniform_int_distribution<int> side_dist_;
     
+    // Recorded traffic, copied once per batch and shared by every feed
+    std::unique_ptr<ReplaySource> replay_;
+    std::vector<ReplayEvent> replay_events_;
+    
 public:
     explicit MarketDataServer(ServerConfig config)
         : config_(std::move(config))
-        , acceptor_(ctx_, tcp::endpoint(ip::address::from_string(config_.host), config_.port))
         , rng_(std::random_device{}())
         , price_dist_(-config_.price_jitter, config_.price_jitter)
         , qty_dist_(1, config_.max_quantity)
         , side_dist_(0, 1) {
         
-        // Set SO_REUSEADDR to allow quick restart
-        acceptor_.set_option(tcp::acceptor::reuse_address(true));
+        auto address = ip::make_address(config_.host);
+        for (auto port : config_.ports) {
+            Feed feed;
+            feed.fanout = std::make_unique<FanoutFeed>(ctx_, tcp::endpoint(address, port), config_.fanout);
+            feeds_.push_back(std::move(feed));
+        }
+        
+        if (config_.replay.enabled()) {
+            replay_ = std::make_unique<ReplaySource>(config_.replay);
+            replay_events_.resize(config_.batch_size);
+        }
     }
     
     ~MarketDataServer() {
@@ -78,33 +107,24 @@ public:
     
     void start() {
         std::cout << config_ << std::endl;
-        std::cout << "Starting market data server on " << acceptor_.local_endpoint() << std::endl;
+        for (auto& feed : feeds_) {
+            std::cout << "Starting market data server on " << feed.fanout->local_endpoint() << std::endl;
+            feed.fanout->start();
+        }
         
         running_ = true;
         
-        // Start accepting connections
-        start_accept();
-        
         // Start message generation in separate thread
         server_thread_ = std::thread([this]() {
             message_generation_loop();
         });
         
-        // Run IO context
+        // Run IO context: accepts and every client's writes; returns once all feeds have closed
         ctx_.run();
     }
     
     void stop() {
         running_ = false;
-        acceptor_.close();
-        
-        for (auto& client : clients_) {
-            if (client && client->is_open()) {
-                client->close();
-            }
-        }
-        clients_.clear();
-        
         ctx_.stop();
         
         if (server_thread_.joinable()) {
@@ -113,27 +133,12 @@ public:
     }
     
 private:
-    void start_accept() {
-        auto socket = std::make_shared<tcp::socket>(ctx_);
-        
-        acceptor_.async_accept(*socket,
-            [this, socket](boost::system::error_code ec) {
-                if (!ec) {
-                    std::cout << "Client connected from " << socket->remote_endpoint() << std::endl;
-                    
-                    // Thread-safe client addition
-                    {
-                        std::lock_guard<std::mutex> lock(clients_mutex_);
-                        clients_.push_back(socket);
-                        std::cout << "Total clients: " << clients_.size() << std::endl;
-                    }
-                    
-                    start_accept(); // Continue accepting more connections
-                } else if (ec != boost::asio::error::operation_aborted) {
-                    std::cerr << "Accept error: " << ec.message() << std::endl;
-                    start_accept();
-                }
-            });
+    std::size_t client_count() const {
+        std::size_t clients = 0;
+        for (const auto& feed : feeds_) {
+            clients += feed.fanout->clients();
+        }
+        return clients;
     }
     
     void message_generation_loop() {
@@ -141,7 +146,6 @@ private:
         
         auto start_time = std::chrono::steady_clock::now();
         std::uint64_t messages_sent = 0;
-        std::uint64_t sequence = 1;
         
         // Calculate timing for rate limiting with higher precision
         auto messages_per_batch = config_.batch_size;
@@ -168,14 +172,8 @@ private:
                 break;
             }
             
-            // Wait for at least one client (thread-safe check)
-            bool has_clients = false;
-            {
-                std::lock_guard<std::mutex> lock(clients_mutex_);
-                has_clients = !clients_.empty();
-            }
-            
-            if (!has_clients) {
+            // Wait for at least one client on any feed
+            if (client_count() == 0) {
                 if (config_.verbose) {
                     std::cout << "Waiting for clients to connect..." << std::endl;
                 }
@@ -184,40 +182,37 @@ private:
             }
             
             if (config_.verbose && messages_sent == 0) {
-                std::size_t client_count = 0;
-                {
-                    std::lock_guard<std::mutex> lock(clients_mutex_);
-                    client_count = clients_.size();
-                }
-                std::cout << "Starting to send messages to " << client_count << " clients..." << std::endl;
+                std::cout << "Starting to send messages to " << client_count() << " clients..." << std::endl;
             }
             
-            // Generate and send a batch of messages
-            std::vector<Msg> batch;
-            batch.reserve(messages_per_batch);
-            
-            for (std::uint32_t i = 0; i < messages_per_batch && running_; ++i) {
-                Msg msg = generate_message(sequence++);
-                batch.push_back(msg);
+            if (replay_) {
+                auto sent = send_replay_batch();
+                if (sent == 0 && replay_->finished()) {
+                    break;
+                }
+                messages_sent += sent;
+                continue;   // Paced by the recorded timestamps
             }
             
-            // Send batch to all connected clients
-            send_batch_to_clients(batch);
-            messages_sent += batch.size();
+            // Encode one batch per feed; its clients all share it
+            for (auto& feed : feeds_) {
+                auto batch = std::make_shared<std::vector<std::uint8_t>>(messages_per_batch * sizeof(Msg));
+                for (std::uint32_t i = 0; i < messages_per_batch; ++i) {
+                    Msg msg = generate_message(feed.sequence++);
+                    std::memcpy(batch->data() + i * sizeof(Msg), &msg, sizeof(Msg));
+                }
+                feed.fanout->publish(std::move(batch));
+            }
+            messages_sent += messages_per_batch;
             
             // Adaptive verbose output based on rate
-            std::uint64_t report_interval = std::max(1000ULL, static_cast<std::uint64_t>(config_.rate) / 10); // Report 10 times per second max
+            std::uint64_t report_interval = std::max<std::uint64_t>(1000, config_.rate / 10); // Report 10 times per second max
             if (config_.verbose && (messages_sent % report_interval == 0 || messages_sent <= 1000)) {
-                std::size_t client_count = 0;
-                {
-                    std::lock_guard<std::mutex> lock(clients_mutex_);
-                    client_count = clients_.size();
-                }
                 auto now = std::chrono::steady_clock::now();
                 auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - start_time).count();
                 auto current_rate = elapsed > 0 ? messages_sent / elapsed : 0;
-                std::cout << "Sent " << messages_sent << " messages to " 
-                          << client_count << " clients (rate: " << current_rate << " msg/s)" << std::endl;
+                std::cout << "Sent " << messages_sent << " messages per feed to " 
+                          << client_count() << " clients (rate: " << current_rate << " msg/s)" << std::endl;
             }
             
             // Rate limiting - sleep until next batch time
@@ -236,18 +231,57 @@ private:
         auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(end_time - start_time).count();
         
         std::cout << "\nMessage generation completed:" << std::endl;
-        std::cout << "  Total messages sent: " << messages_sent << std::endl;
+        std::cout << "  Total messages sent: " << messages_sent << " per feed" << std::endl;
         std::cout << "  Duration: " << elapsed << " seconds" << std::endl;
-        std::cout << "  Average rate: " << (messages_sent / std::max(1LL, elapsed)) << " msgs/sec" << std::endl;
+        std::cout << "  Average rate: " << (messages_sent / std::max<std::int64_t>(1, elapsed)) << " msgs/sec" << std::endl;
+        if (replay_) {
+            std::cout << "  Recorded events: " << replay_->events_replayed() << " over "
+                      << replay_->passes() << " passes" << std::endl;
+        }
+        for (const auto& feed : feeds_) {
+            const auto& fanout = *feed.fanout;
+            std::cout << "  Port " << fanout.local_endpoint().port() << ": "
+                      << fanout.clients_accepted() << " clients, "
+                      << fanout.batches_dropped() << " batches dropped, "
+                      << fanout.batches_shed() << " shed, "
+                      << fanout.slow_disconnects() << " slow disconnects, "
+                      << fanout.bytes_sent() << " bytes sent" << std::endl;
+        }
         
-        // Close all client connections
-        for (auto& client : clients_) {
-            if (client && client->is_open()) {
-                client->close();
-            }
+        // Each client is closed once it has received everything queued for
+        // it, or cut after the drain deadline
+        for (auto& feed : feeds_) {
+            feed.fanout->close();
         }
     }
     
+    // Sends the next due events of the recording to every feed; returns messages sent
+    std::uint64_t send_replay_batch() {
+        auto count = replay_->next_batch(replay_events_);
+        if (count == 0) {
+            return 0;
+        }
+        
+        std::uint64_t messages = 0;
+        std::size_t bytes = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            bytes += replay_events_[i].bytes.size();
+            messages += replay_events_[i].messages;
+        }
+        
+        auto batch = std::make_shared<std::vector<std::uint8_t>>();
+        batch->reserve(bytes);
+        for (std::size_t i = 0; i < count; ++i) {
+            batch->insert(batch->end(), replay_events_[i].bytes.begin(), replay_events_[i].bytes.end());
+        }
+        
+        SharedBatch shared = std::move(batch);
+        for (auto& feed : feeds_) {
+            feed.fanout->publish(shared);
+        }
+        return messages;
+    }
+    
     Msg generate_message(std::uint64_t sequence) {
         Msg msg;
         msg.seq = sequence;
@@ -255,33 +289,6 @@ private:
         msg.qty = (side_dist_(rng_) == 0 ? 1 : -1) * static_cast<std::int32_t>(qty_dist_(rng_));
         return msg;
     }
-    
-    void send_batch_to_clients(const std::vector<Msg>& batch) {
-        if (batch.empty()) return;
-        
-        std::lock_guard<std::mutex> lock(clients_mutex_);
-        
-        // Remove disconnected clients
-        clients_.erase(
-            std::remove_if(clients_.begin(), clients_.end(),
-                [](const std::shared_ptr<tcp::socket>& client) {
-                    return !client || !client->is_open();
-                }),
-            clients_.end());
-        
-        // Send batch to all connected clients
-        for (auto& client : clients_) {
-            if (client && client->is_open()) {
-                boost::system::error_code ec;
-                write(*client, buffer(batch.data(), batch.size() * sizeof(Msg)), ec);
-                
-                if (ec) {
-                    std::cout << "Send error to client: " << ec.message() << std::endl;
-                    client->close();
-                }
-            }
-        }
-    }
 };
 
 // Global server instance for signal handling
@@ -302,8 +309,8 @@ int main(int argc, char* argv[]) {
     // Network settings
     app.add_option("--host", config.host, "Host address to bind to")
         ->default_val(config.host);
-    app.add_option("--port,-p", config.port, "Port to listen on")
-        ->default_val(config.port);
+    app.add_option("--port,-p", config.ports, "Ports to listen on, one feed each")
+        ->capture_default_str();
     
     // Message generation settings
     app.add_option("--rate,-r", config.rate, "Message rate (msgs/sec)")
@@ -323,6 +330,28 @@ int main(int argc, char* argv[]) {
     app.add_option("--max-quantity", config.max_quantity, "Maximum quantity per message")
         ->default_val(config.max_quantity);
     
+    // Replay settings
+    std::string replay_format = "auto";
+    app.add_option("--replay", config.replay.path, "Replay a journal directory or pcap file instead of generating");
+    app.add_option("--replay-format", replay_format, "Recording format (auto, journal, pcap)")
+        ->default_val(replay_format);
+    app.add_option("--replay-speed", config.replay.speed, "Multiple of the recorded pace (0 = max rate)")
+        ->default_val(config.replay.speed);
+    app.add_flag("--replay-loop", config.replay.loop, "Start the recording over when it ends");
+    app.add_option("--replay-origin", config.replay.origin_id, "Journal: replay only this feed origin")
+        ->default_val(config.replay.origin_id);
+    app.add_option("--replay-port", config.replay.port, "Pcap: replay only payloads sent to this port")
+        ->default_val(config.replay.port);
+    
+    // Fan-out settings
+    std::string slow_consumer = "drop";
+    app.add_option("--client-queue", config.fanout.max_queued_batches, "Batches queued per client before it counts as slow")
+        ->default_val(config.fanout.max_queued_batches);
+    app.add_option("--slow-consumer", slow_consumer, "Slow client policy (drop, conflate, disconnect)")
+        ->default_val(slow_consumer);
+    app.add_option("--close-timeout-ms", config.fanout.close_timeout_ms, "On shutdown, time clients get to drain their queues")
+        ->default_val(config.fanout.close_timeout_ms);
+    
     // Output settings
     app.add_flag("--verbose,-v", config.verbose, "Enable verbose output");
     
@@ -339,6 +368,28 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
+    if (config.ports.empty()) {
+        std::cerr << "Error: At least one port is required" << std::endl;
+        return 1;
+    }
+    
+    if (!config.fanout.is_valid()) {
+        std::cerr << "Error: Client queue must be > 0" << std::endl;
+        return 1;
+    }
+    
+    try {
+        config.replay.format = parse_replay_format(replay_format);
+        config.fanout.policy = parse_slow_consumer_policy(slow_consumer);
+    } catch (const std::invalid_argument& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    if (config.replay.enabled() && !config.replay.is_valid()) {
+        std::cerr << "Error: Replay speed must be >= 0" << std::endl;
+        return 1;
+    }
+    
     // Set up signal handling
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
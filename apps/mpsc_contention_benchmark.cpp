@@ -0,0 +1,162 @@
+#include "mdfh/multi_feed_ingestion.hpp"
+#include "mdfh/timing.hpp"
+#include <CLI/CLI.hpp>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+using namespace mdfh;
+
+struct ContentionConfig {
+    std::uint32_t min_producers = 1;
+    std::uint32_t max_producers = 16;
+    std::uint64_t messages_per_producer = 1'000'000;
+    std::uint64_t capacity = 262144;
+    std::uint32_t batch_size = 1;       // 1 = try_push, >1 = try_push_n
+};
+
+struct ContentionResult {
+    std::uint32_t producers;
+    double seconds;
+    std::uint64_t messages;
+    std::uint64_t full_retries;
+    std::uint64_t order_violations;
+};
+
+// Runs N producers against one consumer and verifies per-producer ordering
+ContentionResult run_contention(const ContentionConfig& cfg, std::uint32_t producers) {
+    MPSCRingBuffer buffer(cfg.capacity);
+    std::atomic<bool> start{false};
+    std::atomic<std::uint64_t> full_retries{0};
+    std::vector<std::thread> threads;
+
+    const std::uint64_t total = cfg.messages_per_producer * producers;
+
+    for (std::uint32_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            std::vector<MultiFeedSlot> batch(cfg.batch_size);
+            std::uint64_t retries = 0;
+
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+
+            std::uint64_t seq = 1;
+            while (seq <= cfg.messages_per_producer) {
+                if (cfg.batch_size <= 1) {
+                    MultiFeedSlot slot(Slot(Msg(seq, 100.0, 1), seq), static_cast<std::uint16_t>(p));
+                    if (buffer.try_push(slot)) {
+                        ++seq;
+                    } else {
+                        ++retries;
+                    }
+                    continue;
+                }
+
+                std::uint64_t n = std::min<std::uint64_t>(cfg.batch_size, cfg.messages_per_producer - seq + 1);
+                for (std::uint64_t i = 0; i < n; ++i) {
+                    batch[i] = MultiFeedSlot(Slot(Msg(seq + i, 100.0, 1), seq + i), static_cast<std::uint16_t>(p));
+                }
+
+                std::uint64_t pushed = 0;
+                while (pushed < n) {
+                    auto count = buffer.try_push_n(batch.data() + pushed, n - pushed);
+                    if (count == 0) {
+                        ++retries;
+                    }
+                    pushed += count;
+                }
+                seq += n;
+            }
+
+            full_retries.fetch_add(retries, std::memory_order_relaxed);
+        });
+    }
+
+    std::vector<std::uint64_t> last_seq(producers, 0);
+    std::vector<MultiFeedSlot> popped(256);
+    std::uint64_t received = 0;
+    std::uint64_t order_violations = 0;
+
+    Timer timer;
+    start.store(true, std::memory_order_release);
+
+    while (received < total) {
+        auto count = buffer.try_pop_n(popped.data(), popped.size());
+        for (std::uint64_t i = 0; i < count; ++i) {
+            const auto& slot = popped[i];
+            if (slot.feed_sequence() != last_seq[slot.origin_id] + 1) {
+                ++order_violations;
+            }
+            last_seq[slot.origin_id] = slot.feed_sequence();
+        }
+        received += count;
+    }
+
+    double seconds = timer.elapsed_seconds();
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    return {producers, seconds, received, full_retries.load(), order_violations};
+}
+
+int main(int argc, char* argv[]) {
+    ContentionConfig config;
+
+    CLI::App app{"MPSC fan-in buffer contention benchmark"};
+
+    app.add_option("--min-producers", config.min_producers, "Smallest producer count in the sweep")
+        ->default_val(config.min_producers);
+    app.add_option("--max-producers", config.max_producers, "Largest producer count in the sweep")
+        ->default_val(config.max_producers);
+    app.add_option("--messages,-m", config.messages_per_producer, "Messages per producer")
+        ->default_val(config.messages_per_producer);
+    app.add_option("--capacity,-c", config.capacity, "Buffer capacity (power of 2)")
+        ->default_val(config.capacity);
+    app.add_option("--batch-size,-b", config.batch_size, "Producer batch size (1 = single push)")
+        ->default_val(config.batch_size);
+
+    CLI11_PARSE(app, argc, argv);
+
+    if (!is_power_of_two(config.capacity)) {
+        std::cerr << "Error: capacity must be a power of 2" << std::endl;
+        return 1;
+    }
+    if (config.min_producers == 0 || config.min_producers > config.max_producers) {
+        std::cerr << "Error: invalid producer range" << std::endl;
+        return 1;
+    }
+
+    std::cout << "MPSC contention sweep: " << config.messages_per_producer << " msgs/producer, "
+              << "capacity " << config.capacity << ", batch " << config.batch_size << "\n\n";
+    std::cout << std::setw(10) << "Producers" << std::setw(14) << "Msgs"
+              << std::setw(14) << "Seconds" << std::setw(14) << "Mmsg/s"
+              << std::setw(14) << "FullRetries" << std::setw(12) << "Reorders" << "\n";
+
+    bool ok = true;
+    for (std::uint32_t producers = config.min_producers; producers <= config.max_producers; ++producers) {
+        auto result = run_contention(config, producers);
+        double rate = result.messages / result.seconds / 1e6;
+
+        std::cout << std::fixed << std::setprecision(3)
+                  << std::setw(10) << result.producers
+                  << std::setw(14) << result.messages
+                  << std::setw(14) << result.seconds
+                  << std::setw(14) << rate
+                  << std::setw(14) << result.full_retries
+                  << std::setw(12) << result.order_violations << std::endl;
+
+        if (result.order_violations > 0) {
+            ok = false;
+        }
+    }
+
+    if (!ok) {
+        std::cerr << "\nERROR: per-producer ordering violated" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -13,6 +13,19 @@ int main(int argc, char* argv[]) {
     std::uint32_t max_seconds = 0;
     std::uint64_t max_messages = 0;
     std::uint32_t global_buffer_capacity = 262144;
+    std::string wait_strategy;
+    std::string fan_in_mode;
+    bool arbitrate = false;
+    std::uint32_t dispatcher_threads = 0;
+    std::vector<std::uint32_t> dispatcher_cores;
+    std::uint32_t park_timeout_us = 0;
+    std::string journal_dir;
+    std::string shm_ring_path;
+    std::uint32_t conflate_keys = 0;
+    std::string conflate_by;
+    bool thread_counters = false;
+    std::uint16_t metrics_port = 0;
+    std::string metrics_push;
     
     // CLI options
     app.add_option("-c,--config", config_file, "YAML configuration file");
@@ -21,6 +34,20 @@ int main(int argc, char* argv[]) {
     app.add_option("-t,--time", max_seconds, "Maximum runtime in seconds (0 = infinite)");
     app.add_option("-m,--messages", max_messages, "Maximum messages to process (0 = infinite)");
     app.add_option("-b,--buffer", global_buffer_capacity, "Global buffer capacity (power of 2)");
+    app.add_option("--fan-in", fan_in_mode, "Fan-in mode (relay: per-feed relay threads into an MPSC buffer, direct: consumer drains per-feed lanes)");
+    app.add_option("-d,--dispatcher-threads", dispatcher_threads, "Consumer shards; feeds are split between them");
+    app.add_option("--dispatcher-cores", dispatcher_cores, "CPU core per consumer shard, in shard order")
+        ->expected(-1);
+    app.add_flag("--arbitrate", arbitrate, "Treat all feeds as A/B lines of one stream and drop duplicate sequences");
+    app.add_option("-w,--wait-strategy", wait_strategy, "Idle wait strategy for every loop (spin, yield, park)");
+    app.add_option("--park-timeout", park_timeout_us, "Maximum park time in microseconds");
+    app.add_option("--journal", journal_dir, "Capture consumed messages into a tick journal in this directory");
+    app.add_option("--shm-ring", shm_ring_path, "Publish consumed messages to a shared-memory ring at this path (e.g. /dev/shm/mdfh)");
+    app.add_option("--conflate-keys", conflate_keys, "Keep the latest message of up to this many keys per shard for a slow reader (0 = off)");
+    app.add_option("--conflate-by", conflate_by, "Conflation key (origin, price_level)");
+    app.add_option("--metrics-port", metrics_port, "Serve Prometheus metrics on this port (0 = off)");
+    app.add_option("--metrics-push", metrics_push, "Push metrics snapshots over UDP to host:port");
+    app.add_flag("--thread-counters", thread_counters, "Report cycles, instructions and cache/TLB/branch misses per message for each thread");
     
     CLI11_PARSE(app, argc, argv);
     
@@ -49,6 +76,56 @@ int main(int argc, char* argv[]) {
         if (global_buffer_capacity != 262144) {
             config.global_buffer_capacity = global_buffer_capacity;
         }
+        if (!fan_in_mode.empty()) {
+            config.fan_in_mode = mdfh::parse_fan_in_mode(fan_in_mode);
+        }
+        if (dispatcher_threads > 0) {
+            config.dispatcher_threads = dispatcher_threads;
+        }
+        if (!dispatcher_cores.empty()) {
+            config.dispatcher_cores = dispatcher_cores;
+        }
+        if (arbitrate) {
+            for (auto& feed : config.feeds) {
+                if (feed.arbitration_group.empty()) {
+                    feed.arbitration_group = "default";
+                }
+            }
+        }
+        if (!journal_dir.empty()) {
+            config.journal.directory = journal_dir;
+        }
+        if (!shm_ring_path.empty()) {
+            config.shm_ring.path = shm_ring_path;
+        }
+        if (conflate_keys > 0) {
+            config.conflation.max_keys = conflate_keys;
+        }
+        if (!conflate_by.empty()) {
+            config.conflation.key = mdfh::parse_conflation_key(conflate_by);
+        }
+        if (thread_counters) {
+            config.thread_counters = true;
+        }
+        if (metrics_port > 0) {
+            config.metrics.http_port = metrics_port;
+        }
+        if (!metrics_push.empty()) {
+            config.metrics.push_address = metrics_push;
+        }
+        if (!wait_strategy.empty()) {
+            auto type = mdfh::parse_wait_strategy_type(wait_strategy);
+            config.consumer_wait.type = type;
+            for (auto& feed : config.feeds) {
+                feed.wait.type = type;
+            }
+        }
+        if (park_timeout_us > 0) {
+            config.consumer_wait.park_timeout_us = park_timeout_us;
+            for (auto& feed : config.feeds) {
+                feed.wait.park_timeout_us = park_timeout_us;
+            }
+        }
         
         // Validate configuration
         if (!config.is_valid()) {
@@ -59,8 +136,13 @@ int main(int argc, char* argv[]) {
         // Print configuration summary
         std::cout << "\n=== Multi-Feed Configuration ===" << std::endl;
         std::cout << "Number of feeds: " << config.feeds.size() << std::endl;
-        std::cout << "Global buffer capacity: " << config.global_buffer_capacity << std::endl;
+        std::cout << "Fan-in mode: " << config.fan_in_mode << std::endl;
+        if (config.fan_in_mode == mdfh::FanInMode::RELAY) {
+            std::cout << "Global buffer capacity: " << config.global_buffer_capacity << std::endl;
+        }
+        std::cout << "Dispatcher threads: " << config.dispatcher_threads << std::endl;
         std::cout << "Health check interval: " << config.health_check_interval_ms << "ms" << std::endl;
+        std::cout << "Consumer wait: " << config.consumer_wait << std::endl;
         if (config.max_seconds > 0) {
             std::cout << "Max runtime: " << config.max_seconds << " seconds" << std::endl;
         }
@@ -71,7 +153,11 @@ int main(int argc, char* argv[]) {
         std::cout << "\nFeeds:" << std::endl;
         for (const auto& feed : config.feeds) {
             std::cout << "  - " << feed.name << " [" << feed.host << ":" << feed.port << "] "
-                      << (feed.is_primary ? "(PRIMARY)" : "(BACKUP)") << std::endl;
+                      << (feed.is_primary ? "(PRIMARY)" : "(BACKUP)") << " wait: " << feed.wait;
+            if (!feed.arbitration_group.empty()) {
+                std::cout << " group: " << feed.arbitration_group;
+            }
+            std::cout << std::endl;
         }
         
         // Run benchmark
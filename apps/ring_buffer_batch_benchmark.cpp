@@ -0,0 +1,143 @@
+#include "mdfh/ring_buffer.hpp"
+#include "mdfh/timing.hpp"
+#include <CLI/CLI.hpp>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <sstream>
+
+using namespace mdfh;
+
+struct BatchBenchConfig {
+    std::uint64_t capacity = 65536;
+    std::uint64_t messages = 20'000'000;
+    std::vector<std::uint64_t> batch_sizes = {1, 8, 64, 256};
+    std::uint32_t repeats = 3;
+};
+
+enum class ConsumerMode {
+    POP,            // try_pop per slot, or try_pop_bulk for batches
+    CONSUME_BATCH   // consume_batch callback, one read_pos_ publish per batch
+};
+
+// Runs one producer/consumer pair and returns throughput in msgs/sec
+double run_pair(const BatchBenchConfig& cfg, std::uint64_t batch, ConsumerMode mode) {
+    RingBuffer ring(cfg.capacity);
+    std::atomic<bool> start{false};
+
+    std::thread producer([&]() {
+        std::vector<Slot> slots(batch);
+        while (!start.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+
+        std::uint64_t seq = 1;
+        while (seq <= cfg.messages) {
+            if (batch == 1) {
+                if (ring.try_push(Slot(Msg(seq, 100.0, 1), seq))) {
+                    ++seq;
+                }
+                continue;
+            }
+
+            std::uint64_t n = std::min(batch, cfg.messages - seq + 1);
+            for (std::uint64_t i = 0; i < n; ++i) {
+                slots[i] = Slot(Msg(seq + i, 100.0, 1), seq + i);
+            }
+            std::uint64_t pushed = 0;
+            while (pushed < n) {
+                pushed += ring.try_push_bulk(slots.data() + pushed, n - pushed);
+            }
+            seq += n;
+        }
+    });
+
+    std::vector<Slot> slots(batch);
+    std::uint64_t received = 0;
+    std::uint64_t checksum = 0;
+    auto process = [&checksum](const Slot& slot) { checksum += slot.raw.seq; };
+
+    Timer timer;
+    start.store(true, std::memory_order_release);
+
+    while (received < cfg.messages) {
+        if (mode == ConsumerMode::CONSUME_BATCH) {
+            received += ring.consume_batch(process, batch);
+        } else if (batch == 1) {
+            if (ring.try_pop(slots[0])) {
+                process(slots[0]);
+                ++received;
+            }
+        } else {
+            auto n = ring.try_pop_bulk(slots.data(), batch);
+            for (std::uint64_t i = 0; i < n; ++i) {
+                process(slots[i]);
+            }
+            received += n;
+        }
+    }
+
+    double seconds = timer.elapsed_seconds();
+    producer.join();
+
+    if (checksum != cfg.messages * (cfg.messages + 1) / 2) {
+        throw std::runtime_error("Checksum mismatch: messages lost or duplicated");
+    }
+    return cfg.messages / seconds;
+}
+
+double best_of(const BatchBenchConfig& cfg, std::uint64_t batch, ConsumerMode mode) {
+    double best = 0.0;
+    for (std::uint32_t r = 0; r < cfg.repeats; ++r) {
+        best = std::max(best, run_pair(cfg, batch, mode));
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    BatchBenchConfig config;
+
+    CLI::App app{"Ring buffer batched consumer benchmark"};
+
+    app.add_option("--capacity,-c", config.capacity, "Ring buffer capacity (power of 2)")
+        ->default_val(config.capacity);
+    app.add_option("--messages,-m", config.messages, "Messages per run")
+        ->default_val(config.messages);
+    app.add_option("--batch-sizes,-b", config.batch_sizes, "Batch sizes to sweep");
+    app.add_option("--repeats,-r", config.repeats, "Runs per data point (best is reported)")
+        ->default_val(config.repeats);
+
+    CLI11_PARSE(app, argc, argv);
+
+    if (!is_power_of_two(config.capacity) || config.repeats == 0) {
+        std::cerr << "Error: capacity must be a power of 2 and repeats > 0" << std::endl;
+        return 1;
+    }
+
+    std::cout << "SPSC ring buffer: " << config.messages << " msgs, capacity " << config.capacity
+              << ", best of " << config.repeats << "\n\n";
+    std::cout << std::setw(8) << "Batch" << std::setw(18) << "pop (Mmsg/s)"
+              << std::setw(22) << "consume_batch (Mmsg/s)" << std::setw(10) << "Speedup" << "\n";
+
+    try {
+        for (auto batch : config.batch_sizes) {
+            if (batch == 0) continue;
+            double pop_rate = best_of(config, batch, ConsumerMode::POP);
+            double batch_rate = best_of(config, batch, ConsumerMode::CONSUME_BATCH);
+
+            std::cout << std::fixed << std::setprecision(2)
+                      << std::setw(8) << batch
+                      << std::setw(18) << pop_rate / 1e6
+                      << std::setw(22) << batch_rate / 1e6
+                      << std::setw(9) << batch_rate / pop_rate << "x" << std::endl;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Benchmark failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
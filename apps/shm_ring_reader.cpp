@@ -0,0 +1,106 @@
+#include "mdfh/multi_feed_ingestion.hpp"
+#include "mdfh/shm_ring.hpp"
+#include "mdfh/histogram.hpp"
+#include "mdfh/timing.hpp"
+#include <CLI/CLI.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <thread>
+
+using namespace mdfh;
+
+namespace {
+
+std::atomic<bool> g_stop{false};
+
+void signal_handler(int) {
+    g_stop.store(true);
+}
+
+} // namespace
+
+// Example out-of-process consumer: attaches to a multi_feed_benchmark
+// shared-memory ring and reports rate, losses and publish-to-read latency
+int main(int argc, char* argv[]) {
+    std::string path;
+    std::uint32_t max_seconds = 0;
+    int core = -1;
+
+    CLI::App app{"Shared-memory ring reader"};
+
+    app.add_option("path", path, "Ring file (multi_feed_benchmark --shm-ring)")
+        ->required();
+    app.add_option("--max-seconds,-t", max_seconds, "Run duration (0 = until the producer closes the ring)")
+        ->default_val(max_seconds);
+    app.add_option("--core", core, "Pin the reader to this CPU (-1 = unpinned)")
+        ->default_val(core);
+
+    CLI11_PARSE(app, argc, argv);
+
+    std::signal(SIGINT, signal_handler);
+    std::signal(SIGTERM, signal_handler);
+
+    try {
+        ShmRingReader reader(path);
+        pin_current_thread(core, "shm ring reader");
+        std::cout << "Attached to " << path << " (" << reader.capacity() << " records) at position "
+                  << reader.position() << std::endl;
+
+        // Receive timestamps come from the producer's TSC clock; both
+        // processes keep theirs anchored to CLOCK_MONOTONIC_RAW, so the
+        // difference is latency plus sub-microsecond anchoring error
+        LatencyHistogram latency;
+        std::array<MultiFeedSlot, 256> slots;
+        std::uint64_t received = 0;
+        std::uint64_t polls = 0;
+        Timer timer;
+        auto next_report = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+
+        while (!g_stop.load(std::memory_order_relaxed)) {
+            auto count = reader.poll(slots.data(), slots.size());
+            if (count > 0) {
+                auto now = get_timestamp_ns();
+                for (std::size_t i = 0; i < count; ++i) {
+                    latency.record(now > slots[i].rx_ts ? now - slots[i].rx_ts : 0);
+                }
+                received += count;
+            } else if (reader.finished()) {
+                break;
+            } else {
+                cpu_relax();
+            }
+
+            if ((++polls & 1023) == 0) {
+                auto now = std::chrono::steady_clock::now();
+                if (now >= next_report) {
+                    next_report = now + std::chrono::seconds(1);
+                    std::cout << "Received " << received << " | lost " << reader.lost() << " | laps "
+                              << reader.laps() << std::endl;
+                    if (max_seconds > 0 && timer.elapsed_seconds() >= max_seconds) {
+                        break;
+                    }
+                }
+            }
+        }
+
+        auto elapsed = timer.elapsed_seconds();
+        std::cout << "\n=== Shared-Memory Ring Reader ===" << std::endl;
+        std::cout << "Records received: " << received << " (" << (received / std::max(elapsed, 1e-9))
+                  << " rec/s)" << std::endl;
+        std::cout << "Records lost to laps: " << reader.lost() << " over " << reader.laps() << " laps" << std::endl;
+        if (latency.count() > 0) {
+            std::cout << "Receive-to-read latency (ns): p50 " << latency.value_at_percentile(0.50)
+                      << " | p99 " << latency.value_at_percentile(0.99)
+                      << " | p99.9 " << latency.value_at_percentile(0.999)
+                      << " | max " << latency.max() << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
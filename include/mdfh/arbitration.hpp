@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mdfh {
+
+// Sliding record of which sequence numbers of one stream were delivered.
+// One bit per sequence in a ring of SIZE bits, anchored at the highest
+// sequence seen, so duplicate checks and gap fills are O(1) and allocation-free.
+class SequenceWindow {
+public:
+    static constexpr std::uint64_t SIZE = 4096;     // Sequences tracked behind the high-water mark
+
+    enum class Result {
+        ADVANCED,   // New high-water mark
+        FILLED,     // Behind the high-water mark but never delivered (fills a gap)
+        DUPLICATE   // Already delivered, or too far behind to tell
+    };
+
+    Result accept(std::uint64_t seq) {
+        if (!started_) {
+            started_ = true;
+            next_ = seq;
+        }
+        if (seq >= next_) {
+            // Recycle the bits of the sequences the window slides over
+            clear_range(next_, seq + 1);
+            set(seq);
+            next_ = seq + 1;
+            return Result::ADVANCED;
+        }
+        if (next_ - seq > SIZE || test(seq)) {
+            return Result::DUPLICATE;
+        }
+        set(seq);
+        return Result::FILLED;
+    }
+
+    // One past the highest sequence accepted so far
+    std::uint64_t next_sequence() const { return next_; }
+
+private:
+    static constexpr std::uint64_t WORD_BITS = 64;
+
+    std::array<std::uint64_t, SIZE / WORD_BITS> bits_{};
+    std::uint64_t next_ = 0;
+    bool started_ = false;
+
+    bool test(std::uint64_t seq) const {
+        auto bit = seq & (SIZE - 1);
+        return (bits_[bit / WORD_BITS] >> (bit % WORD_BITS)) & 1;
+    }
+
+    void set(std::uint64_t seq) {
+        auto bit = seq & (SIZE - 1);
+        bits_[bit / WORD_BITS] |= std::uint64_t{1} << (bit % WORD_BITS);
+    }
+
+    // Clears [from, to) a word at a time
+    void clear_range(std::uint64_t from, std::uint64_t to);
+};
+
+// Per-line arbitration counters
+struct LineStats {
+    std::uint64_t wins = 0;          // Messages this line delivered first
+    std::uint64_t duplicates = 0;    // Messages dropped because another line was first
+    std::uint64_t gaps_filled = 0;   // Wins behind the group's high-water mark (another line skipped them)
+};
+
+// A/B line arbitration: feeds in the same group carry one sequence space
+// (Msg::seq); the first copy of each sequence from any line is delivered and
+// later copies are dropped. A gap on one line is filled as soon as another
+// line delivers the message, with no failover timeout.
+// accept() is for the single consumer thread; line_stats() may be read from any thread.
+class LineArbiter {
+public:
+    // Setup (before the first accept()); origin_id must be unique
+    void add_line(std::uint32_t origin_id, const std::string& group);
+
+    bool empty() const { return lines_.empty(); }
+
+    // Returns true if the message should be delivered. Messages from
+    // origins that were never added pass straight through.
+    bool accept(std::uint32_t origin_id, std::uint64_t seq) {
+        if (origin_id >= line_by_origin_.size() || line_by_origin_[origin_id] < 0) {
+            return true;
+        }
+        auto& line = *lines_[static_cast<std::size_t>(line_by_origin_[origin_id])];
+        switch (windows_[line.group].accept(seq)) {
+            case SequenceWindow::Result::ADVANCED:
+                bump(line.wins);
+                return true;
+            case SequenceWindow::Result::FILLED:
+                bump(line.wins);
+                bump(line.gaps_filled);
+                return true;
+            case SequenceWindow::Result::DUPLICATE:
+                break;
+        }
+        bump(line.duplicates);
+        return false;
+    }
+
+    // Counters of one line (all zero for unknown origins)
+    LineStats line_stats(std::uint32_t origin_id) const;
+
+    std::size_t group_count() const { return windows_.size(); }
+
+private:
+    struct Line {
+        std::uint32_t group = 0;
+        std::atomic<std::uint64_t> wins{0};
+        std::atomic<std::uint64_t> duplicates{0};
+        std::atomic<std::uint64_t> gaps_filled{0};
+    };
+
+    std::vector<std::unique_ptr<Line>> lines_;
+    std::vector<std::int32_t> line_by_origin_;      // origin_id -> index into lines_, -1 if not arbitrated
+    std::vector<SequenceWindow> windows_;           // one per group
+    std::vector<std::string> group_names_;
+
+    // Single writer, so a plain load/store keeps readers tear-free without an RMW
+    static void bump(std::atomic<std::uint64_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+};
+
+} // namespace mdfh
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "core.hpp"
+#include "ring_buffer.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace mdfh {
+
+// Instruction set used by the binary batch decoder
+enum class DecoderIsa {
+    SCALAR,     // Portable fallback
+    AVX2,       // 4 records per iteration
+    AVX512      // 8 records per iteration
+};
+
+// Best instruction set supported by the running CPU (detected once)
+DecoderIsa detect_decoder_isa();
+
+// True if the running CPU can execute the given instruction set
+bool is_decoder_isa_supported(DecoderIsa isa);
+
+// Result of decoding one buffer of wire messages
+struct DecodeResult {
+    std::size_t valid = 0;      // Records written to the output slots
+    std::size_t invalid = 0;    // Records rejected by Msg::is_valid
+};
+
+// Vectorized decoder for back-to-back 20-byte binary Msg records.
+// Decodes a whole read buffer straight into Slot storage, stamps every slot
+// with one receive timestamp per buffer, and validates Msg::is_valid across
+// SIMD lanes. Invalid records are skipped, valid ones are written compactly.
+class BinaryBatchDecoder {
+public:
+    using DecodeFn = DecodeResult (*)(const std::uint8_t* data, std::size_t count,
+                                      Slot* out, std::uint64_t rx_ts);
+
+    // Falls back to the best supported ISA if the requested one is unavailable
+    explicit BinaryBatchDecoder(DecoderIsa isa = detect_decoder_isa());
+
+    // Decodes count records from data into out (which must hold count slots)
+    DecodeResult decode(const std::uint8_t* data, std::size_t count, Slot* out, std::uint64_t rx_ts) const {
+        return decode_fn_(data, count, out, rx_ts);
+    }
+
+    DecoderIsa isa() const { return isa_; }
+
+private:
+    DecoderIsa isa_;
+    DecodeFn decode_fn_;
+};
+
+inline std::ostream& operator<<(std::ostream& os, DecoderIsa isa) {
+    switch (isa) {
+        case DecoderIsa::SCALAR: return os << "SCALAR";
+        case DecoderIsa::AVX2: return os << "AVX2";
+        case DecoderIsa::AVX512: return os << "AVX512";
+    }
+    return os << "UNKNOWN_ISA";
+}
+
+} // namespace mdfh
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "core.hpp"
+#include "wait_strategy.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace mdfh {
+
+// Where a scenario's producers get their bytes from
+enum class BenchmarkBackend {
+    MEMORY,         // Decode pre-encoded packets from memory: isolates decode, ring and consumer
+    BOOST_ASIO,     // Loopback UDP multicast through BoostAsioBypassClient
+    IO_URING        // Loopback UDP multicast through IoUringBypassClient
+};
+
+std::ostream& operator<<(std::ostream& os, BenchmarkBackend backend);
+
+// Parses "memory", "asio" or "io_uring" (case-insensitive); throws std::invalid_argument
+BenchmarkBackend parse_benchmark_backend(const std::string& name);
+
+// One point of the matrix
+struct BenchmarkScenario {
+    std::uint64_t capacity = 65536;          // Slots per producer lane (power of 2)
+    std::uint32_t batch_size = 32;           // Messages per packet and per consumer drain
+    std::uint32_t producers = 1;             // Producer lanes, each with its own SPSC ring
+    EncodingType encoding = EncodingType::BINARY;
+    BenchmarkBackend backend = BenchmarkBackend::MEMORY;
+    WaitStrategyType wait = WaitStrategyType::BUSY_SPIN;
+
+    // Stable key used to match results against a baseline, e.g.
+    // "capacity=65536/batch=32/producers=1/encoding=BINARY/backend=MEMORY/wait=BUSY_SPIN"
+    std::string id() const;
+};
+
+// Values to sweep per dimension; the matrix is their cross product
+struct BenchmarkMatrix {
+    std::vector<std::uint64_t> capacities = {65536};
+    std::vector<std::uint32_t> batch_sizes = {32};
+    std::vector<std::uint32_t> producers = {1};
+    std::vector<EncodingType> encodings = {EncodingType::BINARY};
+    std::vector<BenchmarkBackend> backends = {BenchmarkBackend::MEMORY};
+    std::vector<WaitStrategyType> waits = {WaitStrategyType::BUSY_SPIN};
+
+    std::vector<BenchmarkScenario> expand() const;
+    bool is_valid() const;
+};
+
+// Settings shared by every run of every scenario
+struct BenchmarkRunConfig {
+    std::uint64_t messages = 1'000'000;          // Per producer per run, including warm-up
+    std::uint64_t warmup_messages = 100'000;     // Per producer: first messages of a run, not measured
+    std::uint32_t repeats = 5;                   // Measured runs per scenario
+    std::uint64_t rate = 0;                      // Messages/s per producer (0 = as fast as possible)
+    std::uint32_t max_seconds = 30;              // Per-run limit; a run that hits it counts the rest as dropped
+    std::uint32_t drain_ms = 50;                 // Network backends: quiet period that ends a run
+    std::vector<int> cores;                      // Consumer, then producers, then senders (empty = unpinned)
+    std::string multicast_group = "239.255.77.1";
+    std::uint16_t base_port = 47000;             // Producer p listens on base_port + p
+
+    bool is_valid() const;
+};
+
+// A matrix file: "matrix:" lists per dimension, "run:" settings
+struct BenchmarkPlan {
+    BenchmarkMatrix matrix;
+    BenchmarkRunConfig run;
+
+    static BenchmarkPlan from_yaml(const std::string& filename);   // throws std::runtime_error
+};
+
+// One measured run
+struct BenchmarkRun {
+    std::uint64_t sent = 0;                  // Messages offered by all producers
+    std::uint64_t consumed = 0;              // Messages that reached the consumer
+    double throughput = 0.0;                 // Consumed msgs/s after warm-up
+    double drop_rate = 0.0;                  // 1 - consumed / sent
+    std::uint64_t p50_ns = 0;                // Decode-to-consume latency percentiles
+    std::uint64_t p99_ns = 0;
+    std::uint64_t p999_ns = 0;
+    std::uint64_t p9999_ns = 0;
+    std::uint64_t max_ns = 0;
+    std::string placement;                   // CPUs each thread ran on (sched_getaffinity), e.g. "consumer=2 io0=3 sender0=4"
+};
+
+// Mean of a metric across runs with its 95% confidence interval (Student's t)
+struct BenchmarkSummary {
+    double mean = 0.0;
+    double stddev = 0.0;
+    double ci95 = 0.0;                       // Half-width; 0 with a single run
+
+    double low() const { return mean - ci95; }
+    double high() const { return mean + ci95; }
+
+    static BenchmarkSummary of(const std::vector<double>& samples);
+};
+
+// All runs of one scenario; a scenario that cannot run on this host is
+// kept with the reason so the report still covers the whole matrix
+struct ScenarioResult {
+    BenchmarkScenario scenario;
+    std::string id;
+    std::string skipped;                     // Empty if the scenario ran
+    std::vector<BenchmarkRun> runs;          // Empty when loaded from a baseline
+
+    BenchmarkSummary throughput;
+    BenchmarkSummary drop_rate;
+    BenchmarkSummary p50;
+    BenchmarkSummary p99;
+    BenchmarkSummary p999;
+    BenchmarkSummary p9999;
+    BenchmarkSummary max;
+
+    void summarize();                        // Fills the summaries from runs
+};
+
+// Runs a scenario once; throws std::runtime_error if it cannot run here,
+// including when a thread given a core in run.cores did not end up on it
+BenchmarkRun run_benchmark_scenario(const BenchmarkScenario& scenario, const BenchmarkRunConfig& run);
+
+// One discarded warm-up run, then run.repeats measured runs
+ScenarioResult run_benchmark_repeats(const BenchmarkScenario& scenario, const BenchmarkRunConfig& run);
+
+// Machine-readable reports. The JSON report is also the baseline format.
+void write_benchmark_json(std::ostream& os, const std::vector<ScenarioResult>& results, const BenchmarkRunConfig& run);
+void write_benchmark_csv(std::ostream& os, const std::vector<ScenarioResult>& results);
+
+// Reads a JSON report written by write_benchmark_json; throws std::runtime_error
+std::vector<ScenarioResult> load_benchmark_baseline(const std::string& filename);
+
+// A metric that got worse than the baseline by more than the tolerance
+// with non-overlapping confidence intervals
+struct BenchmarkRegression {
+    std::string id;
+    std::string metric;
+    double baseline = 0.0;
+    double current = 0.0;
+    double change = 0.0;                     // Relative change, positive = worse (drop_rate: absolute)
+};
+
+// Compares throughput (lower is worse), drop rate and p50/p99/p99.9 latency
+// (higher is worse) of scenarios present in both; tolerance is relative
+std::vector<BenchmarkRegression> compare_to_baseline(const std::vector<ScenarioResult>& current,
+                                                     const std::vector<ScenarioResult>& baseline,
+                                                     double tolerance);
+
+} // namespace mdfh
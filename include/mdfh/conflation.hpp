@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mdfh {
+
+struct MultiFeedSlot;
+
+// What a conflated value is the latest of
+enum class ConflationKey {
+    ORIGIN,         // Last message per feed
+    PRICE_LEVEL     // Last message per feed, side and price level: a conflated book
+};
+
+std::ostream& operator<<(std::ostream& os, ConflationKey key);
+
+// Parses "origin" or "price_level" (case-insensitive); throws std::invalid_argument
+ConflationKey parse_conflation_key(const std::string& name);
+
+// Conflation stage configuration
+struct ConflationConfig {
+    std::uint32_t max_keys = 0;              // Distinct keys per consumer shard (0 = conflation off)
+    ConflationKey key = ConflationKey::PRICE_LEVEL;
+    double tick_size = 0.01;                 // PRICE_LEVEL: width of one price level
+    std::uint32_t poll_interval_ms = 100;    // Period of the conflated reader
+
+    bool enabled() const { return max_keys > 0; }
+    bool is_valid() const;
+};
+
+// Last-value cache between one full-stream writer and one slow reader.
+// An open-addressing (linear probing) table of cache-line entries keeps the
+// newest message per key; the writer marks updated keys in a dirty bitmap
+// and the reader collects only those, so a reader that falls behind sees
+// the latest state per key instead of a backlog and memory stays bounded
+// by max_keys. Values are published under a per-entry seqlock: the writer
+// never waits, the reader retries a torn copy. Keys are never evicted;
+// messages for a new key once max_keys are in use are counted as overflows.
+class LastValueCache {
+public:
+    explicit LastValueCache(const ConflationConfig& config);  // throws std::invalid_argument
+
+    LastValueCache(const LastValueCache&) = delete;
+    LastValueCache& operator=(const LastValueCache&) = delete;
+
+    // Writer thread: stores each slot as its key's latest value; returns the number stored
+    std::uint64_t update(const MultiFeedSlot* slots, std::uint64_t count);
+
+    // Reader thread: copies the latest value of up to max_count updated keys
+    // and clears their dirty bits; resumes where the previous call stopped
+    std::uint64_t collect(MultiFeedSlot* out, std::uint64_t max_count);
+
+    std::uint64_t key_of(const MultiFeedSlot& slot) const;
+
+    // Statistics (any thread)
+    std::uint64_t updates() const { return updates_.load(std::memory_order_relaxed); }
+    std::uint64_t delivered() const { return delivered_.load(std::memory_order_relaxed); }
+    std::uint64_t overflows() const { return overflows_.load(std::memory_order_relaxed); }
+    std::uint64_t keys() const { return keys_.load(std::memory_order_relaxed); }
+    std::size_t table_size() const { return table_size_; }
+
+private:
+    static constexpr std::uint64_t EMPTY_KEY = UINT64_MAX;
+
+    // One cache line; the value is a MultiFeedSlot stored as words so the
+    // reader's racy copy is made of atomic loads
+    struct alignas(64) Entry {
+        std::atomic<std::uint64_t> version{0};                  // Odd while the writer updates value
+        std::array<std::atomic<std::uint64_t>, 4> value{};
+        std::uint64_t key = EMPTY_KEY;                          // Writer only
+    };
+    static_assert(sizeof(Entry) == 64, "LastValueCache entry must occupy a single cache line");
+
+    // Table index of key, inserting it if there is room; table_size_ if not
+    std::size_t find_or_insert(std::uint64_t key);
+
+    ConflationConfig config_;
+    std::size_t table_size_;                                    // Power of two, at least 2 * max_keys
+    std::unique_ptr<Entry[]> entries_;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> dirty_;      // One bit per entry
+    std::size_t dirty_words_;
+
+    // Writer-owned
+    std::uint64_t key_count_ = 0;
+    std::vector<std::uint64_t> pending_dirty_;                  // Bits set this update(), per word
+    std::vector<std::size_t> touched_words_;
+
+    // Reader-owned
+    std::size_t scan_word_ = 0;
+
+    alignas(64) std::atomic<std::uint64_t> updates_{0};
+    std::atomic<std::uint64_t> overflows_{0};
+    std::atomic<std::uint64_t> keys_{0};
+    alignas(64) std::atomic<std::uint64_t> delivered_{0};
+};
+
+} // namespace mdfh
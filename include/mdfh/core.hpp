@@ -1,5 +1,7 @@
 #pragma once
 
+#include "logger.hpp"
+#include <cctype>
 #include <cstdint>
 #include <ostream>
 #include <stdexcept>
@@ -11,84 +13,6 @@
 
 namespace mdfh {
 
-/**
- * @brief Logging levels for the MDFH system
- */
-enum class LogLevel {
-    DEBUG = 0,
-    INFO = 1,
-    WARN = 2,
-    ERROR = 3,
-    FATAL = 4
-};
-
-/**
- * @brief Simple thread-safe logger for MDFH
- * 
- * Provides structured logging with timestamps and log levels.
- * Thread-safe for concurrent use across multiple threads.
- */
-class Logger {
-private:
-    static LogLevel current_level_;
-    static std::ostream* output_stream_;
-    
-public:
-    /**
-     * @brief Sets the global log level
-     * @param level Minimum log level to output
-     */
-    static void set_log_level(LogLevel level) { current_level_ = level; }
-    
-    /**
-     * @brief Sets the output stream for logging
-     * @param stream Output stream (default: std::cerr)
-     */
-    static void set_output_stream(std::ostream& stream) { output_stream_ = &stream; }
-    
-    /**
-     * @brief Logs a message at the specified level
-     * @param level Log level
-     * @param component Component name (e.g., "RingBuffer", "KernelBypass")
-     * @param message Log message
-     */
-    static void log(LogLevel level, const std::string& component, const std::string& message);
-    
-    /**
-     * @brief Convenience methods for different log levels
-     */
-    static void debug(const std::string& component, const std::string& message) {
-        log(LogLevel::DEBUG, component, message);
-    }
-    
-    static void info(const std::string& component, const std::string& message) {
-        log(LogLevel::INFO, component, message);
-    }
-    
-    static void warn(const std::string& component, const std::string& message) {
-        log(LogLevel::WARN, component, message);
-    }
-    
-    static void error(const std::string& component, const std::string& message) {
-        log(LogLevel::ERROR, component, message);
-    }
-    
-    static void fatal(const std::string& component, const std::string& message) {
-        log(LogLevel::FATAL, component, message);
-    }
-
-private:
-    static std::string get_timestamp();
-    static std::string level_to_string(LogLevel level);
-};
-
-// Convenience macros for logging
-#define MDFH_LOG_DEBUG(component, message) mdfh::Logger::debug(component, message)
-#define MDFH_LOG_INFO(component, message) mdfh::Logger::info(component, message)
-#define MDFH_LOG_WARN(component, message) mdfh::Logger::warn(component, message)
-#define MDFH_LOG_ERROR(component, message) mdfh::Logger::error(component, message)
-#define MDFH_LOG_FATAL(component, message) mdfh::Logger::fatal(component, message)
-
 /**
  * @brief Core message structure - the fundamental unit of market data
  * 
@@ -210,6 +134,22 @@ inline bool is_valid_transport(TransportType transport) {
     return transport == TransportType::TCP || transport == TransportType::UDP_MULTICAST;
 }
 
+/**
+ * @brief Parses a transport name ("tcp", "udp", "udp_multicast" or "multicast", case-insensitive)
+ * @param name The transport name
+ * @return The matching transport type
+ * @throws std::invalid_argument if the name is not recognized
+ */
+inline TransportType parse_transport_type(const std::string& name) {
+    std::string lower;
+    for (char c : name) {
+        lower += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    if (lower == "tcp") return TransportType::TCP;
+    if (lower == "udp_multicast" || lower == "multicast" || lower == "udp") return TransportType::UDP_MULTICAST;
+    throw std::invalid_argument("Unknown transport type: " + name);
+}
+
 /**
  * @brief Validates an encoding type
  * @param encoding The encoding type to validate
@@ -257,17 +197,6 @@ inline std::ostream& operator<<(std::ostream& os, EncodingType encoding) {
     return os << "UNKNOWN_ENCODING";
 }
 
-inline std::ostream& operator<<(std::ostream& os, LogLevel level) {
-    switch (level) {
-        case LogLevel::DEBUG: return os << "DEBUG";
-        case LogLevel::INFO: return os << "INFO";
-        case LogLevel::WARN: return os << "WARN";
-        case LogLevel::ERROR: return os << "ERROR";
-        case LogLevel::FATAL: return os << "FATAL";
-    }
-    return os << "UNKNOWN_LEVEL";
-}
-
 inline std::ostream& operator<<(std::ostream& os, const Msg& msg) {
     return os << "Msg{seq=" << msg.seq << ", px=" << msg.px 
               << ", qty=" << msg.qty << ", side=" << msg.side() << "}";
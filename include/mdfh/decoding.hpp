@@ -0,0 +1,117 @@
+#pragma once
+
+#include "core.hpp"
+#include "encoding.hpp"
+#include "ring_buffer.hpp"
+#include "batch_decoder.hpp"
+#include <array>
+#include <memory>
+
+namespace mdfh {
+
+// Per-call outcome of decoding a chunk of the byte stream
+struct DecodeCounts {
+    std::size_t decoded = 0;    // Messages published to the ring
+    std::size_t dropped = 0;    // Complete messages lost because the ring was full
+    std::size_t malformed = 0;  // Frames/records rejected by validation or framing
+};
+
+// Message decoder interface - mirrors MessageEncoder on the ingestion side.
+// Decoders are incremental: bytes of a trailing incomplete message are kept
+// in a fixed internal buffer and completed by the next call (no allocation).
+// Concrete decoders are final: called through their own type (as Pipeline
+// does) they bind statically and can inline.
+class MessageDecoder {
+public:
+    virtual ~MessageDecoder() = default;
+
+    // Decode one chunk of the stream straight into ring slots stamped with rx_ts
+    virtual DecodeCounts decode(const std::uint8_t* data, std::size_t size, std::uint64_t rx_ts, RingBuffer& ring) = 0;
+
+    // Discard any buffered partial message (e.g. after a reconnect)
+    virtual void reset() = 0;
+};
+
+// Binary decoder - back-to-back 20-byte Msg records, SIMD batch decode
+class BinaryDecoder final : public MessageDecoder {
+private:
+    BinaryBatchDecoder batch_decoder_;
+    std::array<std::uint8_t, sizeof(Msg)> partial_buffer_{};
+    std::size_t partial_size_{0};
+
+public:
+    explicit BinaryDecoder(DecoderIsa isa = detect_decoder_isa()) : batch_decoder_(isa) {}
+    DecodeCounts decode(const std::uint8_t* data, std::size_t size, std::uint64_t rx_ts, RingBuffer& ring) override;
+    void reset() override { partial_size_ = 0; }
+
+private:
+    void decode_records(const std::uint8_t* data, std::size_t count, std::uint64_t rx_ts,
+                        RingBuffer& ring, DecodeCounts& counts);
+};
+
+// ITCH payload parser - fixed 26-byte quote, validated with one branch
+struct ITCHPayloadParser {
+    static constexpr std::uint16_t ENCODING_ID = SOFH_ENCODING_ITCH;
+    static constexpr std::size_t MIN_FRAME_SIZE = sizeof(SOFH) + sizeof(ITCHMsg);
+
+    bool parse(const std::uint8_t* payload, std::size_t length, Msg& out) const;
+};
+
+// FIX payload parser - tag=value fields located with a SIMD SOH scan
+struct FIXPayloadParser {
+    static constexpr std::uint16_t ENCODING_ID = SOFH_ENCODING_FIX;
+    static constexpr std::size_t MIN_FRAME_SIZE = sizeof(SOFH) + 32;
+
+    bool verify_checksum = true;    // Check tag 10 against the byte sum
+
+    bool parse(const std::uint8_t* payload, std::size_t length, Msg& out) const;
+};
+
+// SOFH-framed stream decoder, parameterized on the payload parser so the
+// per-frame parse is inlined (no virtual call per message).
+// A header with an impossible length or a foreign encoding type means the
+// stream lost sync; the decoder then scans forward a byte at a time until a
+// plausible header appears and counts one malformed frame per episode.
+template<typename PayloadParser>
+class SOFHFramedDecoder final : public MessageDecoder {
+public:
+    // Largest frame accepted (and buffered across reads)
+    static constexpr std::size_t MAX_FRAME_SIZE = 1024;
+
+    explicit SOFHFramedDecoder(PayloadParser parser = {}) : parser_(parser) {}
+    DecodeCounts decode(const std::uint8_t* data, std::size_t size, std::uint64_t rx_ts, RingBuffer& ring) override;
+    void reset() override { partial_size_ = 0; resyncing_ = false; }
+
+private:
+    // Ring span claimed for the current decode call
+    struct SlotCursor {
+        std::span<Slot> slots;
+        std::size_t used = 0;
+    };
+
+    // Decodes one complete frame into the next free slot
+    void emit_frame(const std::uint8_t* frame, std::size_t length, std::size_t frames_hint,
+                    std::uint64_t rx_ts, RingBuffer& ring, SlotCursor& cursor, DecodeCounts& counts);
+
+    // Returns the frame length if data holds a plausible SOFH header, else 0
+    static std::size_t frame_length(const std::uint8_t* data);
+
+    PayloadParser parser_;
+    std::array<std::uint8_t, MAX_FRAME_SIZE> partial_buffer_{};
+    std::size_t partial_size_{0};
+    bool resyncing_{false};
+};
+
+extern template class SOFHFramedDecoder<ITCHPayloadParser>;
+extern template class SOFHFramedDecoder<FIXPayloadParser>;
+
+// ITCH decoder - Information Technology Communication Hub protocol
+using ITCHDecoder = SOFHFramedDecoder<ITCHPayloadParser>;
+
+// FIX decoder - Financial Information eXchange protocol
+using FIXDecoder = SOFHFramedDecoder<FIXPayloadParser>;
+
+// Factory function to create the decoder matching an encoder
+std::unique_ptr<MessageDecoder> create_decoder(EncodingType type);
+
+} // namespace mdfh
@@ -4,6 +4,8 @@
 #include <vector>
 #include <cstring>
 #include <string>
+#include <memory>
+#include <span>
 
 // Platform-specific endianness handling
 #include <arpa/inet.h>  // For htonl, htons, etc.
@@ -12,6 +14,9 @@
 #define htobe16(x) OSSwapHostToBigInt16(x)
 #define htobe32(x) OSSwapHostToBigInt32(x)
 #define htobe64(x) OSSwapHostToBigInt64(x)
+#define be16toh(x) OSSwapBigToHostInt16(x)
+#define be32toh(x) OSSwapBigToHostInt32(x)
+#define be64toh(x) OSSwapBigToHostInt64(x)
 #elif defined(__linux__)
 #include <endian.h>
 #elif defined(_WIN32)
@@ -19,6 +24,9 @@
 #define htobe16(x) htons(x)
 #define htobe32(x) htonl(x)
 #define htobe64(x) (((uint64_t)htonl((x) & 0xFFFFFFFF) << 32) | htonl((x) >> 32))
+#define be16toh(x) ntohs(x)
+#define be32toh(x) ntohl(x)
+#define be64toh(x) htobe64(x)
 #endif
 
 namespace mdfh {
@@ -32,6 +40,10 @@ struct SOFH {
 #pragma pack(pop)
 static_assert(sizeof(SOFH) == 6, "SOFH must be exactly 6 bytes");
 
+// SOFH encoding_type values written by the encoders
+constexpr std::uint16_t SOFH_ENCODING_FIX = 0x5000;
+constexpr std::uint16_t SOFH_ENCODING_ITCH = 0x4954;   // 'IT'
+
 // ITCH message format
 #pragma pack(push, 1)
 struct ITCHMsg {
@@ -55,39 +67,64 @@ struct EncodingConfig {
 class MessageEncoder {
 public:
     virtual ~MessageEncoder() = default;
-    virtual std::vector<std::uint8_t> encode(const std::vector<Msg>& msgs) = 0;
-    virtual void encode_inplace(const std::vector<Msg>& msgs, std::vector<std::uint8_t>& buffer) = 0;
+    
+    // Upper bound on the encoded size of count messages
+    virtual std::size_t max_encoded_size(std::size_t count) const = 0;
+    
+    // Encode into a caller-owned buffer without allocating; returns bytes written.
+    // If message_ends is non-empty, message_ends[i] receives the end offset of
+    // message i (it must then hold msgs.size() entries).
+    // Throws std::length_error if out is smaller than max_encoded_size(msgs.size()).
+    virtual std::size_t encode_into(std::span<const Msg> msgs, std::span<std::uint8_t> out,
+                                    std::span<std::size_t> message_ends) = 0;
+    
+    std::size_t encode_into(std::span<const Msg> msgs, std::span<std::uint8_t> out) {
+        return encode_into(msgs, out, {});
+    }
+    
+    // Convenience wrappers over encode_into
+    std::vector<std::uint8_t> encode(const std::vector<Msg>& msgs);
+    void encode_inplace(const std::vector<Msg>& msgs, std::vector<std::uint8_t>& buffer);
 };
 
 // Binary encoder - fastest, direct memory copy
-class BinaryEncoder : public MessageEncoder {
+class BinaryEncoder final : public MessageEncoder {
 public:
-    std::vector<std::uint8_t> encode(const std::vector<Msg>& msgs) override;
-    void encode_inplace(const std::vector<Msg>& msgs, std::vector<std::uint8_t>& buffer) override;
+    std::size_t max_encoded_size(std::size_t count) const override { return count * sizeof(Msg); }
+    using MessageEncoder::encode_into;
+    std::size_t encode_into(std::span<const Msg> msgs, std::span<std::uint8_t> out,
+                            std::span<std::size_t> message_ends) override;
 };
 
 // FIX encoder - Financial Information eXchange protocol
-class FIXEncoder : public MessageEncoder {
+class FIXEncoder final : public MessageEncoder {
 private:
     EncodingConfig config_;
     
 public:
-    explicit FIXEncoder(EncodingConfig config = {}) : config_(std::move(config)) {}
-    std::vector<std::uint8_t> encode(const std::vector<Msg>& msgs) override;
-    void encode_inplace(const std::vector<Msg>& msgs, std::vector<std::uint8_t>& buffer) override;
+    // Worst-case FIX message excluding the comp IDs (20-digit seq/qty, wide prices)
+    static constexpr std::size_t MAX_FIXED_MESSAGE_SIZE = 224;
     
-private:
-    std::uint8_t calculate_checksum(const std::string& msg) const;
+    explicit FIXEncoder(EncodingConfig config = {}) : config_(std::move(config)) {}
+    std::size_t max_encoded_size(std::size_t count) const override;
+    using MessageEncoder::encode_into;
+    std::size_t encode_into(std::span<const Msg> msgs, std::span<std::uint8_t> out,
+                            std::span<std::size_t> message_ends) override;
 };
 
 // ITCH encoder - Information Technology Communication Hub protocol
-class ITCHEncoder : public MessageEncoder {
+class ITCHEncoder final : public MessageEncoder {
 public:
-    std::vector<std::uint8_t> encode(const std::vector<Msg>& msgs) override;
-    void encode_inplace(const std::vector<Msg>& msgs, std::vector<std::uint8_t>& buffer) override;
+    std::size_t max_encoded_size(std::size_t count) const override { return count * (sizeof(SOFH) + sizeof(ITCHMsg)); }
+    using MessageEncoder::encode_into;
+    std::size_t encode_into(std::span<const Msg> msgs, std::span<std::uint8_t> out,
+                            std::span<std::size_t> message_ends) override;
 };
 
 // Factory function to create appropriate encoder
 std::unique_ptr<MessageEncoder> create_encoder(EncodingType type, const EncodingConfig& config = {});
 
+// Parses "binary", "fix" or "itch" (case-insensitive) from config files and CLI options
+EncodingType parse_encoding_type(const std::string& name);
+
 } // namespace mdfh 
\ No newline at end of file
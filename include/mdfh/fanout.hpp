@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/asio.hpp>
+
+namespace mdfh {
+
+// What happens to a client whose send queue is full when a batch arrives
+enum class SlowConsumerPolicy {
+    DROP,           // Skip the new batch for that client
+    CONFLATE,       // Replace its queued batches (those not being written) with the new one
+    DISCONNECT      // Close the client
+};
+
+std::ostream& operator<<(std::ostream& os, SlowConsumerPolicy policy);
+
+// Parses "drop", "conflate" or "disconnect" (case-insensitive); throws std::invalid_argument
+SlowConsumerPolicy parse_slow_consumer_policy(const std::string& name);
+
+// One encoded batch, shared by every client queue it waits in
+using SharedBatch = std::shared_ptr<const std::vector<std::uint8_t>>;
+
+// Fan-out configuration
+struct FanoutConfig {
+    std::size_t max_queued_batches = 256;   // Per-client send queue bound
+    std::size_t max_gather = 64;            // Batches per gathered write (IOV_MAX-friendly)
+    std::size_t max_pending_batches = 1024; // Published but not yet queued to clients; more are shed
+    std::uint32_t close_timeout_ms = 2000;  // close(): time clients get to drain before they are cut
+    SlowConsumerPolicy policy = SlowConsumerPolicy::DROP;
+
+    bool is_valid() const { return max_queued_batches > 0 && max_gather > 0 && max_pending_batches > 0; }
+};
+
+// One TCP feed: accepts subscribers on a port and streams every published
+// batch to each of them. Runs on the io_context's thread: each client has
+// its own bounded queue of shared batches and one async gathered write in
+// flight, so a client that stops reading only fills its own queue and the
+// slow-consumer policy decides what it loses. Batches are only ever dropped
+// whole, so clients never see a torn message. If the io_context thread
+// itself falls behind, publish() sheds batches beyond max_pending_batches
+// instead of letting posted handlers pile up. Destroy the feed only once
+// its io_context has stopped running.
+class FanoutFeed {
+public:
+    // Binds immediately (SO_REUSEADDR); throws boost::system::system_error
+    FanoutFeed(boost::asio::io_context& ctx, const boost::asio::ip::tcp::endpoint& endpoint,
+               FanoutConfig config);
+    ~FanoutFeed();
+
+    FanoutFeed(const FanoutFeed&) = delete;
+    FanoutFeed& operator=(const FanoutFeed&) = delete;
+
+    // Starts accepting clients
+    void start();
+
+    // Queues batch for every connected client; safe from any thread.
+    // Returns false if it was shed because max_pending_batches are still
+    // waiting for the io_context thread.
+    bool publish(SharedBatch batch);
+
+    // Stops accepting; each client is closed once its queue has drained, or
+    // after close_timeout_ms if it has not (a client that stopped reading
+    // never drains). Safe from any thread.
+    void close();
+
+    boost::asio::ip::tcp::endpoint local_endpoint() const { return endpoint_; }
+
+    // Statistics (any thread)
+    std::size_t clients() const { return clients_.load(std::memory_order_relaxed); }
+    std::uint64_t clients_accepted() const { return accepted_.load(std::memory_order_relaxed); }
+    std::uint64_t batches_published() const { return published_.load(std::memory_order_relaxed); }
+    std::uint64_t batches_dropped() const { return dropped_.load(std::memory_order_relaxed); }     // Summed over clients
+    std::uint64_t batches_shed() const { return shed_.load(std::memory_order_relaxed); }          // Never reached a client queue
+    std::uint64_t slow_disconnects() const { return slow_disconnects_.load(std::memory_order_relaxed); }
+    std::uint64_t bytes_sent() const { return bytes_sent_.load(std::memory_order_relaxed); }
+
+private:
+    struct Session;
+
+    void accept();
+    void deliver(const SharedBatch& batch);
+    void write(const std::shared_ptr<Session>& session);
+    void on_written(const std::shared_ptr<Session>& session, const boost::system::error_code& ec,
+                    std::size_t bytes);
+    void remove(const std::shared_ptr<Session>& session);
+    void cut_remaining();
+
+    boost::asio::io_context& ctx_;
+    boost::asio::ip::tcp::acceptor acceptor_;
+    boost::asio::ip::tcp::endpoint endpoint_;
+    FanoutConfig config_;
+    std::vector<std::shared_ptr<Session>> sessions_;    // io_context thread only
+    bool closing_ = false;                              // io_context thread only
+    boost::asio::steady_timer close_timer_;
+
+    std::atomic<std::size_t> pending_{0};               // Posted deliver() handlers not yet run
+
+    std::atomic<std::size_t> clients_{0};
+    std::atomic<std::uint64_t> accepted_{0};
+    std::atomic<std::uint64_t> published_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::atomic<std::uint64_t> shed_{0};
+    std::atomic<std::uint64_t> slow_disconnects_{0};
+    std::atomic<std::uint64_t> bytes_sent_{0};
+};
+
+} // namespace mdfh
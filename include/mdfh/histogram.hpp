@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace mdfh {
+
+// Log-linear latency histogram in the style of HdrHistogram. Values below
+// SUB_BUCKET_COUNT ns are counted exactly; above that every power of two is
+// split into SUB_BUCKET_HALF buckets, so a bucket is never wider than 1/128
+// (0.8%) of the values in it. The range covers 2^MAX_VALUE_BITS ns (about
+// 9.8 hours); anything longer lands in the top bucket.
+//
+// Counts are atomics, so reporters query and merge while writers record.
+// record() is the single-writer path (a relaxed load and store, no locked
+// instruction): give each recording thread its own histogram and merge()
+// them for reporting. record_shared() is for histograms several threads
+// write. Percentile queries walk the buckets once: O(BUCKET_COUNT), no sort.
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 8;
+    static constexpr unsigned MAX_VALUE_BITS = 45;
+    static constexpr std::uint64_t SUB_BUCKET_COUNT = 1ULL << SUB_BUCKET_BITS;
+    static constexpr std::uint64_t SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;
+    static constexpr std::uint64_t MAX_VALUE = (1ULL << MAX_VALUE_BITS) - 1;
+    static constexpr std::size_t BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 2) * SUB_BUCKET_HALF;
+
+    // Single writer thread
+    void record(std::uint64_t value_ns, std::uint64_t count = 1) {
+        bump(counts_[bucket_index(value_ns)], count);
+        bump(count_, count);
+        bump(sum_, value_ns * count);
+        if (value_ns < min_.load(std::memory_order_relaxed)) {
+            min_.store(value_ns, std::memory_order_relaxed);
+        }
+        if (value_ns > max_.load(std::memory_order_relaxed)) {
+            max_.store(value_ns, std::memory_order_relaxed);
+        }
+    }
+
+    // Any number of writer threads
+    void record_shared(std::uint64_t value_ns, std::uint64_t count = 1);
+
+    // Adds other's counts to this histogram; lock-free, safe while both are recorded to
+    void merge(const LatencyHistogram& other);
+
+    // Clears all counts; not atomic as a whole, so call it while nothing records
+    void reset();
+
+    // Queries
+    std::uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    std::uint64_t min() const;                  // 0 if empty
+    std::uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+    std::uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+    double mean() const;
+
+    // Smallest recorded value with at least percentile (0..1) of the samples
+    // at or below it, reported as the top of its bucket (0 if empty)
+    std::uint64_t value_at_percentile(double percentile) const;
+
+    // Bucket layout
+    static std::size_t bucket_index(std::uint64_t value) {
+        if (value < SUB_BUCKET_COUNT) {
+            return static_cast<std::size_t>(value);
+        }
+        if (value > MAX_VALUE) {
+            value = MAX_VALUE;
+        }
+        auto shift = static_cast<unsigned>(std::bit_width(value)) - SUB_BUCKET_BITS;
+        return static_cast<std::size_t>((shift + 1) * SUB_BUCKET_HALF + (value >> shift) - SUB_BUCKET_HALF);
+    }
+    static std::uint64_t bucket_lowest(std::size_t index);
+    static std::uint64_t bucket_highest(std::size_t index);
+
+private:
+    std::array<std::atomic<std::uint64_t>, BUCKET_COUNT> counts_{};
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<std::uint64_t> min_{UINT64_MAX};
+    std::atomic<std::uint64_t> max_{0};
+
+    static void bump(std::atomic<std::uint64_t>& counter, std::uint64_t n) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+};
+
+} // namespace mdfh
@@ -2,8 +2,13 @@
 
 #include "core.hpp"
 #include "ring_buffer.hpp"
+#include "decoding.hpp"
+#include "histogram.hpp"
+#include "metrics.hpp"
 #include "timing.hpp"
+#include "wait_strategy.hpp"
 #include <boost/asio.hpp>
+#include <functional>
 #include <string>
 #include <atomic>
 #include <array>
@@ -12,6 +17,8 @@
 
 namespace mdfh {
 
+class ThreadCounters;
+
 // Configuration for the benchmark ingestion client
 struct IngestionConfig {
     // Network settings
@@ -20,6 +27,9 @@ struct IngestionConfig {
     
     // Performance settings
     std::uint32_t buffer_capacity = 65536;  // Ring buffer capacity (power of 2)
+    EncodingType encoding = EncodingType::BINARY;  // Wire format sent by the server
+    WaitConfig consumer_wait;               // Idle policy of the consumer loop
+    MetricsConfig metrics;                  // Scrape/push endpoints of the metrics exporter
     
     // Exit criteria
     std::uint32_t max_seconds = 0;          // Run duration (0 = infinite)
@@ -41,16 +51,15 @@ private:
     // Sequence tracking
     std::atomic<bool> first_message_seen_{false};
     std::uint64_t expected_seq_{0};
-    std::uint64_t gap_count_{0};
+    std::atomic<std::uint64_t> gap_count_{0};
     
     // Timing
     Timer timer_;
-    std::chrono::steady_clock::time_point last_flush_;
     
-    // Latency histogram (microseconds)
-    std::array<std::uint64_t, 1001> latency_buckets_{};  // 0-999µs + overflow
+    // Receive-to-process latency (ns), written by the consumer thread
+    LatencyHistogram latency_;
     
-    // For rate calculation - track deltas
+    // For rate calculation - track deltas (reporter thread only)
     std::uint64_t last_messages_received_{0};
     std::uint64_t last_messages_processed_{0};
     std::uint64_t last_bytes_received_{0};
@@ -66,42 +75,58 @@ public:
     virtual void record_message_processed(const Slot& slot);
     virtual void record_message_dropped();
     
-    // Periodic reporting
-    virtual void check_periodic_flush();
+    // Batched variants used by the parser (one atomic update per read buffer)
+    virtual void record_messages_received(std::uint64_t count);
+    virtual void record_messages_dropped(std::uint64_t count);
+    
+    // Periodic reporting; runs as a MetricsExporter reporter, never on the data path
+    virtual void print_periodic_stats();
     virtual void print_final_stats();
     
+    // Exports the counters and latency histogram (this object must outlive the registry's readers)
+    void register_metrics(MetricsRegistry& registry, const MetricsRegistry::Labels& labels = {}) const;
+    
     // Getters
     std::uint64_t messages_received() const { return messages_received_.load(); }
     std::uint64_t messages_processed() const { return messages_processed_.load(); }
     std::uint64_t messages_dropped() const { return messages_dropped_.load(); }
     std::uint64_t bytes_received() const { return bytes_received_.load(); }
-    std::uint64_t gap_count() const { return gap_count_; }
+    std::uint64_t gap_count() const { return gap_count_.load(std::memory_order_relaxed); }
     double elapsed_seconds() const { return timer_.elapsed_seconds(); }
-    
-private:
-    void print_periodic_stats();
-    std::uint64_t calculate_percentile(double percentile, std::uint64_t total_samples);
+    const LatencyHistogram& latency() const { return latency_; }
 };
 
 // Message parser - handles parsing of incoming byte streams
 class MessageParser {
 private:
-    // Pre-allocated buffer for partial messages (ZERO ALLOCATION IN HOT PATH)
-    static constexpr std::size_t MAX_PARTIAL_SIZE = 65536;  // 64KB max partial message
-    std::array<std::uint8_t, MAX_PARTIAL_SIZE> partial_buffer_;
-    std::size_t partial_size_{0};
+    // Wire-format decoder; owns the partial-message buffer (ZERO ALLOCATION IN HOT PATH)
+    std::unique_ptr<MessageDecoder> decoder_;
+    EncodingType encoding_;
     
 public:
-    MessageParser();
+    explicit MessageParser(EncodingType encoding = EncodingType::BINARY);
     
     // Parse incoming bytes and push complete messages to ring buffer
     void parse_bytes(const std::uint8_t* data, std::size_t size, RingBuffer& ring, IngestionStats& stats);
     
+    // Same, stamping messages with a receive time taken earlier (e.g. a kernel timestamp)
+    void parse_bytes(const std::uint8_t* data, std::size_t size, std::uint64_t rx_ts, RingBuffer& ring, IngestionStats& stats);
+    
+    // Decode without touching stats, so a caller handling a burst of packets
+    // can add the counts up and record them once with record_counts()
+    DecodeCounts decode(const std::uint8_t* data, std::size_t size, std::uint64_t rx_ts, RingBuffer& ring) {
+        return decoder_->decode(data, size, rx_ts, ring);
+    }
+    static void record_counts(const DecodeCounts& counts, IngestionStats& stats);
+    
     // Zero-copy parsing for high performance scenarios
     void parse_bytes_zero_copy(const std::uint8_t* data, std::size_t size, RingBuffer& ring, IngestionStats& stats);
+    void parse_bytes_zero_copy(const std::uint8_t* data, std::size_t size, std::uint64_t rx_ts, RingBuffer& ring, IngestionStats& stats);
     
-private:
-    void process_complete_message(const Msg& msg, std::uint64_t timestamp, RingBuffer& ring, IngestionStats& stats);
+    // Drop any buffered partial message (e.g. after a reconnect)
+    void reset() { decoder_->reset(); }
+    
+    EncodingType encoding() const { return encoding_; }
 };
 
 // Network client for receiving market data
@@ -118,8 +143,13 @@ public:
     // Connect to server
     void connect();
     
-    // Main I/O loop (runs in separate thread)
-    void run_io_loop(RingBuffer& ring, IngestionStats& stats, MessageParser& parser);
+    // Main I/O loop (runs in separate thread); counters, if given, belong to that thread
+    void run_io_loop(RingBuffer& ring, IngestionStats& stats, MessageParser& parser,
+                     ThreadCounters* counters = nullptr);
+    
+    // Reads until stopped or disconnected, handing each read to on_read
+    // (one call per read, not per message)
+    void read_loop(const std::function<void(const std::uint8_t* data, std::size_t size)>& on_read);
     
     // Signal stop
     void stop() { should_stop_ = true; }
@@ -132,9 +162,11 @@ class IngestionBenchmark {
 private:
     IngestionConfig config_;
     RingBuffer ring_;
+    WaitSignal consumer_signal_;            // Parser commits wake a parked consumer
     IngestionStats stats_;
-    MessageParser parser_;
     NetworkClient client_;
+    MetricsRegistry metrics_;
+    MetricsExporter exporter_;              // Periodic stats line and metrics export
     
     std::atomic<bool> should_stop_{false};
     
@@ -148,7 +180,12 @@ public:
     const IngestionStats& stats() const { return stats_; }
     
 private:
-    void consumer_loop();
+    // Maximum slots processed in place per consume_batch call
+    static constexpr std::uint64_t CONSUMER_BATCH_SIZE = 256;
+    
+    // Runs consume_batch(max) until should_continue() says stop
+    template <typename ConsumeBatch>
+    void consumer_loop(ConsumeBatch&& consume_batch);
     bool should_continue() const;
 };
 
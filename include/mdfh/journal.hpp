@@ -0,0 +1,189 @@
+#pragma once
+
+#include "core.hpp"
+#include "ring_buffer.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mdfh {
+
+struct MultiFeedSlot;
+
+// One journaled message: same 32-byte layout as MultiFeedSlot
+struct JournalRecord {
+    Msg raw;                             // Market data message (20 bytes, packed)
+    std::uint16_t origin_id = 0;         // Feed the message arrived on
+    std::uint16_t reserved = 0;
+    std::uint64_t rx_ts = 0;             // Receive timestamp in nanoseconds
+
+    JournalRecord() = default;
+    JournalRecord(const Slot& slot, std::uint16_t origin)
+        : raw(slot.raw), origin_id(origin), rx_ts(slot.rx_ts) {}
+
+    Slot to_slot() const { return Slot(raw, rx_ts); }
+};
+static_assert(sizeof(JournalRecord) == 32, "JournalRecord must be exactly 32 bytes");
+
+// First page of every segment file
+struct JournalSegmentHeader {
+    static constexpr char MAGIC[8] = {'M', 'D', 'F', 'H', 'J', 'R', 'N', 'L'};
+    static constexpr std::uint32_t VERSION = 1;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t record_size;
+    std::uint64_t segment_index;
+    std::uint64_t capacity;              // Records the segment can hold
+    std::uint64_t committed;             // Records known to be on disk (updated after each msync)
+};
+
+// Sparse seq -> position entry, one per index_stride records of an origin
+struct JournalIndexEntry {
+    std::uint64_t seq;
+    std::uint32_t record;                // Record number within the segment
+    std::uint16_t origin_id;
+    std::uint16_t reserved;
+};
+static_assert(sizeof(JournalIndexEntry) == 16, "JournalIndexEntry must be exactly 16 bytes");
+
+// Journal configuration
+struct JournalConfig {
+    std::string directory;               // Segment directory (empty = journaling disabled)
+    std::uint64_t segment_bytes = 256ull << 20;     // Size of each pre-allocated segment file
+    std::uint32_t flush_interval_ms = 10;           // Background msync period
+    std::uint32_t index_stride = 1024;              // Records per origin between index entries
+
+    bool enabled() const { return !directory.empty(); }
+    bool is_valid() const;
+};
+
+// Append-only tick journal on memory-mapped segment files.
+// append() copies records into the mapped segment and publishes the count;
+// a flusher thread msyncs the new range, stamps the header and keeps the
+// next segment pre-allocated, so a roll is a pointer swap on the caller's
+// thread. Segments are named journal-NNNNNN.seg with a journal-NNNNNN.idx
+// sidecar written when the segment is closed.
+// append() and flush() must be called from a single thread.
+class JournalWriter {
+public:
+    explicit JournalWriter(JournalConfig config);  // throws std::runtime_error on I/O failure
+    ~JournalWriter();
+
+    JournalWriter(const JournalWriter&) = delete;
+    JournalWriter& operator=(const JournalWriter&) = delete;
+
+    void append(std::span<const JournalRecord> records);
+    void append(std::span<const Slot> slots, std::uint16_t origin_id);
+    void append(const MultiFeedSlot* slots, std::uint64_t count);
+
+    // Blocks until everything appended so far is on disk
+    void flush();
+
+    // Flushes, writes the final index and stops the flusher (idempotent)
+    void close();
+
+    // Statistics
+    std::uint64_t records_written() const { return records_written_.load(std::memory_order_relaxed); }
+    std::uint64_t segments_rolled() const { return segments_rolled_.load(std::memory_order_relaxed); }
+    std::uint64_t roll_stalls() const { return roll_stalls_.load(std::memory_order_relaxed); }
+    std::uint64_t syncs() const { return syncs_.load(std::memory_order_relaxed); }
+    const JournalConfig& config() const { return config_; }
+
+private:
+    struct Segment;
+
+    JournalConfig config_;
+    std::uint64_t capacity_;                        // Records per segment
+
+    // Writer-owned
+    std::shared_ptr<Segment> current_;
+    std::uint64_t write_index_ = 0;
+    std::vector<std::uint32_t> origin_counts_;      // Records per origin in the current segment
+
+    // Shared with the flusher under mutex_
+    std::mutex mutex_;
+    std::condition_variable flusher_cv_;
+    std::condition_variable flushed_cv_;
+    std::shared_ptr<Segment> spare_;
+    std::vector<std::shared_ptr<Segment>> retired_;
+    std::uint64_t next_segment_index_ = 0;
+    std::uint64_t flush_requests_ = 0;
+    std::uint64_t flushes_completed_ = 0;
+    bool stop_ = false;
+    bool closed_ = false;
+    std::thread flusher_;
+
+    std::atomic<std::uint64_t> records_written_{0};
+    std::atomic<std::uint64_t> segments_rolled_{0};
+    std::atomic<std::uint64_t> roll_stalls_{0};
+    std::atomic<std::uint64_t> syncs_{0};
+
+    template <typename Fill>
+    void append_records(std::uint64_t count, Fill&& fill);
+
+    void roll();
+    std::shared_ptr<Segment> create_segment(std::uint64_t index);
+    void flusher_loop();
+    void sync_segment(Segment& segment);
+    void finish_segment(Segment& segment);
+};
+
+// Read-only view of a journal directory
+class JournalReader {
+public:
+    struct Position {
+        std::size_t segment;             // Segment number, 0 = oldest
+        std::uint64_t record;            // Record within the segment
+    };
+
+    explicit JournalReader(const std::string& directory);  // throws std::runtime_error
+    ~JournalReader();
+
+    JournalReader(const JournalReader&) = delete;
+    JournalReader& operator=(const JournalReader&) = delete;
+
+    std::size_t segment_count() const { return segments_.size(); }
+
+    // Committed records of one segment
+    std::span<const JournalRecord> records(std::size_t segment) const;
+
+    std::uint64_t total_records() const;
+
+    // Position of the first record of (origin_id, seq), via the sparse index
+    std::optional<Position> find(std::uint16_t origin_id, std::uint64_t seq) const;
+
+    // Calls fn(const JournalRecord&) for every record in journal order
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (std::size_t s = 0; s < segments_.size(); ++s) {
+            for (const auto& record : records(s)) {
+                fn(record);
+            }
+        }
+    }
+
+private:
+    struct MappedSegment {
+        const void* map = nullptr;
+        std::size_t bytes = 0;
+        const JournalRecord* records = nullptr;
+        std::uint64_t count = 0;
+        std::vector<JournalIndexEntry> index;
+    };
+
+    std::vector<MappedSegment> segments_;
+};
+
+// Segment file names in a journal directory, in segment order
+std::vector<std::string> list_journal_segments(const std::string& directory);
+
+} // namespace mdfh
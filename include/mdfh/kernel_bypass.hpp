@@ -4,6 +4,8 @@
 #include "ring_buffer.hpp"
 #include "timing.hpp"
 #include "performance_tracker.hpp"
+#include "placement.hpp"
+#include "wait_strategy.hpp"
 #include <memory>
 #include <string>
 #include <vector>
@@ -11,18 +13,21 @@
 #include <atomic>
 #include <thread>
 #include <array>
+#include <span>
 
 namespace mdfh {
 
 // Forward declarations
 class IngestionStats;
 class MessageParser;
+class MulticastReceiver;
 
 // Kernel bypass networking backend types
 enum class BypassBackend {
     BOOST_ASIO,     // Standard kernel networking (fallback)
     DPDK,           // Intel DPDK for high performance
-    SOLARFLARE_VI   // Solarflare ef_vi for ultra-low latency
+    SOLARFLARE_VI,  // Solarflare ef_vi for ultra-low latency
+    IO_URING        // Linux io_uring multishot recv on stock kernels
 };
 
 // Configuration for kernel bypass networking
@@ -34,19 +39,55 @@ struct BypassConfig {
     std::string host = "127.0.0.1";           // Host address
     std::uint16_t port = 9001;                // Port number
     
+    // Transport (UDP_MULTICAST joins host as the group; Boost.Asio and io_uring backends)
+    TransportType transport = TransportType::TCP;
+    std::string multicast_interface = "0.0.0.0";  // Local interface address for the join
+    bool kernel_timestamps = true;            // SO_TIMESTAMPNS receive stamps (multicast)
+    bool hardware_timestamps = false;         // SO_TIMESTAMPING NIC stamps (multicast)
+    
+    // io_uring settings (rx_ring_size is the number of provided buffers)
+    bool io_uring_sqpoll = true;              // Kernel thread polls the submission queue
+    std::uint32_t io_uring_buffer_size = 4096;    // Bytes per provided receive buffer
+    
     // Performance settings
     std::uint32_t rx_ring_size = 2048;        // RX ring buffer size (power of 2)
     std::uint32_t batch_size = 32;            // Packet batch processing size
-    std::uint32_t cpu_core = 0;               // CPU core to pin threads to
-    bool enable_numa_awareness = true;        // NUMA-aware allocations
+    int cpu_core = -1;                        // CPU of the reception thread (-1 = unpinned)
+    bool enable_numa_awareness = true;        // Bind buffers to cpu_core's NUMA node
+    HugePageMode huge_pages = HugePageMode::NONE;   // Backing of the sample and ingestion buffers
     
     // Zero-copy settings
     bool enable_zero_copy = true;             // Enable zero-copy reception
     std::uint32_t zero_copy_threshold = 64;   // Minimum packet size for zero-copy
     
+    // Wire format of the incoming stream
+    EncodingType encoding = EncodingType::BINARY;
+    
     // Timeout settings
     std::uint32_t poll_timeout_us = 100;      // Polling timeout in microseconds
     
+    // Idle policy of the reception loop; parks for up to poll_timeout_us
+    WaitStrategyType wait_strategy = WaitStrategyType::SPIN_PARK;
+    std::uint32_t spin_iterations = 100;      // Empty polls spent spinning before yielding/parking
+    
+    WaitConfig wait_config() const {
+        WaitConfig wait;
+        wait.type = wait_strategy;
+        wait.spin_iterations = spin_iterations;
+        wait.park_timeout_us = poll_timeout_us;
+        return wait;
+    }
+    
+    // Placement for buffers used by the reception thread, which runs on cpu_core
+    MemoryPlacement memory_placement() const {
+        MemoryPlacement memory;
+        memory.huge_pages = huge_pages;
+        if (enable_numa_awareness && cpu_core >= 0) {
+            memory.numa_node = numa_node_of_cpu(cpu_core);
+        }
+        return memory;
+    }
+    
     // Performance tracking settings
     PerformanceConfig perf_config;            // Performance tracking configuration
     
@@ -69,6 +110,10 @@ struct PacketDesc {
 // Callback for packet reception
 using PacketHandler = std::function<void(const PacketDesc& packet)>;
 
+// Callback for a received burst. Descriptors are only valid for the call;
+// the buffers they point at stay valid until release_packet(context).
+using BatchPacketHandler = std::function<void(std::span<const PacketDesc> packets)>;
+
 // Abstract base class for kernel bypass networking
 class KernelBypassClient {
 protected:
@@ -76,13 +121,20 @@ protected:
     std::unique_ptr<PerformanceTracker> perf_tracker_;
     std::atomic<bool> running_{false};
     std::thread reception_thread_;
-    PacketHandler packet_handler_;
+    BatchPacketHandler batch_handler_;
     
     // Statistics
     std::atomic<std::uint64_t> packets_received_{0};
     std::atomic<std::uint64_t> bytes_received_{0};
     std::atomic<std::uint64_t> packets_dropped_{0};
     
+    // Reception thread CPU time vs wall time, sampled by the reception loop
+    std::atomic<std::uint64_t> reception_cpu_ns_{0};
+    std::atomic<std::uint64_t> reception_wall_ns_{0};
+    
+    // Run on the reception thread after its loop exits
+    std::function<void()> reception_exit_handler_;
+    
 public:
     KernelBypassClient() = default;
     virtual ~KernelBypassClient() = default;
@@ -93,9 +145,16 @@ public:
     virtual void disconnect() = 0;
     virtual bool is_connected() const = 0;
     
-    // Reception control
-    virtual void start_reception(PacketHandler handler) = 0;
+    // Reception control; backends hand each receive burst to the handler in one call
+    virtual void start_batch_reception(BatchPacketHandler handler) = 0;
+    
+    // Per-packet adapter over start_batch_reception()
+    void start_reception(PacketHandler handler);
     virtual void stop_reception() = 0;
+    
+    // Runs handler on the reception thread once its loop has exited, before
+    // stop_reception() returns (final per-thread samples); set before starting
+    void set_reception_exit_handler(std::function<void()> handler) { reception_exit_handler_ = std::move(handler); }
     virtual void release_packet(void* context) = 0;
     
     // Statistics
@@ -109,6 +168,7 @@ public:
     virtual std::string backend_info() const = 0;
     
     // Performance tracking
+    PerformanceTracker* performance_tracker() const { return perf_tracker_.get(); }
     void print_performance_report() const {
         if (perf_tracker_) {
             perf_tracker_->print_performance_report();
@@ -116,16 +176,21 @@ public:
     }
     
 protected:
-    void record_stage_timestamp(StageTimestamps& timestamps) {
-        if (perf_tracker_) {
-            perf_tracker_->record_timestamp(timestamps);
+    // Called from the reception thread; start values come from reception_clock_start()
+    struct ReceptionClock {
+        std::uint64_t cpu_ns;
+        std::uint64_t wall_ns;
+    };
+    static ReceptionClock reception_clock_start();
+    void reception_exited() {
+        if (reception_exit_handler_) {
+            reception_exit_handler_();
         }
     }
-    
-    void update_cache_stats() {
-        if (perf_tracker_) {
-            perf_tracker_->update_cache_stats();
-        }
+    void sample_reception_cpu(const ReceptionClock& start);
+    double reception_cpu_utilization() const {
+        auto wall = reception_wall_ns_.load(std::memory_order_relaxed);
+        return wall > 0 ? static_cast<double>(reception_cpu_ns_.load(std::memory_order_relaxed)) / wall : 0.0;
     }
 };
 
@@ -137,9 +202,10 @@ class BoostAsioBypassClient : public KernelBypassClient {
 private:
     BypassConfig config_;
     std::unique_ptr<class NetworkClient> asio_client_;
+    std::unique_ptr<MulticastReceiver> mcast_receiver_;
     std::atomic<bool> running_{false};
     std::thread reception_thread_;
-    PacketHandler packet_handler_;
+    BatchPacketHandler batch_handler_;
     
     // Statistics
     std::atomic<std::uint64_t> packets_received_{0};
@@ -156,7 +222,7 @@ public:
     void disconnect() override;
     bool is_connected() const override;
     
-    void start_reception(PacketHandler handler) override;
+    void start_batch_reception(BatchPacketHandler handler) override;
     void stop_reception() override;
     
     void release_packet(void* context) override;
@@ -164,13 +230,14 @@ public:
     std::uint64_t packets_received() const override { return packets_received_.load(); }
     std::uint64_t bytes_received() const override { return bytes_received_.load(); }
     std::uint64_t packets_dropped() const override { return packets_dropped_.load(); }
-    double cpu_utilization() const override { return 0.0; }
+    double cpu_utilization() const override { return reception_cpu_utilization(); }
     
     BypassBackend backend_type() const override { return BypassBackend::BOOST_ASIO; }
     std::string backend_info() const override { return "Boost.Asio (kernel networking)"; }
     
 private:
     void reception_loop();
+    void multicast_reception_loop();
 };
 
 #ifdef MDFH_ENABLE_DPDK
@@ -183,7 +250,8 @@ private:
     bool initialized_{false};
     std::atomic<bool> running_{false};
     std::thread reception_thread_;
-    PacketHandler packet_handler_;
+    BatchPacketHandler batch_handler_;
+    std::vector<PacketDesc> burst_;            // Descriptors of the burst being delivered
     
     // Statistics
     std::atomic<std::uint64_t> packets_received_{0};
@@ -203,7 +271,7 @@ public:
     void disconnect() override;
     bool is_connected() const override { return initialized_ && !running_.load(); }
     
-    void start_reception(PacketHandler handler) override;
+    void start_batch_reception(BatchPacketHandler handler) override;
     void stop_reception() override;
     
     void release_packet(void* context) override;
@@ -241,7 +309,8 @@ private:
     bool initialized_{false};
     std::atomic<bool> running_{false};
     std::thread reception_thread_;
-    PacketHandler packet_handler_;
+    BatchPacketHandler batch_handler_;
+    std::vector<PacketDesc> burst_;            // Descriptors of the burst being delivered
     
     // Statistics
     std::atomic<std::uint64_t> packets_received_{0};
@@ -258,7 +327,7 @@ public:
     void disconnect() override;
     bool is_connected() const override { return initialized_; }
     
-    void start_reception(PacketHandler handler) override;
+    void start_batch_reception(BatchPacketHandler handler) override;
     void stop_reception() override;
     
     void release_packet(void* context) override;
@@ -275,10 +344,70 @@ private:
     bool setup_virtual_interface();
     bool setup_packet_buffers();
     void reception_loop();
-    void process_events();
+    int process_events();   // Returns the number of events polled
 };
 #endif // MDFH_ENABLE_SOLARFLARE
 
+#ifdef MDFH_ENABLE_IO_URING
+// io_uring implementation for stock Linux kernels (5.19+ for buffer rings,
+// 6.0+ for multishot recv). One multishot recv stays armed on the socket and
+// the kernel fills buffers from a provided buffer ring; each buffer reaches
+// the handler in place and returns to the ring through release_packet().
+class IoUringBypassClient : public KernelBypassClient {
+private:
+    struct Ring;    // Mapped submission/completion queues and buffer ring
+    
+    BypassConfig config_;
+    std::unique_ptr<Ring> ring_;
+    std::unique_ptr<class MulticastReceiver> mcast_receiver_;  // Multicast socket setup
+    int socket_fd_{-1};
+    bool recv_armed_{false};
+    bool sqpoll_{false};
+    std::atomic<bool> connected_{false};
+    std::atomic<bool> running_{false};
+    std::thread reception_thread_;
+    BatchPacketHandler batch_handler_;
+    std::vector<PacketDesc> burst_;            // Descriptors of the burst being delivered
+    
+    // Statistics
+    std::atomic<std::uint64_t> packets_received_{0};
+    std::atomic<std::uint64_t> bytes_received_{0};
+    std::atomic<std::uint64_t> packets_dropped_{0};
+    std::uint64_t buffers_outstanding_{0};     // Handed to the handler, not yet released
+    
+public:
+    IoUringBypassClient();
+    ~IoUringBypassClient() override;
+    
+    // KernelBypassClient interface
+    bool initialize(const BypassConfig& config) override;
+    bool connect() override;
+    void disconnect() override;
+    bool is_connected() const override { return connected_.load(); }
+    
+    void start_batch_reception(BatchPacketHandler handler) override;
+    void stop_reception() override;
+    
+    // Returns the buffer to the provided buffer ring; call from the reception thread
+    void release_packet(void* context) override;
+    
+    std::uint64_t packets_received() const override { return packets_received_.load(); }
+    std::uint64_t bytes_received() const override { return bytes_received_.load(); }
+    std::uint64_t packets_dropped() const override { return packets_dropped_.load(); }
+    double cpu_utilization() const override { return reception_cpu_utilization(); }
+    
+    BypassBackend backend_type() const override { return BypassBackend::IO_URING; }
+    std::string backend_info() const override;
+    
+private:
+    bool setup_ring();
+    bool setup_buffer_ring();
+    bool arm_recv();
+    void reception_loop();
+    void close_socket();
+};
+#endif // MDFH_ENABLE_IO_URING
+
 // High-level kernel bypass ingestion client
 class BypassIngestionClient {
 private:
@@ -288,6 +417,15 @@ private:
     RingBuffer* ring_buffer_{nullptr};
     IngestionStats* stats_{nullptr};
     
+    // Stage tracing of sampled packets (owned by the backend; null if disabled)
+    PerformanceTracker* tracker_{nullptr};
+    std::array<StageTimestamps, 4> burst_traces_;     // Sampled packets of the current burst
+    
+    // Hardware counters of the reception thread (reception thread only)
+    ThreadCounters* io_counters_{nullptr};
+    bool io_counters_attached_{false};
+    std::uint64_t messages_decoded_{0};
+    
     // Pre-allocated zero-copy packet management (ZERO ALLOCATION IN HOT PATH)
     static constexpr std::size_t MAX_PENDING_PACKETS = 1024;
     std::array<void*, MAX_PENDING_PACKETS> pending_packets_;
@@ -319,6 +457,9 @@ public:
     std::uint64_t packets_dropped() const;
     double cpu_utilization() const;
     
+    // Stage tracing: the consumer finishes traces via complete_traces()
+    PerformanceTracker* performance_tracker() const { return tracker_; }
+    
     // Performance reporting
     void print_performance_report() const {
         if (bypass_client_) {
@@ -327,7 +468,11 @@ public:
     }
     
 private:
-    void packet_handler(const PacketDesc& packet);
+    // Packets ahead of the one being decoded whose data is prefetched
+    static constexpr std::size_t PREFETCH_DISTANCE = 4;
+    
+    void batch_handler(std::span<const PacketDesc> packets);
+    void retire_packet(void* context);
     void cleanup_processed_packets();
     
     // Zero-allocation packet management (HOT PATH)
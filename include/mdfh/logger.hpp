@@ -0,0 +1,355 @@
+#pragma once
+
+#include "timing.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Levels below this are compiled out of the MDFH_LOG_* macros entirely
+// (0 = DEBUG ... 4 = FATAL); set through the MDFH_LOG_LEVEL CMake option
+#ifndef MDFH_LOG_MIN_LEVEL
+#define MDFH_LOG_MIN_LEVEL 0
+#endif
+
+namespace mdfh {
+
+/**
+ * @brief Logging levels for the MDFH system
+ */
+enum class LogLevel {
+    DEBUG = 0,
+    INFO = 1,
+    WARN = 2,
+    ERROR = 3,
+    FATAL = 4
+};
+
+inline std::ostream& operator<<(std::ostream& os, LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG: return os << "DEBUG";
+        case LogLevel::INFO: return os << "INFO";
+        case LogLevel::WARN: return os << "WARN";
+        case LogLevel::ERROR: return os << "ERROR";
+        case LogLevel::FATAL: return os << "FATAL";
+    }
+    return os << "UNKNOWN_LEVEL";
+}
+
+/**
+ * @brief One deferred log statement: the captured arguments plus the
+ * function that knows their types and formats them on the backend thread
+ */
+struct alignas(64) LogRecord {
+    static constexpr std::size_t SIZE = 256;
+    static constexpr std::size_t PAYLOAD_SIZE = SIZE - 32;
+
+    using FormatFn = void (*)(std::ostream& os, const std::byte* payload);
+
+    std::uint64_t timestamp_ns = 0;      // get_timestamp_ns() at the call site
+    FormatFn format = nullptr;
+    const char* component = nullptr;     // String literal
+    LogLevel level = LogLevel::INFO;
+    std::array<std::byte, PAYLOAD_SIZE> payload;
+};
+static_assert(sizeof(LogRecord) == LogRecord::SIZE, "LogRecord must be exactly 256 bytes");
+
+namespace log_detail {
+
+// How one argument type is captured into a payload and streamed back out.
+// FIXED_SIZE bytes are always written; strings add their (truncated) text.
+template <typename T, typename = void>
+struct LogArg {
+    static_assert(sizeof(T) == 0, "Log arguments must be arithmetic, enums, pointers or strings");
+};
+
+template <typename T>
+struct LogArg<T, std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>>> {
+    static constexpr std::size_t FIXED_SIZE = sizeof(T);
+
+    static std::size_t encode(std::byte* out, std::size_t, const T& value) {
+        std::memcpy(out, &value, sizeof(T));
+        return sizeof(T);
+    }
+
+    static std::size_t decode(std::ostream& os, const std::byte* in) {
+        T value;
+        std::memcpy(&value, in, sizeof(T));
+        if constexpr (std::is_same_v<T, bool>) {
+            os << (value ? "true" : "false");
+        } else if constexpr (std::is_enum_v<T>) {
+            if constexpr (requires { os << value; }) {
+                os << value;
+            } else {
+                os << static_cast<std::underlying_type_t<T>>(value);
+            }
+        } else if constexpr (sizeof(T) == 1 && !std::is_same_v<T, char>) {
+            os << static_cast<int>(value);
+        } else {
+            os << value;
+        }
+        return sizeof(T);
+    }
+};
+
+// Text is copied (a caller's buffer may be gone by the time it is formatted)
+struct StringLogArg {
+    static constexpr std::size_t FIXED_SIZE = sizeof(std::uint16_t);
+
+    static std::size_t encode(std::byte* out, std::size_t available, std::string_view text) {
+        auto length = static_cast<std::uint16_t>(std::min(text.size(), available - FIXED_SIZE));
+        std::memcpy(out, &length, FIXED_SIZE);
+        std::memcpy(out + FIXED_SIZE, text.data(), length);
+        return FIXED_SIZE + length;
+    }
+
+    static std::size_t decode(std::ostream& os, const std::byte* in) {
+        std::uint16_t length;
+        std::memcpy(&length, in, FIXED_SIZE);
+        os.write(reinterpret_cast<const char*>(in + FIXED_SIZE), length);
+        return FIXED_SIZE + length;
+    }
+};
+
+template <> struct LogArg<std::string> : StringLogArg {};
+template <> struct LogArg<std::string_view> : StringLogArg {};
+template <> struct LogArg<const char*> : StringLogArg {
+    static std::size_t encode(std::byte* out, std::size_t available, const char* text) {
+        return StringLogArg::encode(out, available, text ? std::string_view(text) : std::string_view("(null)"));
+    }
+};
+template <> struct LogArg<char*> : LogArg<const char*> {};
+
+template <typename T>
+struct LogArg<T, std::enable_if_t<std::is_pointer_v<T> && !std::is_same_v<T, const char*> && !std::is_same_v<T, char*>>> {
+    static constexpr std::size_t FIXED_SIZE = sizeof(const void*);
+
+    static std::size_t encode(std::byte* out, std::size_t, T value) {
+        auto pointer = static_cast<const void*>(value);
+        std::memcpy(out, &pointer, sizeof(pointer));
+        return sizeof(pointer);
+    }
+
+    static std::size_t decode(std::ostream& os, const std::byte* in) {
+        const void* pointer;
+        std::memcpy(&pointer, in, sizeof(pointer));
+        os << pointer;
+        return sizeof(pointer);
+    }
+};
+
+// Captured type of an argument: arrays decay to pointers, references and cv are dropped
+template <typename T>
+using Captured = std::decay_t<T>;
+
+template <typename... Args>
+void format_args(std::ostream& os, const std::byte* payload) {
+    std::size_t pos = 0;
+    ((pos += LogArg<Args>::decode(os, payload + pos)), ...);
+}
+
+// Writes every argument; each string may use what the remaining fixed-size arguments leave
+template <typename... Args>
+void encode_args(std::byte* payload, const Args&... args) {
+    static_assert((LogArg<Captured<Args>>::FIXED_SIZE + ... + 0) <= LogRecord::PAYLOAD_SIZE,
+                  "Too many log arguments for one LogRecord");
+    std::size_t pos = 0;
+    std::size_t reserved = (LogArg<Captured<Args>>::FIXED_SIZE + ... + 0);
+    ((reserved -= LogArg<Captured<Args>>::FIXED_SIZE,
+      pos += LogArg<Captured<Args>>::encode(payload + pos, LogRecord::PAYLOAD_SIZE - pos - reserved, args)), ...);
+}
+
+// Per-thread SPSC queue of records: the logging thread produces, the backend thread consumes
+class LogQueue {
+public:
+    static constexpr std::uint64_t CAPACITY = 1024;
+
+    LogQueue();
+
+    // Producer side; claim() returns null when the queue is full
+    LogRecord* claim() {
+        auto head = head_.load(std::memory_order_relaxed);
+        if (head - cached_tail_ >= CAPACITY) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head - cached_tail_ >= CAPACITY) {
+                dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+        }
+        return &records_[head & (CAPACITY - 1)];
+    }
+    void commit() { head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // Consumer side
+    const LogRecord* front() const {
+        auto tail = tail_.load(std::memory_order_relaxed);
+        return tail == head_.load(std::memory_order_acquire) ? nullptr : &records_[tail & (CAPACITY - 1)];
+    }
+    void pop() { tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+    bool empty() const { return tail_.load(std::memory_order_relaxed) == head_.load(std::memory_order_acquire); }
+    std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // Set when the owning thread exits; the backend frees the queue once drained
+    std::atomic<bool> retired{false};
+
+private:
+    std::unique_ptr<LogRecord[]> records_;
+    alignas(64) std::atomic<std::uint64_t> head_{0};
+    std::uint64_t cached_tail_ = 0;
+    std::atomic<std::uint64_t> dropped_{0};
+    alignas(64) std::atomic<std::uint64_t> tail_{0};
+};
+
+// True once the backend has shut down at exit; later records are written synchronously
+inline std::atomic<bool> backend_stopped{false};
+
+} // namespace log_detail
+
+/**
+ * @brief Deferred logger for MDFH
+ *
+ * A log call copies its arguments (numbers, enums, pointers and string text)
+ * into a record on the calling thread's own SPSC queue and returns; a
+ * background thread formats records with timestamps and writes them to the
+ * output stream. Nothing is formatted or allocated on the caller's thread,
+ * and a full queue drops the record (counted and reported) rather than
+ * blocking. Levels below MDFH_LOG_MIN_LEVEL are removed at compile time,
+ * the rest cost one relaxed load when filtered out at runtime.
+ */
+class Logger {
+private:
+    static std::atomic<LogLevel> current_level_;
+    static std::atomic<std::ostream*> output_stream_;
+
+public:
+    /**
+     * @brief Sets the global log level
+     * @param level Minimum log level to output
+     */
+    static void set_log_level(LogLevel level) { current_level_.store(level, std::memory_order_relaxed); }
+
+    /**
+     * @brief Sets the output stream for logging
+     * @param stream Output stream (default: std::cerr)
+     */
+    static void set_output_stream(std::ostream& stream) { output_stream_.store(&stream, std::memory_order_release); }
+
+    static std::ostream* output_stream() { return output_stream_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Whether a record at this level would be written
+     */
+    static bool enabled(LogLevel level) { return level >= current_level_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Queues a record at the specified level
+     * @param level Log level
+     * @param component Component name, a string literal (e.g., "RingBuffer", "KernelBypass")
+     * @param args Message pieces, written one after another
+     */
+    template <typename... Args>
+    static void log(LogLevel level, const char* component, const Args&... args) {
+        if (!enabled(level)) {
+            return;
+        }
+
+        auto* queue = thread_queue();
+        if (!queue) [[unlikely]] {
+            LogRecord record;
+            capture(record, level, component, args...);
+            write_now(record);
+            return;
+        }
+
+        auto* record = queue->claim();
+        if (!record) {
+            return;
+        }
+        capture(*record, level, component, args...);
+        queue->commit();
+        if (level == LogLevel::FATAL) {
+            flush();
+        }
+    }
+
+    /**
+     * @brief Convenience methods for different log levels
+     */
+    template <typename... Args>
+    static void debug(const char* component, const Args&... args) { log(LogLevel::DEBUG, component, args...); }
+
+    template <typename... Args>
+    static void info(const char* component, const Args&... args) { log(LogLevel::INFO, component, args...); }
+
+    template <typename... Args>
+    static void warn(const char* component, const Args&... args) { log(LogLevel::WARN, component, args...); }
+
+    template <typename... Args>
+    static void error(const char* component, const Args&... args) { log(LogLevel::ERROR, component, args...); }
+
+    template <typename... Args>
+    static void fatal(const char* component, const Args&... args) { log(LogLevel::FATAL, component, args...); }
+
+    /**
+     * @brief Blocks until every record queued so far has been written
+     */
+    static void flush();
+
+private:
+    template <typename... Args>
+    static void capture(LogRecord& record, LogLevel level, const char* component, const Args&... args) {
+        record.timestamp_ns = get_timestamp_ns();
+        record.format = &log_detail::format_args<log_detail::Captured<Args>...>;
+        record.component = component;
+        record.level = level;
+        log_detail::encode_args(record.payload.data(), args...);
+    }
+
+    // Marks the queue retired when its thread exits
+    struct QueueHandle {
+        log_detail::LogQueue* queue = nullptr;
+        ~QueueHandle() {
+            if (queue) {
+                queue->retired.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    // Calling thread's queue, registered with the backend on first use (null after shutdown)
+    static log_detail::LogQueue* thread_queue() {
+        thread_local QueueHandle handle;
+        if (!handle.queue || log_detail::backend_stopped.load(std::memory_order_relaxed)) [[unlikely]] {
+            handle.queue = log_detail::backend_stopped.load(std::memory_order_relaxed) ? nullptr : register_thread();
+        }
+        return handle.queue;
+    }
+
+    static log_detail::LogQueue* register_thread();
+    static void write_now(const LogRecord& record);
+};
+
+// Logging macros: arguments are not evaluated unless the level is enabled,
+// e.g. MDFH_LOG_DEBUG("RingBuffer", "Created ring buffer with capacity ", capacity)
+#define MDFH_LOG_AT(level, component, ...)                                          \
+    do {                                                                            \
+        if constexpr (static_cast<int>(level) >= MDFH_LOG_MIN_LEVEL) {              \
+            if (mdfh::Logger::enabled(level)) {                                     \
+                mdfh::Logger::log(level, component, __VA_ARGS__);                   \
+            }                                                                       \
+        }                                                                           \
+    } while (0)
+
+#define MDFH_LOG_DEBUG(component, ...) MDFH_LOG_AT(mdfh::LogLevel::DEBUG, component, __VA_ARGS__)
+#define MDFH_LOG_INFO(component, ...) MDFH_LOG_AT(mdfh::LogLevel::INFO, component, __VA_ARGS__)
+#define MDFH_LOG_WARN(component, ...) MDFH_LOG_AT(mdfh::LogLevel::WARN, component, __VA_ARGS__)
+#define MDFH_LOG_ERROR(component, ...) MDFH_LOG_AT(mdfh::LogLevel::ERROR, component, __VA_ARGS__)
+#define MDFH_LOG_FATAL(component, ...) MDFH_LOG_AT(mdfh::LogLevel::FATAL, component, __VA_ARGS__)
+
+} // namespace mdfh
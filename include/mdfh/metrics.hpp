@@ -0,0 +1,156 @@
+#pragma once
+
+#include "histogram.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <boost/asio.hpp>
+
+namespace mdfh {
+
+// Monotonic count owned by the registry. add() is the single-writer path
+// (relaxed load and store, like LatencyHistogram::record()); add_shared()
+// is for counters several threads bump.
+class MetricCounter {
+public:
+    void add(std::uint64_t n = 1) {
+        value_.store(value_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+    void add_shared(std::uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+    std::uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    alignas(64) std::atomic<std::uint64_t> value_{0};
+};
+
+// Point-in-time value owned by the registry
+class MetricGauge {
+public:
+    void set(std::int64_t value) { value_.store(value, std::memory_order_relaxed); }
+    std::int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    alignas(64) std::atomic<std::int64_t> value_{0};
+};
+
+// Named metrics for export. Instruments are registered during setup (under
+// a mutex); afterwards the data path only touches their atomics and the
+// exporter thread reads them when it renders a snapshot. Values that stats
+// classes already keep are exported through read callbacks instead of being
+// counted twice. Series of one name form a family and must share its type.
+class MetricsRegistry {
+public:
+    using Labels = std::vector<std::pair<std::string, std::string>>;
+
+    MetricCounter& counter(const std::string& name, const std::string& help, const Labels& labels = {});
+    MetricGauge& gauge(const std::string& name, const std::string& help, const Labels& labels = {});
+
+    // Exports a value owned elsewhere; read runs on the exporter thread and must be thread-safe
+    void counter_fn(const std::string& name, const std::string& help, const Labels& labels,
+                    std::function<double()> read);
+    void gauge_fn(const std::string& name, const std::string& help, const Labels& labels,
+                  std::function<double()> read);
+
+    // Exported as a summary: p50/p90/p99/p99.9/p99.99, sum and count (histogram must outlive the registry)
+    void histogram(const std::string& name, const std::string& help, const Labels& labels,
+                   const LatencyHistogram& histogram);
+
+    // Prometheus text exposition format 0.0.4
+    std::string render_prometheus() const;
+
+private:
+    enum class MetricType { COUNTER, GAUGE, SUMMARY };
+
+    struct Series {
+        std::string labels;                             // Rendered label pairs without braces
+        std::function<double()> read;                   // COUNTER and GAUGE
+        const LatencyHistogram* histogram = nullptr;    // SUMMARY
+    };
+
+    struct Family {
+        std::string name;
+        std::string help;
+        MetricType type;
+        std::vector<Series> series;
+    };
+
+    // Throws std::invalid_argument if name is already registered with another type
+    Family& family(const std::string& name, const std::string& help, MetricType type);
+
+    mutable std::mutex mutex_;
+    std::vector<Family> families_;                      // Registration order
+    std::unordered_map<std::string, std::size_t> family_index_;
+    std::deque<MetricCounter> counters_;                // deque: stable addresses
+    std::deque<MetricGauge> gauges_;
+};
+
+// Metrics export configuration
+struct MetricsConfig {
+    std::uint16_t http_port = 0;         // Prometheus scrape endpoint, GET /metrics (0 = off)
+    std::string push_address;            // host:port receiving the exposition text over UDP (empty = off)
+    std::uint32_t push_interval_ms = 1000;
+
+    bool enabled() const { return http_port != 0 || !push_address.empty(); }
+    bool is_valid() const;
+};
+
+// Background exporter: one thread serves scrapes, pushes snapshots over UDP
+// and runs the periodic console reporters, so none of that formatting or I/O
+// happens on the threads moving market data.
+class MetricsExporter {
+public:
+    MetricsExporter(const MetricsRegistry& registry, MetricsConfig config);
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    // Runs report on the exporter thread every period (register before start())
+    void add_reporter(std::chrono::milliseconds period, std::function<void()> report);
+
+    // Throws boost::system::system_error if the endpoint cannot be bound or resolved
+    void start();
+
+    // Stops the thread; reporters do not run again (idempotent)
+    void stop();
+
+    // Statistics
+    std::uint64_t scrapes() const { return scrapes_.load(std::memory_order_relaxed); }
+    std::uint64_t pushes() const { return pushes_.load(std::memory_order_relaxed); }
+
+private:
+    struct Reporter {
+        std::chrono::milliseconds period;
+        std::function<void()> report;
+        std::unique_ptr<boost::asio::steady_timer> timer;
+    };
+
+    void accept();
+    void schedule_push();
+    void push();
+    void schedule_reporter(Reporter& reporter);
+
+    const MetricsRegistry& registry_;
+    MetricsConfig config_;
+    boost::asio::io_context ctx_;
+    std::optional<boost::asio::ip::tcp::acceptor> acceptor_;
+    std::optional<boost::asio::ip::udp::socket> push_socket_;
+    boost::asio::ip::udp::endpoint push_endpoint_;
+    std::optional<boost::asio::steady_timer> push_timer_;
+    std::vector<Reporter> reporters_;
+    std::thread thread_;
+    std::atomic<std::uint64_t> scrapes_{0};
+    std::atomic<std::uint64_t> pushes_{0};
+};
+
+} // namespace mdfh
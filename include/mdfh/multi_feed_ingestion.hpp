@@ -4,6 +4,15 @@
 #include "ring_buffer.hpp"
 #include "timing.hpp"
 #include "ingestion.hpp"
+#include "multicast_receiver.hpp"
+#include "wait_strategy.hpp"
+#include "arbitration.hpp"
+#include "journal.hpp"
+#include "histogram.hpp"
+#include "performance_tracker.hpp"
+#include "metrics.hpp"
+#include "conflation.hpp"
+#include "shm_ring.hpp"
 #include <boost/asio.hpp>
 #include <yaml-cpp/yaml.h>
 #include <string>
@@ -15,6 +24,9 @@
 #include <mutex>
 #include <condition_variable>
 #include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <span>
 
 namespace mdfh {
 
@@ -25,29 +37,61 @@ struct FeedConfig {
     std::uint16_t port = 9001;           // Port number
     std::uint32_t origin_id = 0;         // Unique feed identifier for sequence tracking
     bool is_primary = true;              // Primary vs backup feed
+    std::string arbitration_group;       // Feeds sharing a group are A/B lines of one sequence space (empty = none)
     std::uint32_t heartbeat_interval_ms = 1000;  // Expected heartbeat interval
     std::uint32_t timeout_multiplier = 3;        // Timeout = heartbeat_interval * multiplier
     
+    // Transport settings (UDP_MULTICAST joins host as the group on port)
+    TransportType transport = TransportType::TCP;
+    std::string interface = "0.0.0.0";   // Local interface address for multicast joins
+    RxTimestampSource timestamps = RxTimestampSource::KERNEL;   // Multicast receive timestamps
+    
     // Performance settings
     std::uint32_t buffer_capacity = 65536;  // Per-feed ring buffer capacity
+    EncodingType encoding = EncodingType::BINARY;  // Wire format of this feed
+    WaitConfig wait;                     // Idle policy of this feed's relay and multicast loops
+    
+    // Placement (-1 = unpinned). The local buffer binds to io_core's NUMA
+    // node unless memory.numa_node is set explicitly.
+    int io_core = -1;                    // CPU of the I/O (parsing) thread
+    int relay_core = -1;                 // CPU of the relay thread (RELAY fan-in only)
+    MemoryPlacement memory;              // Backing of the local buffer (defaults to MultiFeedConfig::memory)
     
     // Validation
     bool is_valid() const;
 };
 
+// How feed messages reach the consumer
+enum class FanInMode {
+    RELAY,      // I/O thread -> feed ring -> relay thread -> shared MPSC buffer -> consumer
+    DIRECT      // I/O thread parses into its feed ring (lane), the consumer round-robins the lanes
+};
+
 // Multi-feed ingestion configuration
 struct MultiFeedConfig {
     std::vector<FeedConfig> feeds;
     
     // Global settings
-    std::uint32_t global_buffer_capacity = 262144;  // Main MPSC ring buffer capacity
-    std::uint32_t dispatcher_threads = 1;           // Number of dispatcher threads
+    std::uint32_t global_buffer_capacity = 262144;  // MPSC ring buffer capacity per shard (RELAY only)
+    FanInMode fan_in_mode = FanInMode::RELAY;       // Relay threads or direct per-feed lanes
+    std::uint32_t dispatcher_threads = 1;           // Consumer shards, each fed by a disjoint set of feeds
+    std::vector<std::uint32_t> dispatcher_cores;    // CPU core of each shard's consumer (empty = unpinned)
+    int health_core = -1;                           // CPU of the health monitor thread (-1 = unpinned)
+    MemoryPlacement memory;                         // Backing of the shard buffers, default for the feeds
+    JournalConfig journal;                          // Tick capture of consumed messages (empty directory = off)
+    ConflationConfig conflation;                    // Last-value cache for a slow reader (max_keys 0 = off)
+    ShmRingConfig shm_ring;                         // Shared-memory ring for out-of-process readers (empty path = off)
+    bool thread_counters = false;                   // Hardware counter group per I/O, relay and consumer thread
+    MetricsConfig metrics;                          // Scrape/push endpoints of the metrics exporter
     std::uint32_t max_seconds = 0;                  // Run duration (0 = infinite)
     std::uint64_t max_messages = 0;                 // Message limit (0 = infinite)
     
     // Health monitoring
     std::uint32_t health_check_interval_ms = 100;   // Health check frequency
     
+    // Idle policy of the consumer draining the global buffer
+    WaitConfig consumer_wait;
+    
     // Load from YAML file
     static MultiFeedConfig from_yaml(const std::string& filename);
     
@@ -58,38 +102,76 @@ struct MultiFeedConfig {
     bool is_valid() const;
 };
 
-// Enhanced slot with feed origin information
-struct MultiFeedSlot {
-    Slot base_slot;                      // Original slot data
-    std::uint32_t origin_id;             // Feed origin identifier
-    std::uint64_t feed_sequence;         // Per-feed sequence number
-    std::chrono::steady_clock::time_point arrival_time;  // When message arrived
+// Compact fan-in record with feed origin information.
+// Packs the message, its receive timestamp and a narrow origin id into 32 bytes:
+// consumer batch arrays and journal segments hold two per cache line, and in the
+// MPSC ring a record fills the rest of its cell's line after the sequence stamp.
+// The per-feed sequence is the message's own seq and the arrival time is the
+// rx_ts MessageParser already stamped.
+struct alignas(32) MultiFeedSlot {
+    Msg raw;                             // Market data message (20 bytes, packed)
+    std::uint16_t origin_id = 0;         // Feed origin identifier
+    std::uint16_t reserved = 0;          // Keeps rx_ts naturally aligned
+    std::uint64_t rx_ts = 0;             // Receive timestamp in nanoseconds
     
     MultiFeedSlot() = default;
-    MultiFeedSlot(const Slot& slot, std::uint32_t origin, std::uint64_t seq)
-        : base_slot(slot), origin_id(origin), feed_sequence(seq)
-        , arrival_time(std::chrono::steady_clock::now()) {}
+    MultiFeedSlot(const Slot& slot, std::uint16_t origin)
+        : raw(slot.raw), origin_id(origin), rx_ts(slot.rx_ts) {}
+    
+    std::uint64_t feed_sequence() const { return raw.seq; }
+    Slot to_slot() const { return Slot(raw, rx_ts); }
 };
+static_assert(sizeof(MultiFeedSlot) == 32, "MultiFeedSlot must be exactly 32 bytes");
+static_assert(offsetof(MultiFeedSlot, rx_ts) % alignof(std::uint64_t) == 0,
+              "MultiFeedSlot::rx_ts must be naturally aligned");
+
+// Largest origin_id that fits in MultiFeedSlot::origin_id
+inline constexpr std::uint32_t MAX_ORIGIN_ID = 0xFFFF;
 
-// Multi-producer, single-consumer ring buffer for fan-in
+// Multi-producer, single-consumer ring buffer for fan-in.
+// Bounded Vyukov-style queue: every cell carries a sequence stamp that tells
+// producers when the cell is free and tells the consumer when its payload has
+// been fully written, so claiming a position and publishing it are decoupled.
 class MPSCRingBuffer {
 private:
-    std::vector<MultiFeedSlot> slots_;
-    std::atomic<std::uint64_t> write_pos_{0};
-    std::atomic<std::uint64_t> read_pos_{0};
+    // Sequence stamp and record share one cache line
+    struct alignas(64) Cell {
+        std::atomic<std::uint64_t> sequence{0};
+        MultiFeedSlot data;
+    };
+    static_assert(sizeof(Cell) == 64, "MPSC cell must occupy a single cache line");
+    
+    PlacedArray<Cell> cells_;
     std::uint64_t capacity_;
     std::uint64_t mask_;
     
+    // Producers contend on enqueue_pos_, the consumer owns dequeue_pos_
+    alignas(64) std::atomic<std::uint64_t> enqueue_pos_{0};
+    WaitSignal* consumer_signal_{nullptr};
+    alignas(64) std::atomic<std::uint64_t> dequeue_pos_{0};
+    
 public:
-    explicit MPSCRingBuffer(std::uint64_t capacity);
+    explicit MPSCRingBuffer(std::uint64_t capacity, const MemoryPlacement& placement = {});
     
-    // Thread-safe multi-producer operations
+    // Thread-safe multi-producer operations. A push only fails when the
+    // buffer is full; lost races against other producers are retried.
     bool try_push(const MultiFeedSlot& slot);
+    
+    // Claims a contiguous run of up to count cells with a single CAS
+    // Returns number of slots actually pushed
+    std::uint64_t try_push_n(const MultiFeedSlot* slots, std::uint64_t count);
+    
+    // Single-consumer operations
     bool try_pop(MultiFeedSlot& slot);
+    std::uint64_t try_pop_n(MultiFeedSlot* slots, std::uint64_t max_count);
+    
+    // Wakes a parked consumer after every push (set before producers start)
+    void set_consumer_signal(WaitSignal* signal) { consumer_signal_ = signal; }
     
     // Statistics
     std::uint64_t size() const;
     std::uint64_t capacity() const { return capacity_; }
+    HugePageMode memory_backing() const { return cells_.backing(); }
 };
 
 // Feed health status
@@ -101,27 +183,52 @@ enum class FeedStatus {
     FAILED       // Connection failed
 };
 
-// Per-feed statistics and health monitoring
+// Per-feed statistics and health monitoring.
+// Messages are recorded by a single thread (the feed's relay loop, or the
+// consumer in DIRECT fan-in), which keeps counters and gap state in plain
+// members and publishes a copy once per batch under a seqlock. The health
+// thread and reporters read consistent snapshots without taking a lock.
 class FeedMonitor {
+public:
+    struct Snapshot {
+        std::uint64_t messages_received = 0;
+        std::uint64_t bytes_received = 0;
+        std::uint64_t sequence_gaps = 0;
+        std::uint64_t messages_dropped = 0;  // Relayed messages lost to a full shard buffer
+        std::uint64_t last_sequence = 0;
+        std::int64_t last_message_ns = 0;    // steady_clock time of the last recorded batch
+    };
+    
 private:
     FeedConfig config_;
     std::atomic<FeedStatus> status_{FeedStatus::CONNECTING};
+    
+    // Writer-owned state
+    Snapshot local_;
+    std::uint64_t expected_sequence_ = 0;
+    bool first_message_seen_ = false;
+    
+    // Receive-to-relay latency of batched messages (ns); readable from any thread
+    LatencyHistogram latency_;
+    
+    // Published copy of local_; seq_ is odd while an update is in progress
+    alignas(64) std::atomic<std::uint64_t> seq_{0};
     std::atomic<std::uint64_t> messages_received_{0};
     std::atomic<std::uint64_t> bytes_received_{0};
     std::atomic<std::uint64_t> sequence_gaps_{0};
+    std::atomic<std::uint64_t> messages_dropped_{0};
     std::atomic<std::uint64_t> last_sequence_{0};
-    std::atomic<std::chrono::steady_clock::time_point> last_message_time_;
-    
-    // Gap tracking
-    std::uint64_t expected_sequence_ = 0;
-    bool first_message_seen_ = false;
-    mutable std::mutex gap_mutex_;
+    std::atomic<std::int64_t> last_message_ns_{0};
     
 public:
     explicit FeedMonitor(FeedConfig config);
     
-    // Update statistics
+    // Update statistics (single writer thread)
     void record_message(const Msg& msg, std::uint64_t bytes);
+    
+    // Batched form of record_message(): one clock read and one publish per batch
+    void record_messages(std::span<const Slot> slots);
+    void record_dropped(std::uint64_t count);
     void record_connection_established();
     void record_connection_failed();
     
@@ -130,15 +237,22 @@ public:
     bool is_healthy() const;
     bool is_dead() const;
     
+    // Consistent view of the counters, safe from any thread
+    Snapshot snapshot() const;
+    
     // Accessors
     FeedStatus status() const { return status_.load(); }
-    std::uint64_t messages_received() const { return messages_received_.load(); }
-    std::uint64_t bytes_received() const { return bytes_received_.load(); }
-    std::uint64_t sequence_gaps() const { return sequence_gaps_.load(); }
+    std::uint64_t messages_received() const { return snapshot().messages_received; }
+    std::uint64_t bytes_received() const { return snapshot().bytes_received; }
+    std::uint64_t sequence_gaps() const { return snapshot().sequence_gaps; }
     const FeedConfig& config() const { return config_; }
+    const LatencyHistogram& latency() const { return latency_; }
     
     // Statistics reporting
     void print_stats() const;
+    
+private:
+    void publish();
 };
 
 // Single feed ingestion worker
@@ -146,9 +260,12 @@ class FeedWorker {
 private:
     FeedConfig config_;
     std::unique_ptr<FeedMonitor> monitor_;
-    std::unique_ptr<NetworkClient> client_;
+    std::unique_ptr<NetworkClient> client_;             // TCP feeds
+    std::unique_ptr<MulticastReceiver> mcast_client_;   // UDP multicast feeds
     std::unique_ptr<MessageParser> parser_;
     std::unique_ptr<RingBuffer> local_buffer_;
+    WaitSignal relay_signal_;                           // I/O thread -> relay loop wakeups
+    PerformanceTracker* counters_{nullptr};             // Registry for thread counters (null = off)
     std::atomic<bool> should_stop_{false};
     std::thread worker_thread_;
     
@@ -156,25 +273,54 @@ public:
     explicit FeedWorker(FeedConfig config);
     ~FeedWorker();
     
-    // Lifecycle
-    void start(MPSCRingBuffer& global_buffer);
+    // Lifecycle; with counters, the worker's threads attach hardware counters to it
+    void start(MPSCRingBuffer& global_buffer, PerformanceTracker* counters = nullptr);
+    
+    // DIRECT fan-in: the worker thread runs the I/O loop itself and its local
+    // buffer becomes a lane drained by the consumer through drain_lane()
+    void start_direct(WaitSignal& consumer_signal, PerformanceTracker* counters = nullptr);
     void stop();
     
+    // Moves up to max_count messages from the local buffer into slots, recording them
+    // in the monitor as one batch (the buffer's single consumer only)
+    std::uint64_t drain_lane(MultiFeedSlot* slots, std::uint64_t max_count);
+    
     // Status
     bool is_running() const;
     const FeedMonitor& monitor() const { return *monitor_; }
     
 private:
-    void worker_loop(MPSCRingBuffer& global_buffer);
-    void process_local_messages(MPSCRingBuffer& global_buffer);
+    // global_buffer is null in DIRECT mode
+    void worker_loop(MPSCRingBuffer* global_buffer);
+    
+    // Returns the number of messages relayed
+    std::uint64_t process_local_messages(MPSCRingBuffer& global_buffer);
+    
+    // Relay batch size between local and global buffers
+    static constexpr std::size_t RELAY_BATCH_SIZE = 64;
 };
 
-// Fan-in dispatcher - coordinates multiple feed workers
+// Fan-in dispatcher - coordinates multiple feed workers.
+// Feeds are sharded across dispatcher_threads consumers by feed: each feed
+// belongs to exactly one shard (every line of an arbitration group to the
+// same one), so per-feed order and A/B dedup hold within a shard and the
+// shards share nothing on the consume path.
 class FanInDispatcher {
 private:
+    // State of one consumer shard (touched by its consumer thread only,
+    // apart from the queue and signal its feed workers publish to)
+    struct Shard {
+        std::unique_ptr<MPSCRingBuffer> buffer;         // RELAY mode only
+        WaitSignal consumer_signal;                     // Feed workers -> consumer wakeups
+        std::vector<FeedWorker*> workers;               // Feeds routed to this shard
+        std::size_t next_lane = 0;                      // DIRECT mode round-robin cursor
+        LineArbiter arbiter;                            // A/B dedup for this shard's groups
+    };
+    
     MultiFeedConfig config_;
-    std::unique_ptr<MPSCRingBuffer> global_buffer_;
     std::vector<std::unique_ptr<FeedWorker>> workers_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::vector<std::size_t> shard_by_worker_;          // workers_ index -> shards_ index
     std::atomic<bool> should_stop_{false};
     std::thread health_monitor_thread_;
     
@@ -185,27 +331,65 @@ public:
     explicit FanInDispatcher(MultiFeedConfig config);
     ~FanInDispatcher();
     
-    // Lifecycle
-    void start();
+    // Lifecycle; counters (if any) registers the feed workers' threads
+    void start(PerformanceTracker* counters = nullptr);
     void stop();
     
-    // Consumer interface
-    bool try_consume_message(MultiFeedSlot& slot);
+    // Consumer interface; each shard must be drained by one thread only
+    bool try_consume_message(MultiFeedSlot& slot, std::size_t shard = 0);
+    
+    // In DIRECT mode each pass takes an equal share of max_count from every
+    // lane, starting one lane later on each call so no feed is favoured.
+    // Duplicates from arbitrated lines are removed before returning.
+    std::uint64_t try_consume_messages(MultiFeedSlot* slots, std::uint64_t max_count, std::size_t shard = 0);
+    
+    // Number of consumer shards (dispatcher_threads, capped at the number of independent feeds/groups)
+    std::size_t shard_count() const { return shards_.size(); }
+    
+    // Arbitration counters of one feed (zero unless it has an arbitration_group)
+    LineStats line_stats(std::uint32_t origin_id) const;
     
-    // Statistics and monitoring
+    // Signal notified on every push to a shard's buffer or lanes, for a parking consumer
+    WaitSignal& consumer_signal(std::size_t shard = 0) { return shards_[shard]->consumer_signal; }
+    
+    // Statistics and monitoring; the summary is printed by a MetricsExporter reporter
     void print_health_summary() const;
+    void register_metrics(MetricsRegistry& registry) const;
     std::uint64_t total_messages_received() const;
     
 private:
     void health_monitor_loop();
     void promote_backup_feeds();
+    void assign_shards();                               // Builds shards_ and routes each feed to one
+    std::uint64_t drain_lanes(Shard& shard, MultiFeedSlot* slots, std::uint64_t max_count);
+    std::uint64_t drain(Shard& shard, MultiFeedSlot* slots, std::uint64_t max_count);
 };
 
+inline std::ostream& operator<<(std::ostream& os, FanInMode mode) {
+    switch (mode) {
+        case FanInMode::RELAY: return os << "RELAY";
+        case FanInMode::DIRECT: return os << "DIRECT";
+    }
+    return os << "UNKNOWN_FAN_IN_MODE";
+}
+
+// Parses "relay" or "direct" (case-insensitive); throws std::invalid_argument otherwise
+FanInMode parse_fan_in_mode(const std::string& name);
+
 // Main multi-feed ingestion benchmark
 class MultiFeedIngestionBenchmark {
 private:
     MultiFeedConfig config_;
     std::unique_ptr<FanInDispatcher> dispatcher_;
+    std::vector<std::unique_ptr<JournalWriter>> journals_;  // One per shard when journaling is enabled
+    std::vector<std::unique_ptr<ShmRingWriter>> shm_rings_; // One per shard when the shared-memory ring is enabled
+    std::vector<std::unique_ptr<LatencyHistogram>> shard_latency_;  // Receive-to-consume, one writer each
+    std::unique_ptr<PerformanceTracker> thread_counters_;           // Set when config_.thread_counters
+    std::vector<std::unique_ptr<LastValueCache>> conflation_;       // One per shard when conflation is enabled
+    LatencyHistogram conflated_staleness_;                          // Receive-to-read age of conflated values
+    std::thread conflated_reader_;
+    MetricsRegistry metrics_;
+    MetricsExporter exporter_;                                      // Health summary and metrics export
     std::atomic<bool> should_stop_{false};
     
     // Global statistics
@@ -224,7 +408,11 @@ public:
     double elapsed_seconds() const { return benchmark_timer_.elapsed_seconds(); }
     
 private:
-    void consumer_loop();
+    // Drains one shard; shard 0 runs on the calling thread
+    void consumer_loop(std::size_t shard);
+    
+    // Slow consumer: reads the latest value per key of every shard each poll_interval_ms
+    void conflated_reader_loop();
     bool should_continue() const;
     void print_final_stats();
 };
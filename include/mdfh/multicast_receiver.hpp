@@ -0,0 +1,116 @@
+#pragma once
+
+#include "core.hpp"
+#include "ring_buffer.hpp"
+#include "ingestion.hpp"
+#include "kernel_bypass.hpp"
+#include "wait_strategy.hpp"
+#include <boost/asio.hpp>
+#include <atomic>
+#include <chrono>
+#include <span>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
+
+namespace mdfh {
+
+// Source of the per-datagram receive timestamp
+enum class RxTimestampSource {
+    USERSPACE,  // get_timestamp_ns() after the receive call returns
+    KERNEL,     // SO_TIMESTAMPNS: stamped by the kernel as the packet arrives
+    HARDWARE    // SO_TIMESTAMPING raw NIC stamp, kernel stamp if the NIC gives none
+};
+
+// Configuration for a multicast receive socket
+struct MulticastConfig {
+    std::vector<std::string> groups;            // Multicast groups to join (all on one port)
+    std::uint16_t port = 9001;
+    std::string interface = "0.0.0.0";          // Local interface address used for the joins
+    std::uint32_t batch_size = 32;              // Datagrams per recvmmsg call
+    std::uint32_t max_datagram_size = 2048;     // Larger datagrams are truncated and dropped
+    std::uint32_t socket_buffer_size = 8u << 20;    // SO_RCVBUF request (0 = kernel default)
+    WaitConfig wait;                            // Idle policy of run_io_loop (parks in ppoll)
+    RxTimestampSource timestamps = RxTimestampSource::KERNEL;
+
+    bool is_valid() const;
+};
+
+// UDP multicast receiver - joins every configured group on one socket and
+// drains it with recvmmsg, one syscall per batch of datagrams.
+// Kernel and NIC timestamps are CLOCK_REALTIME (hardware stamps assume the
+// PHC is disciplined to it, e.g. by phc2sys); they are shifted into the
+// get_timestamp_ns() clock so latency is measured from packet arrival.
+class MulticastReceiver {
+private:
+    MulticastConfig config_;
+    boost::asio::io_context ctx_;
+    boost::asio::ip::udp::socket socket_;
+    std::atomic<bool> should_stop_{false};
+
+    // Receive buffers, one max_datagram_size slot per batch entry (reused per call)
+    std::vector<std::uint8_t> buffers_;
+    std::vector<PacketDesc> packets_;
+#if defined(__linux__)
+    std::vector<mmsghdr> msgs_;
+    std::vector<iovec> iovecs_;
+    std::vector<std::uint8_t> control_;
+#endif
+    RxTimestampSource active_timestamps_ = RxTimestampSource::USERSPACE;
+
+    // Statistics
+    std::atomic<std::uint64_t> datagrams_received_{0};
+    std::atomic<std::uint64_t> datagrams_truncated_{0};
+
+public:
+    explicit MulticastReceiver(MulticastConfig config);
+    ~MulticastReceiver();
+
+    // Bind, join the groups and enable timestamping; throws boost::system::system_error
+    void open();
+    void close();
+    bool is_open() const { return socket_.is_open(); }
+
+    // Underlying socket, for backends that drive receives themselves (io_uring)
+    int native_handle() { return socket_.native_handle(); }
+
+    // Receives up to batch_size datagrams without blocking. The returned
+    // descriptors point into internal buffers valid until the next call.
+    std::span<const PacketDesc> receive_batch();
+
+    // Waits up to timeout for a datagram; returns false on timeout
+    bool wait_readable(std::chrono::microseconds timeout);
+
+    // Main I/O loop (runs in separate thread), same contract as NetworkClient
+    void run_io_loop(RingBuffer& ring, IngestionStats& stats, MessageParser& parser,
+                     ThreadCounters* counters = nullptr);
+
+    // Signal stop
+    void stop() { should_stop_ = true; }
+
+    const MulticastConfig& config() const { return config_; }
+    RxTimestampSource timestamp_source() const { return active_timestamps_; }
+    std::uint64_t datagrams_received() const { return datagrams_received_.load(); }
+    std::uint64_t datagrams_truncated() const { return datagrams_truncated_.load(); }
+
+private:
+    void enable_timestamps();
+};
+
+inline std::ostream& operator<<(std::ostream& os, RxTimestampSource source) {
+    switch (source) {
+        case RxTimestampSource::USERSPACE: return os << "USERSPACE";
+        case RxTimestampSource::KERNEL: return os << "KERNEL";
+        case RxTimestampSource::HARDWARE: return os << "HARDWARE";
+    }
+    return os << "UNKNOWN_TIMESTAMP_SOURCE";
+}
+
+// Parses "userspace", "kernel" or "hardware" (case-insensitive); throws std::invalid_argument otherwise
+RxTimestampSource parse_rx_timestamp_source(const std::string& name);
+
+} // namespace mdfh
@@ -2,45 +2,166 @@
 
 #include "core.hpp"
 #include "timing.hpp"
+#include "placement.hpp"
+#include "histogram.hpp"
+#include "metrics.hpp"
 #include <array>
 #include <atomic>
 #include <chrono>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 namespace mdfh {
 
-// Stage timestamps for detailed latency analysis
+// Stage timestamps of one sampled packet, following its first message from
+// the NIC to the consumer (get_timestamp_ns() clock; 0 = stage not reached)
 struct alignas(64) StageTimestamps {
-    std::uint64_t packet_rx;      // Hardware timestamp when packet received
-    std::uint64_t parse_start;    // Start of message parsing
-    std::uint64_t parse_end;      // End of message parsing
-    std::uint64_t ring_push;      // When message pushed to ring buffer
-    std::uint64_t ring_pop;       // When message popped from ring buffer
-    std::uint64_t process_end;    // End of message processing
-    
-    // Padding to ensure cache line alignment
-    char padding[8];
+    std::uint64_t packet_rx = 0;      // Hardware timestamp when packet received
+    std::uint64_t parse_start = 0;    // Start of message parsing
+    std::uint64_t parse_end = 0;      // End of message parsing
+    std::uint64_t ring_push = 0;      // When message published to ring buffer
+    std::uint64_t ring_pop = 0;       // When message popped from ring buffer
+    std::uint64_t process_end = 0;    // End of message processing
+    std::uint64_t ring_pos = 0;       // Ring position of the message (RingBuffer::write_position())
 };
 
-// Cache performance counters
-struct alignas(64) CacheStats {
-    std::atomic<std::uint64_t> l1_misses{0};
-    std::atomic<std::uint64_t> l2_misses{0};
-    std::atomic<std::uint64_t> l3_misses{0};
-    std::atomic<std::uint64_t> cache_references{0};
-    
-    // Padding to ensure cache line alignment
-    char padding[32];
+// Intervals between consecutive StageTimestamps fields
+enum class LatencyStage : std::size_t {
+    RX_TO_PARSE,    // packet_rx -> parse_start: backend delivery
+    PARSE,          // parse_start -> parse_end: decoding the packet
+    RING_PUBLISH,   // parse_end -> ring_push: rest of the burst until publish
+    RING_QUEUE,     // ring_push -> ring_pop: waiting for the consumer
+    PROCESS,        // ring_pop -> process_end: consumer batch
+    COUNT
+};
+
+inline constexpr std::size_t LATENCY_STAGE_COUNT = static_cast<std::size_t>(LatencyStage::COUNT);
+
+const char* latency_stage_name(LatencyStage stage);
+
+// Hardware events of a PerfCounterGroup (user space only)
+enum class PerfEvent : std::size_t {
+    CYCLES,
+    INSTRUCTIONS,
+    L1D_MISSES,     // L1 data cache read misses
+    LLC_MISSES,     // Last-level cache read misses
+    DTLB_MISSES,    // Data TLB read misses
+    BRANCH_MISSES,
+    COUNT
+};
+
+inline constexpr std::size_t PERF_EVENT_COUNT = static_cast<std::size_t>(PerfEvent::COUNT);
+using PerfCounts = std::array<std::uint64_t, PERF_EVENT_COUNT>;
+
+const char* perf_event_name(PerfEvent event);
+
+// How long a group was enabled and how long it was actually on the PMU.
+// A group needing more counters than are free (the NMI watchdog holds one)
+// is multiplexed (running < enabled) or never scheduled (running == 0).
+struct PerfTimes {
+    std::uint64_t enabled = 0;
+    std::uint64_t running = 0;
+    
+    bool counted() const { return running > 0; }
+    bool multiplexed() const { return running > 0 && running < enabled; }
+    double fraction() const { return enabled > 0 ? static_cast<double>(running) / static_cast<double>(enabled) : 0.0; }
+};
+
+// perf_event group counting the thread that opened it. The counters are
+// scheduled together, so ratios (IPC, misses per instruction) are coherent.
+// Each counter's page is mapped so read() can use rdpmc without a syscall;
+// counters the kernel does not expose that way are read with read(2).
+class PerfCounterGroup {
+public:
+    PerfCounterGroup() = default;
+    ~PerfCounterGroup();
+    
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+    
+    // Opens and enables the group for the calling thread; false if the cycle
+    // counter cannot be opened. Events the CPU lacks stay unavailable.
+    bool open();
+    void close();
+    
+    bool is_open() const { return counters_[0].fd >= 0; }
+    bool available(PerfEvent event) const { return counters_[static_cast<std::size_t>(event)].fd >= 0; }
+    bool user_rdpmc() const { return user_rdpmc_; }
+    
+    // Current counts (opening thread only; 0 for unavailable events)
+    PerfCounts read() const;
+    
+    // Enabled and running time of the group so far (read(2) on the leader)
+    PerfTimes times() const;
+    
+private:
+    struct Counter {
+        int fd = -1;
+        void* page = nullptr;           // perf_event_mmap_page
+    };
+    
+    std::array<Counter, PERF_EVENT_COUNT> counters_;
+    bool user_rdpmc_{false};
+    
+    std::uint64_t read_counter(const Counter& counter) const;
+};
+
+// Hardware counters of one pipeline thread. The owning thread opens the
+// group and publishes its counts with its message count now and then;
+// reporters read the published totals from any thread.
+class ThreadCounters {
+public:
+    // Owning-thread calls between samples
+    static constexpr std::uint32_t SAMPLE_INTERVAL = 1024;
+    
+    explicit ThreadCounters(std::string name) : name_(std::move(name)) {}
+    
+    // Owning thread: opens the group; counts start from here
+    bool open();
+    
+    // Owning thread: publishes counts since open() and messages handled so
+    // far; counts of a multiplexed group are scaled to the enabled time
+    void sample(std::uint64_t messages);
+    
+    // Owning thread, once per loop iteration or batch: samples every SAMPLE_INTERVAL calls
+    void maybe_sample(std::uint64_t messages) {
+        if (--countdown_ == 0) {
+            countdown_ = SAMPLE_INTERVAL;
+            sample(messages);
+        }
+    }
+    
+    // Any thread
+    const std::string& name() const { return name_; }
+    bool available(PerfEvent event) const { return group_.available(event); }
+    bool user_rdpmc() const { return group_.user_rdpmc(); }
+    std::uint64_t messages() const { return messages_.load(std::memory_order_relaxed); }
+    PerfCounts totals() const;
+    PerfTimes times() const;
+    
+private:
+    std::string name_;
+    PerfCounterGroup group_;
+    PerfCounts baseline_{};
+    PerfTimes baseline_times_{};
+    std::uint32_t countdown_{SAMPLE_INTERVAL};
+    
+    std::array<std::atomic<std::uint64_t>, PERF_EVENT_COUNT> totals_{};
+    std::atomic<std::uint64_t> enabled_ns_{0};
+    std::atomic<std::uint64_t> running_ns_{0};
+    std::atomic<std::uint64_t> messages_{0};
 };
 
 // Performance tracking configuration
 struct PerformanceConfig {
     bool enable_hardware_timestamps = true;
-    bool enable_cache_analysis = true;
+    bool enable_cache_analysis = true;       // perf_event counter group per attached thread
     bool enable_detailed_latency = true;
-    std::uint32_t sampling_rate = 1000;  // Sample every Nth packet
+    std::uint32_t sampling_rate = 1000;  // Trace every Nth packet through all stages
     std::uint32_t max_samples = 1000000; // Maximum samples to store (pre-allocated)
+    MemoryPlacement sample_memory;       // Backing of the sample buffer
 };
 
 class PerformanceTracker {
@@ -48,59 +169,101 @@ private:
     PerformanceConfig config_;
     
     // Pre-allocated circular buffer for timestamp samples (ZERO ALLOCATION IN HOT PATH)
-    std::vector<StageTimestamps> timestamp_samples_;
+    PlacedArray<StageTimestamps> timestamp_samples_;
     alignas(64) std::atomic<std::uint64_t> sample_write_pos_{0};
-    alignas(64) std::atomic<std::uint64_t> sample_count_{0};
     std::uint64_t sample_mask_;
     
-    CacheStats cache_stats_;
+    // End-to-end latency of every completed trace (ns); percentiles come from here
+    LatencyHistogram latency_;
+    
+    // Per-stage latency of every traced packet (ns)
+    std::array<LatencyHistogram, LATENCY_STAGE_COUNT> stage_latency_;
+    
+    // Sampling decision, made by the parsing thread once per packet
+    std::uint64_t packet_count_{0};
+    
+    // Traces handed from the parsing thread to the consumer, oldest first (SPSC)
+    static constexpr std::size_t MAX_PENDING_TRACES = 256;
+    std::array<StageTimestamps, MAX_PENDING_TRACES> pending_traces_;
+    alignas(64) std::atomic<std::uint64_t> trace_tail_{0};   // Written by the parsing thread
+    alignas(64) std::atomic<std::uint64_t> trace_head_{0};   // Written by the consumer
     
-    // Hardware performance counter handles
-    void* perf_fd_{nullptr};
+    // Pipeline threads with hardware counters, in attach order
+    mutable std::mutex threads_mutex_;
+    std::vector<std::unique_ptr<ThreadCounters>> threads_;
     
 public:
     explicit PerformanceTracker(const PerformanceConfig& config = PerformanceConfig());
     ~PerformanceTracker();
     
-    // Initialize hardware performance counters
-    bool initialize();
+    // Parsing thread: true if this packet should be traced through every stage
+    bool sample_packet() {
+        return config_.enable_detailed_latency && packet_count_++ % config_.sampling_rate == 0;
+    }
     
-    // Record timestamps for a processing stage (ZERO ALLOCATION - HOT PATH)
+    // Parsing thread: queues a trace stamped up to ring_push for the consumer
+    // to finish. ring_pos is the position of the packet's first message.
+    void begin_trace(const StageTimestamps& timestamps);
+    
+    // Consumer: true if a queued trace's message lies before end_pos
+    bool trace_due(std::uint64_t end_pos) const {
+        auto head = trace_head_.load(std::memory_order_relaxed);
+        return head != trace_tail_.load(std::memory_order_acquire) &&
+               pending_traces_[head % MAX_PENDING_TRACES].ring_pos < end_pos;
+    }
+    
+    // Consumer: finishes the traces of messages in [first_pos, first_pos + count)
+    // with the batch's pop and process-end stamps
+    void complete_traces(std::uint64_t first_pos, std::uint64_t count,
+                         std::uint64_t ring_pop, std::uint64_t process_end);
+    
+    // Record a (possibly partial) trace: every stage whose two stamps are set,
+    // end-to-end latency once process_end is set (ZERO ALLOCATION - HOT PATH)
     void record_timestamp(const StageTimestamps& timestamps);
     
-    // Update cache statistics
-    void update_cache_stats();
+    // Opens a counter group for the calling thread under name (cold path).
+    // Returns null when cache analysis is disabled or perf_event is refused;
+    // the pointer stays valid for the tracker's lifetime.
+    ThreadCounters* attach_thread(const std::string& name);
     
     // Get latency statistics
     struct LatencyStats {
-        double p50, p90, p95, p99, p99_9;
+        double p50, p90, p95, p99, p99_9, p99_99;
         double mean;
+        double max;
         std::uint64_t samples;
     };
     
     LatencyStats get_latency_stats() const;
+    LatencyStats get_stage_latency_stats(LatencyStage stage) const;
+    const LatencyHistogram& latency_histogram() const { return latency_; }
+    const LatencyHistogram& stage_histogram(LatencyStage stage) const {
+        return stage_latency_[static_cast<std::size_t>(stage)];
+    }
     
-    // Get cache statistics
-    struct CacheMetrics {
-        double l1_miss_rate;
-        double l2_miss_rate;
-        double l3_miss_rate;
-        std::uint64_t total_references;
+    // Published hardware counters of each attached thread
+    struct ThreadMetrics {
+        std::string name;
+        std::uint64_t messages;
+        PerfCounts counts;              // Scaled if the group was multiplexed
+        PerfTimes times;
+        std::array<bool, PERF_EVENT_COUNT> available;
+        bool user_rdpmc;
+        
+        double ipc() const;
+        double per_message(PerfEvent event) const;
     };
     
-    CacheMetrics get_cache_metrics() const;
+    std::vector<ThreadMetrics> get_thread_metrics() const;
     
     // Print detailed performance report
     void print_performance_report() const;
     
-private:
-    // Helper methods for hardware performance counters
-    bool setup_perf_counters();
-    void read_perf_counters();
-    void close_perf_counters();
+    // Exports the end-to-end and per-stage latency histograms
+    void register_metrics(MetricsRegistry& registry) const;
     
-    // Calculate latency percentiles
-    double calculate_percentile(const std::vector<double>& latencies, double percentile) const;
+private:
+    static LatencyStats latency_stats_from(const LatencyHistogram& histogram);
     
     // Get current samples for analysis (creates temporary vector)
     std::vector<StageTimestamps> get_current_samples() const;
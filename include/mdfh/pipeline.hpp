@@ -0,0 +1,313 @@
+#pragma once
+
+#include "decoding.hpp"
+#include "histogram.hpp"
+#include "ingestion.hpp"
+#include "kernel_bypass.hpp"
+#include "multicast_receiver.hpp"
+#include "ring_buffer.hpp"
+#include "timing.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mdfh {
+
+// Statically composed ingestion path: source -> decoder -> queue -> sink,
+// with a statistics policy. Every stage is a template parameter used through
+// its concrete type, so parse, push and consume inline into the producer and
+// consumer loops with no virtual call or std::function per message, and a
+// NullStats pipeline carries no statistics code at all.
+//
+// Stage requirements:
+//   Source   std::size_t poll(Fn&& on_burst), calling on_burst(std::span<const PacketDesc>)
+//            at most once and returning the number of packets delivered
+//   Decoder  DecodeCounts decode(const std::uint8_t*, std::size_t, std::uint64_t rx_ts, Queue&)
+//            (BinaryDecoder, ITCHDecoder, FIXDecoder; VirtualDecoder adapts a MessageDecoder)
+//   Queue    RingBuffer, or anything with its hold_commits/publish/consume_batch
+//   Sink     void operator()(const Slot&) (std::function works too, at one indirect call per message)
+//   Stats    NullStats, CountingStats or IngestionStatsAdapter (see below)
+//
+// The virtual interfaces stay available as adapters: VirtualDecoder wraps a
+// MessageDecoder, IngestionStatsAdapter feeds an IngestionStats, and a
+// push-based producer uses PushSource and calls ingest() itself, e.g. from a
+// KernelBypassClient's BatchPacketHandler (one std::function call per burst,
+// not per message).
+//
+// IngestionBenchmark (TCP) runs on a Pipeline. BypassIngestionClient and the
+// multi-feed handlers still decode through MessageParser.
+
+// Statistics policies. on_decoded runs on the producer once per burst;
+// on_processed on the consumer once per message, with one timestamp per
+// consumed batch if the policy asks for it (RECORDS_LATENCY).
+
+// Records nothing; every call compiles away
+struct NullStats {
+    static constexpr bool RECORDS_LATENCY = false;
+
+    void on_decoded(std::uint64_t, const DecodeCounts&) {}
+    void on_processed(const Slot&, std::uint64_t) {}
+};
+
+// Counters and latency histogram filled by CountingStats. Each side owns its
+// cache line and updates it with plain relaxed stores; any thread may read.
+class PipelineCounters {
+public:
+    std::uint64_t bytes_received() const { return bytes_.load(std::memory_order_relaxed); }
+    std::uint64_t messages_received() const { return received_.load(std::memory_order_relaxed); }
+    std::uint64_t messages_dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    std::uint64_t messages_malformed() const { return malformed_.load(std::memory_order_relaxed); }
+    std::uint64_t messages_processed() const { return processed_.load(std::memory_order_relaxed); }
+    std::uint64_t gap_count() const { return gaps_.load(std::memory_order_relaxed); }
+    const LatencyHistogram& latency() const { return latency_; }
+
+private:
+    friend class CountingStats;
+
+    static void bump(std::atomic<std::uint64_t>& counter, std::uint64_t n) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    // Producer
+    alignas(64) std::atomic<std::uint64_t> bytes_{0};
+    std::atomic<std::uint64_t> received_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::atomic<std::uint64_t> malformed_{0};
+
+    // Consumer
+    alignas(64) std::atomic<std::uint64_t> processed_{0};
+    std::atomic<std::uint64_t> gaps_{0};
+    std::uint64_t expected_seq_{0};
+    LatencyHistogram latency_;
+};
+
+// Inline counting into a PipelineCounters: message counts, sequence gaps
+// and receive-to-consume latency without a virtual call
+class CountingStats {
+public:
+    static constexpr bool RECORDS_LATENCY = true;
+
+    explicit CountingStats(PipelineCounters& counters) : counters_(&counters) {}
+
+    void on_decoded(std::uint64_t bytes, const DecodeCounts& counts) {
+        PipelineCounters::bump(counters_->bytes_, bytes);
+        PipelineCounters::bump(counters_->received_, counts.decoded);
+        if (counts.dropped + counts.malformed > 0) {
+            PipelineCounters::bump(counters_->dropped_, counts.dropped);
+            PipelineCounters::bump(counters_->malformed_, counts.malformed);
+        }
+    }
+
+    void on_processed(const Slot& slot, std::uint64_t now_ns) {
+        auto& c = *counters_;
+        if (c.expected_seq_ != 0 && slot.raw.seq != c.expected_seq_) {
+            PipelineCounters::bump(c.gaps_, 1);
+        }
+        c.expected_seq_ = slot.raw.seq + 1;
+        PipelineCounters::bump(c.processed_, 1);
+        c.latency_.record(now_ns > slot.rx_ts ? now_ns - slot.rx_ts : 0);
+    }
+
+    PipelineCounters& counters() const { return *counters_; }
+
+private:
+    PipelineCounters* counters_;
+};
+
+// Adapter onto the virtual IngestionStats, for pipelines reported through
+// its periodic/final output and metrics export
+class IngestionStatsAdapter {
+public:
+    static constexpr bool RECORDS_LATENCY = false;       // record_message_processed stamps each message
+
+    explicit IngestionStatsAdapter(IngestionStats& stats) : stats_(&stats) {}
+
+    void on_decoded(std::uint64_t bytes, const DecodeCounts& counts) {
+        stats_->record_bytes_received(bytes);
+        MessageParser::record_counts(counts, *stats_);
+    }
+
+    void on_processed(const Slot& slot, std::uint64_t) { stats_->record_message_processed(slot); }
+
+    IngestionStats& stats() const { return *stats_; }
+
+private:
+    IngestionStats* stats_;
+};
+
+// Adapter onto the virtual MessageDecoder, for an encoding picked at runtime
+// without specializing the pipeline (one virtual call per burst packet)
+class VirtualDecoder {
+public:
+    explicit VirtualDecoder(EncodingType encoding) : decoder_(create_decoder(encoding)) {}
+    explicit VirtualDecoder(std::unique_ptr<MessageDecoder> decoder) : decoder_(std::move(decoder)) {}
+
+    DecodeCounts decode(const std::uint8_t* data, std::size_t size, std::uint64_t rx_ts, RingBuffer& ring) {
+        return decoder_->decode(data, size, rx_ts, ring);
+    }
+    void reset() { decoder_->reset(); }
+
+private:
+    std::unique_ptr<MessageDecoder> decoder_;
+};
+
+// Calls fn with std::type_identity of the concrete decoder type for encoding,
+// so a runtime choice still yields a fully specialized pipeline that builds
+// its decoder in place; fn must return the same type for every decoder
+// (typically a generic lambda)
+template <typename Fn>
+decltype(auto) with_decoder(EncodingType encoding, Fn&& fn) {
+    switch (encoding) {
+        case EncodingType::FIX: return std::forward<Fn>(fn)(std::type_identity<FIXDecoder>{});
+        case EncodingType::ITCH: return std::forward<Fn>(fn)(std::type_identity<ITCHDecoder>{});
+        case EncodingType::BINARY: break;
+    }
+    return std::forward<Fn>(fn)(std::type_identity<BinaryDecoder>{});
+}
+
+// Source of a pipeline fed through ingest() by a push-based producer (a
+// socket read loop, a KernelBypassClient handler); such a pipeline has no
+// produce()
+struct PushSource {};
+
+// Source draining a MulticastReceiver: one recvmmsg per poll, each datagram
+// stamped with its own arrival time
+class MulticastSource {
+public:
+    explicit MulticastSource(MulticastReceiver& receiver) : receiver_(&receiver) {}
+
+    template <typename Fn>
+    std::size_t poll(Fn&& on_burst) {
+        auto packets = receiver_->receive_batch();
+        if (!packets.empty()) {
+            on_burst(packets);
+        }
+        return packets.size();
+    }
+
+    MulticastReceiver& receiver() const { return *receiver_; }
+
+private:
+    MulticastReceiver* receiver_;
+};
+
+// Source replaying packets already in memory, burst packets per poll and
+// cycling until limit packets were delivered (0 = forever). The packet
+// bytes are owned by the caller.
+class BufferSource {
+public:
+    explicit BufferSource(std::vector<PacketDesc> packets, std::size_t burst = 32, std::uint64_t limit = 0)
+        : packets_(std::move(packets)), burst_(std::max<std::size_t>(burst, 1)), limit_(limit) {}
+
+    template <typename Fn>
+    std::size_t poll(Fn&& on_burst) {
+        if (exhausted()) {
+            return 0;
+        }
+        auto left = limit_ > 0 ? limit_ - delivered_ : std::numeric_limits<std::uint64_t>::max();
+        auto count = static_cast<std::size_t>(std::min<std::uint64_t>({burst_, packets_.size() - next_, left}));
+        on_burst(std::span<const PacketDesc>(packets_.data() + next_, count));
+        next_ = (next_ + count) % packets_.size();
+        delivered_ += count;
+        return count;
+    }
+
+    bool exhausted() const { return packets_.empty() || (limit_ > 0 && delivered_ >= limit_); }
+    std::uint64_t delivered() const { return delivered_; }
+
+private:
+    std::vector<PacketDesc> packets_;
+    std::size_t burst_;
+    std::uint64_t limit_;
+    std::size_t next_ = 0;
+    std::uint64_t delivered_ = 0;
+};
+
+template <typename Source, typename Decoder, typename Queue, typename Sink, typename Stats = NullStats>
+class Pipeline {
+public:
+    Pipeline(Source source, Decoder decoder, Queue& queue, Sink sink, Stats stats = {})
+        : source_(std::move(source)), decoder_(std::move(decoder)), queue_(queue),
+          sink_(std::move(sink)), stats_(std::move(stats)) {}
+
+    // Default-constructs the decoder in place (see with_decoder)
+    Pipeline(Source source, std::type_identity<Decoder>, Queue& queue, Sink sink, Stats stats = {})
+        : source_(std::move(source)), decoder_(), queue_(queue),
+          sink_(std::move(sink)), stats_(std::move(stats)) {}
+
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    // Producer thread: polls the source once and ingests what it delivered;
+    // returns the number of packets
+    std::size_t produce() {
+        return source_.poll([this](std::span<const PacketDesc> packets) { ingest(packets); });
+    }
+
+    // Producer thread: decodes a burst into the queue, published with one
+    // release store. Packets without a receive stamp share one per burst.
+    // The caller keeps ownership of the packets (release_packet etc.).
+    DecodeCounts ingest(std::span<const PacketDesc> packets) {
+        DecodeCounts total;
+        if (packets.empty()) {
+            return total;
+        }
+
+        const auto burst_ts = get_timestamp_ns();
+        std::uint64_t bytes = 0;
+        queue_.hold_commits();
+        for (const auto& packet : packets) {
+            auto counts = decoder_.decode(packet.data, packet.length,
+                                          packet.timestamp_ns != 0 ? packet.timestamp_ns : burst_ts, queue_);
+            total.decoded += counts.decoded;
+            total.dropped += counts.dropped;
+            total.malformed += counts.malformed;
+            bytes += packet.length;
+        }
+        queue_.publish();
+
+        stats_.on_decoded(bytes, total);
+        return total;
+    }
+
+    // Producer thread: decodes one chunk of a byte stream (e.g. a TCP read)
+    DecodeCounts ingest(const std::uint8_t* data, std::size_t size, std::uint64_t rx_ts) {
+        auto counts = decoder_.decode(data, size, rx_ts, queue_);
+        stats_.on_decoded(size, counts);
+        return counts;
+    }
+
+    // Consumer thread: hands up to max_count queued messages to the sink
+    std::uint64_t consume(std::uint64_t max_count) {
+        std::uint64_t now_ns = 0;
+        if constexpr (Stats::RECORDS_LATENCY) {
+            now_ns = get_timestamp_ns();
+        }
+        return queue_.consume_batch([this, now_ns](const Slot& slot) {
+            stats_.on_processed(slot, now_ns);
+            sink_(slot);
+        }, max_count);
+    }
+
+    Source& source() { return source_; }
+    Decoder& decoder() { return decoder_; }
+    Queue& queue() { return queue_; }
+    Sink& sink() { return sink_; }
+    Stats& stats() { return stats_; }
+
+private:
+    [[no_unique_address]] Source source_;
+    Decoder decoder_;
+    Queue& queue_;
+    [[no_unique_address]] Sink sink_;
+    [[no_unique_address]] Stats stats_;
+};
+
+} // namespace mdfh
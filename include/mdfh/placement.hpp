@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mdfh {
+
+// Page backing for large buffers
+enum class HugePageMode {
+    NONE,           // Regular 4KB pages
+    TRANSPARENT,    // 2MB-aligned mapping with MADV_HUGEPAGE (THP, no reservation needed)
+    HUGE_2MB,       // MAP_HUGETLB from the 2MB pool (vm.nr_hugepages)
+    HUGE_1GB        // MAP_HUGETLB from the 1GB pool (hugepagesz=1G at boot)
+};
+
+// Where and how a buffer's memory is placed
+struct MemoryPlacement {
+    HugePageMode huge_pages = HugePageMode::NONE;
+    int numa_node = -1;         // Bind pages to this node (-1 = first touch by the allocating thread)
+    bool prefault = true;       // Touch every page at allocation so the hot path never faults
+};
+
+// Anonymous mapping placed per MemoryPlacement. Hugepage requests that the
+// system cannot satisfy fall back (1GB -> 2MB -> THP -> regular pages) with
+// a warning, so a misconfigured host runs slower instead of failing.
+class MappedRegion {
+private:
+    void* data_ = nullptr;
+    std::size_t size_ = 0;
+    HugePageMode backing_ = HugePageMode::NONE;
+
+public:
+    MappedRegion() = default;
+
+    // Throws std::bad_alloc if no mapping at all can be created
+    MappedRegion(std::size_t bytes, const MemoryPlacement& placement);
+    ~MappedRegion();
+
+    MappedRegion(const MappedRegion&) = delete;
+    MappedRegion& operator=(const MappedRegion&) = delete;
+
+    MappedRegion(MappedRegion&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0)),
+          backing_(other.backing_) {}
+
+    MappedRegion& operator=(MappedRegion&& other) noexcept {
+        if (this != &other) {
+            release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            backing_ = other.backing_;
+        }
+        return *this;
+    }
+
+    void* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+    // Backing actually obtained after any fallback
+    HugePageMode backing() const { return backing_; }
+
+private:
+    void release();
+};
+
+// Fixed-size array of default-constructed T living in a MappedRegion.
+// Used for ring storage in place of std::vector so the slots can sit on
+// hugepages local to the threads that use them.
+template <typename T>
+class PlacedArray {
+private:
+    MappedRegion region_;
+    T* data_ = nullptr;
+    std::size_t size_ = 0;
+
+public:
+    PlacedArray() = default;
+
+    PlacedArray(std::size_t size, const MemoryPlacement& placement)
+        : region_(size * sizeof(T), placement), size_(size) {
+        static_assert(alignof(T) <= 4096, "PlacedArray relies on page alignment");
+        data_ = static_cast<T*>(region_.data());
+        for (std::size_t i = 0; i < size_; ++i) {
+            new (data_ + i) T();
+        }
+    }
+
+    ~PlacedArray() { destroy(); }
+
+    PlacedArray(const PlacedArray&) = delete;
+    PlacedArray& operator=(const PlacedArray&) = delete;
+
+    PlacedArray(PlacedArray&& other) noexcept
+        : region_(std::move(other.region_)),
+          data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0)) {}
+
+    PlacedArray& operator=(PlacedArray&& other) noexcept {
+        if (this != &other) {
+            destroy();
+            region_ = std::move(other.region_);
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    T& operator[](std::size_t i) { return data_[i]; }
+    const T& operator[](std::size_t i) const { return data_[i]; }
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    HugePageMode backing() const { return region_.backing(); }
+
+private:
+    void destroy() {
+        for (std::size_t i = 0; i < size_; ++i) {
+            data_[i].~T();
+        }
+        size_ = 0;
+    }
+};
+
+// Pins the calling thread to cpu_core; returns false if the kernel refuses
+bool set_cpu_affinity(std::uint32_t cpu_core);
+
+// Pins the calling thread when cpu_core >= 0, logging a warning on failure
+void pin_current_thread(int cpu_core, const std::string& thread_name);
+
+// CPUs the calling thread may run on (sched_getaffinity); empty if unknown
+std::vector<int> current_cpu_affinity();
+
+// NUMA node of a CPU, or -1 if unknown (non-Linux, offline CPU)
+int numa_node_of_cpu(int cpu_core);
+
+inline std::ostream& operator<<(std::ostream& os, HugePageMode mode) {
+    switch (mode) {
+        case HugePageMode::NONE: return os << "NONE";
+        case HugePageMode::TRANSPARENT: return os << "TRANSPARENT";
+        case HugePageMode::HUGE_2MB: return os << "HUGE_2MB";
+        case HugePageMode::HUGE_1GB: return os << "HUGE_1GB";
+    }
+    return os << "UNKNOWN_HUGE_PAGE_MODE";
+}
+
+inline std::ostream& operator<<(std::ostream& os, const MemoryPlacement& placement) {
+    os << placement.huge_pages;
+    if (placement.numa_node >= 0) {
+        os << " on node " << placement.numa_node;
+    }
+    return os << (placement.prefault ? ", prefaulted" : "");
+}
+
+// Parses "none", "thp" / "transparent", "2mb" or "1gb" (case-insensitive);
+// throws std::invalid_argument otherwise
+HugePageMode parse_huge_page_mode(const std::string& name);
+
+} // namespace mdfh
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "core.hpp"
+#include "journal.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <string>
+
+namespace mdfh {
+
+// Recording formats a ReplaySource can read
+enum class ReplayFormat {
+    AUTO,       // Directory = journal, file = pcap
+    JOURNAL,    // JournalWriter segment directory
+    PCAP        // Classic libpcap capture (pcapng is not supported)
+};
+
+// Replay configuration
+struct ReplayConfig {
+    std::string path;                   // Journal directory or pcap file (empty = synthetic traffic)
+    ReplayFormat format = ReplayFormat::AUTO;
+    double speed = 1.0;                 // Multiple of the recorded pace (0 = as fast as possible)
+    bool loop = false;                  // Start over at the end instead of finishing
+    int origin_id = -1;                 // Journal: only this feed (-1 = all)
+    std::uint16_t port = 0;             // Pcap: only UDP/TCP payloads to this port (0 = all)
+
+    bool enabled() const { return !path.empty(); }
+    bool is_valid() const { return speed >= 0.0 && origin_id <= 0xFFFF; }
+};
+
+std::ostream& operator<<(std::ostream& os, ReplayFormat format);
+std::ostream& operator<<(std::ostream& os, const ReplayConfig& config);
+
+// Parses "auto", "journal" or "pcap"; throws std::invalid_argument otherwise
+ReplayFormat parse_replay_format(const std::string& name);
+
+// One recorded unit: a journaled message or one captured packet's payload.
+// bytes points into the mapped recording and stays valid for the source's lifetime.
+struct ReplayEvent {
+    std::uint64_t timestamp_ns = 0;
+    std::span<const std::uint8_t> bytes;
+    std::uint32_t messages = 1;         // Binary messages carried (journal: 1, capture: payload / sizeof(Msg))
+};
+
+// Maps recorded timestamps onto the wall clock at a speed multiple.
+// The first timestamp seen anchors the timeline; restart() re-anchors it.
+class ReplayPacer {
+private:
+    double speed_;
+    bool anchored_ = false;
+    std::uint64_t base_ts_ = 0;
+    std::chrono::steady_clock::time_point start_;
+
+public:
+    explicit ReplayPacer(double speed) : speed_(speed) {}
+
+    void restart() { anchored_ = false; }
+
+    std::chrono::steady_clock::time_point deadline(std::uint64_t timestamp_ns) {
+        if (!anchored_) {
+            anchored_ = true;
+            base_ts_ = timestamp_ns;
+            start_ = std::chrono::steady_clock::now();
+        }
+        // Timestamps from several feeds may interleave slightly out of order
+        auto delta = timestamp_ns > base_ts_ ? timestamp_ns - base_ts_ : 0;
+        return start_ + std::chrono::nanoseconds(static_cast<std::int64_t>(static_cast<double>(delta) / speed_));
+    }
+
+    bool unpaced() const { return speed_ <= 0.0; }
+    
+    // Sleeps through long gaps, then spins the last stretch for precision
+    static void wait_until(std::chrono::steady_clock::time_point due);
+};
+
+// Streams a recorded journal or pcap file in recorded order with the
+// original, scaled or unthrottled timing. The recording is mmapped and
+// events reference it directly, so sending them is zero-copy.
+class ReplaySource {
+public:
+    explicit ReplaySource(ReplayConfig config);  // throws std::runtime_error if the recording can't be read
+    ~ReplaySource();
+
+    ReplaySource(const ReplaySource&) = delete;
+    ReplaySource& operator=(const ReplaySource&) = delete;
+
+    // Fills out with the next events. Waits for the first one to fall due
+    // (at most MAX_WAIT, so callers can check their stop conditions), then
+    // adds the following events that are already due. Returns 0 if nothing
+    // was due yet or the recording is over (finished()).
+    std::size_t next_batch(std::span<ReplayEvent> out);
+
+    bool finished() const { return finished_; }
+
+    // Back to the first event; the next batch re-anchors the timeline
+    void rewind();
+
+    ReplayFormat format() const { return format_; }
+    const ReplayConfig& config() const { return config_; }
+
+    // Statistics
+    std::uint64_t events_replayed() const { return events_replayed_; }
+    std::uint64_t passes() const { return passes_; }
+    std::uint64_t skipped_packets() const { return skipped_packets_; }  // Pcap frames without a usable payload
+
+    static constexpr std::chrono::milliseconds MAX_WAIT{100};
+
+private:
+    ReplayConfig config_;
+    ReplayFormat format_;
+    ReplayPacer pacer_;
+
+    // Journal recording
+    std::unique_ptr<JournalReader> journal_;
+    std::size_t segment_ = 0;
+    std::uint64_t record_ = 0;
+
+    // Pcap recording
+    const std::uint8_t* pcap_ = nullptr;
+    std::size_t pcap_bytes_ = 0;
+    std::size_t pcap_offset_ = 0;
+    std::uint32_t link_type_ = 0;
+    bool swapped_ = false;
+    bool nanosecond_ = false;
+
+    ReplayEvent pending_;
+    bool has_pending_ = false;
+    bool finished_ = false;
+
+    std::uint64_t events_replayed_ = 0;
+    std::uint64_t pass_events_ = 0;
+    std::uint64_t passes_ = 0;
+    std::uint64_t skipped_packets_ = 0;
+
+    void open_pcap();
+    void reset_position();
+    bool read_next(ReplayEvent& event);
+    bool read_journal(ReplayEvent& event);
+    bool read_pcap(ReplayEvent& event);
+    bool take(ReplayEvent& event);
+};
+
+} // namespace mdfh
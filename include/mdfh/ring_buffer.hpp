@@ -1,10 +1,14 @@
 #pragma once
 
 #include "core.hpp"
+#include "placement.hpp"
+#include "wait_strategy.hpp"
 #include <vector>
 #include <atomic>
 #include <stdexcept>
 #include <memory>
+#include <span>
+#include <algorithm>
 
 namespace mdfh {
 
@@ -62,6 +66,7 @@ static_assert(sizeof(Slot) <= 128, "Slot should not exceed 128 bytes");
  * - Cache-line aligned slots to prevent false sharing
  * - Memory prefetching for improved performance
  * - Bulk operations for batch processing
+ * - In-place claim/commit and peek/release for zero-copy producers and consumers
  * - Back-pressure handling modes
  * 
  * @note This implementation assumes single producer and single consumer threads
@@ -78,20 +83,35 @@ public:
     };
 
 private:
-    std::vector<Slot> slots_;
+    PlacedArray<Slot> slots_;
+    std::uint64_t capacity_;
+    std::uint64_t mask_;
+    
+    // Producer cache line: write index plus producer-local state. The cached
+    // read index is only refreshed when it makes the buffer look full.
     alignas(64) std::atomic<std::uint64_t> write_pos_{0};
+    std::uint64_t cached_read_pos_{0};
+    std::uint64_t claimed_{0};
+    std::uint64_t held_{0};             // Committed but not yet published (hold_commits)
+    bool holding_{false};
+    WaitSignal* consumer_signal_{nullptr};
+    
+    // Consumer cache line: read index plus consumer-local state. The cached
+    // write index is only refreshed when it makes the buffer look empty.
     alignas(64) std::atomic<std::uint64_t> read_pos_{0};
+    std::uint64_t cached_write_pos_{0};
+    std::uint64_t peeked_{0};
+    
     alignas(64) std::atomic<std::uint64_t> high_water_mark_{0};
-    std::uint64_t capacity_;
-    std::uint64_t mask_;
 
 public:
     /**
      * @brief Constructs a ring buffer with the specified capacity
      * @param capacity Buffer capacity (must be a power of 2)
+     * @param placement Page size, NUMA node and prefaulting of the slot storage
      * @throws std::invalid_argument if capacity is not a power of 2
      */
-    explicit RingBuffer(std::uint64_t capacity);
+    explicit RingBuffer(std::uint64_t capacity, const MemoryPlacement& placement = {});
     
     /**
      * @brief Destructor
@@ -154,6 +174,17 @@ public:
      */
     std::uint64_t try_pop_bulk(Slot* slots, std::uint64_t max_count);
     
+    /**
+     * @brief Consumes up to max_count slots in place with a callback
+     * @param fn Callable invoked as fn(const Slot&) for each slot, in order
+     * @param max_count Maximum number of slots to consume
+     * @return Number of slots consumed
+     * @note read_pos_ is published once per batch rather than once per slot
+     * @note Thread-safe for single consumer
+     */
+    template <typename Fn>
+    std::uint64_t consume_batch(Fn&& fn, std::uint64_t max_count);
+    
     /**
      * @brief Push with back-pressure handling
      * @param slot The slot to push
@@ -174,6 +205,8 @@ public:
     /**
      * @brief Gets the high water mark (maximum size reached)
      * @return High water mark value
+     * @note Sampled whenever either side refreshes its cached index, which is
+     *       exact when the buffer approaches full or the consumer falls behind
      */
     std::uint64_t high_water_mark() const;
     
@@ -183,6 +216,12 @@ public:
      */
     std::uint64_t capacity() const { return capacity_; }
     
+    /**
+     * @brief Gets the page backing of the slot storage
+     * @return Backing actually obtained (after any hugepage fallback)
+     */
+    HugePageMode memory_backing() const { return slots_.backing(); }
+    
     /**
      * @brief Checks if the buffer is empty
      * @return true if empty, false otherwise
@@ -203,45 +242,153 @@ public:
         return static_cast<double>(size()) / static_cast<double>(capacity_); 
     }
     
-    // Zero-copy access for high-performance scenarios
-    // WARNING: These methods are not thread-safe and should only be used
-    // by the producer thread with careful synchronization
+    /**
+     * @brief Gets the index mask for wrapping
+     * @return Index mask (capacity - 1)
+     */
+    std::uint64_t mask() const { return mask_; }
     
     /**
-     * @brief Gets direct access to the slot array (UNSAFE)
-     * @return Pointer to the slot array
-     * @warning Only use this for zero-copy scenarios with proper synchronization
+     * @brief Position the next pushed or claimed slot will take (producer only)
+     * @return Slots written since construction, including held commits
+     * @note Positions never wrap; position p lives at index p & mask()
      */
-    Slot* slots() { return slots_.data(); }
+    std::uint64_t write_position() const { return producer_pos(); }
     
     /**
-     * @brief Gets the current write position (UNSAFE)
-     * @return Current write position
-     * @warning Only use this for zero-copy scenarios with proper synchronization
+     * @brief Position of the next slot try_pop() or peek() returns (consumer only)
+     * @return Slots read since construction
      */
-    std::uint64_t write_pos() const { return write_pos_.load(std::memory_order_relaxed); }
+    std::uint64_t read_position() const { return read_pos_.load(std::memory_order_relaxed); }
+    
+    // Zero-copy in-place access
+    // Producer side: claim() -> write slots in place -> commit()
+    // Consumer side: peek() -> read slots in place -> release()
     
     /**
-     * @brief Gets the current read position (UNSAFE)
-     * @return Current read position
-     * @warning Only use this for zero-copy scenarios with proper synchronization
+     * @brief Claims up to count contiguous writable slots (producer only)
+     * @param count Number of slots wanted
+     * @return Span of writable slots; may be shorter than count when the buffer
+     *         is nearly full or the claim reaches the end of the slot array,
+     *         empty when the buffer is full
+     * @note Slots are invisible to the consumer until commit() is called.
+     *       A new claim() supersedes any uncommitted previous claim.
      */
-    std::uint64_t read_pos() const { return read_pos_.load(std::memory_order_relaxed); }
+    std::span<Slot> claim(std::uint64_t count);
     
     /**
-     * @brief Gets the index mask for wrapping
-     * @return Index mask (capacity - 1)
+     * @brief Publishes the first count slots of the last claim (producer only)
+     * @param count Number of slots to publish (<= size of the last claim)
+     * @throws std::logic_error if count exceeds the outstanding claim
      */
-    std::uint64_t mask() const { return mask_; }
+    void commit(std::uint64_t count);
+    
+    /**
+     * @brief Defers publication of commit() until publish() (producer only)
+     * @note Lets a producer that decodes a burst of packets publish them with
+     *       one release store and one consumer wake-up. Claims made while
+     *       holding continue after the held slots; any other push publishes
+     *       the held slots along with its own.
+     */
+    void hold_commits();
+    
+    /**
+     * @brief Publishes every slot committed since hold_commits() and stops holding (producer only)
+     */
+    void publish();
     
     /**
-     * @brief Advances the write position by count (UNSAFE)
-     * @param count Number of positions to advance
-     * @warning Only use this for zero-copy scenarios with proper synchronization
+     * @brief Peeks at up to max_count contiguous readable slots (consumer only)
+     * @param max_count Maximum number of slots wanted
+     * @return Span of readable slots; may be shorter than max_count at the end
+     *         of the slot array, empty when the buffer is empty
+     * @note Slots stay owned by the consumer until release() is called
      */
-    void advance_write_pos(std::uint64_t count);
+    std::span<const Slot> peek(std::uint64_t max_count);
+    
+    /**
+     * @brief Returns the first count peeked slots to the producer (consumer only)
+     * @param count Number of slots to release (<= size of the last peek)
+     * @throws std::logic_error if count exceeds the outstanding peek
+     */
+    void release(std::uint64_t count);
+    
+    /**
+     * @brief Wakes a parked consumer on every publish (set before starting threads)
+     * @param signal Signal the consumer's WaitStrategy parks on, or nullptr
+     * @note Costs the producer one fence per publish while attached
+     */
+    void set_consumer_signal(WaitSignal* signal) { consumer_signal_ = signal; }
 
 private:
+    /**
+     * @brief Producer's next write position, including held commits
+     */
+    std::uint64_t producer_pos() const {
+        return write_pos_.load(std::memory_order_relaxed) + held_;
+    }
+    
+    /**
+     * @brief Release-stores write_pos_, which also publishes any held commits
+     * @param write New write position
+     */
+    void publish_to(std::uint64_t write) {
+        write_pos_.store(write, std::memory_order_release);
+        held_ = 0;
+        notify_consumer();
+    }
+    
+    /**
+     * @brief Notifies the attached consumer signal after write_pos_ advanced
+     */
+    void notify_consumer() {
+        if (consumer_signal_) {
+            consumer_signal_->notify();
+        }
+    }
+    
+    /**
+     * @brief Reloads the consumer's index when the cached copy says full
+     * @param write Current write position
+     * @param needed Number of free slots wanted
+     * @return Number of free slots after any refresh
+     */
+    std::uint64_t free_slots(std::uint64_t write, std::uint64_t needed) {
+        auto free = capacity_ - (write - cached_read_pos_);
+        if (free < needed) {
+            cached_read_pos_ = read_pos_.load(std::memory_order_acquire);
+            free = capacity_ - (write - cached_read_pos_);
+            update_high_water_mark(write - cached_read_pos_);
+        }
+        return free;
+    }
+    
+    /**
+     * @brief Reloads the producer's index when the cached copy says empty
+     * @param read Current read position
+     * @return Number of readable slots after any refresh
+     */
+    std::uint64_t readable_slots(std::uint64_t read) {
+        auto available = cached_write_pos_ - read;
+        if (available == 0) {
+            cached_write_pos_ = write_pos_.load(std::memory_order_acquire);
+            available = cached_write_pos_ - read;
+            update_high_water_mark(available);
+        }
+        return available;
+    }
+    
+    /**
+     * @brief Raises the high water mark (called by both sides off the fast path)
+     * @param current_size Observed buffer size
+     */
+    void update_high_water_mark(std::uint64_t current_size) {
+        auto current_hwm = high_water_mark_.load(std::memory_order_relaxed);
+        while (current_size > current_hwm &&
+               !high_water_mark_.compare_exchange_weak(current_hwm, current_size, std::memory_order_relaxed)) {
+        }
+    }
+    
     /**
      * @brief Validates the capacity parameter
      * @param capacity The capacity to validate
@@ -250,6 +397,24 @@ private:
     void validate_capacity(std::uint64_t capacity) const;
 };
 
+template <typename Fn>
+std::uint64_t RingBuffer::consume_batch(Fn&& fn, std::uint64_t max_count) {
+    auto read = read_pos_.load(std::memory_order_relaxed);
+    auto to_consume = std::min(max_count, readable_slots(read));
+    
+    if (to_consume == 0) {
+        return 0;  // Buffer empty
+    }
+    
+    for (std::uint64_t i = 0; i < to_consume; ++i) {
+        fn(static_cast<const Slot&>(slots_[(read + i) & mask_]));
+    }
+    
+    // Single release store hands the whole batch back to the producer
+    read_pos_.store(read + to_consume, std::memory_order_release);
+    return to_consume;
+}
+
 /**
  * @brief Creates a ring buffer with validated capacity
  * @param capacity Buffer capacity (must be power of 2)
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace mdfh {
+
+struct MultiFeedSlot;
+
+// Shared-memory ring configuration
+struct ShmRingConfig {
+    std::string path;                    // File in /dev/shm or a hugetlbfs mount (empty = off)
+    std::uint64_t capacity = 1u << 20;   // Records (power of 2)
+    std::uint32_t max_readers = 16;      // Reader cursor slots
+
+    bool enabled() const { return !path.empty(); }
+    bool is_valid() const;
+};
+
+// On-memory layout, shared by every process mapping the ring. Page 0 is the
+// header, followed by max_readers cursor lines and capacity cells. All
+// offsets are fixed by the header, so a reader built from another revision
+// refuses a ring whose version or record size differs.
+struct ShmRingHeader {
+    static constexpr char MAGIC[8] = {'M', 'D', 'F', 'H', 'S', 'H', 'M', 'R'};
+    static constexpr std::uint32_t VERSION = 1;
+
+    char magic[8];                       // Written last: a ring without it is still being created
+    std::uint32_t version;
+    std::uint32_t record_size;
+    std::uint64_t capacity;
+    std::uint32_t max_readers;
+    std::uint32_t producer_pid;
+    std::uint64_t cursors_offset;
+    std::uint64_t cells_offset;
+
+    alignas(64) std::atomic<std::uint64_t> write_pos;   // Records published
+    std::atomic<std::uint32_t> closed;                  // Producer detached; nothing more will be written
+};
+
+// One reader's slot; pid 0 = free
+struct alignas(64) ShmRingCursor {
+    std::atomic<std::uint32_t> pid;
+    std::atomic<std::uint64_t> position;                // Next record the reader will read
+    std::atomic<std::uint64_t> lost;                    // Records overwritten before it read them
+};
+
+// One record. sequence is 2 * (position + 1) once the record at position
+// is complete and odd while it is being written; the payload is a
+// MultiFeedSlot stored as words so a reader's racy copy is atomic loads.
+struct alignas(64) ShmRingCell {
+    std::atomic<std::uint64_t> sequence;
+    std::array<std::atomic<std::uint64_t>, 4> value;
+};
+
+static_assert(sizeof(ShmRingCursor) == 64, "ShmRingCursor must occupy a single cache line");
+static_assert(sizeof(ShmRingCell) == 64, "ShmRingCell must occupy a single cache line");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Shared-memory atomics must be lock-free");
+
+// Mapped ring file (internal to ShmRingWriter and ShmRingReader)
+class ShmRingMapping {
+public:
+    ShmRingMapping() = default;
+    ShmRingMapping(void* data, std::size_t size) : data_(data), size_(size) {}
+    ~ShmRingMapping();
+
+    ShmRingMapping(const ShmRingMapping&) = delete;
+    ShmRingMapping& operator=(const ShmRingMapping&) = delete;
+
+    ShmRingMapping& operator=(ShmRingMapping&& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        return *this;
+    }
+
+    ShmRingHeader& header() const { return *static_cast<ShmRingHeader*>(data_); }
+    ShmRingCursor* cursors() const;
+    ShmRingCell* cells() const;
+
+private:
+    void* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+// Single producer of a broadcast ring in shared memory. publish() never
+// waits for readers: each reader has its own cursor and a reader that falls
+// a full ring behind is lapped, detects it and skips ahead. The file is
+// recreated on construction, so readers of a previous run keep their old
+// mapping, see it closed and must reattach.
+class ShmRingWriter {
+public:
+    explicit ShmRingWriter(ShmRingConfig config);     // throws std::runtime_error / std::invalid_argument
+    ~ShmRingWriter();                                 // Marks the ring closed; the file stays for late readers
+
+    ShmRingWriter(const ShmRingWriter&) = delete;
+    ShmRingWriter& operator=(const ShmRingWriter&) = delete;
+
+    // Writes count records and publishes them with one release store
+    void publish(const MultiFeedSlot* slots, std::uint64_t count);
+
+    // Statistics (any thread)
+    std::uint64_t records_published() const;
+    std::uint32_t readers() const;
+    std::uint64_t max_reader_lag() const;            // Records the slowest attached reader is behind
+    const ShmRingConfig& config() const { return config_; }
+
+private:
+    ShmRingConfig config_;
+    ShmRingMapping mapping_;
+    std::uint64_t mask_;
+    std::uint64_t write_pos_ = 0;                     // Producer-owned copy of header().write_pos
+};
+
+// One independent reader of a ShmRingWriter's ring, typically in another
+// process. Attaching maps the file and claims a cursor slot (slots of dead
+// processes are reclaimed); reading starts at the newest record.
+class ShmRingReader {
+public:
+    // throws std::runtime_error if the file is missing, not a ring, or all cursor slots are taken
+    explicit ShmRingReader(const std::string& path);
+    ~ShmRingReader();                                 // Frees the cursor slot
+
+    ShmRingReader(const ShmRingReader&) = delete;
+    ShmRingReader& operator=(const ShmRingReader&) = delete;
+
+    // Copies up to max_count records in order; after a lap, skips to the
+    // newest record and adds what it missed to lost()
+    std::uint64_t poll(MultiFeedSlot* out, std::uint64_t max_count);
+
+    // True once the producer detached and everything it wrote has been read
+    bool finished() const;
+
+    std::uint64_t position() const { return position_; }
+    std::uint64_t lost() const { return lost_; }
+    std::uint64_t laps() const { return laps_; }
+    std::uint64_t capacity() const { return capacity_; }
+
+private:
+    ShmRingMapping mapping_;
+    ShmRingCursor* cursor_ = nullptr;
+    std::uint64_t capacity_ = 0;
+    std::uint64_t mask_ = 0;
+    std::uint64_t position_ = 0;
+    std::uint64_t lost_ = 0;
+    std::uint64_t laps_ = 0;
+};
+
+} // namespace mdfh
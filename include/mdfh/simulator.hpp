@@ -2,11 +2,20 @@
 
 #include "core.hpp"
 #include "encoding.hpp"
+#include "replay.hpp"
+#include "traffic_model.hpp"
 #include "timing.hpp"
 #include <boost/asio.hpp>
 #include <string>
 #include <random>
 #include <memory>
+#include <span>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
 
 namespace mdfh {
 
@@ -19,9 +28,13 @@ struct SimulatorConfig {
     TransportType transport = TransportType::TCP;
     EncodingType encoding = EncodingType::BINARY;
     
+    std::vector<std::string> extra_mcast_groups;    // more groups fed from the same sendmmsg call
+    
     // Performance settings
-    std::uint32_t rate = 100'000;       // messages per second
+    std::uint32_t rate = 100'000;       // messages per second (0 = unthrottled)
     std::uint32_t batch_size = 100;     // messages per batch
+    std::uint32_t mtu = 1500;           // UDP datagrams are packed up to mtu - 28 bytes
+    std::uint32_t zero_copy_threshold = 0;  // MSG_ZEROCOPY for TCP sends / UDP datagrams >= this many bytes (0 = off, Linux only)
     
     // Market data generation
     std::uint64_t seed = 42;            // RNG seed for reproducible runs
@@ -29,9 +42,18 @@ struct SimulatorConfig {
     double price_jitter = 0.05;         // ± max price movement per tick
     std::int32_t max_quantity = 100;    // maximum order quantity
     
+    // Arrival process and symbol activity (uniform, one instrument by default)
+    TrafficModelConfig traffic;
+    
     // Encoding configuration
     EncodingConfig encoding_config;
     
+    // Replay mode: encode this many seconds of traffic up front, then loop it
+    std::uint32_t pregenerate_seconds = 0;  // 0 = generate and encode live
+    
+    // Recorded traffic (journal or pcap) sent instead of generated messages
+    ReplayConfig recording;
+    
     // Exit criteria
     std::uint32_t max_seconds = 0;      // run duration (0 = infinite)
     std::uint64_t max_messages = 0;     // message limit (0 = infinite)
@@ -40,55 +62,143 @@ struct SimulatorConfig {
 // Output stream operator for configuration display
 std::ostream& operator<<(std::ostream& os, const SimulatorConfig& cfg);
 
-// Market data generator - creates realistic market data sequences
+// Market data generator - creates realistic market data sequences.
+// With several instruments, each message picks one by Zipf-distributed
+// activity and moves that instrument's own price. Msg has no symbol field
+// (its 20-byte layout is the binary wire format), so the instrument ids are
+// returned alongside the batch for callers that track them.
 class MarketDataGenerator {
 private:
     std::mt19937_64 rng_;
     std::uniform_real_distribution<double> price_dist_;
     std::uniform_int_distribution<std::int32_t> qty_dist_;
+    InstrumentSampler instrument_sampler_;
     
-    double current_price_;
+    std::vector<double> prices_;        // Current price per instrument
     std::uint64_t sequence_;
     
 public:
     explicit MarketDataGenerator(const SimulatorConfig& config);
     
-    // Generate a batch of market data messages
-    void generate_batch(std::vector<Msg>& batch);
+    // Generate a batch of market data messages; if instruments is non-empty
+    // (batch.size() entries), instruments[i] receives message i's instrument
+    void generate_batch(std::span<Msg> batch, std::span<std::uint32_t> instruments = {});
     
     // Reset generator state
     void reset(const SimulatorConfig& config);
 };
 
+// Tracks MSG_ZEROCOPY sends on one socket and reaps their completions.
+// A zero-copy send pins the caller's pages, so the bytes must not change
+// until the kernel reports the send complete on the socket error queue.
+class ZeroCopyTracker {
+private:
+    int fd_ = -1;
+    std::uint32_t threshold_ = 0;
+    std::uint64_t outstanding_ = 0;
+    
+public:
+    // Enables SO_ZEROCOPY on fd; stays disabled if unsupported or threshold is 0
+    void enable(int fd, std::uint32_t threshold);
+    
+    // MSG_ZEROCOPY when enabled and bytes (a TCP send, a UDP datagram) is at least threshold
+    int send_flags(std::size_t bytes) const;
+    
+    void record_sends(std::uint64_t count) { outstanding_ += count; }
+    
+    // Drains completion notifications; with wait_all, blocks until none are outstanding
+    void reap(bool wait_all);
+    
+    bool enabled() const { return fd_ >= 0; }
+    std::uint64_t outstanding() const { return outstanding_; }
+};
+
 // Abstract base class for transport implementations
 class Transport {
 public:
     virtual ~Transport() = default;
-    virtual void send(const std::vector<std::uint8_t>& data) = 0;
+    virtual void send(std::span<const std::uint8_t> data) = 0;
+    
+    // Sends the buffers in order; each buffer is one indivisible unit (a
+    // message or a pre-packed block). The default sends them one by one.
+    virtual void send_batch(std::span<const std::span<const std::uint8_t>> buffers);
+    
+    // True if buffers passed to send/send_batch stay unmodified for the
+    // transport's lifetime (e.g. a replay arena). Zero-copy sends then
+    // return without waiting for the kernel to release the pages.
+    virtual void set_stable_buffers(bool stable) { (void)stable; }
+    
     virtual bool is_connected() const = 0;
 };
 
-// TCP transport implementation
+// TCP transport implementation - scatter-gather writes, optional MSG_ZEROCOPY
 class TCPTransport : public Transport {
 private:
     boost::asio::ip::tcp::socket socket_;
+    std::vector<boost::asio::const_buffer> iov_;   // reused gather list
+    ZeroCopyTracker zero_copy_;
+    bool stable_buffers_ = false;
     
 public:
-    explicit TCPTransport(boost::asio::ip::tcp::socket socket);
-    void send(const std::vector<std::uint8_t>& data) override;
+    explicit TCPTransport(boost::asio::ip::tcp::socket socket, std::uint32_t zero_copy_threshold = 0);
+    void send(std::span<const std::uint8_t> data) override;
+    void send_batch(std::span<const std::span<const std::uint8_t>> buffers) override;
+    void set_stable_buffers(bool stable) override { stable_buffers_ = stable; }
     bool is_connected() const override;
+    
+private:
+    void write_gathered();
 };
 
-// UDP multicast transport implementation
+// UDP multicast transport implementation - MTU packing and sendmmsg fan-out
 class UDPMulticastTransport : public Transport {
 private:
+    // One packed datagram: iov_[first_iov, first_iov + iov_count)
+    struct Datagram {
+        std::size_t first_iov;
+        std::size_t iov_count;
+    };
+    
     boost::asio::ip::udp::socket socket_;
-    boost::asio::ip::udp::endpoint endpoint_;
+    std::vector<boost::asio::ip::udp::endpoint> endpoints_;
+    std::size_t max_payload_;
+    
+    // Reused per call so send_batch never allocates in steady state
+    std::vector<boost::asio::const_buffer> iov_;
+    std::vector<Datagram> datagrams_;
+#if defined(__linux__)
+    std::vector<iovec> native_iov_;
+    std::vector<mmsghdr> msgs_;
+#endif
+    ZeroCopyTracker zero_copy_;
+    bool stable_buffers_ = false;
     
 public:
     UDPMulticastTransport(boost::asio::io_context& ctx, const SimulatorConfig& config);
-    void send(const std::vector<std::uint8_t>& data) override;
+    void send(std::span<const std::uint8_t> data) override;
+    void send_batch(std::span<const std::span<const std::uint8_t>> buffers) override;
+    void set_stable_buffers(bool stable) override { stable_buffers_ = stable; }
     bool is_connected() const override;
+    
+    std::size_t max_payload() const { return max_payload_; }
+    
+private:
+    void pack(std::span<const std::span<const std::uint8_t>> buffers);
+    void send_datagrams();
+};
+
+// Pre-encoded traffic: one contiguous arena, sent one batch at a time
+struct EncodedTraffic {
+    std::vector<std::uint8_t> bytes;
+    std::vector<std::size_t> batch_offsets;     // batch i is [offsets[i], offsets[i + 1])
+    std::vector<std::size_t> message_ends;      // End offset in bytes of every message, in order
+    std::vector<std::uint64_t> arrival_ns;      // Modeled send time of every message (empty = rate limited)
+    std::uint64_t duration_ns = 0;              // Modeled length of one pass
+    
+    std::size_t batch_count() const { return batch_offsets.empty() ? 0 : batch_offsets.size() - 1; }
+    std::span<const std::uint8_t> batch(std::size_t i) const {
+        return {bytes.data() + batch_offsets[i], batch_offsets[i + 1] - batch_offsets[i]};
+    }
 };
 
 // Main simulator class - orchestrates market data generation and transmission
@@ -101,6 +211,27 @@ private:
     RateLimiter rate_limiter_;
     Timer timer_;
     
+    // Reused every tick so the send loop never allocates
+    std::vector<Msg> batch_;
+    std::vector<std::uint8_t> encoded_buffer_;
+    std::vector<std::size_t> message_ends_;
+    std::vector<std::span<const std::uint8_t>> message_spans_;
+    
+    // Replay mode state
+    EncodedTraffic traffic_;
+    std::size_t replay_index_ = 0;
+    
+    // Modeled arrivals (non-uniform traffic models); message i of a batch
+    // is sent when the pacer reaches arrival_ns_[i]
+    std::unique_ptr<ArrivalProcess> arrivals_;
+    ReplayPacer pacer_{1.0};
+    std::vector<std::uint64_t> arrival_ns_;
+    std::uint64_t pass_offset_ns_ = 0;
+    
+    // Recording playback state
+    std::unique_ptr<ReplaySource> recording_;
+    std::vector<ReplayEvent> recording_events_;
+    
     // Statistics
     std::uint64_t messages_sent_ = 0;
     
@@ -119,11 +250,18 @@ public:
     
 private:
     bool should_continue() const;
+    void throttle();
+    void send_messages(const std::uint8_t* base, std::size_t begin, std::span<const std::size_t> ends);
+    void send_paced(const std::uint8_t* base, std::size_t begin, std::span<const std::size_t> ends,
+                    std::span<const std::uint64_t> arrivals, std::uint64_t offset_ns);
     void send_batch();
+    void replay_batch();
+    void pregenerate_traffic();
+    bool play_recording_batch();
 };
 
 // Factory functions for creating transports
-std::unique_ptr<Transport> create_tcp_transport(boost::asio::ip::tcp::socket socket);
+std::unique_ptr<Transport> create_tcp_transport(boost::asio::ip::tcp::socket socket, const SimulatorConfig& config = {});
 std::unique_ptr<Transport> create_udp_transport(boost::asio::io_context& ctx, const SimulatorConfig& config);
 
 } // namespace mdfh 
\ No newline at end of file
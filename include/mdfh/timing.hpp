@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <chrono>
 
@@ -8,10 +9,15 @@
 #include <time.h>
 #endif
 
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#define MDFH_HAVE_TSC 1
+#endif
+
 namespace mdfh {
 
-// High-performance timestamp function using platform-specific optimizations
-inline std::uint64_t get_timestamp_ns() {
+// Monotonic clock read through clock_gettime (CLOCK_MONOTONIC_RAW where available)
+inline std::uint64_t get_monotonic_ns() {
 #if defined(__linux__) || defined(__APPLE__)
     struct timespec ts;
     #ifdef CLOCK_MONOTONIC_RAW
@@ -28,6 +34,84 @@ inline std::uint64_t get_timestamp_ns() {
 #endif
 }
 
+// Time stamp counter scaled onto get_monotonic_ns(). Calibrated once per
+// process (about 10ms, on first use), then re-anchored to the monotonic
+// clock every REANCHOR_NS by whichever thread reads it next, with the scale
+// re-estimated over the whole time since calibration. Stamps therefore track
+// CLOCK_MONOTONIC_RAW to within the error accumulated over one interval
+// instead of drifting with uptime, and stay comparable with kernel receive
+// stamps and with other processes doing the same. A re-anchor may step the
+// clock by that residual (well under a microsecond once the scale settles).
+// Only used when the CPU reports an invariant TSC.
+class TscClock {
+public:
+    static constexpr std::uint64_t REANCHOR_NS = 100'000'000;
+    
+    static const TscClock& instance() {
+        static const TscClock clock;
+        return clock;
+    }
+    
+    bool enabled() const { return enabled_; }
+    double ticks_per_ns() const {
+        auto mult = mult_.load(std::memory_order_relaxed);
+        return mult > 0 ? static_cast<double>(1ULL << MULT_SHIFT) / static_cast<double>(mult) : 0.0;
+    }
+    
+    std::uint64_t now_ns() const {
+#ifdef MDFH_HAVE_TSC
+        if (enabled_) {
+            // rdtscp waits for earlier instructions, so a stage end is not stamped early
+            unsigned aux;
+            auto tsc = __rdtscp(&aux);
+
+            // Seqlock read of the anchor; while it is being replaced, read the clock directly
+            auto seq = seq_.load(std::memory_order_acquire);
+            auto base_tsc = base_tsc_.load(std::memory_order_relaxed);
+            auto base_ns = base_ns_.load(std::memory_order_relaxed);
+            auto mult = mult_.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if ((seq & 1) != 0 || seq_.load(std::memory_order_relaxed) != seq) {
+                return get_monotonic_ns();
+            }
+
+            // A TSC slightly behind the anchor (skew between cores) maps to the anchor
+            auto ticks = tsc > base_tsc ? tsc - base_tsc : 0;
+            if (ticks >= reanchor_ticks_) {
+                return reanchor(seq);
+            }
+            return base_ns + static_cast<std::uint64_t>((static_cast<unsigned __int128>(ticks) * mult) >> MULT_SHIFT);
+        }
+#endif
+        return get_monotonic_ns();
+    }
+    
+private:
+    static constexpr unsigned MULT_SHIFT = 32;
+    
+    TscClock();
+    
+    // Moves the anchor to the current (TSC, monotonic) pair unless another
+    // thread already is; returns the monotonic time
+    std::uint64_t reanchor(std::uint64_t seq) const;
+    
+    bool enabled_{false};
+    std::uint64_t calibration_tsc_{0};  // Start of calibration: the scale is measured from here
+    std::uint64_t calibration_ns_{0};
+    std::uint64_t reanchor_ticks_{0};
+    
+    // Anchor, replaced under seq_ (odd while being written)
+    mutable std::atomic<std::uint64_t> seq_{0};
+    mutable std::atomic<std::uint64_t> base_tsc_{0};
+    mutable std::atomic<std::uint64_t> base_ns_{0};
+    mutable std::atomic<std::uint64_t> mult_{0};   // ns per tick in 32.32 fixed point
+};
+
+// High-performance timestamp function: calibrated TSC, clock_gettime fallback
+inline std::uint64_t get_timestamp_ns() {
+    return TscClock::instance().now_ns();
+}
+
 // Rate limiter for controlling message throughput
 class RateLimiter {
 private:
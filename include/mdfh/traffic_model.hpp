@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <string>
+
+namespace mdfh {
+
+// Message arrival process of generated traffic
+enum class ArrivalModel {
+    UNIFORM,        // Evenly spaced at the configured rate
+    POISSON,        // Exponential inter-arrival times, mean = 1 / rate
+    HAWKES,         // Self-exciting: every message raises the short-term intensity
+    MICROBURST      // burst_messages within burst_us, then idle to keep the average rate
+};
+
+std::ostream& operator<<(std::ostream& os, ArrivalModel model);
+
+// Parses "uniform", "poisson", "hawkes" or "microburst"; throws std::invalid_argument otherwise
+ArrivalModel parse_arrival_model(const std::string& name);
+
+// Arrival and symbol-activity shape of generated traffic. Every arrival
+// model averages to the configured rate; they differ in how it clusters.
+struct TrafficModelConfig {
+    ArrivalModel arrivals = ArrivalModel::UNIFORM;
+
+    // Hawkes: intensity mu + sum(alpha * exp(-(t - t_i) / decay)); branching = alpha * decay
+    double hawkes_branching = 0.7;      // Messages triggered per message (0..1, higher = burstier)
+    double hawkes_decay_us = 50.0;      // How long a message keeps exciting the stream
+
+    // Microburst
+    std::uint32_t burst_messages = 1000;
+    std::uint32_t burst_us = 100;
+
+    // Symbol activity: instrument k is picked with weight 1 / (k + 1)^zipf_exponent
+    std::uint32_t instruments = 1;
+    double zipf_exponent = 1.0;
+
+    bool is_valid() const;
+};
+
+std::ostream& operator<<(std::ostream& os, const TrafficModelConfig& config);
+
+// Arrival times of successive messages under a TrafficModelConfig,
+// in nanoseconds from the first message
+class ArrivalProcess {
+private:
+    ArrivalModel model_;
+    std::mt19937_64 rng_;
+    double mean_gap_ns_;
+    double time_ns_ = 0.0;
+
+    // Hawkes state
+    double baseline_per_ns_ = 0.0;
+    double jump_per_ns_ = 0.0;
+    double decay_per_ns_ = 0.0;
+    double excitation_per_ns_ = 0.0;    // Intensity above baseline just after the last message
+
+    // Microburst state
+    double burst_start_ns_ = 0.0;
+    double burst_period_ns_ = 0.0;
+    double burst_gap_ns_ = 0.0;
+    std::uint32_t burst_messages_ = 1;
+    std::uint32_t burst_index_ = 0;
+
+    std::uniform_real_distribution<double> unit_{0.0, 1.0};
+
+public:
+    ArrivalProcess(const TrafficModelConfig& config, double rate, std::uint64_t seed);
+
+    // Arrival time of the next message; non-decreasing
+    std::uint64_t next_ns();
+
+private:
+    double open_unit();
+};
+
+// Zipf-distributed instrument picker
+class InstrumentSampler {
+private:
+    std::discrete_distribution<std::uint32_t> dist_;
+    std::uint32_t count_;
+
+public:
+    InstrumentSampler(std::uint32_t instruments, double exponent);
+
+    template <typename Rng>
+    std::uint32_t operator()(Rng& rng) { return count_ > 1 ? dist_(rng) : 0; }
+
+    std::uint32_t count() const { return count_; }
+};
+
+} // namespace mdfh
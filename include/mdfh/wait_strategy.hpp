@@ -0,0 +1,186 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace mdfh {
+
+// Pause instruction for spin loops: frees pipeline resources for the
+// sibling hyperthread and avoids the memory-order flush on loop exit
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+// How an idle loop waits for more work
+enum class WaitStrategyType {
+    BUSY_SPIN,      // cpu_relax() forever: lowest latency, burns a core
+    SPIN_YIELD,     // Spin, then sched_yield() between polls
+    SPIN_PARK       // Spin, optionally yield, then park until woken or timed out
+};
+
+// Per-loop wait configuration (selectable per component from YAML/CLI)
+struct WaitConfig {
+    WaitStrategyType type = WaitStrategyType::SPIN_PARK;
+    std::uint32_t spin_iterations = 100;    // Empty polls spent spinning before yielding
+    std::uint32_t yield_iterations = 0;     // Empty polls spent yielding before parking (SPIN_PARK)
+    std::uint32_t park_timeout_us = 100;    // Upper bound on one park (0 = poll and return)
+
+    bool is_valid() const { return park_timeout_us <= 1'000'000; }
+};
+
+// Wakeup channel from a producer to one parked consumer.
+// The consumer announces itself before its final poll, so the producer only
+// pays for a fence and a load on commit unless someone is actually parked.
+class WaitSignal {
+private:
+    alignas(64) std::atomic<std::uint32_t> epoch_{0};   // futex word
+    std::atomic<std::uint32_t> waiters_{0};
+
+public:
+    // Producer side: call after publishing new work
+    void notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) != 0) {
+            wake();
+        }
+    }
+
+    // Consumer side: announce, poll once more, then wait() or cancel_wait()
+    std::uint32_t prepare_wait() {
+        waiters_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return epoch_.load(std::memory_order_relaxed);
+    }
+
+    // Blocks while the epoch still equals key, at most timeout
+    void wait(std::uint32_t key, std::chrono::microseconds timeout);
+
+    void cancel_wait() { waiters_.fetch_sub(1, std::memory_order_relaxed); }
+
+private:
+    void wake();
+};
+
+// Idle-loop helper: call reset() when a poll found work and idle() when it
+// found none. Empty polls escalate from spinning to yielding to parking.
+class WaitStrategy {
+private:
+    WaitConfig config_;
+    WaitSignal* signal_;
+    std::uint32_t idle_polls_ = 0;
+    std::uint32_t key_ = 0;
+    bool announced_ = false;
+
+public:
+    // signal may be null; parking then falls back to a timed sleep
+    explicit WaitStrategy(const WaitConfig& config = {}, WaitSignal* signal = nullptr)
+        : config_(config), signal_(signal) {}
+
+    ~WaitStrategy() { reset(); }
+
+    WaitStrategy(const WaitStrategy&) = delete;
+    WaitStrategy& operator=(const WaitStrategy&) = delete;
+
+    void reset() {
+        idle_polls_ = 0;
+        if (announced_) {
+            signal_->cancel_wait();
+            announced_ = false;
+        }
+    }
+
+    // Parks on the signal (or sleeps). The first parking call only announces
+    // the waiter and returns, so the caller polls once more before blocking.
+    void idle() {
+        if (should_spin()) {
+            return;
+        }
+        if (!signal_) {
+            sleep(park_timeout());
+            return;
+        }
+        if (!announced_) {
+            key_ = signal_->prepare_wait();
+            announced_ = true;
+            return;
+        }
+        signal_->wait(key_, park_timeout());
+        signal_->cancel_wait();
+        announced_ = false;
+    }
+
+    // Same escalation, parking in park(timeout) instead, e.g. poll() on a
+    // socket or io_uring_enter(GETEVENTS), where the kernel is the producer
+    template <typename Park>
+    void idle(Park&& park) {
+        if (should_spin()) {
+            return;
+        }
+        park(park_timeout());
+    }
+
+    const WaitConfig& config() const { return config_; }
+
+private:
+    // Spin and yield phases; returns false once the caller should park
+    bool should_spin() {
+        if (idle_polls_ < config_.spin_iterations || config_.type == WaitStrategyType::BUSY_SPIN) {
+            ++idle_polls_;
+            cpu_relax();
+            return true;
+        }
+        if (config_.type == WaitStrategyType::SPIN_YIELD ||
+            idle_polls_ < config_.spin_iterations + config_.yield_iterations) {
+            ++idle_polls_;
+            yield();
+            return true;
+        }
+        return false;
+    }
+
+    std::chrono::microseconds park_timeout() const {
+        return std::chrono::microseconds(config_.park_timeout_us);
+    }
+
+    static void yield();
+    static void sleep(std::chrono::microseconds timeout);
+};
+
+inline std::ostream& operator<<(std::ostream& os, WaitStrategyType type) {
+    switch (type) {
+        case WaitStrategyType::BUSY_SPIN: return os << "BUSY_SPIN";
+        case WaitStrategyType::SPIN_YIELD: return os << "SPIN_YIELD";
+        case WaitStrategyType::SPIN_PARK: return os << "SPIN_PARK";
+    }
+    return os << "UNKNOWN_WAIT_STRATEGY";
+}
+
+inline std::ostream& operator<<(std::ostream& os, const WaitConfig& cfg) {
+    os << cfg.type;
+    if (cfg.type != WaitStrategyType::BUSY_SPIN) {
+        os << " (spin " << cfg.spin_iterations;
+        if (cfg.type == WaitStrategyType::SPIN_PARK) {
+            os << ", yield " << cfg.yield_iterations << ", park " << cfg.park_timeout_us << "us";
+        }
+        os << ")";
+    }
+    return os;
+}
+
+// Parses "spin", "yield" or "park" (case-insensitive); throws std::invalid_argument otherwise
+WaitStrategyType parse_wait_strategy_type(const std::string& name);
+
+} // namespace mdfh
@@ -16,7 +16,7 @@ DURATION=60
 BENCHMARK_TYPE="bypass"  # Options: bypass, multi_feed
 BATCH_SIZE=32           # Number of messages per batch
 RX_RING_SIZE=4096       # RX ring buffer size
-CPU_CORE=0              # CPU core for networking thread
+CPU_CORE=-1             # CPU core for networking thread (-1 = unpinned)
 BACKEND="asio"          # Kernel bypass backend: asio, dpdk, solarflare
 ZERO_COPY=false         # Enable zero-copy optimization
 VERBOSE=false           # Enable verbose output
@@ -195,7 +195,7 @@ echo "  ✓ Back-pressure handling"
 echo
 echo -e "${BLUE}Next steps:${NC}"
 echo "  1. Review performance results in $PERF_RESULTS_FILE"
-echo "  2. Run specific performance tests: ./tests/perf_tests"
+echo "  2. Sweep the benchmark matrix: ./benchmark_driver --matrix ../config/benchmark_matrix.yaml"
 echo "  3. Profile with tools like perf or valgrind for deeper analysis"
 echo "  4. Integrate tests into CI/CD pipeline"
 
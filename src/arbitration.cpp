@@ -0,0 +1,56 @@
+#include "mdfh/arbitration.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace mdfh {
+
+// SequenceWindow implementation
+void SequenceWindow::clear_range(std::uint64_t from, std::uint64_t to) {
+    if (to - from >= SIZE) {
+        bits_.fill(0);
+        return;
+    }
+    while (from < to) {
+        auto bit = from & (SIZE - 1);
+        auto offset = bit % WORD_BITS;
+        auto count = std::min(WORD_BITS - offset, to - from);
+        auto mask = count == WORD_BITS ? ~std::uint64_t{0} : ((std::uint64_t{1} << count) - 1) << offset;
+        bits_[bit / WORD_BITS] &= ~mask;
+        from += count;
+    }
+}
+
+// LineArbiter implementation
+void LineArbiter::add_line(std::uint32_t origin_id, const std::string& group) {
+    if (origin_id < line_by_origin_.size() && line_by_origin_[origin_id] >= 0) {
+        throw std::invalid_argument("Duplicate arbitration line origin_id: " + std::to_string(origin_id));
+    }
+
+    auto it = std::find(group_names_.begin(), group_names_.end(), group);
+    auto group_index = static_cast<std::uint32_t>(it - group_names_.begin());
+    if (it == group_names_.end()) {
+        group_names_.push_back(group);
+        windows_.emplace_back();
+    }
+
+    if (origin_id >= line_by_origin_.size()) {
+        line_by_origin_.resize(origin_id + 1, -1);
+    }
+    line_by_origin_[origin_id] = static_cast<std::int32_t>(lines_.size());
+    lines_.push_back(std::make_unique<Line>());
+    lines_.back()->group = group_index;
+}
+
+LineStats LineArbiter::line_stats(std::uint32_t origin_id) const {
+    LineStats stats;
+    if (origin_id >= line_by_origin_.size() || line_by_origin_[origin_id] < 0) {
+        return stats;
+    }
+    const auto& line = *lines_[static_cast<std::size_t>(line_by_origin_[origin_id])];
+    stats.wins = line.wins.load(std::memory_order_relaxed);
+    stats.duplicates = line.duplicates.load(std::memory_order_relaxed);
+    stats.gaps_filled = line.gaps_filled.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace mdfh
@@ -0,0 +1,213 @@
+#include "mdfh/batch_decoder.hpp"
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define MDFH_HAS_X86_DECODERS 1
+#endif
+
+namespace mdfh {
+
+namespace {
+
+// Portable per-record decode; also handles the tail the vector kernels leave
+DecodeResult decode_scalar(const std::uint8_t* data, std::size_t count, Slot* out, std::uint64_t rx_ts) {
+    DecodeResult result;
+    for (std::size_t i = 0; i < count; ++i) {
+        Slot& slot = out[result.valid];
+        std::memcpy(&slot.raw, data + i * sizeof(Msg), sizeof(Msg));
+        slot.rx_ts = rx_ts;
+        if (slot.raw.is_valid()) {
+            ++result.valid;
+        } else {
+            ++result.invalid;
+        }
+    }
+    return result;
+}
+
+#ifdef MDFH_HAS_X86_DECODERS
+
+// Each record is copied as one 32-byte load: bytes 0..19 are the Msg, 20..23
+// are zeroed padding and 24..31 receive rx_ts (offsetof(Slot, rx_ts) == 24).
+// The load runs 12 bytes past the record, so the vector loops stop while a
+// full record still follows the last lane and the scalar path takes the rest.
+static_assert(offsetof(Slot, rx_ts) == 24, "vector decoders assume rx_ts at byte 24");
+
+// Four records loaded as rows, transposed into seq/px/qty columns.
+// Column lane order is (r0, r2, r1, r3) because unpack works per 128-bit lane.
+struct RecordColumns {
+    __m256i seq;
+    __m256d px;
+    __m256i qty;    // qty in the low dword of each 64-bit lane
+};
+
+__attribute__((target("avx2")))
+inline RecordColumns transpose_records(__m256i r0, __m256i r1, __m256i r2, __m256i r3) {
+    __m256i lo01 = _mm256_permute2x128_si256(r0, r1, 0x20);    // seq0 px0 | seq1 px1
+    __m256i lo23 = _mm256_permute2x128_si256(r2, r3, 0x20);    // seq2 px2 | seq3 px3
+    __m256i hi01 = _mm256_permute2x128_si256(r0, r1, 0x31);    // qty0 ... | qty1 ...
+    __m256i hi23 = _mm256_permute2x128_si256(r2, r3, 0x31);    // qty2 ... | qty3 ...
+
+    return {
+        _mm256_unpacklo_epi64(lo01, lo23),
+        _mm256_castsi256_pd(_mm256_unpackhi_epi64(lo01, lo23)),
+        _mm256_unpacklo_epi64(hi01, hi23)
+    };
+}
+
+// Maps a (r0, r2, r1, r3) lane mask back to record order
+inline unsigned record_order(unsigned lanes) {
+    return (lanes & 0x9u) | ((lanes & 0x2u) << 1) | ((lanes & 0x4u) >> 1);
+}
+
+__attribute__((target("avx2")))
+inline void store_slot(__m256i record, Slot* slot, __m256i ts) {
+    _mm256_store_si256(reinterpret_cast<__m256i*>(slot), _mm256_blend_epi32(record, ts, 0xE0));
+}
+
+__attribute__((target("avx2")))
+inline __m256i load_record(const std::uint8_t* rec) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rec));
+}
+
+// Branch-free compaction: always store, advance only past valid records
+__attribute__((target("avx2")))
+inline void store_group(const __m256i (&rows)[4], unsigned valid_mask, Slot* out, DecodeResult& result, __m256i ts) {
+    if (valid_mask == 0xFu) {
+        // Common case: no compaction, four independent stores
+        Slot* dst = out + result.valid;
+        for (unsigned lane = 0; lane < 4; ++lane) {
+            store_slot(rows[lane], dst + lane, ts);
+        }
+        result.valid += 4;
+        return;
+    }
+    for (unsigned lane = 0; lane < 4; ++lane) {
+        store_slot(rows[lane], out + result.valid, ts);
+        result.valid += (valid_mask >> lane) & 1u;
+    }
+    result.invalid += 4 - static_cast<std::size_t>(__builtin_popcount(valid_mask));
+}
+
+__attribute__((target("avx2")))
+inline unsigned validate_avx2(const RecordColumns& cols) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i seq_zero = _mm256_cmpeq_epi64(cols.seq, zero);
+    __m256i qty_zero = _mm256_cmpeq_epi64(_mm256_slli_epi64(cols.qty, 32), zero);
+    __m256d px_pos = _mm256_cmp_pd(cols.px, _mm256_setzero_pd(), _CMP_GT_OQ);
+
+    unsigned bad = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_or_si256(seq_zero, qty_zero))));
+    unsigned good_px = static_cast<unsigned>(_mm256_movemask_pd(px_pos));
+    return record_order(good_px & ~bad & 0xFu);
+}
+
+__attribute__((target("avx2")))
+DecodeResult decode_avx2(const std::uint8_t* data, std::size_t count, Slot* out, std::uint64_t rx_ts) {
+    constexpr std::size_t LANES = 4;
+    const __m256i ts = _mm256_set_epi64x(static_cast<long long>(rx_ts), 0, 0, 0);
+
+    DecodeResult result;
+    std::size_t i = 0;
+    for (; i + LANES < count; i += LANES) {
+        const std::uint8_t* base = data + i * sizeof(Msg);
+        const __m256i rows[4] = {
+            load_record(base), load_record(base + 20), load_record(base + 40), load_record(base + 60)
+        };
+
+        unsigned valid_mask = validate_avx2(transpose_records(rows[0], rows[1], rows[2], rows[3]));
+        store_group(rows, valid_mask, out, result, ts);
+    }
+
+    DecodeResult tail = decode_scalar(data + i * sizeof(Msg), count - i, out + result.valid, rx_ts);
+    result.valid += tail.valid;
+    result.invalid += tail.invalid;
+    return result;
+}
+
+// Same row loads and transpose as AVX2, but both groups of four are validated
+// with one set of 512-bit mask compares
+__attribute__((target("avx512f,avx512vl,avx2")))
+DecodeResult decode_avx512(const std::uint8_t* data, std::size_t count, Slot* out, std::uint64_t rx_ts) {
+    constexpr std::size_t LANES = 8;
+    const __m256i ts = _mm256_set_epi64x(static_cast<long long>(rx_ts), 0, 0, 0);
+
+    DecodeResult result;
+    std::size_t i = 0;
+    for (; i + LANES < count; i += LANES) {
+        const std::uint8_t* base = data + i * sizeof(Msg);
+        const __m256i lo[4] = {
+            load_record(base), load_record(base + 20), load_record(base + 40), load_record(base + 60)
+        };
+        const __m256i hi[4] = {
+            load_record(base + 80), load_record(base + 100), load_record(base + 120), load_record(base + 140)
+        };
+
+        RecordColumns a = transpose_records(lo[0], lo[1], lo[2], lo[3]);
+        RecordColumns b = transpose_records(hi[0], hi[1], hi[2], hi[3]);
+
+        // Zero-masked inserts with a full mask: the plain forms (and the zext
+        // helpers built on them) pass an undefined vector through, which GCC
+        // reports as -Wmaybe-uninitialized. Same vinserti64x4, no mask applied.
+        __m512i seq = _mm512_maskz_inserti64x4(0xFF, _mm512_castsi256_si512(a.seq), b.seq, 1);
+        __m512d px = _mm512_maskz_insertf64x4(0xFF, _mm512_castpd256_pd512(a.px), b.px, 1);
+        __m512i qty = _mm512_maskz_inserti64x4(0xFF, _mm512_castsi256_si512(a.qty), b.qty, 1);
+
+        unsigned lanes = _mm512_test_epi64_mask(seq, seq)
+                       & _mm512_cmp_pd_mask(px, _mm512_setzero_pd(), _CMP_GT_OQ)
+                       & _mm512_test_epi64_mask(qty, _mm512_set1_epi64(0xFFFFFFFF));
+
+        store_group(lo, record_order(lanes & 0xFu), out, result, ts);
+        store_group(hi, record_order(lanes >> 4), out, result, ts);
+    }
+
+    DecodeResult tail = decode_scalar(data + i * sizeof(Msg), count - i, out + result.valid, rx_ts);
+    result.valid += tail.valid;
+    result.invalid += tail.invalid;
+    return result;
+}
+
+#endif // MDFH_HAS_X86_DECODERS
+
+BinaryBatchDecoder::DecodeFn select_decoder(DecoderIsa isa) {
+    switch (isa) {
+#ifdef MDFH_HAS_X86_DECODERS
+        case DecoderIsa::AVX512: return decode_avx512;
+        case DecoderIsa::AVX2: return decode_avx2;
+#endif
+        default: return decode_scalar;
+    }
+}
+
+} // namespace
+
+bool is_decoder_isa_supported(DecoderIsa isa) {
+    switch (isa) {
+        case DecoderIsa::SCALAR:
+            return true;
+#ifdef MDFH_HAS_X86_DECODERS
+        case DecoderIsa::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case DecoderIsa::AVX512:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("avx512f")
+                && __builtin_cpu_supports("avx512vl");
+#endif
+        default:
+            return false;
+    }
+}
+
+DecoderIsa detect_decoder_isa() {
+    static const DecoderIsa detected = [] {
+        if (is_decoder_isa_supported(DecoderIsa::AVX512)) return DecoderIsa::AVX512;
+        if (is_decoder_isa_supported(DecoderIsa::AVX2)) return DecoderIsa::AVX2;
+        return DecoderIsa::SCALAR;
+    }();
+    return detected;
+}
+
+BinaryBatchDecoder::BinaryBatchDecoder(DecoderIsa isa)
+    : isa_(is_decoder_isa_supported(isa) ? isa : detect_decoder_isa()),
+      decode_fn_(select_decoder(isa_)) {}
+
+} // namespace mdfh
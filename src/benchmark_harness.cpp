@@ -0,0 +1,784 @@
+#include "mdfh/benchmark_harness.hpp"
+#include "mdfh/encoding.hpp"
+#include "mdfh/histogram.hpp"
+#include "mdfh/ingestion.hpp"
+#include "mdfh/kernel_bypass.hpp"
+#include "mdfh/placement.hpp"
+#include "mdfh/ring_buffer.hpp"
+#include "mdfh/timing.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <ctime>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include <boost/asio.hpp>
+#include <unistd.h>
+#include <yaml-cpp/yaml.h>
+
+namespace mdfh {
+
+namespace {
+
+constexpr std::size_t MAX_DATAGRAM = 65507;
+constexpr std::uint64_t POOL_MESSAGES = 65536;     // Messages pre-encoded per producer, cycled
+
+// A producer's pre-encoded packets of batch_size messages each
+struct PacketPool {
+    std::vector<std::uint8_t> bytes;
+    std::vector<std::size_t> offsets;                // Packet i is [offsets[i], offsets[i + 1])
+    std::size_t max_packet = 0;
+
+    std::size_t packets() const { return offsets.size() - 1; }
+    std::span<const std::uint8_t> packet(std::size_t i) const {
+        return {bytes.data() + offsets[i], offsets[i + 1] - offsets[i]};
+    }
+};
+
+PacketPool encode_packets(EncodingType encoding, std::uint32_t batch, std::uint32_t producer) {
+    auto encoder = create_encoder(encoding);
+    auto packets = std::max<std::uint64_t>(16, POOL_MESSAGES / batch);
+
+    PacketPool pool;
+    pool.bytes.resize(encoder->max_encoded_size(batch) * packets);
+    pool.offsets.reserve(packets + 1);
+    pool.offsets.push_back(0);
+
+    std::vector<Msg> msgs(batch);
+    std::uint64_t seq = static_cast<std::uint64_t>(producer) << 40;
+    for (std::uint64_t p = 0; p < packets; ++p) {
+        for (auto& msg : msgs) {
+            ++seq;
+            auto level = static_cast<std::int32_t>(seq % 64);
+            msg = Msg(seq, 100.0 + level * 0.01, (seq & 1) ? 1 + level : -(1 + level));
+        }
+        auto out = std::span<std::uint8_t>(pool.bytes).subspan(pool.offsets.back());
+        auto size = encoder->encode_into(msgs, out);
+        pool.max_packet = std::max(pool.max_packet, size);
+        pool.offsets.push_back(pool.offsets.back() + size);
+    }
+    return pool;
+}
+
+// Spins until a producer that has sent `sent` messages is due to send more
+void pace(std::uint64_t start_ns, std::uint64_t sent, std::uint64_t rate) {
+    if (rate == 0) {
+        return;
+    }
+    auto due = start_ns + static_cast<std::uint64_t>(static_cast<double>(sent) * 1e9 / static_cast<double>(rate));
+    while (get_timestamp_ns() < due) {
+        cpu_relax();
+    }
+}
+
+// "0-3,8" for {0, 1, 2, 3, 8}; "?" if unknown
+std::string format_cpus(const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return "?";
+    }
+    std::string text;
+    for (std::size_t i = 0; i < cpus.size();) {
+        auto j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+            ++j;
+        }
+        text += (text.empty() ? "" : ",") + std::to_string(cpus[i]);
+        if (j > i) {
+            text += "-" + std::to_string(cpus[j]);
+        }
+        i = j + 1;
+    }
+    return text;
+}
+
+BypassBackend bypass_backend_of(BenchmarkBackend backend) {
+    return backend == BenchmarkBackend::IO_URING ? BypassBackend::IO_URING : BypassBackend::BOOST_ASIO;
+}
+
+// Two-sided 95% quantile of Student's t for df = 1..30
+double t_critical_95(std::size_t df) {
+    static constexpr double TABLE[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    return df >= 1 && df <= 30 ? TABLE[df - 1] : 1.960;
+}
+
+std::string lowercase(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+template <typename T>
+std::string to_text(const T& value) {
+    std::ostringstream os;
+    os << value;
+    return os.str();
+}
+
+// A scalar or a list of scalars, each converted with parse
+template <typename T, typename Parse>
+void load_list(const YAML::Node& node, std::vector<T>& values, Parse parse) {
+    if (!node) {
+        return;
+    }
+    values.clear();
+    if (node.IsSequence()) {
+        for (const auto& item : node) {
+            values.push_back(parse(item));
+        }
+    } else {
+        values.push_back(parse(node));
+    }
+}
+
+std::string json_escape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += ' ';
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+void write_summary(std::ostream& os, const BenchmarkSummary& summary) {
+    os << "{\"mean\": " << summary.mean << ", \"stddev\": " << summary.stddev << ", \"ci95\": " << summary.ci95 << "}";
+}
+
+BenchmarkSummary load_summary(const YAML::Node& node) {
+    BenchmarkSummary summary;
+    if (node) {
+        summary.mean = node["mean"].as<double>();
+        summary.stddev = node["stddev"].as<double>(0.0);
+        summary.ci95 = node["ci95"].as<double>(0.0);
+    }
+    return summary;
+}
+
+std::string utc_timestamp() {
+    auto now = std::time(nullptr);
+    std::tm tm{};
+    gmtime_r(&now, &tm);
+    char text[32];
+    std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", &tm);
+    return text;
+}
+
+std::string host_name() {
+    char name[256] = {};
+    return ::gethostname(name, sizeof(name) - 1) == 0 ? name : "unknown";
+}
+
+} // namespace
+
+std::ostream& operator<<(std::ostream& os, BenchmarkBackend backend) {
+    switch (backend) {
+        case BenchmarkBackend::MEMORY: return os << "MEMORY";
+        case BenchmarkBackend::BOOST_ASIO: return os << "BOOST_ASIO";
+        case BenchmarkBackend::IO_URING: return os << "IO_URING";
+    }
+    return os << "UNKNOWN_BENCHMARK_BACKEND";
+}
+
+BenchmarkBackend parse_benchmark_backend(const std::string& name) {
+    auto lower = lowercase(name);
+    if (lower == "memory") return BenchmarkBackend::MEMORY;
+    if (lower == "asio" || lower == "boost_asio") return BenchmarkBackend::BOOST_ASIO;
+    if (lower == "io_uring" || lower == "uring") return BenchmarkBackend::IO_URING;
+    throw std::invalid_argument("Unknown benchmark backend: " + name);
+}
+
+std::string BenchmarkScenario::id() const {
+    std::ostringstream os;
+    os << "capacity=" << capacity << "/batch=" << batch_size << "/producers=" << producers
+       << "/encoding=" << encoding << "/backend=" << backend << "/wait=" << wait;
+    return os.str();
+}
+
+std::vector<BenchmarkScenario> BenchmarkMatrix::expand() const {
+    std::vector<BenchmarkScenario> scenarios;
+    for (auto backend : backends) {
+        for (auto encoding : encodings) {
+            for (auto producer_count : producers) {
+                for (auto capacity : capacities) {
+                    for (auto batch : batch_sizes) {
+                        for (auto wait : waits) {
+                            BenchmarkScenario scenario;
+                            scenario.capacity = capacity;
+                            scenario.batch_size = batch;
+                            scenario.producers = producer_count;
+                            scenario.encoding = encoding;
+                            scenario.backend = backend;
+                            scenario.wait = wait;
+                            scenarios.push_back(scenario);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return scenarios;
+}
+
+bool BenchmarkMatrix::is_valid() const {
+    auto power_of_two = [](std::uint64_t value) { return value > 0 && (value & (value - 1)) == 0; };
+    return !capacities.empty() && !batch_sizes.empty() && !producers.empty() && !encodings.empty() &&
+           !backends.empty() && !waits.empty() &&
+           std::all_of(capacities.begin(), capacities.end(), power_of_two) &&
+           std::all_of(batch_sizes.begin(), batch_sizes.end(), [](std::uint32_t b) { return b > 0 && b <= 4096; }) &&
+           std::all_of(producers.begin(), producers.end(), [](std::uint32_t p) { return p > 0 && p <= 64; });
+}
+
+bool BenchmarkRunConfig::is_valid() const {
+    boost::system::error_code ec;
+    auto group = boost::asio::ip::make_address(multicast_group, ec);
+    return messages > warmup_messages && repeats > 0 && max_seconds > 0 && !ec && group.is_multicast();
+}
+
+BenchmarkPlan BenchmarkPlan::from_yaml(const std::string& filename) {
+    BenchmarkPlan plan;
+
+    try {
+        YAML::Node yaml = YAML::LoadFile(filename);
+
+        if (auto matrix = yaml["matrix"]) {
+            load_list(matrix["capacity"], plan.matrix.capacities,
+                      [](const YAML::Node& n) { return n.as<std::uint64_t>(); });
+            load_list(matrix["batch_size"], plan.matrix.batch_sizes,
+                      [](const YAML::Node& n) { return n.as<std::uint32_t>(); });
+            load_list(matrix["producers"], plan.matrix.producers,
+                      [](const YAML::Node& n) { return n.as<std::uint32_t>(); });
+            load_list(matrix["encoding"], plan.matrix.encodings,
+                      [](const YAML::Node& n) { return parse_encoding_type(n.as<std::string>()); });
+            load_list(matrix["backend"], plan.matrix.backends,
+                      [](const YAML::Node& n) { return parse_benchmark_backend(n.as<std::string>()); });
+            load_list(matrix["wait_strategy"], plan.matrix.waits,
+                      [](const YAML::Node& n) { return parse_wait_strategy_type(n.as<std::string>()); });
+        }
+
+        if (auto run = yaml["run"]) {
+            if (run["messages"]) {
+                plan.run.messages = run["messages"].as<std::uint64_t>();
+            }
+            if (run["warmup_messages"]) {
+                plan.run.warmup_messages = run["warmup_messages"].as<std::uint64_t>();
+            }
+            if (run["repeats"]) {
+                plan.run.repeats = run["repeats"].as<std::uint32_t>();
+            }
+            if (run["rate"]) {
+                plan.run.rate = run["rate"].as<std::uint64_t>();
+            }
+            if (run["max_seconds"]) {
+                plan.run.max_seconds = run["max_seconds"].as<std::uint32_t>();
+            }
+            if (run["drain_ms"]) {
+                plan.run.drain_ms = run["drain_ms"].as<std::uint32_t>();
+            }
+            if (run["cores"]) {
+                plan.run.cores = run["cores"].as<std::vector<int>>();
+            }
+            if (run["multicast_group"]) {
+                plan.run.multicast_group = run["multicast_group"].as<std::string>();
+            }
+            if (run["base_port"]) {
+                plan.run.base_port = run["base_port"].as<std::uint16_t>();
+            }
+        }
+    }
+    catch (const YAML::Exception& e) {
+        throw std::runtime_error("Failed to parse benchmark matrix " + filename + ": " + e.what());
+    }
+
+    return plan;
+}
+
+BenchmarkSummary BenchmarkSummary::of(const std::vector<double>& samples) {
+    BenchmarkSummary summary;
+    if (samples.empty()) {
+        return summary;
+    }
+
+    auto n = samples.size();
+    for (auto sample : samples) {
+        summary.mean += sample;
+    }
+    summary.mean /= static_cast<double>(n);
+
+    if (n > 1) {
+        double squares = 0.0;
+        for (auto sample : samples) {
+            squares += (sample - summary.mean) * (sample - summary.mean);
+        }
+        summary.stddev = std::sqrt(squares / static_cast<double>(n - 1));
+        summary.ci95 = t_critical_95(n - 1) * summary.stddev / std::sqrt(static_cast<double>(n));
+    }
+    return summary;
+}
+
+void ScenarioResult::summarize() {
+    auto metric = [this](auto field) {
+        std::vector<double> samples;
+        samples.reserve(runs.size());
+        for (const auto& run : runs) {
+            samples.push_back(static_cast<double>(run.*field));
+        }
+        return BenchmarkSummary::of(samples);
+    };
+
+    throughput = metric(&BenchmarkRun::throughput);
+    drop_rate = metric(&BenchmarkRun::drop_rate);
+    p50 = metric(&BenchmarkRun::p50_ns);
+    p99 = metric(&BenchmarkRun::p99_ns);
+    p999 = metric(&BenchmarkRun::p999_ns);
+    p9999 = metric(&BenchmarkRun::p9999_ns);
+    max = metric(&BenchmarkRun::max_ns);
+}
+
+// Producer p decodes into its own SPSC ring, so producers never contend and
+// the consumer drains the lanes round-robin, batch_size slots at a time.
+// MEMORY producers decode straight from their packet pool; the network
+// backends receive each producer's packets from a sender thread over
+// loopback multicast and decode on the backend's reception thread.
+BenchmarkRun run_benchmark_scenario(const BenchmarkScenario& scenario, const BenchmarkRunConfig& run) {
+    const bool network = scenario.backend != BenchmarkBackend::MEMORY;
+    const auto producers = scenario.producers;
+    const auto packets_per_producer = (run.messages + scenario.batch_size - 1) / scenario.batch_size;
+    auto core_of = [&run](std::size_t index) { return index < run.cores.size() ? run.cores[index] : -1; };
+
+    // Affinity each thread observed once running, indexed like run.cores:
+    // consumer, producers (reception threads on network backends), senders.
+    // Each entry is written by its own thread and read after the joins.
+    const std::size_t roles = network ? 1 + 2 * static_cast<std::size_t>(producers) : 1 + producers;
+    std::vector<std::vector<int>> observed(roles);
+    std::vector<char> observed_io(producers, 0);
+    auto role_name = [&](std::size_t index) {
+        if (index == 0) {
+            return std::string("consumer");
+        }
+        if (index <= producers) {
+            return (network ? "io" : "producer") + std::to_string(index - 1);
+        }
+        return "sender" + std::to_string(index - 1 - producers);
+    };
+
+    std::vector<PacketPool> pools;
+    for (std::uint32_t p = 0; p < producers; ++p) {
+        pools.push_back(encode_packets(scenario.encoding, scenario.batch_size, p));
+    }
+    if (network && pools.front().max_packet > MAX_DATAGRAM) {
+        throw std::runtime_error("a batch of " + std::to_string(scenario.batch_size) + " " +
+                                 to_text(scenario.encoding) + " messages does not fit in a UDP datagram");
+    }
+
+    WaitSignal signal;
+    std::vector<std::unique_ptr<RingBuffer>> rings;
+    std::vector<MessageParser> parsers;
+    for (std::uint32_t p = 0; p < producers; ++p) {
+        rings.push_back(std::make_unique<RingBuffer>(scenario.capacity));
+        rings.back()->set_consumer_signal(&signal);
+        parsers.emplace_back(scenario.encoding);
+    }
+
+    // Network backends: one client per producer, all joined before any traffic
+    std::vector<std::unique_ptr<KernelBypassClient>> clients;
+    if (network) {
+        auto backend = bypass_backend_of(scenario.backend);
+        for (std::uint32_t p = 0; p < producers; ++p) {
+            BypassConfig config;
+            config.backend = backend;
+            config.transport = TransportType::UDP_MULTICAST;
+            config.host = run.multicast_group;
+            config.port = static_cast<std::uint16_t>(run.base_port + p);
+            config.multicast_interface = "127.0.0.1";
+            config.encoding = scenario.encoding;
+            config.wait_strategy = scenario.wait;
+            config.cpu_core = core_of(1 + p);
+            config.io_uring_buffer_size = static_cast<std::uint32_t>((pools[p].max_packet + 4095) / 4096 * 4096);
+
+            auto client = create_bypass_client(backend);
+            if (client->backend_type() != backend) {
+                throw std::runtime_error(to_text(scenario.backend) + " backend is not compiled in");
+            }
+            if (!client->initialize(config) || !client->connect()) {
+                throw std::runtime_error("cannot join " + config.host + ":" + std::to_string(config.port) +
+                                         " with " + client->backend_info());
+            }
+
+            auto* raw = client.get();
+            auto& ring = *rings[p];
+            auto& parser = parsers[p];
+            auto& io_affinity = observed[1 + p];
+            auto& io_seen = observed_io[p];
+            client->start_batch_reception([raw, &ring, &parser, &io_affinity, &io_seen](std::span<const PacketDesc> packets) {
+                if (!io_seen) {
+                    io_affinity = current_cpu_affinity();
+                    io_seen = 1;
+                }
+                auto burst_ts = get_timestamp_ns();
+                ring.hold_commits();
+                for (const auto& packet : packets) {
+                    parser.decode(packet.data, packet.length, packet.timestamp_ns != 0 ? packet.timestamp_ns : burst_ts, ring);
+                    raw->release_packet(packet.context);
+                }
+                ring.publish();
+            });
+            clients.push_back(std::move(client));
+        }
+    }
+
+    std::atomic<bool> start{false};
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint32_t> producers_done{0};
+    std::atomic<std::uint64_t> start_ns{0};
+    std::vector<std::uint64_t> sent(producers, 0);       // Each written by its producer, read after join
+    std::vector<std::thread> threads;
+
+    for (std::uint32_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            const auto role = network ? 1 + producers + p : 1 + p;
+            pin_current_thread(core_of(role), "benchmark producer");
+            observed[role] = current_cpu_affinity();
+            const auto& pool = pools[p];
+
+            std::unique_ptr<boost::asio::io_context> ctx;
+            std::unique_ptr<boost::asio::ip::udp::socket> socket;
+            boost::asio::ip::udp::endpoint destination;
+            if (network) {
+                namespace ip = boost::asio::ip;
+                ctx = std::make_unique<boost::asio::io_context>();
+                socket = std::make_unique<ip::udp::socket>(*ctx, ip::udp::v4());
+                socket->set_option(ip::multicast::outbound_interface(ip::address_v4::loopback()));
+                socket->set_option(ip::multicast::enable_loopback(true));
+                destination = ip::udp::endpoint(ip::make_address(run.multicast_group),
+                                                static_cast<std::uint16_t>(run.base_port + p));
+            }
+
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            auto begin = start_ns.load(std::memory_order_relaxed);
+
+            std::uint64_t messages = 0;
+            for (std::uint64_t i = 0; i < packets_per_producer && !stop.load(std::memory_order_relaxed); ++i) {
+                pace(begin, messages, run.rate);
+                auto packet = pool.packet(i % pool.packets());
+                if (network) {
+                    // A datagram the kernel refuses is lost like one dropped on the wire
+                    boost::system::error_code ec;
+                    socket->send_to(boost::asio::buffer(packet.data(), packet.size()), destination, 0, ec);
+                } else {
+                    parsers[p].decode(packet.data(), packet.size(), get_timestamp_ns(), *rings[p]);
+                }
+                messages += scenario.batch_size;
+            }
+
+            sent[p] = messages;
+            producers_done.fetch_add(1, std::memory_order_release);
+        });
+    }
+
+    // Consumer
+    auto latency = std::make_unique<LatencyHistogram>();
+    const std::uint64_t warmup = run.warmup_messages * producers;
+    std::uint64_t consumed = 0;
+    std::uint64_t measure_start = 0;
+    std::uint64_t last_consumed_ns = 0;
+
+    std::thread consumer([&]() {
+        pin_current_thread(core_of(0), "benchmark consumer");
+        observed[0] = current_cpu_affinity();
+        WaitConfig wait;
+        wait.type = scenario.wait;
+        WaitStrategy waiter(wait, &signal);
+
+        auto now = get_timestamp_ns();
+        start_ns.store(now, std::memory_order_relaxed);
+        if (warmup == 0) {
+            measure_start = now;
+        }
+        const auto deadline = now + static_cast<std::uint64_t>(run.max_seconds) * 1'000'000'000ULL;
+        const auto drain_ns = static_cast<std::uint64_t>(run.drain_ms) * 1'000'000ULL;
+        std::uint64_t quiet_since = 0;
+        start.store(true, std::memory_order_release);
+
+        while (true) {
+            std::uint64_t got = 0;
+            for (auto& ring : rings) {
+                auto batch_ts = get_timestamp_ns();
+                got += ring->consume_batch([&](const Slot& slot) {
+                    if (++consumed > warmup) {
+                        latency->record(batch_ts > slot.rx_ts ? batch_ts - slot.rx_ts : 0);
+                    } else if (consumed == warmup) {
+                        measure_start = batch_ts;
+                    }
+                }, scenario.batch_size);
+            }
+
+            now = get_timestamp_ns();
+            if (got > 0) {
+                last_consumed_ns = now;
+                quiet_since = 0;
+                waiter.reset();
+                continue;
+            }
+
+            // Every producer published before it counted itself done, so
+            // empty rings now mean everything decoded has been consumed
+            if (producers_done.load(std::memory_order_acquire) == producers) {
+                if (quiet_since == 0) {
+                    quiet_since = now;
+                }
+                if (!network || now - quiet_since >= drain_ns) {
+                    break;
+                }
+            }
+            if (now >= deadline) {
+                stop.store(true, std::memory_order_relaxed);
+                break;
+            }
+            waiter.idle();
+        }
+    });
+
+    consumer.join();
+    stop.store(true, std::memory_order_relaxed);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (auto& client : clients) {
+        client->stop_reception();
+        client->disconnect();
+    }
+
+    // A thread that is not where run.cores put it would measure accidental
+    // co-location rather than the scenario
+    BenchmarkRun result;
+    for (std::size_t i = 0; i < roles; ++i) {
+        auto name = role_name(i);
+        result.placement += (i > 0 ? " " : "") + name + "=" + format_cpus(observed[i]);
+        auto core = core_of(i);
+        if (core >= 0 && !observed[i].empty() && observed[i] != std::vector<int>{core}) {
+            throw std::runtime_error(name + " ran on CPUs " + format_cpus(observed[i]) + ", not core " +
+                                     std::to_string(core));
+        }
+    }
+    for (auto count : sent) {
+        result.sent += count;
+    }
+    result.consumed = consumed;
+    result.drop_rate = result.sent > 0 ? 1.0 - static_cast<double>(consumed) / static_cast<double>(result.sent) : 0.0;
+    if (consumed > warmup && last_consumed_ns > measure_start) {
+        result.throughput = static_cast<double>(consumed - warmup) * 1e9 /
+                            static_cast<double>(last_consumed_ns - measure_start);
+    }
+    if (latency->count() > 0) {
+        result.p50_ns = latency->value_at_percentile(0.50);
+        result.p99_ns = latency->value_at_percentile(0.99);
+        result.p999_ns = latency->value_at_percentile(0.999);
+        result.p9999_ns = latency->value_at_percentile(0.9999);
+        result.max_ns = latency->max();
+    }
+    return result;
+}
+
+ScenarioResult run_benchmark_repeats(const BenchmarkScenario& scenario, const BenchmarkRunConfig& run) {
+    ScenarioResult result;
+    result.scenario = scenario;
+    result.id = scenario.id();
+
+    try {
+        run_benchmark_scenario(scenario, run);      // Warm-up: page faults, socket joins, CPU frequency
+        for (std::uint32_t r = 0; r < run.repeats; ++r) {
+            result.runs.push_back(run_benchmark_scenario(scenario, run));
+        }
+    }
+    catch (const std::runtime_error& e) {
+        result.skipped = e.what();
+        result.runs.clear();
+    }
+
+    result.summarize();
+    return result;
+}
+
+void write_benchmark_json(std::ostream& os, const std::vector<ScenarioResult>& results, const BenchmarkRunConfig& run) {
+    auto flags = os.flags();
+    auto precision = os.precision();
+    os << std::setprecision(10);
+
+    os << "{\n";
+    os << "  \"format\": \"mdfh-benchmark\",\n";
+    os << "  \"version\": 1,\n";
+    os << "  \"host\": \"" << json_escape(host_name()) << "\",\n";
+    os << "  \"cpus\": " << std::thread::hardware_concurrency() << ",\n";
+    os << "  \"timestamp\": \"" << utc_timestamp() << "\",\n";
+    os << "  \"run\": {\"messages\": " << run.messages << ", \"warmup_messages\": " << run.warmup_messages
+       << ", \"repeats\": " << run.repeats << ", \"rate\": " << run.rate << "},\n";
+    os << "  \"scenarios\": [";
+
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        const auto& s = result.scenario;
+        os << (i == 0 ? "\n" : ",\n");
+        os << "    {\n";
+        os << "      \"id\": \"" << json_escape(result.id) << "\",\n";
+        os << "      \"capacity\": " << s.capacity << ", \"batch_size\": " << s.batch_size
+           << ", \"producers\": " << s.producers << ",\n";
+        os << "      \"encoding\": \"" << s.encoding << "\", \"backend\": \"" << s.backend
+           << "\", \"wait_strategy\": \"" << s.wait << "\",\n";
+        if (!result.skipped.empty()) {
+            os << "      \"skipped\": \"" << json_escape(result.skipped) << "\",\n";
+        }
+        os << "      \"runs\": " << result.runs.size() << ",\n";
+        os << "      \"throughput\": ";
+        write_summary(os, result.throughput);
+        os << ",\n      \"drop_rate\": ";
+        write_summary(os, result.drop_rate);
+        os << ",\n      \"latency_ns\": {\n";
+        os << "        \"p50\": ";
+        write_summary(os, result.p50);
+        os << ",\n        \"p99\": ";
+        write_summary(os, result.p99);
+        os << ",\n        \"p99.9\": ";
+        write_summary(os, result.p999);
+        os << ",\n        \"p99.99\": ";
+        write_summary(os, result.p9999);
+        os << ",\n        \"max\": ";
+        write_summary(os, result.max);
+        os << "\n      }\n";
+        os << "    }";
+    }
+
+    os << "\n  ]\n}\n";
+    os.flags(flags);
+    os.precision(precision);
+}
+
+void write_benchmark_csv(std::ostream& os, const std::vector<ScenarioResult>& results) {
+    auto flags = os.flags();
+    auto precision = os.precision();
+    os << std::setprecision(10);
+
+    os << "id,capacity,batch_size,producers,encoding,backend,wait_strategy,status,runs,"
+          "throughput_mean,throughput_ci95,drop_rate_mean,drop_rate_ci95,"
+          "p50_ns_mean,p99_ns_mean,p99_ns_ci95,p999_ns_mean,p999_ns_ci95,p9999_ns_mean,max_ns_mean\n";
+    for (const auto& result : results) {
+        const auto& s = result.scenario;
+        os << result.id << "," << s.capacity << "," << s.batch_size << "," << s.producers << ","
+           << s.encoding << "," << s.backend << "," << s.wait << ","
+           << (result.skipped.empty() ? "ok" : "skipped") << "," << result.runs.size() << ","
+           << result.throughput.mean << "," << result.throughput.ci95 << ","
+           << result.drop_rate.mean << "," << result.drop_rate.ci95 << ","
+           << result.p50.mean << "," << result.p99.mean << "," << result.p99.ci95 << ","
+           << result.p999.mean << "," << result.p999.ci95 << "," << result.p9999.mean << ","
+           << result.max.mean << "\n";
+    }
+
+    os.flags(flags);
+    os.precision(precision);
+}
+
+std::vector<ScenarioResult> load_benchmark_baseline(const std::string& filename) {
+    std::vector<ScenarioResult> results;
+
+    try {
+        // JSON is a subset of YAML
+        YAML::Node json = YAML::LoadFile(filename);
+        if (json["format"].as<std::string>("") != "mdfh-benchmark") {
+            throw std::runtime_error(filename + " is not a benchmark report");
+        }
+
+        for (const auto& node : json["scenarios"]) {
+            ScenarioResult result;
+            result.id = node["id"].as<std::string>();
+            result.scenario.capacity = node["capacity"].as<std::uint64_t>();
+            result.scenario.batch_size = node["batch_size"].as<std::uint32_t>();
+            result.scenario.producers = node["producers"].as<std::uint32_t>();
+            result.scenario.encoding = parse_encoding_type(node["encoding"].as<std::string>());
+            result.scenario.backend = parse_benchmark_backend(node["backend"].as<std::string>());
+            result.scenario.wait = parse_wait_strategy_type(node["wait_strategy"].as<std::string>());
+            result.skipped = node["skipped"].as<std::string>("");
+
+            result.throughput = load_summary(node["throughput"]);
+            result.drop_rate = load_summary(node["drop_rate"]);
+            auto latency = node["latency_ns"];
+            result.p50 = load_summary(latency["p50"]);
+            result.p99 = load_summary(latency["p99"]);
+            result.p999 = load_summary(latency["p99.9"]);
+            result.p9999 = load_summary(latency["p99.99"]);
+            result.max = load_summary(latency["max"]);
+            results.push_back(std::move(result));
+        }
+    }
+    catch (const YAML::Exception& e) {
+        throw std::runtime_error("Failed to parse benchmark baseline " + filename + ": " + e.what());
+    }
+    catch (const std::invalid_argument& e) {
+        throw std::runtime_error("Failed to parse benchmark baseline " + filename + ": " + e.what());
+    }
+
+    return results;
+}
+
+std::vector<BenchmarkRegression> compare_to_baseline(const std::vector<ScenarioResult>& current,
+                                                     const std::vector<ScenarioResult>& baseline,
+                                                     double tolerance) {
+    std::unordered_map<std::string, const ScenarioResult*> by_id;
+    for (const auto& result : baseline) {
+        if (result.skipped.empty()) {
+            by_id.emplace(result.id, &result);
+        }
+    }
+
+    std::vector<BenchmarkRegression> regressions;
+    auto check = [&](const std::string& id, const char* metric, const BenchmarkSummary& base,
+                     const BenchmarkSummary& now, bool higher_is_worse) {
+        // Worse by more than the tolerance, and not explained by run-to-run noise
+        bool worse = higher_is_worse
+            ? now.mean > base.mean * (1.0 + tolerance) && now.low() > base.high()
+            : now.mean < base.mean * (1.0 - tolerance) && now.high() < base.low();
+        if (worse) {
+            double change = base.mean != 0.0 ? (now.mean - base.mean) / base.mean : 1.0;
+            regressions.push_back({id, metric, base.mean, now.mean, higher_is_worse ? change : -change});
+        }
+    };
+
+    for (const auto& result : current) {
+        auto it = by_id.find(result.id);
+        if (!result.skipped.empty() || it == by_id.end()) {
+            continue;
+        }
+        const auto& base = *it->second;
+        check(result.id, "throughput", base.throughput, result.throughput, false);
+        check(result.id, "p50_ns", base.p50, result.p50, true);
+        check(result.id, "p99_ns", base.p99, result.p99, true);
+        check(result.id, "p99.9_ns", base.p999, result.p999, true);
+
+        // Drop rates sit near zero, where a relative tolerance alone is meaningless
+        if (result.drop_rate.mean > base.drop_rate.mean * (1.0 + tolerance) + 0.001 &&
+            result.drop_rate.low() > base.drop_rate.high()) {
+            regressions.push_back({result.id, "drop_rate", base.drop_rate.mean, result.drop_rate.mean,
+                                   result.drop_rate.mean - base.drop_rate.mean});
+        }
+    }
+    return regressions;
+}
+
+} // namespace mdfh
@@ -0,0 +1,171 @@
+#include "mdfh/conflation.hpp"
+#include "mdfh/multi_feed_ingestion.hpp"
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cmath>
+#include <ostream>
+#include <stdexcept>
+
+namespace mdfh {
+
+namespace {
+
+using SlotWords = std::array<std::uint64_t, 4>;
+static_assert(sizeof(SlotWords) == sizeof(MultiFeedSlot), "MultiFeedSlot must be four words");
+
+// Fibonacci hashing: the top bits of key * 2^64/phi
+std::size_t hash_index(std::uint64_t key, unsigned bits) {
+    return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >> (64 - bits));
+}
+
+} // namespace
+
+std::ostream& operator<<(std::ostream& os, ConflationKey key) {
+    switch (key) {
+        case ConflationKey::ORIGIN: return os << "ORIGIN";
+        case ConflationKey::PRICE_LEVEL: return os << "PRICE_LEVEL";
+    }
+    return os << "UNKNOWN_CONFLATION_KEY";
+}
+
+ConflationKey parse_conflation_key(const std::string& name) {
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (lower == "origin") return ConflationKey::ORIGIN;
+    if (lower == "price_level") return ConflationKey::PRICE_LEVEL;
+    throw std::invalid_argument("Unknown conflation key: " + name);
+}
+
+bool ConflationConfig::is_valid() const {
+    return tick_size > 0.0 && poll_interval_ms > 0 && max_keys <= (1u << 30);
+}
+
+LastValueCache::LastValueCache(const ConflationConfig& config) : config_(config) {
+    if (!config_.enabled() || !config_.is_valid()) {
+        throw std::invalid_argument("Invalid conflation configuration");
+    }
+
+    // Load factor at most 1/2 keeps probe sequences short
+    table_size_ = std::max<std::size_t>(64, std::bit_ceil(static_cast<std::size_t>(config_.max_keys) * 2));
+    entries_ = std::make_unique<Entry[]>(table_size_);
+    dirty_words_ = table_size_ / 64;
+    dirty_ = std::make_unique<std::atomic<std::uint64_t>[]>(dirty_words_);
+    pending_dirty_.assign(dirty_words_, 0);
+    touched_words_.reserve(dirty_words_);
+}
+
+std::uint64_t LastValueCache::key_of(const MultiFeedSlot& slot) const {
+    std::uint64_t origin = slot.origin_id;
+    if (config_.key == ConflationKey::ORIGIN) {
+        return origin;
+    }
+
+    // origin (16 bits) | sell side (1 bit) | price level (47 bits)
+    auto level = static_cast<std::int64_t>(std::llround(slot.raw.px / config_.tick_size));
+    std::uint64_t side = slot.raw.qty < 0 ? 1 : 0;
+    return (origin << 48) | (side << 47) | (static_cast<std::uint64_t>(level) & ((1ULL << 47) - 1));
+}
+
+std::size_t LastValueCache::find_or_insert(std::uint64_t key) {
+    auto bits = static_cast<unsigned>(std::countr_zero(table_size_));
+    auto mask = table_size_ - 1;
+    for (auto index = hash_index(key, bits);; index = (index + 1) & mask) {
+        auto& entry = entries_[index];
+        if (entry.key == key) {
+            return index;
+        }
+        if (entry.key == EMPTY_KEY) {
+            if (key_count_ >= config_.max_keys) {
+                return table_size_;
+            }
+            entry.key = key;
+            keys_.store(++key_count_, std::memory_order_relaxed);
+            return index;
+        }
+    }
+}
+
+std::uint64_t LastValueCache::update(const MultiFeedSlot* slots, std::uint64_t count) {
+    std::uint64_t stored = 0;
+    for (std::uint64_t i = 0; i < count; ++i) {
+        auto index = find_or_insert(key_of(slots[i]));
+        if (index == table_size_) {
+            continue;
+        }
+
+        auto& entry = entries_[index];
+        auto words = std::bit_cast<SlotWords>(slots[i]);
+        auto version = entry.version.load(std::memory_order_relaxed);
+        entry.version.store(version + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t w = 0; w < words.size(); ++w) {
+            entry.value[w].store(words[w], std::memory_order_relaxed);
+        }
+        entry.version.store(version + 2, std::memory_order_release);
+
+        auto word = index / 64;
+        if (pending_dirty_[word] == 0) {
+            touched_words_.push_back(word);
+        }
+        pending_dirty_[word] |= 1ULL << (index % 64);
+        ++stored;
+    }
+
+    // One locked RMW per touched bitmap word per batch, not per message
+    for (auto word : touched_words_) {
+        dirty_[word].fetch_or(pending_dirty_[word], std::memory_order_release);
+        pending_dirty_[word] = 0;
+    }
+    touched_words_.clear();
+
+    updates_.store(updates_.load(std::memory_order_relaxed) + stored, std::memory_order_relaxed);
+    if (stored < count) {
+        overflows_.store(overflows_.load(std::memory_order_relaxed) + (count - stored), std::memory_order_relaxed);
+    }
+    return stored;
+}
+
+std::uint64_t LastValueCache::collect(MultiFeedSlot* out, std::uint64_t max_count) {
+    std::uint64_t collected = 0;
+    for (std::size_t scanned = 0; scanned < dirty_words_ && collected < max_count; ++scanned) {
+        auto word = scan_word_;
+        if (dirty_[word].load(std::memory_order_relaxed) == 0) {
+            scan_word_ = (scan_word_ + 1) % dirty_words_;
+            continue;
+        }
+
+        // Clear before reading: an update racing the copy sets the bit again
+        auto bits = dirty_[word].exchange(0, std::memory_order_acquire);
+        while (bits != 0 && collected < max_count) {
+            auto bit = static_cast<std::size_t>(std::countr_zero(bits));
+            bits &= bits - 1;
+
+            const auto& entry = entries_[word * 64 + bit];
+            SlotWords words;
+            std::uint64_t before;
+            do {
+                before = entry.version.load(std::memory_order_acquire);
+                for (std::size_t w = 0; w < words.size(); ++w) {
+                    words[w] = entry.value[w].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+            } while ((before & 1) != 0 || entry.version.load(std::memory_order_relaxed) != before);
+
+            out[collected++] = std::bit_cast<MultiFeedSlot>(words);
+        }
+
+        if (bits != 0) {
+            dirty_[word].fetch_or(bits, std::memory_order_relaxed);     // Out of room: next call resumes here
+        } else {
+            scan_word_ = (scan_word_ + 1) % dirty_words_;
+        }
+    }
+
+    delivered_.store(delivered_.load(std::memory_order_relaxed) + collected, std::memory_order_relaxed);
+    return collected;
+}
+
+} // namespace mdfh
@@ -0,0 +1,409 @@
+#include "mdfh/decoding.hpp"
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Branch prediction hints for the per-frame path
+#ifndef LIKELY
+#define LIKELY(x) __builtin_expect(!!(x), 1)
+#endif
+#ifndef UNLIKELY
+#define UNLIKELY(x) __builtin_expect(!!(x), 0)
+#endif
+
+namespace mdfh {
+
+namespace {
+
+constexpr std::uint8_t SOH = 0x01;
+
+// Calls fn(index) for every SOH byte in order until fn returns false.
+// SSE2 is part of the x86-64 baseline, so no runtime dispatch is needed.
+template<typename Fn>
+inline void for_each_soh(const std::uint8_t* data, std::size_t length, Fn&& fn) {
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i soh = _mm_set1_epi8(static_cast<char>(SOH));
+    for (; i + 16 <= length; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, soh)));
+        while (mask != 0) {
+            if (!fn(i + static_cast<std::size_t>(__builtin_ctz(mask)))) {
+                return;
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i < length; ++i) {
+        if (data[i] == SOH && !fn(i)) {
+            return;
+        }
+    }
+}
+
+// Sum of bytes for the FIX checksum (tag 10)
+inline std::uint32_t byte_sum(const std::uint8_t* data, std::size_t length) {
+    std::uint32_t sum = 0;
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(chunk, _mm_setzero_si128()));
+    }
+    sum = static_cast<std::uint32_t>(_mm_cvtsi128_si32(acc) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(acc, acc)));
+#endif
+    for (; i < length; ++i) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+inline bool parse_uint(const std::uint8_t* p, std::size_t length, std::uint64_t& out) {
+    if (length == 0 || length > 19) {
+        return false;
+    }
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < length; ++i) {
+        unsigned digit = static_cast<unsigned>(p[i] - '0');
+        if (digit > 9) {
+            return false;
+        }
+        value = value * 10 + digit;
+    }
+    out = value;
+    return true;
+}
+
+// Decimal price "123.4567" -> double, exact for the encoder's 4 decimals
+inline bool parse_price(const std::uint8_t* p, std::size_t length, double& out) {
+    static constexpr double POW10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+
+    std::uint64_t mantissa = 0;
+    std::size_t digits = 0;
+    std::size_t frac_digits = 0;
+    bool seen_point = false;
+
+    for (std::size_t i = 0; i < length; ++i) {
+        if (p[i] == '.' && !seen_point) {
+            seen_point = true;
+            continue;
+        }
+        unsigned digit = static_cast<unsigned>(p[i] - '0');
+        if (digit > 9 || ++digits > 18 || (seen_point && frac_digits == 9)) {
+            return false;
+        }
+        mantissa = mantissa * 10 + digit;
+        frac_digits += seen_point ? 1 : 0;
+    }
+    if (digits == 0) {
+        return false;
+    }
+    out = static_cast<double>(mantissa) / POW10[frac_digits];
+    return true;
+}
+
+} // namespace
+
+// BinaryDecoder implementation
+DecodeCounts BinaryDecoder::decode(const std::uint8_t* data, std::size_t size, std::uint64_t rx_ts, RingBuffer& ring) {
+    DecodeCounts counts;
+    std::size_t offset = 0;
+
+    // Complete a record split across the previous read
+    if (partial_size_ > 0) {
+        std::size_t needed = sizeof(Msg) - partial_size_;
+        if (size < needed) {
+            std::memcpy(partial_buffer_.data() + partial_size_, data, size);
+            partial_size_ += size;
+            return counts;
+        }
+
+        std::memcpy(partial_buffer_.data() + partial_size_, data, needed);
+        decode_records(partial_buffer_.data(), 1, rx_ts, ring, counts);
+        partial_size_ = 0;
+        offset = needed;
+    }
+
+    // Decode all complete records in place
+    std::size_t complete = (size - offset) / sizeof(Msg);
+    decode_records(data + offset, complete, rx_ts, ring, counts);
+    offset += complete * sizeof(Msg);
+
+    if (offset < size) {
+        partial_size_ = size - offset;
+        std::memcpy(partial_buffer_.data(), data + offset, partial_size_);
+    }
+    return counts;
+}
+
+void BinaryDecoder::decode_records(const std::uint8_t* data, std::size_t count, std::uint64_t rx_ts,
+                                   RingBuffer& ring, DecodeCounts& counts) {
+    while (count > 0) {
+        // Claim may return fewer slots at the wrap point, so loop until done
+        auto slots = ring.claim(count);
+        if (slots.empty()) {
+            // Buffer full, drop the rest of this batch
+            counts.dropped += count;
+            return;
+        }
+
+        // Invalid records are compacted out, so only the valid prefix is published
+        auto result = batch_decoder_.decode(data, slots.size(), slots.data(), rx_ts);
+        ring.commit(result.valid);
+        counts.decoded += result.valid;
+        counts.malformed += result.invalid;
+
+        data += slots.size() * sizeof(Msg);
+        count -= slots.size();
+    }
+}
+
+// ITCH payload parser
+bool ITCHPayloadParser::parse(const std::uint8_t* payload, std::size_t length, Msg& out) const {
+    // MIN_FRAME_SIZE guarantees a full ITCHMsg is readable
+    ITCHMsg itch;
+    std::memcpy(&itch, payload, sizeof(ITCHMsg));
+
+    auto seq = be64toh(itch.seq);
+    auto price = be32toh(itch.price);
+    auto qty = static_cast<std::int32_t>(be32toh(itch.qty));
+    bool is_sell = itch.side == 'S';
+
+    // Validation folded into one branch at the caller
+    bool ok = (length == sizeof(ITCHMsg)) & (itch.msg_type == 'Q') & (is_sell | (itch.side == 'B'))
+            & (seq != 0) & (price != 0) & (qty > 0);
+
+    out.seq = seq;
+    out.px = price / 10000.0;
+    out.qty = qty * (1 - 2 * static_cast<std::int32_t>(is_sell));
+    return ok;
+}
+
+// FIX payload parser
+bool FIXPayloadParser::parse(const std::uint8_t* payload, std::size_t length, Msg& out) const {
+    enum : unsigned { HAVE_TYPE = 1, HAVE_SEQ = 2, HAVE_SIDE = 4, HAVE_PX = 8, HAVE_QTY = 16, HAVE_CHECKSUM = 32 };
+    constexpr unsigned HAVE_ALL = HAVE_TYPE | HAVE_SEQ | HAVE_SIDE | HAVE_PX | HAVE_QTY | HAVE_CHECKSUM;
+
+    if (std::memcmp(payload, "8=FIX", 5) != 0) {
+        return false;
+    }
+
+    unsigned seen = 0;
+    bool ok = true;
+    bool is_sell = false;
+    std::uint64_t seq = 0;
+    std::uint64_t qty = 0;
+    double px = 0.0;
+    std::size_t field_start = 0;
+    std::size_t end = 0;
+
+    for_each_soh(payload, length, [&](std::size_t soh) {
+        const std::uint8_t* field = payload + field_start;
+        std::size_t field_length = soh - field_start;
+
+        // Tag digits up to '='
+        std::uint32_t tag = 0;
+        std::size_t i = 0;
+        while (i < field_length && field[i] != '=') {
+            unsigned digit = static_cast<unsigned>(field[i] - '0');
+            if (digit > 9 || i == 6) {
+                ok = false;
+                return false;
+            }
+            tag = tag * 10 + digit;
+            ++i;
+        }
+        if (i == 0 || i == field_length) {
+            ok = false;
+            return false;
+        }
+
+        const std::uint8_t* value = field + i + 1;
+        std::size_t value_length = field_length - i - 1;
+
+        switch (tag) {
+            case 35:
+                ok &= value_length == 1 && value[0] == 'X';
+                seen |= HAVE_TYPE;
+                break;
+            case 34:
+                ok &= parse_uint(value, value_length, seq);
+                seen |= HAVE_SEQ;
+                break;
+            case 269:
+                ok &= value_length == 1 && (value[0] == '0' || value[0] == '1');
+                is_sell = value[0] == '1';
+                seen |= HAVE_SIDE;
+                break;
+            case 270:
+                ok &= parse_price(value, value_length, px);
+                seen |= HAVE_PX;
+                break;
+            case 271:
+                ok &= parse_uint(value, value_length, qty);
+                seen |= HAVE_QTY;
+                break;
+            case 10: {
+                // Checksum covers every byte before the tag 10 field
+                std::uint64_t expected = 0;
+                ok &= parse_uint(value, value_length, expected);
+                if (verify_checksum) {
+                    ok &= (byte_sum(payload, field_start) % 256) == expected;
+                }
+                seen |= HAVE_CHECKSUM;
+                end = soh + 1;
+                return false;
+            }
+            default:
+                break;
+        }
+
+        field_start = soh + 1;
+        return ok;
+    });
+
+    out.seq = seq;
+    out.px = px;
+    out.qty = static_cast<std::int32_t>(qty) * (is_sell ? -1 : 1);
+
+    return ok && seen == HAVE_ALL && end == length
+        && seq != 0 && px > 0.0 && qty != 0 && qty <= static_cast<std::uint64_t>(INT32_MAX);
+}
+
+// SOFHFramedDecoder implementation
+template<typename PayloadParser>
+std::size_t SOFHFramedDecoder<PayloadParser>::frame_length(const std::uint8_t* data) {
+    SOFH header;
+    std::memcpy(&header, data, sizeof(SOFH));
+
+    std::size_t length = be32toh(header.message_length);
+    bool plausible = (length >= PayloadParser::MIN_FRAME_SIZE) & (length <= MAX_FRAME_SIZE)
+                   & (be16toh(header.encoding_type) == PayloadParser::ENCODING_ID);
+    return plausible ? length : 0;
+}
+
+template<typename PayloadParser>
+void SOFHFramedDecoder<PayloadParser>::emit_frame(const std::uint8_t* frame, std::size_t length, std::size_t frames_hint,
+                                                  std::uint64_t rx_ts, RingBuffer& ring, SlotCursor& cursor,
+                                                  DecodeCounts& counts) {
+    if (cursor.used == cursor.slots.size()) {
+        // Publish what we have and claim room for the rest of this read
+        ring.commit(cursor.used);
+        cursor.used = 0;
+        cursor.slots = ring.claim(frames_hint);
+        if (cursor.slots.empty()) {
+            ++counts.dropped;
+            return;
+        }
+    }
+
+    Slot& slot = cursor.slots[cursor.used];
+    if (LIKELY(parser_.parse(frame + sizeof(SOFH), length - sizeof(SOFH), slot.raw))) {
+        slot.rx_ts = rx_ts;
+        ++cursor.used;
+        ++counts.decoded;
+    } else {
+        ++counts.malformed;
+    }
+}
+
+template<typename PayloadParser>
+DecodeCounts SOFHFramedDecoder<PayloadParser>::decode(const std::uint8_t* data, std::size_t size,
+                                                      std::uint64_t rx_ts, RingBuffer& ring) {
+    DecodeCounts counts;
+    SlotCursor cursor;
+    std::size_t offset = 0;
+
+    // Complete a frame split across the previous read (ZERO ALLOCATION)
+    while (partial_size_ > 0) {
+        if (partial_size_ < sizeof(SOFH)) {
+            std::size_t take = std::min(sizeof(SOFH) - partial_size_, size - offset);
+            std::memcpy(partial_buffer_.data() + partial_size_, data + offset, take);
+            partial_size_ += take;
+            offset += take;
+            if (partial_size_ < sizeof(SOFH)) {
+                return counts;
+            }
+        }
+
+        std::size_t length = frame_length(partial_buffer_.data());
+        if (length == 0) {
+            // Buffered bytes are not a frame start; slide one byte and retry
+            if (!resyncing_) {
+                ++counts.malformed;
+                resyncing_ = true;
+            }
+            --partial_size_;
+            std::memmove(partial_buffer_.data(), partial_buffer_.data() + 1, partial_size_);
+            continue;
+        }
+        resyncing_ = false;
+
+        std::size_t take = std::min(length - partial_size_, size - offset);
+        std::memcpy(partial_buffer_.data() + partial_size_, data + offset, take);
+        partial_size_ += take;
+        offset += take;
+        if (partial_size_ < length) {
+            return counts;
+        }
+
+        emit_frame(partial_buffer_.data(), length, (size - offset) / PayloadParser::MIN_FRAME_SIZE + 1,
+                   rx_ts, ring, cursor, counts);
+        partial_size_ = 0;
+    }
+
+    // Decode all complete frames in place
+    while (size - offset >= sizeof(SOFH)) {
+        std::size_t length = frame_length(data + offset);
+        if (UNLIKELY(length == 0)) {
+            if (!resyncing_) {
+                ++counts.malformed;
+                resyncing_ = true;
+            }
+            ++offset;
+            continue;
+        }
+        resyncing_ = false;
+
+        if (size - offset < length) {
+            break;
+        }
+
+        emit_frame(data + offset, length, (size - offset) / PayloadParser::MIN_FRAME_SIZE + 1,
+                   rx_ts, ring, cursor, counts);
+        offset += length;
+    }
+
+    ring.commit(cursor.used);
+
+    // Save the trailing partial frame; always <= MAX_FRAME_SIZE by construction
+    if (offset < size) {
+        partial_size_ = size - offset;
+        std::memcpy(partial_buffer_.data(), data + offset, partial_size_);
+    }
+    return counts;
+}
+
+template class SOFHFramedDecoder<ITCHPayloadParser>;
+template class SOFHFramedDecoder<FIXPayloadParser>;
+
+// Factory function
+std::unique_ptr<MessageDecoder> create_decoder(EncodingType type) {
+    switch (type) {
+        case EncodingType::BINARY:
+            return std::make_unique<BinaryDecoder>();
+        case EncodingType::FIX:
+            return std::make_unique<FIXDecoder>();
+        case EncodingType::ITCH:
+            return std::make_unique<ITCHDecoder>();
+    }
+    throw std::invalid_argument("Unknown encoding type");
+}
+
+} // namespace mdfh
@@ -5,6 +5,9 @@
 #include <chrono>
 #include <memory>
 #include <ctime>
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
 
 namespace mdfh {
 
@@ -74,44 +77,58 @@ static const char* get_fast_timestamp() {
     return cached_timestamp;
 }
 
-// Binary encoder implementation
-std::vector<std::uint8_t> BinaryEncoder::encode(const std::vector<Msg>& msgs) {
+// MessageEncoder convenience wrappers
+std::vector<std::uint8_t> MessageEncoder::encode(const std::vector<Msg>& msgs) {
     std::vector<std::uint8_t> buffer;
     encode_inplace(msgs, buffer);
     return buffer;
 }
 
-void BinaryEncoder::encode_inplace(const std::vector<Msg>& msgs, std::vector<std::uint8_t>& buffer) {
-    buffer.resize(msgs.size() * sizeof(Msg));
-    std::memcpy(buffer.data(), msgs.data(), buffer.size());
+void MessageEncoder::encode_inplace(const std::vector<Msg>& msgs, std::vector<std::uint8_t>& buffer) {
+    // Only grows when the worst case exceeds the buffer's existing capacity
+    buffer.resize(max_encoded_size(msgs.size()));
+    buffer.resize(encode_into(msgs, buffer));
 }
 
-// FIX encoder implementation
-std::uint8_t FIXEncoder::calculate_checksum(const std::string& msg) const {
-    std::uint32_t sum = 0;
-    for (char c : msg) {
-        sum += static_cast<std::uint8_t>(c);
+// Binary encoder implementation
+std::size_t BinaryEncoder::encode_into(std::span<const Msg> msgs, std::span<std::uint8_t> out,
+                                       std::span<std::size_t> message_ends) {
+    std::size_t bytes = msgs.size() * sizeof(Msg);
+    if (out.size() < bytes) {
+        throw std::length_error("BinaryEncoder output buffer too small");
+    }
+    std::memcpy(out.data(), msgs.data(), bytes);
+    for (std::size_t i = 0; i < message_ends.size(); ++i) {
+        message_ends[i] = (i + 1) * sizeof(Msg);
     }
-    return static_cast<std::uint8_t>(sum % 256);
+    return bytes;
 }
 
-std::vector<std::uint8_t> FIXEncoder::encode(const std::vector<Msg>& msgs) {
-    std::vector<std::uint8_t> buffer;
-    encode_inplace(msgs, buffer);
-    return buffer;
+// FIX encoder implementation
+std::size_t FIXEncoder::max_encoded_size(std::size_t count) const {
+    return count * (sizeof(SOFH) + MAX_FIXED_MESSAGE_SIZE
+                    + config_.sender_comp_id.size() + config_.target_comp_id.size());
 }
 
-void FIXEncoder::encode_inplace(const std::vector<Msg>& msgs, std::vector<std::uint8_t>& buffer) {
-    buffer.clear();
+std::size_t FIXEncoder::encode_into(std::span<const Msg> msgs, std::span<std::uint8_t> out,
+                                    std::span<std::size_t> message_ends) {
+    if (out.size() < max_encoded_size(msgs.size())) {
+        throw std::length_error("FIXEncoder output buffer too small");
+    }
     
-    // Pre-allocate buffer to avoid reallocations
-    buffer.reserve(msgs.size() * 150); // Estimate ~150 bytes per FIX message
+    // Timestamp is cached per second, so resolve it once per batch
+    const char* timestamp = get_fast_timestamp();
+    auto ts_len = std::strlen(timestamp);
     
-    // Thread-local buffer for fast FIX message construction
-    static thread_local char fix_buffer[512];
+    std::uint8_t* cursor = out.data();
+    bool record_ends = !message_ends.empty();
     
-    for (const auto& msg : msgs) {
-        char* p = fix_buffer;
+    for (std::size_t i = 0; i < msgs.size(); ++i) {
+        const Msg& msg = msgs[i];
+        
+        // Message is built in place after the SOFH header
+        char* fix_start = reinterpret_cast<char*>(cursor + sizeof(SOFH));
+        char* p = fix_start;
         
         // FIX 4.4 Market Data Incremental Refresh
         std::memcpy(p, "8=FIX.4.4\x01", 10);
@@ -145,11 +162,9 @@ void FIXEncoder::encode_inplace(const std::vector<Msg>& msgs, std::vector<std::u
         body_p = fast_uint_to_chars(msg.seq, body_p);
         *body_p++ = '\x01';
         
-        // Timestamp (cached per second)
-        const char* timestamp = get_fast_timestamp();
+        // SendingTime
         std::memcpy(body_p, "52=", 3);
         body_p += 3;
-        auto ts_len = std::strlen(timestamp);
         std::memcpy(body_p, timestamp, ts_len);
         body_p += ts_len;
         *body_p++ = '\x01';
@@ -193,7 +208,7 @@ void FIXEncoder::encode_inplace(const std::vector<Msg>& msgs, std::vector<std::u
         
         // Calculate checksum
         std::uint32_t checksum = 0;
-        for (char* cp = fix_buffer; cp < body_p; ++cp) {
+        for (char* cp = fix_start; cp < body_p; ++cp) {
             checksum += static_cast<std::uint8_t>(*cp);
         }
         checksum %= 256;
@@ -201,53 +216,47 @@ void FIXEncoder::encode_inplace(const std::vector<Msg>& msgs, std::vector<std::u
         // Add checksum
         std::memcpy(body_p, "10=", 3);
         body_p += 3;
-        if (checksum < 10) {
-            *body_p++ = '0';
-            *body_p++ = '0';
-            *body_p++ = '0' + checksum;
-        } else if (checksum < 100) {
-            *body_p++ = '0';
-            *body_p++ = '0' + (checksum / 10);
-            *body_p++ = '0' + (checksum % 10);
-        } else {
-            *body_p++ = '0' + (checksum / 100);
-            *body_p++ = '0' + ((checksum / 10) % 10);
-            *body_p++ = '0' + (checksum % 10);
-        }
+        *body_p++ = '0' + (checksum / 100);
+        *body_p++ = '0' + ((checksum / 10) % 10);
+        *body_p++ = '0' + (checksum % 10);
         *body_p++ = '\x01';
         
-        auto complete_msg_len = body_p - fix_buffer;
+        auto complete_msg_len = body_p - fix_start;
         
         // Add SOFH header
         SOFH sofh;
         sofh.message_length = htobe32(static_cast<std::uint32_t>(sizeof(SOFH) + complete_msg_len));
-        sofh.encoding_type = htobe16(0x5000);  // FIX encoding type
+        sofh.encoding_type = htobe16(SOFH_ENCODING_FIX);
+        std::memcpy(cursor, &sofh, sizeof(SOFH));
         
-        // Append to buffer
-        const std::uint8_t* sofh_ptr = reinterpret_cast<const std::uint8_t*>(&sofh);
-        buffer.insert(buffer.end(), sofh_ptr, sofh_ptr + sizeof(SOFH));
-        buffer.insert(buffer.end(), reinterpret_cast<const std::uint8_t*>(fix_buffer), 
-                     reinterpret_cast<const std::uint8_t*>(fix_buffer) + complete_msg_len);
+        cursor = reinterpret_cast<std::uint8_t*>(body_p);
+        if (record_ends) {
+            message_ends[i] = static_cast<std::size_t>(cursor - out.data());
+        }
     }
+    
+    return static_cast<std::size_t>(cursor - out.data());
 }
 
 // ITCH encoder implementation
-std::vector<std::uint8_t> ITCHEncoder::encode(const std::vector<Msg>& msgs) {
-    std::vector<std::uint8_t> buffer;
-    encode_inplace(msgs, buffer);
-    return buffer;
-}
-
-void ITCHEncoder::encode_inplace(const std::vector<Msg>& msgs, std::vector<std::uint8_t>& buffer) {
-    buffer.clear();
+std::size_t ITCHEncoder::encode_into(std::span<const Msg> msgs, std::span<std::uint8_t> out,
+                                     std::span<std::size_t> message_ends) {
+    if (out.size() < max_encoded_size(msgs.size())) {
+        throw std::length_error("ITCHEncoder output buffer too small");
+    }
     
     std::uint64_t timestamp_ns = get_timestamp_ns();
+    std::uint8_t* cursor = out.data();
     
-    for (const auto& msg : msgs) {
-        // SOFH header
-        SOFH sofh;
-        sofh.message_length = htobe32(static_cast<std::uint32_t>(sizeof(SOFH) + sizeof(ITCHMsg)));
-        sofh.encoding_type = htobe16(0x4954);  // 'IT' for ITCH
+    // SOFH header is identical for every message
+    SOFH sofh;
+    sofh.message_length = htobe32(static_cast<std::uint32_t>(sizeof(SOFH) + sizeof(ITCHMsg)));
+    sofh.encoding_type = htobe16(SOFH_ENCODING_ITCH);
+    
+    bool record_ends = !message_ends.empty();
+    
+    for (std::size_t i = 0; i < msgs.size(); ++i) {
+        const Msg& msg = msgs[i];
         
         // ITCH message
         ITCHMsg itch_msg;
@@ -258,13 +267,15 @@ void ITCHEncoder::encode_inplace(const std::vector<Msg>& msgs, std::vector<std::
         itch_msg.qty = htobe32(static_cast<std::uint32_t>(std::abs(msg.qty)));
         itch_msg.side = (msg.qty > 0) ? 'B' : 'S';
         
-        // Append to buffer
-        const std::uint8_t* sofh_ptr = reinterpret_cast<const std::uint8_t*>(&sofh);
-        buffer.insert(buffer.end(), sofh_ptr, sofh_ptr + sizeof(SOFH));
-        
-        const std::uint8_t* itch_ptr = reinterpret_cast<const std::uint8_t*>(&itch_msg);
-        buffer.insert(buffer.end(), itch_ptr, itch_ptr + sizeof(ITCHMsg));
+        std::memcpy(cursor, &sofh, sizeof(SOFH));
+        std::memcpy(cursor + sizeof(SOFH), &itch_msg, sizeof(ITCHMsg));
+        cursor += sizeof(SOFH) + sizeof(ITCHMsg);
+        if (record_ends) {
+            message_ends[i] = static_cast<std::size_t>(cursor - out.data());
+        }
     }
+    
+    return static_cast<std::size_t>(cursor - out.data());
 }
 
 // Factory function
@@ -280,4 +291,15 @@ std::unique_ptr<MessageEncoder> create_encoder(EncodingType type, const Encoding
     throw std::invalid_argument("Unknown encoding type");
 }
 
+EncodingType parse_encoding_type(const std::string& name) {
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    
+    if (lower == "binary") return EncodingType::BINARY;
+    if (lower == "fix") return EncodingType::FIX;
+    if (lower == "itch") return EncodingType::ITCH;
+    throw std::invalid_argument("Unknown encoding type: " + name);
+}
+
 } // namespace mdfh 
\ No newline at end of file
@@ -0,0 +1,248 @@
+#include "mdfh/fanout.hpp"
+#include "mdfh/logger.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <ostream>
+#include <stdexcept>
+
+namespace mdfh {
+
+namespace asio = boost::asio;
+using tcp = asio::ip::tcp;
+
+std::ostream& operator<<(std::ostream& os, SlowConsumerPolicy policy) {
+    switch (policy) {
+        case SlowConsumerPolicy::DROP: return os << "DROP";
+        case SlowConsumerPolicy::CONFLATE: return os << "CONFLATE";
+        case SlowConsumerPolicy::DISCONNECT: return os << "DISCONNECT";
+    }
+    return os << "UNKNOWN_SLOW_CONSUMER_POLICY";
+}
+
+SlowConsumerPolicy parse_slow_consumer_policy(const std::string& name) {
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (lower == "drop") return SlowConsumerPolicy::DROP;
+    if (lower == "conflate") return SlowConsumerPolicy::CONFLATE;
+    if (lower == "disconnect") return SlowConsumerPolicy::DISCONNECT;
+    throw std::invalid_argument("Unknown slow consumer policy: " + name);
+}
+
+namespace {
+
+std::string to_string(const tcp::endpoint& endpoint) {
+    return endpoint.address().to_string() + ":" + std::to_string(endpoint.port());
+}
+
+} // namespace
+
+// queue[0, in_flight) is being written; the rest waits for the next write
+struct FanoutFeed::Session {
+    explicit Session(tcp::socket s) : socket(std::move(s)) {}
+
+    tcp::socket socket;
+    std::string peer;
+    std::deque<SharedBatch> queue;
+    std::vector<asio::const_buffer> gather;     // Reused gather list of the write in flight
+    std::size_t in_flight = 0;
+};
+
+FanoutFeed::FanoutFeed(asio::io_context& ctx, const tcp::endpoint& endpoint, FanoutConfig config)
+    : ctx_(ctx)
+    , acceptor_(ctx, endpoint)
+    , endpoint_(acceptor_.local_endpoint())
+    , config_(config)
+    , close_timer_(ctx) {}
+
+FanoutFeed::~FanoutFeed() {
+    boost::system::error_code ec;
+    acceptor_.close(ec);
+    for (auto& session : sessions_) {
+        session->socket.close(ec);
+    }
+}
+
+void FanoutFeed::start() {
+    asio::post(ctx_, [this]() { accept(); });
+}
+
+bool FanoutFeed::publish(SharedBatch batch) {
+    published_.fetch_add(1, std::memory_order_relaxed);
+    if (pending_.fetch_add(1, std::memory_order_relaxed) >= config_.max_pending_batches) {
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+        shed_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    asio::post(ctx_, [this, batch = std::move(batch)]() {
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+        deliver(batch);
+    });
+    return true;
+}
+
+void FanoutFeed::close() {
+    asio::post(ctx_, [this]() {
+        closing_ = true;
+        boost::system::error_code ec;
+        acceptor_.close(ec);
+
+        // Idle clients go now; the rest when their last write completes,
+        // or when the deadline cuts those that stopped reading
+        auto idle = sessions_;
+        for (auto& session : idle) {
+            if (session->queue.empty()) {
+                remove(session);
+            }
+        }
+        if (!sessions_.empty()) {
+            close_timer_.expires_after(std::chrono::milliseconds(config_.close_timeout_ms));
+            close_timer_.async_wait([this](const boost::system::error_code& ec) {
+                if (!ec) {
+                    cut_remaining();
+                }
+            });
+        }
+    });
+}
+
+void FanoutFeed::cut_remaining() {
+    if (sessions_.empty()) {
+        return;
+    }
+    MDFH_LOG_WARN("Fanout", to_string(endpoint_), ": closing ", sessions_.size(),
+                  " clients that did not drain within ", config_.close_timeout_ms, " ms");
+    auto remaining = sessions_;
+    for (auto& session : remaining) {
+        remove(session);
+    }
+}
+
+void FanoutFeed::accept() {
+    acceptor_.async_accept([this](boost::system::error_code ec, tcp::socket socket) {
+        if (ec) {
+            if (ec != asio::error::operation_aborted) {
+                MDFH_LOG_WARN("Fanout", "Accept error on ", to_string(endpoint_), ": ", ec.message());
+                accept();
+            }
+            return;
+        }
+        if (closing_) {
+            return;
+        }
+
+        socket.set_option(tcp::no_delay(true), ec);
+        auto session = std::make_shared<Session>(std::move(socket));
+        auto peer = session->socket.remote_endpoint(ec);
+        session->peer = ec ? std::string("unknown") : to_string(peer);
+        sessions_.push_back(session);
+
+        clients_.store(sessions_.size(), std::memory_order_relaxed);
+        accepted_.fetch_add(1, std::memory_order_relaxed);
+        MDFH_LOG_INFO("Fanout", to_string(endpoint_), ": client ", session->peer, " connected (",
+                      sessions_.size(), " clients)");
+        accept();
+    });
+}
+
+void FanoutFeed::deliver(const SharedBatch& batch) {
+    // Indexed: DISCONNECT removes sessions while we walk them
+    for (std::size_t i = 0; i < sessions_.size();) {
+        auto session = sessions_[i];
+
+        if (session->queue.size() >= config_.max_queued_batches) {
+            switch (config_.policy) {
+                case SlowConsumerPolicy::DROP:
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    ++i;
+                    continue;
+                case SlowConsumerPolicy::CONFLATE: {
+                    auto waiting = session->queue.size() - session->in_flight;
+                    if (waiting == 0) {
+                        // Everything queued is already being written
+                        dropped_.fetch_add(1, std::memory_order_relaxed);
+                        ++i;
+                        continue;
+                    }
+                    session->queue.erase(session->queue.begin() + static_cast<std::ptrdiff_t>(session->in_flight),
+                                         session->queue.end());
+                    dropped_.fetch_add(waiting, std::memory_order_relaxed);
+                    break;
+                }
+                case SlowConsumerPolicy::DISCONNECT:
+                    slow_disconnects_.fetch_add(1, std::memory_order_relaxed);
+                    MDFH_LOG_WARN("Fanout", to_string(endpoint_), ": disconnecting slow client ", session->peer,
+                                  " (", session->queue.size(), " batches queued)");
+                    remove(session);
+                    continue;
+            }
+        }
+
+        session->queue.push_back(batch);
+        if (session->in_flight == 0) {
+            write(session);
+        }
+        ++i;
+    }
+}
+
+void FanoutFeed::write(const std::shared_ptr<Session>& session) {
+    auto count = std::min(session->queue.size(), config_.max_gather);
+    session->gather.clear();
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto& bytes = *session->queue[i];
+        session->gather.emplace_back(bytes.data(), bytes.size());
+    }
+    session->in_flight = count;
+
+    asio::async_write(session->socket, session->gather,
+        [this, session](const boost::system::error_code& ec, std::size_t bytes) {
+            on_written(session, ec, bytes);
+        });
+}
+
+void FanoutFeed::on_written(const std::shared_ptr<Session>& session, const boost::system::error_code& ec,
+                            std::size_t bytes) {
+    if (ec) {
+        // A closed socket means remove() already ran (slow disconnect or close())
+        if (session->socket.is_open() && ec != asio::error::operation_aborted) {
+            MDFH_LOG_INFO("Fanout", to_string(endpoint_), ": client ", session->peer, " disconnected: ",
+                          ec.message());
+        }
+        remove(session);
+        return;
+    }
+
+    bytes_sent_.fetch_add(bytes, std::memory_order_relaxed);
+    session->queue.erase(session->queue.begin(),
+                         session->queue.begin() + static_cast<std::ptrdiff_t>(session->in_flight));
+    session->in_flight = 0;
+
+    if (!session->queue.empty()) {
+        write(session);
+    } else if (closing_) {
+        remove(session);
+    }
+}
+
+void FanoutFeed::remove(const std::shared_ptr<Session>& session) {
+    auto it = std::find(sessions_.begin(), sessions_.end(), session);
+    if (it == sessions_.end()) {
+        return;     // Already removed; this is its aborted write completing
+    }
+    sessions_.erase(it);
+    clients_.store(sessions_.size(), std::memory_order_relaxed);
+
+    boost::system::error_code ec;
+    session->socket.shutdown(tcp::socket::shutdown_both, ec);
+    session->socket.close(ec);
+
+    // The last client is gone: don't keep the io_context running until the deadline
+    if (closing_ && sessions_.empty()) {
+        close_timer_.cancel();
+    }
+}
+
+} // namespace mdfh
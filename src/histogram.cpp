@@ -0,0 +1,103 @@
+#include "mdfh/histogram.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace mdfh {
+
+namespace {
+
+void raise_to(std::atomic<std::uint64_t>& target, std::uint64_t value) {
+    auto current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+void lower_to(std::atomic<std::uint64_t>& target, std::uint64_t value) {
+    auto current = target.load(std::memory_order_relaxed);
+    while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+void LatencyHistogram::record_shared(std::uint64_t value_ns, std::uint64_t count) {
+    counts_[bucket_index(value_ns)].fetch_add(count, std::memory_order_relaxed);
+    count_.fetch_add(count, std::memory_order_relaxed);
+    sum_.fetch_add(value_ns * count, std::memory_order_relaxed);
+    lower_to(min_, value_ns);
+    raise_to(max_, value_ns);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+        if (auto n = other.counts_[i].load(std::memory_order_relaxed)) {
+            counts_[i].fetch_add(n, std::memory_order_relaxed);
+        }
+    }
+    count_.fetch_add(other.count_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    sum_.fetch_add(other.sum_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    lower_to(min_, other.min_.load(std::memory_order_relaxed));
+    raise_to(max_, other.max_.load(std::memory_order_relaxed));
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : counts_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    min_.store(UINT64_MAX, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::min() const {
+    auto value = min_.load(std::memory_order_relaxed);
+    return value == UINT64_MAX ? 0 : value;
+}
+
+double LatencyHistogram::mean() const {
+    auto n = count();
+    return n > 0 ? static_cast<double>(sum_.load(std::memory_order_relaxed)) / static_cast<double>(n) : 0.0;
+}
+
+std::uint64_t LatencyHistogram::value_at_percentile(double percentile) const {
+    auto total = count();
+    if (total == 0) {
+        return 0;
+    }
+
+    auto target = static_cast<std::uint64_t>(std::ceil(std::clamp(percentile, 0.0, 1.0) * static_cast<double>(total)));
+    target = std::max<std::uint64_t>(target, 1);
+
+    // A racing writer may have stored min before max
+    auto lowest = min();
+    auto highest = std::max(max(), lowest);
+
+    // Writers may add samples during the walk; anything past the total read above counts as the max
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += counts_[i].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            return std::clamp(bucket_highest(i), lowest, highest);
+        }
+    }
+    return highest;
+}
+
+std::uint64_t LatencyHistogram::bucket_lowest(std::size_t index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    auto shift = index / SUB_BUCKET_HALF - 1;
+    return (index % SUB_BUCKET_HALF + SUB_BUCKET_HALF) << shift;
+}
+
+std::uint64_t LatencyHistogram::bucket_highest(std::size_t index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    auto shift = index / SUB_BUCKET_HALF - 1;
+    return bucket_lowest(index) + (1ULL << shift) - 1;
+}
+
+} // namespace mdfh
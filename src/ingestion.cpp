@@ -1,4 +1,6 @@
 #include "mdfh/ingestion.hpp"
+#include "mdfh/performance_tracker.hpp"
+#include "mdfh/pipeline.hpp"
 #include <iostream>
 #include <iomanip>
 #include <cstring>
@@ -14,6 +16,8 @@ std::ostream& operator<<(std::ostream& os, const IngestionConfig& cfg) {
     os << "  Host: " << cfg.host << "\n";
     os << "  Port: " << cfg.port << "\n";
     os << "  Buffer Capacity: " << cfg.buffer_capacity << " slots\n";
+    os << "  Encoding: " << cfg.encoding << "\n";
+    os << "  Consumer Wait: " << cfg.consumer_wait << "\n";
     if (cfg.max_seconds > 0) {
         os << "  Max Duration: " << cfg.max_seconds << " seconds\n";
     }
@@ -24,8 +28,7 @@ std::ostream& operator<<(std::ostream& os, const IngestionConfig& cfg) {
 }
 
 // IngestionStats implementation
-IngestionStats::IngestionStats() 
-    : last_flush_(std::chrono::steady_clock::now()) {}
+IngestionStats::IngestionStats() = default;
 
 void IngestionStats::record_bytes_received(std::uint64_t bytes) {
     bytes_received_.fetch_add(bytes, std::memory_order_relaxed);
@@ -44,33 +47,26 @@ void IngestionStats::record_message_processed(const Slot& slot) {
         first_message_seen_ = true;
     } else {
         if (slot.raw.seq != expected_seq_) {
-            gap_count_++;
+            gap_count_.store(gap_count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
         }
         expected_seq_ = slot.raw.seq + 1;
     }
     
     // Calculate latency and update histogram
     auto now_ns = get_timestamp_ns();
-    auto latency_ns = now_ns - slot.rx_ts;
-    auto latency_us = latency_ns / 1000;
-    
-    if (latency_us < 1000) {
-        latency_buckets_[latency_us]++;
-    } else {
-        latency_buckets_[1000]++;  // Overflow bucket
-    }
+    latency_.record(now_ns > slot.rx_ts ? now_ns - slot.rx_ts : 0);
 }
 
 void IngestionStats::record_message_dropped() {
     messages_dropped_.fetch_add(1, std::memory_order_relaxed);
 }
 
-void IngestionStats::check_periodic_flush() {
-    auto now = std::chrono::steady_clock::now();
-    if (std::chrono::duration_cast<std::chrono::seconds>(now - last_flush_).count() >= 1) {
-        print_periodic_stats();
-        last_flush_ = now;
-    }
+void IngestionStats::record_messages_received(std::uint64_t count) {
+    messages_received_.fetch_add(count, std::memory_order_relaxed);
+}
+
+void IngestionStats::record_messages_dropped(std::uint64_t count) {
+    messages_dropped_.fetch_add(count, std::memory_order_relaxed);
 }
 
 void IngestionStats::print_periodic_stats() {
@@ -119,120 +115,72 @@ void IngestionStats::print_final_stats() {
     std::cout << "Messages received: " << msgs_recv << "\n";
     std::cout << "Messages processed: " << msgs_proc << "\n";
     std::cout << "Messages dropped: " << msgs_drop << "\n";
-    std::cout << "Sequence gaps: " << gap_count_ << "\n";
+    std::cout << "Sequence gaps: " << gap_count() << "\n";
     std::cout << "Bytes received: " << bytes_recv << " (" << (bytes_recv / 1024.0 / 1024.0) << " MB)\n";
     std::cout << "Average rate: " << (msgs_recv / elapsed) << " msg/s\n";
     std::cout << "Average bandwidth: " << (bytes_recv / elapsed / 1024 / 1024) << " MB/s\n";
     
     // Latency percentiles
-    std::uint64_t total_samples = msgs_proc;
-    if (total_samples > 0) {
+    if (latency_.count() > 0) {
+        std::cout << std::setprecision(3);
         std::cout << "\nLatency percentiles (microseconds):\n";
-        std::cout << "  50th: " << calculate_percentile(0.50, total_samples) << "µs\n";
-        std::cout << "  90th: " << calculate_percentile(0.90, total_samples) << "µs\n";
-        std::cout << "  95th: " << calculate_percentile(0.95, total_samples) << "µs\n";
-        std::cout << "  99th: " << calculate_percentile(0.99, total_samples) << "µs\n";
-        std::cout << "  99.9th: " << calculate_percentile(0.999, total_samples) << "µs\n";
+        std::cout << "  50th: " << latency_.value_at_percentile(0.50) / 1e3 << "µs\n";
+        std::cout << "  90th: " << latency_.value_at_percentile(0.90) / 1e3 << "µs\n";
+        std::cout << "  95th: " << latency_.value_at_percentile(0.95) / 1e3 << "µs\n";
+        std::cout << "  99th: " << latency_.value_at_percentile(0.99) / 1e3 << "µs\n";
+        std::cout << "  99.9th: " << latency_.value_at_percentile(0.999) / 1e3 << "µs\n";
+        std::cout << "  99.99th: " << latency_.value_at_percentile(0.9999) / 1e3 << "µs\n";
+        std::cout << "  Max: " << latency_.max() / 1e3 << "µs\n";
     }
 }
 
-std::uint64_t IngestionStats::calculate_percentile(double percentile, std::uint64_t total_samples) {
-    std::uint64_t target = static_cast<std::uint64_t>(total_samples * percentile);
-    std::uint64_t count = 0;
-    
-    for (std::size_t i = 0; i < latency_buckets_.size(); ++i) {
-        count += latency_buckets_[i];
-        if (count >= target) {
-            return i >= 1000 ? 1000 : i;  // Return 1000+ for overflow bucket
-        }
-    }
-    return 0;
+void IngestionStats::register_metrics(MetricsRegistry& registry, const MetricsRegistry::Labels& labels) const {
+    registry.counter_fn("mdfh_messages_received_total", "Messages decoded from the feed", labels,
+                        [this]() { return static_cast<double>(messages_received()); });
+    registry.counter_fn("mdfh_messages_processed_total", "Messages taken off the ring by the consumer", labels,
+                        [this]() { return static_cast<double>(messages_processed()); });
+    registry.counter_fn("mdfh_messages_dropped_total", "Messages lost to a full ring", labels,
+                        [this]() { return static_cast<double>(messages_dropped()); });
+    registry.counter_fn("mdfh_bytes_received_total", "Payload bytes read from the feed", labels,
+                        [this]() { return static_cast<double>(bytes_received()); });
+    registry.counter_fn("mdfh_sequence_gaps_total", "Sequence gaps seen by the consumer", labels,
+                        [this]() { return static_cast<double>(gap_count()); });
+    registry.histogram("mdfh_receive_to_process_latency_ns", "Receive-to-process latency in nanoseconds",
+                       labels, latency_);
 }
 
 // MessageParser implementation
-MessageParser::MessageParser() {
-    // Pre-allocated buffer is already initialized in header
-    partial_size_ = 0;
+MessageParser::MessageParser(EncodingType encoding)
+    : decoder_(create_decoder(encoding)), encoding_(encoding) {}
+
+void MessageParser::parse_bytes(const std::uint8_t* data, std::size_t size, RingBuffer& ring, IngestionStats& stats) {
+    // One receive timestamp for the whole read buffer
+    parse_bytes(data, size, get_timestamp_ns(), ring, stats);
 }
 
-void MessageParser::process_complete_message(const Msg& msg, std::uint64_t timestamp, RingBuffer& ring, IngestionStats& stats) {
-    Slot slot{msg, timestamp};
-    
-    if (!ring.try_push(slot)) {
-        stats.record_message_dropped();
-    } else {
-        stats.record_message_received();
-    }
+void MessageParser::parse_bytes(const std::uint8_t* data, std::size_t size, std::uint64_t rx_ts, RingBuffer& ring, IngestionStats& stats) {
+    record_counts(decoder_->decode(data, size, rx_ts, ring), stats);
 }
 
-void MessageParser::parse_bytes(const std::uint8_t* data, std::size_t size, RingBuffer& ring, IngestionStats& stats) {
-    std::size_t offset = 0;
-    
-    // If we have partial data from previous read, prepend it (ZERO ALLOCATION)
-    if (partial_size_ > 0) {
-        // Check if we can fit the new data
-        if (partial_size_ + size > MAX_PARTIAL_SIZE) {
-            // Process what we can from the partial buffer first
-            std::size_t bytes_to_add = std::min(size, MAX_PARTIAL_SIZE - partial_size_);
-            std::memcpy(partial_buffer_.data() + partial_size_, data, bytes_to_add);
-            
-            // Process messages from the combined buffer
-            std::size_t combined_size = partial_size_ + bytes_to_add;
-            std::size_t partial_offset = 0;
-            
-            while (partial_offset + sizeof(Msg) <= combined_size) {
-                auto now_ns = get_timestamp_ns();
-                Msg msg;
-                std::memcpy(&msg, partial_buffer_.data() + partial_offset, sizeof(Msg));
-                process_complete_message(msg, now_ns, ring, stats);
-                partial_offset += sizeof(Msg);
-            }
-            
-            // Clear partial buffer and continue with remaining new data
-            partial_size_ = 0;
-            offset = bytes_to_add;  // Skip the bytes we already used
-        } else {
-            // Copy new data to partial buffer
-            std::memcpy(partial_buffer_.data() + partial_size_, data, size);
-            data = partial_buffer_.data();
-            size = partial_size_ + size;
-            offset = 0;
-        }
+void MessageParser::record_counts(const DecodeCounts& counts, IngestionStats& stats) {
+    if (counts.decoded > 0) {
+        stats.record_messages_received(counts.decoded);
     }
-    
-    // Process complete messages
-    while (offset + sizeof(Msg) <= size) {
-        auto now_ns = get_timestamp_ns();
-        
-        Msg msg;
-        std::memcpy(&msg, data + offset, sizeof(Msg));
-        
-        process_complete_message(msg, now_ns, ring, stats);
-        offset += sizeof(Msg);
-    }
-    
-    // Save any remaining partial data (ZERO ALLOCATION)
-    if (offset < size) {
-        std::size_t remaining = size - offset;
-        if (remaining <= MAX_PARTIAL_SIZE) {
-            std::memcpy(partial_buffer_.data(), data + offset, remaining);
-            partial_size_ = remaining;
-        } else {
-            // This should never happen with the increased buffer size
-            MDFH_LOG_ERROR("MessageParser", "Partial data too large, dropping");
-            partial_size_ = 0;
-        }
-    } else {
-        partial_size_ = 0;  // No partial data
+    if (counts.dropped + counts.malformed > 0) {
+        stats.record_messages_dropped(counts.dropped + counts.malformed);
     }
 }
 
 void MessageParser::parse_bytes_zero_copy(const std::uint8_t* data, std::size_t size, RingBuffer& ring, IngestionStats& stats) {
-    // For zero-copy, we need to handle partial messages differently
-    // This is a simplified version - in practice, you'd want more sophisticated buffering
+    // Decoders already write straight into claimed ring slots; only a
+    // message split across reads passes through the partial buffer
     parse_bytes(data, size, ring, stats);
 }
 
+void MessageParser::parse_bytes_zero_copy(const std::uint8_t* data, std::size_t size, std::uint64_t rx_ts, RingBuffer& ring, IngestionStats& stats) {
+    parse_bytes(data, size, rx_ts, ring, stats);
+}
+
 // NetworkClient implementation
 NetworkClient::NetworkClient(IngestionConfig config) 
     : config_(std::move(config)), socket_(ctx_) {}
@@ -243,7 +191,19 @@ void NetworkClient::connect() {
     std::cout << "Connected to " << config_.host << ":" << config_.port << std::endl;
 }
 
-void NetworkClient::run_io_loop(RingBuffer& ring, IngestionStats& stats, MessageParser& parser) {
+void NetworkClient::run_io_loop(RingBuffer& ring, IngestionStats& stats, MessageParser& parser,
+                                ThreadCounters* counters) {
+    read_loop([&](const std::uint8_t* data, std::size_t size) {
+        stats.record_bytes_received(size);
+        parser.parse_bytes_zero_copy(data, size, ring, stats);
+        
+        if (counters) {
+            counters->maybe_sample(stats.messages_received());
+        }
+    });
+}
+
+void NetworkClient::read_loop(const std::function<void(const std::uint8_t* data, std::size_t size)>& on_read) {
     std::array<std::uint8_t, 4096> buffer;
     
     while (!should_stop_.load(std::memory_order_acquire) && socket_.is_open()) {
@@ -264,8 +224,7 @@ void NetworkClient::run_io_loop(RingBuffer& ring, IngestionStats& stats, Message
                 break;
             }
             
-            stats.record_bytes_received(bytes_read);
-            parser.parse_bytes_zero_copy(buffer.data(), bytes_read, ring, stats);
+            on_read(buffer.data(), bytes_read);
         }
         catch (std::exception& e) {
             std::cerr << "I/O error: " << e.what() << std::endl;
@@ -278,48 +237,65 @@ void NetworkClient::run_io_loop(RingBuffer& ring, IngestionStats& stats, Message
 IngestionBenchmark::IngestionBenchmark(IngestionConfig config)
     : config_(std::move(config))
     , ring_(config_.buffer_capacity)
-    , client_(config_) {}
+    , client_(config_)
+    , exporter_(metrics_, config_.metrics) {
+    ring_.set_consumer_signal(&consumer_signal_);
+    stats_.register_metrics(metrics_);
+    exporter_.add_reporter(std::chrono::seconds(1), [this]() { stats_.print_periodic_stats(); });
+}
 
 void IngestionBenchmark::run() {
     std::cout << config_ << std::endl;
     
     // Connect to server
     client_.connect();
+    exporter_.start();
     
-    // Start I/O thread
-    std::thread io_thread([this]() {
-        client_.run_io_loop(ring_, stats_, parser_);
+    // Decoder, ring, statistics and consumer as one Pipeline specialized for
+    // the encoding: the decoder is called through its concrete type and the
+    // per-message statistics inline into the consumer's batch loop
+    with_decoder(config_.encoding, [this](auto decoder_type) {
+        Pipeline pipeline(PushSource{}, decoder_type, ring_, [](const Slot&) {}, IngestionStatsAdapter(stats_));
+        
+        // Start I/O thread
+        std::thread io_thread([this, &pipeline]() {
+            client_.read_loop([&pipeline](const std::uint8_t* data, std::size_t size) {
+                // One receive timestamp for the whole read buffer
+                pipeline.ingest(data, size, get_timestamp_ns());
+            });
+        });
+        
+        // Run consumer in main thread
+        auto consume_batch = [&pipeline](std::uint64_t max_count) { return pipeline.consume(max_count); };
+        consumer_loop(consume_batch);
+        
+        // Signal stop and wait for I/O thread
+        client_.stop();
+        if (io_thread.joinable()) {
+            io_thread.join();
+        }
+        
+        // Drain any remaining messages
+        while (consume_batch(CONSUMER_BATCH_SIZE) > 0) {
+        }
     });
-    
-    // Run consumer in main thread
-    consumer_loop();
-    
-    // Signal stop and wait for I/O thread
-    client_.stop();
-    if (io_thread.joinable()) {
-        io_thread.join();
-    }
-    
-    // Drain any remaining messages
-    Slot slot;
-    while (ring_.try_pop(slot)) {
-        stats_.record_message_processed(slot);
-    }
+    exporter_.stop();
     
     // Print final statistics
     stats_.print_final_stats();
 }
 
-void IngestionBenchmark::consumer_loop() {
-    Slot slot;
+template <typename ConsumeBatch>
+void IngestionBenchmark::consumer_loop(ConsumeBatch&& consume_batch) {
+    WaitStrategy waiter(config_.consumer_wait, &consumer_signal_);
     
     while (should_continue()) {
-        if (ring_.try_pop(slot)) {
-            stats_.record_message_processed(slot);
+        // Process slots in place and publish read_pos_ once per batch
+        if (consume_batch(CONSUMER_BATCH_SIZE) > 0) {
+            waiter.reset();
+        } else {
+            waiter.idle();
         }
-        
-        // Periodic statistics reporting
-        stats_.check_periodic_flush();
     }
 }
 
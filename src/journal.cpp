@@ -0,0 +1,520 @@
+#include "mdfh/journal.hpp"
+#include "mdfh/multi_feed_ingestion.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mdfh {
+
+static_assert(offsetof(JournalRecord, origin_id) == offsetof(MultiFeedSlot, origin_id) &&
+              offsetof(JournalRecord, rx_ts) == offsetof(MultiFeedSlot, rx_ts),
+              "JournalRecord and MultiFeedSlot must share a layout");
+
+namespace {
+
+constexpr std::size_t HEADER_BYTES = 4096;
+constexpr std::size_t PAGE_BYTES = 4096;
+
+std::string segment_path(const std::string& directory, std::uint64_t index) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "journal-%06llu.seg", static_cast<unsigned long long>(index));
+    return (std::filesystem::path(directory) / name).string();
+}
+
+std::string index_path(const std::string& seg_path) {
+    return std::filesystem::path(seg_path).replace_extension(".idx").string();
+}
+
+// Segment number encoded in a journal-NNNNNN.seg file name, or -1
+long long parse_segment_index(const std::string& file_name) {
+    unsigned long long index = 0;
+    int consumed = 0;
+    if (std::sscanf(file_name.c_str(), "journal-%llu.seg%n", &index, &consumed) != 1 ||
+        static_cast<std::size_t>(consumed) != file_name.size()) {
+        return -1;
+    }
+    return static_cast<long long>(index);
+}
+
+std::runtime_error io_error(const std::string& what, const std::string& path) {
+    return std::runtime_error("Journal: " + what + " " + path + ": " + std::strerror(errno));
+}
+
+} // namespace
+
+bool JournalConfig::is_valid() const {
+    // Index entries address records with 32 bits
+    return segment_bytes >= HEADER_BYTES + PAGE_BYTES &&
+           (segment_bytes - HEADER_BYTES) / sizeof(JournalRecord) <= UINT32_MAX &&
+           flush_interval_ms > 0 &&
+           index_stride > 0;
+}
+
+std::vector<std::string> list_journal_segments(const std::string& directory) {
+    std::vector<std::pair<long long, std::string>> found;
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+        auto index = parse_segment_index(it->path().filename().string());
+        if (index >= 0) {
+            found.emplace_back(index, it->path().string());
+        }
+    }
+    std::sort(found.begin(), found.end());
+
+    std::vector<std::string> paths;
+    paths.reserve(found.size());
+    for (auto& entry : found) {
+        paths.push_back(std::move(entry.second));
+    }
+    return paths;
+}
+
+// One mapped segment file
+struct JournalWriter::Segment {
+    std::string path;
+    int fd = -1;
+    std::uint8_t* map = nullptr;
+    std::size_t bytes = 0;
+    JournalSegmentHeader* header = nullptr;
+    JournalRecord* records = nullptr;
+
+    std::atomic<std::uint64_t> published{0};    // Written by the appender
+    std::uint64_t synced = 0;                   // Flusher-owned
+    std::vector<JournalIndexEntry> index;       // Appender-owned until retired
+    bool finished = false;
+
+    ~Segment() {
+        if (map) {
+            ::munmap(map, bytes);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+};
+
+// JournalWriter implementation
+JournalWriter::JournalWriter(JournalConfig config)
+    : config_(std::move(config)) {
+    if (!config_.enabled() || !config_.is_valid()) {
+        throw std::invalid_argument("Invalid journal configuration");
+    }
+    capacity_ = (config_.segment_bytes - HEADER_BYTES) / sizeof(JournalRecord);
+
+    std::error_code ec;
+    std::filesystem::create_directories(config_.directory, ec);
+    if (ec) {
+        throw std::runtime_error("Journal: cannot create " + config_.directory + ": " + ec.message());
+    }
+
+    // Continue numbering after any segments already in the directory
+    auto existing = list_journal_segments(config_.directory);
+    if (!existing.empty()) {
+        next_segment_index_ = static_cast<std::uint64_t>(
+            parse_segment_index(std::filesystem::path(existing.back()).filename().string())) + 1;
+    }
+
+    current_ = create_segment(next_segment_index_++);
+    spare_ = create_segment(next_segment_index_++);
+    flusher_ = std::thread(&JournalWriter::flusher_loop, this);
+}
+
+JournalWriter::~JournalWriter() {
+    close();
+}
+
+std::shared_ptr<JournalWriter::Segment> JournalWriter::create_segment(std::uint64_t index) {
+    auto segment = std::make_shared<Segment>();
+    segment->path = segment_path(config_.directory, index);
+    segment->bytes = HEADER_BYTES + capacity_ * sizeof(JournalRecord);
+
+    segment->fd = ::open(segment->path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (segment->fd < 0) {
+        throw io_error("cannot create", segment->path);
+    }
+
+    // Allocate the blocks up front so appends never extend the file;
+    // ftruncate covers filesystems without fallocate support
+    int rc = ::posix_fallocate(segment->fd, 0, static_cast<off_t>(segment->bytes));
+    if (rc != 0 && ::ftruncate(segment->fd, static_cast<off_t>(segment->bytes)) != 0) {
+        throw io_error("cannot size", segment->path);
+    }
+
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;
+#endif
+    void* map = ::mmap(nullptr, segment->bytes, PROT_READ | PROT_WRITE, flags, segment->fd, 0);
+    if (map == MAP_FAILED) {
+        throw io_error("cannot map", segment->path);
+    }
+    segment->map = static_cast<std::uint8_t*>(map);
+    segment->header = reinterpret_cast<JournalSegmentHeader*>(segment->map);
+    segment->records = reinterpret_cast<JournalRecord*>(segment->map + HEADER_BYTES);
+
+    auto& header = *segment->header;
+    std::memcpy(header.magic, JournalSegmentHeader::MAGIC, sizeof(header.magic));
+    header.version = JournalSegmentHeader::VERSION;
+    header.record_size = sizeof(JournalRecord);
+    header.segment_index = index;
+    header.capacity = capacity_;
+    header.committed = 0;
+
+    segment->index.reserve(capacity_ / config_.index_stride + 64);
+    return segment;
+}
+
+template <typename Fill>
+void JournalWriter::append_records(std::uint64_t count, Fill&& fill) {
+    std::uint64_t done = 0;
+    while (done < count) {
+        if (write_index_ == capacity_) {
+            roll();
+        }
+        auto n = std::min(count - done, capacity_ - write_index_);
+        JournalRecord* dst = current_->records + write_index_;
+        fill(dst, done, n);
+
+        // Sparse index: first record of each origin, then every index_stride of it
+        for (std::uint64_t i = 0; i < n; ++i) {
+            auto origin = dst[i].origin_id;
+            if (origin >= origin_counts_.size()) {
+                origin_counts_.resize(origin + 1, 0);
+            }
+            if (origin_counts_[origin]++ % config_.index_stride == 0) {
+                current_->index.push_back({dst[i].raw.seq, static_cast<std::uint32_t>(write_index_ + i), origin, 0});
+            }
+        }
+
+        write_index_ += n;
+        done += n;
+        current_->published.store(write_index_, std::memory_order_release);
+    }
+    records_written_.store(records_written_.load(std::memory_order_relaxed) + count,
+                           std::memory_order_relaxed);
+}
+
+void JournalWriter::append(std::span<const JournalRecord> records) {
+    append_records(records.size(), [&](JournalRecord* dst, std::uint64_t from, std::uint64_t n) {
+        std::memcpy(dst, records.data() + from, n * sizeof(JournalRecord));
+    });
+}
+
+void JournalWriter::append(std::span<const Slot> slots, std::uint16_t origin_id) {
+    append_records(slots.size(), [&](JournalRecord* dst, std::uint64_t from, std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            dst[i] = JournalRecord(slots[from + i], origin_id);
+        }
+    });
+}
+
+void JournalWriter::append(const MultiFeedSlot* slots, std::uint64_t count) {
+    append_records(count, [&](JournalRecord* dst, std::uint64_t from, std::uint64_t n) {
+        std::memcpy(static_cast<void*>(dst), slots + from, n * sizeof(JournalRecord));
+    });
+}
+
+void JournalWriter::roll() {
+    std::shared_ptr<Segment> next;
+    std::uint64_t stall_index = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        retired_.push_back(current_);
+        if (spare_) {
+            next = std::move(spare_);
+        } else {
+            stall_index = next_segment_index_++;
+        }
+    }
+
+    // The flusher fell behind: create the segment inline
+    if (!next) {
+        roll_stalls_.fetch_add(1, std::memory_order_relaxed);
+        next = create_segment(stall_index);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        current_ = std::move(next);
+    }
+    flusher_cv_.notify_one();
+
+    write_index_ = 0;
+    std::fill(origin_counts_.begin(), origin_counts_.end(), 0);
+    segments_rolled_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void JournalWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (closed_) {
+        return;
+    }
+    auto target = ++flush_requests_;
+    flusher_cv_.notify_one();
+    flushed_cv_.wait(lock, [&] { return flushes_completed_ >= target || closed_; });
+}
+
+void JournalWriter::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closed_) {
+            return;
+        }
+        stop_ = true;
+    }
+    flusher_cv_.notify_one();
+    if (flusher_.joinable()) {
+        flusher_.join();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    flushed_cv_.notify_all();
+}
+
+void JournalWriter::sync_segment(Segment& segment) {
+    auto published = segment.published.load(std::memory_order_acquire);
+    if (published == segment.synced) {
+        return;
+    }
+
+    auto begin = (HEADER_BYTES + segment.synced * sizeof(JournalRecord)) / PAGE_BYTES * PAGE_BYTES;
+    auto end = HEADER_BYTES + published * sizeof(JournalRecord);
+    if (::msync(segment.map + begin, end - begin, MS_SYNC) != 0) {
+        MDFH_LOG_WARN("Journal", "msync failed for ", segment.path, ": ", std::strerror(errno));
+        return;
+    }
+
+    // Records are durable before the header claims them
+    segment.header->committed = published;
+    ::msync(segment.map, HEADER_BYTES, MS_SYNC);
+    segment.synced = published;
+    syncs_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void JournalWriter::finish_segment(Segment& segment) {
+    if (segment.finished) {
+        return;
+    }
+    sync_segment(segment);
+
+    std::ofstream idx(index_path(segment.path), std::ios::binary | std::ios::trunc);
+    if (idx) {
+        idx.write(reinterpret_cast<const char*>(segment.index.data()),
+                  static_cast<std::streamsize>(segment.index.size() * sizeof(JournalIndexEntry)));
+    }
+    if (!idx) {
+        MDFH_LOG_WARN("Journal", "Could not write index for ", segment.path);
+    }
+
+    // Give back the unused tail of a partially filled segment
+    ::munmap(segment.map, segment.bytes);
+    segment.map = nullptr;
+    if (::ftruncate(segment.fd, static_cast<off_t>(HEADER_BYTES + segment.synced * sizeof(JournalRecord))) != 0) {
+        MDFH_LOG_WARN("Journal", "Could not truncate ", segment.path, ": ", std::strerror(errno));
+    }
+    ::close(segment.fd);
+    segment.fd = -1;
+    segment.finished = true;
+}
+
+void JournalWriter::flusher_loop() {
+    using Clock = std::chrono::steady_clock;
+    constexpr auto MAX_SPARE_BACKOFF = std::chrono::milliseconds(1000);
+
+    auto interval = std::chrono::milliseconds(config_.flush_interval_ms);
+    // After a failed spare creation, no new attempt (nor wake-up for one)
+    // until spare_retry_at; the backoff doubles per failure
+    auto spare_retry_at = Clock::time_point{};
+    auto spare_backoff = interval;
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    for (;;) {
+        flusher_cv_.wait_for(lock, interval, [&] {
+            return stop_ || !retired_.empty() || (!spare_ && Clock::now() >= spare_retry_at) ||
+                   flush_requests_ != flushes_completed_;
+        });
+
+        bool stopping = stop_;
+        auto requests = flush_requests_;
+        auto current = current_;
+        auto retired = std::move(retired_);
+        retired_.clear();
+        bool need_spare = !spare_ && !stopping && Clock::now() >= spare_retry_at;
+        lock.unlock();
+
+        for (auto& segment : retired) {
+            finish_segment(*segment);
+        }
+        sync_segment(*current);
+
+        std::shared_ptr<Segment> spare;
+        if (need_spare) {
+            std::uint64_t index;
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                index = next_segment_index_++;
+            }
+            try {
+                spare = create_segment(index);
+                spare_backoff = interval;
+            } catch (const std::exception& e) {
+                MDFH_LOG_WARN("Journal", e.what(), " (retrying in ", spare_backoff.count(), " ms)");
+                spare_retry_at = Clock::now() + spare_backoff;
+                spare_backoff = std::min(spare_backoff * 2, MAX_SPARE_BACKOFF);
+
+                // Hand the index back unless a stalled roll() has taken a later one
+                std::lock_guard<std::mutex> guard(mutex_);
+                if (next_segment_index_ == index + 1) {
+                    next_segment_index_ = index;
+                }
+            }
+        }
+
+        if (stopping) {
+            finish_segment(*current);
+        }
+
+        lock.lock();
+        if (spare) {
+            spare_ = std::move(spare);
+        }
+        flushes_completed_ = requests;
+        flushed_cv_.notify_all();
+
+        if (stopping) {
+            // The pre-allocated spare was never written; don't leave it behind
+            if (spare_) {
+                auto path = spare_->path;
+                spare_.reset();
+                ::unlink(path.c_str());
+            }
+            return;
+        }
+    }
+}
+
+// JournalReader implementation
+JournalReader::JournalReader(const std::string& directory) {
+    for (const auto& path : list_journal_segments(directory)) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw io_error("cannot open", path);
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw io_error("cannot stat", path);
+        }
+        auto bytes = static_cast<std::size_t>(st.st_size);
+        if (bytes < HEADER_BYTES) {
+            ::close(fd);
+            continue;    // Segment being created by a live writer
+        }
+
+        void* map = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            throw io_error("cannot map", path);
+        }
+
+        MappedSegment segment;
+        segment.map = map;
+        segment.bytes = bytes;
+        segments_.push_back(std::move(segment));
+        auto& mapped = segments_.back();
+
+        const auto* header = static_cast<const JournalSegmentHeader*>(map);
+        if (std::memcmp(header->magic, JournalSegmentHeader::MAGIC, sizeof(header->magic)) != 0 ||
+            header->version != JournalSegmentHeader::VERSION ||
+            header->record_size != sizeof(JournalRecord)) {
+            throw std::runtime_error("Journal: " + path + " is not a journal segment");
+        }
+
+        // Only records the header vouches for are trusted
+        mapped.records = reinterpret_cast<const JournalRecord*>(static_cast<const std::uint8_t*>(map) + HEADER_BYTES);
+        mapped.count = std::min<std::uint64_t>(header->committed, (bytes - HEADER_BYTES) / sizeof(JournalRecord));
+
+        std::ifstream idx(index_path(path), std::ios::binary | std::ios::ate);
+        if (idx) {
+            auto size = static_cast<std::size_t>(idx.tellg());
+            mapped.index.resize(size / sizeof(JournalIndexEntry));
+            idx.seekg(0);
+            idx.read(reinterpret_cast<char*>(mapped.index.data()),
+                     static_cast<std::streamsize>(mapped.index.size() * sizeof(JournalIndexEntry)));
+        }
+    }
+}
+
+JournalReader::~JournalReader() {
+    for (auto& segment : segments_) {
+        ::munmap(const_cast<void*>(segment.map), segment.bytes);
+    }
+}
+
+std::span<const JournalRecord> JournalReader::records(std::size_t segment) const {
+    const auto& mapped = segments_.at(segment);
+    return {mapped.records, mapped.count};
+}
+
+std::uint64_t JournalReader::total_records() const {
+    std::uint64_t total = 0;
+    for (const auto& segment : segments_) {
+        total += segment.count;
+    }
+    return total;
+}
+
+std::optional<JournalReader::Position> JournalReader::find(std::uint16_t origin_id, std::uint64_t seq) const {
+    for (std::size_t s = 0; s < segments_.size(); ++s) {
+        const auto& segment = segments_[s];
+        std::uint64_t begin = 0;
+        std::uint64_t end = segment.count;
+
+        // Narrow the scan to the stride that should hold seq; a segment
+        // without an index (still being written) is scanned in full
+        if (!segment.index.empty()) {
+            const JournalIndexEntry* floor = nullptr;
+            const JournalIndexEntry* ceiling = nullptr;
+            for (const auto& entry : segment.index) {
+                if (entry.origin_id != origin_id) {
+                    continue;
+                }
+                if (entry.seq <= seq) {
+                    floor = &entry;
+                } else if (floor) {
+                    ceiling = &entry;
+                    break;
+                } else {
+                    break;
+                }
+            }
+            if (!floor) {
+                continue;
+            }
+            begin = floor->record;
+            if (ceiling) {
+                end = std::min<std::uint64_t>(end, ceiling->record);
+            }
+        }
+
+        for (auto r = begin; r < end; ++r) {
+            const auto& record = segment.records[r];
+            if (record.origin_id == origin_id && record.raw.seq == seq) {
+                return Position{s, r};
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace mdfh
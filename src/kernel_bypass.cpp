@@ -1,5 +1,6 @@
 #include "mdfh/kernel_bypass.hpp"
 #include "mdfh/ingestion.hpp"
+#include "mdfh/multicast_receiver.hpp"
 #include "mdfh/timing.hpp"
 #include <iostream>
 #include <cstring>
@@ -7,6 +8,8 @@
 #include <thread>
 #ifdef __linux__
 #include <sched.h>
+#include <poll.h>
+#include <ctime>
 #endif
 #include <unistd.h>
 
@@ -17,6 +20,19 @@
 #include <rte_mempool.h>
 #include <rte_lcore.h>
 #include <rte_cycles.h>
+#include <rte_prefetch.h>
+#endif
+
+#ifdef MDFH_ENABLE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <atomic>
+#include <cerrno>
+#include <system_error>
 #endif
 
 #ifdef MDFH_ENABLE_SOLARFLARE
@@ -42,6 +58,20 @@ bool BypassConfig::is_valid() const {
         return false;
     }
     
+    if (transport == TransportType::UDP_MULTICAST) {
+        boost::system::error_code ec;
+        auto group = boost::asio::ip::make_address(host, ec);
+        if (ec || !group.is_multicast()) {
+            std::cerr << "BypassConfig validation failed: host " << host
+                      << " is not a multicast group" << std::endl;
+            return false;
+        }
+        if (backend != BypassBackend::BOOST_ASIO && backend != BypassBackend::IO_URING) {
+            std::cerr << "BypassConfig validation failed: multicast is only supported by the Boost.Asio and io_uring backends" << std::endl;
+            return false;
+        }
+    }
+    
     if (interface_name.empty()) {
         std::cerr << "BypassConfig validation failed: interface_name cannot be empty" << std::endl;
         return false;
@@ -81,9 +111,9 @@ bool BypassConfig::is_valid() const {
     }
     
     // Validate CPU core (basic check)
-    if (cpu_core > 256) {  // Reasonable upper bound
+    if (cpu_core < -1 || cpu_core > 256) {  // Reasonable upper bound
         std::cerr << "BypassConfig validation failed: cpu_core " << cpu_core 
-                  << " too large (max 256)" << std::endl;
+                  << " out of range (-1 to 256)" << std::endl;
         return false;
     }
     
@@ -106,25 +136,40 @@ std::unique_ptr<KernelBypassClient> create_bypass_client(BypassBackend backend)
             return std::make_unique<SolarflareBypassClient>();
 #endif
 
+#ifdef MDFH_ENABLE_IO_URING
+        case BypassBackend::IO_URING:
+            return std::make_unique<IoUringBypassClient>();
+#endif
+
         default:
             std::cerr << "Unsupported bypass backend, falling back to Boost.Asio" << std::endl;
             return std::make_unique<BoostAsioBypassClient>();
     }
 }
 
-// Utility function to set CPU affinity
-bool set_cpu_affinity(std::uint32_t cpu_core) {
-#ifdef __linux__
-    cpu_set_t cpuset;
-    CPU_ZERO(&cpuset);
-    CPU_SET(cpu_core, &cpuset);
-    
-    return sched_setaffinity(0, sizeof(cpuset), &cpuset) == 0;
-#else
-    // CPU affinity not supported on this platform
-    (void)cpu_core;
-    return true;
-#endif
+void KernelBypassClient::start_reception(PacketHandler handler) {
+    if (!handler) {
+        return;
+    }
+    start_batch_reception([handler = std::move(handler)](std::span<const PacketDesc> packets) {
+        for (const auto& packet : packets) {
+            handler(packet);
+        }
+    });
+}
+
+// Reception thread CPU accounting
+KernelBypassClient::ReceptionClock KernelBypassClient::reception_clock_start() {
+    timespec cpu;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+    return {static_cast<std::uint64_t>(cpu.tv_sec) * 1'000'000'000ULL + static_cast<std::uint64_t>(cpu.tv_nsec),
+            get_timestamp_ns()};
+}
+
+void KernelBypassClient::sample_reception_cpu(const ReceptionClock& start) {
+    auto now = reception_clock_start();
+    reception_cpu_ns_.store(now.cpu_ns - start.cpu_ns, std::memory_order_relaxed);
+    reception_wall_ns_.store(now.wall_ns - start.wall_ns, std::memory_order_relaxed);
 }
 
 // BoostAsioBypassClient implementation
@@ -141,19 +186,46 @@ bool BoostAsioBypassClient::initialize(const BypassConfig& config) {
     }
     
     config_ = config;
-    perf_tracker_ = std::make_unique<PerformanceTracker>(config.perf_config);
+    auto perf_config = config.perf_config;
+    perf_config.sample_memory = config.memory_placement();
+    perf_tracker_ = std::make_unique<PerformanceTracker>(perf_config);
     
     // Create underlying NetworkClient with converted config
     IngestionConfig ing_config;
     ing_config.host = config.host;
     ing_config.port = config.port;
     ing_config.buffer_capacity = config.rx_ring_size;
+    ing_config.encoding = config.encoding;
+    
+    if (config.transport == TransportType::UDP_MULTICAST) {
+        MulticastConfig mcast_config;
+        mcast_config.groups = {config.host};
+        mcast_config.port = config.port;
+        mcast_config.interface = config.multicast_interface;
+        mcast_config.batch_size = config.batch_size;
+        mcast_config.wait = config.wait_config();
+        mcast_config.timestamps = config.hardware_timestamps ? RxTimestampSource::HARDWARE
+                                : config.kernel_timestamps ? RxTimestampSource::KERNEL
+                                : RxTimestampSource::USERSPACE;
+        mcast_receiver_ = std::make_unique<MulticastReceiver>(mcast_config);
+        return true;
+    }
     
     asio_client_ = std::make_unique<NetworkClient>(ing_config);
     return true;
 }
 
 bool BoostAsioBypassClient::connect() {
+    if (mcast_receiver_) {
+        try {
+            mcast_receiver_->open();
+            return true;
+        } catch (const std::exception& e) {
+            std::cerr << "Multicast join failed: " << e.what() << std::endl;
+            return false;
+        }
+    }
+    
     if (!asio_client_) {
         return false;
     }
@@ -172,28 +244,31 @@ void BoostAsioBypassClient::disconnect() {
     if (asio_client_) {
         asio_client_->stop();
     }
+    if (mcast_receiver_) {
+        mcast_receiver_->close();
+    }
 }
 
 bool BoostAsioBypassClient::is_connected() const {
+    if (mcast_receiver_) {
+        return mcast_receiver_->is_open();
+    }
     return asio_client_ && asio_client_->is_connected();
 }
 
-void BoostAsioBypassClient::start_reception(PacketHandler handler) {
+void BoostAsioBypassClient::start_batch_reception(BatchPacketHandler handler) {
     if (!handler || running_.load()) {
         return;
     }
     
-    packet_handler_ = std::move(handler);
+    batch_handler_ = std::move(handler);
     running_ = true;
     
     reception_thread_ = std::thread([this]() {
+        pin_current_thread(config_.cpu_core, "asio rx");
         reception_loop();
+        reception_exited();
     });
-    
-    // Set CPU affinity if requested
-    if (config_.cpu_core > 0) {
-        set_cpu_affinity(config_.cpu_core);
-    }
 }
 
 void BoostAsioBypassClient::stop_reception() {
@@ -209,6 +284,11 @@ void BoostAsioBypassClient::release_packet(void* context) {
 }
 
 void BoostAsioBypassClient::reception_loop() {
+    if (mcast_receiver_) {
+        multicast_reception_loop();
+        return;
+    }
+    
     std::cout << "Boost.Asio bypass client reception loop started" << std::endl;
     
     // Buffer for receiving data
@@ -247,8 +327,21 @@ void BoostAsioBypassClient::reception_loop() {
         }
     };
     
+    // Idle reads park in the kernel until the socket turns readable
+    WaitStrategy waiter(config_.wait_config());
+    auto park = [&socket](std::chrono::microseconds timeout) {
+#ifdef __linux__
+        pollfd pfd{socket->native_handle(), POLLIN, 0};
+        timespec ts{static_cast<time_t>(timeout.count() / 1'000'000), static_cast<long>(timeout.count() % 1'000'000) * 1000};
+        ::ppoll(&pfd, 1, &ts, nullptr);
+#else
+        std::this_thread::sleep_for(timeout);
+#endif
+    };
+    
     // Initial connection
     bool connected = connect_to_server();
+    const auto clock_start = reception_clock_start();
     auto last_reconnect_attempt = std::chrono::steady_clock::now();
     const auto reconnect_interval = std::chrono::seconds(1);
     
@@ -276,8 +369,8 @@ void BoostAsioBypassClient::reception_loop() {
             std::size_t bytes_received = socket->read_some(boost::asio::buffer(buffer), ec);
             
             if (ec == boost::asio::error::would_block || ec == boost::asio::error::try_again) {
-                // No data available, poll again after timeout
-                std::this_thread::sleep_for(std::chrono::microseconds(config_.poll_timeout_us));
+                // No data available, spin or park per the wait strategy
+                waiter.idle(park);
                 continue;
             } else if (ec == boost::asio::error::eof) {
                 std::cout << "Server closed connection, will reconnect..." << std::endl;
@@ -285,13 +378,15 @@ void BoostAsioBypassClient::reception_loop() {
                 connected = false;
                 continue;
             } else if (ec) {
-                std::cerr << "Read error: " << ec.message() << std::endl;
+                MDFH_LOG_ERROR("KernelBypass", "Read error: ", ec.message());
                 socket->close();
                 connected = false;
                 continue;
             }
             
             if (bytes_received > 0) {
+                waiter.reset();
+                
                 // Update statistics
                 packets_received_.fetch_add(1, std::memory_order_relaxed);
                 bytes_received_.fetch_add(bytes_received, std::memory_order_relaxed);
@@ -302,26 +397,19 @@ void BoostAsioBypassClient::reception_loop() {
                 // Create packet descriptor
                 PacketDesc packet(buffer.data(), bytes_received, timestamp_ns, nullptr);
                 
-                // Record stage timestamp
-                StageTimestamps timestamps;
-                timestamps.packet_rx = timestamp_ns;
-                
-                // Call packet handler
-                if (packet_handler_) {
-                    timestamps.parse_start = get_timestamp_ns();
-                    packet_handler_(packet);
-                    timestamps.parse_end = get_timestamp_ns();
-                    record_stage_timestamp(timestamps);
+                // Call packet handler with a one-packet burst
+                if (batch_handler_) {
+                    batch_handler_({&packet, 1});
                 }
                 
-                // Update cache statistics periodically
+                // Sample reception CPU time periodically
                 if (packets_received_.load() % 1000 == 0) {
-                    update_cache_stats();
+                    sample_reception_cpu(clock_start);
                 }
             }
             
         } catch (const std::exception& e) {
-            std::cerr << "Reception error: " << e.what() << std::endl;
+            MDFH_LOG_ERROR("KernelBypass", "Reception error: ", e.what());
             if (socket) {
                 socket->close();
             }
@@ -332,9 +420,58 @@ void BoostAsioBypassClient::reception_loop() {
     if (socket && socket->is_open()) {
         socket->close();
     }
+    sample_reception_cpu(clock_start);
     std::cout << "Boost.Asio bypass client reception loop stopped" << std::endl;
 }
 
+void BoostAsioBypassClient::multicast_reception_loop() {
+    std::cout << "Boost.Asio multicast reception loop started" << std::endl;
+    
+    WaitStrategy waiter(config_.wait_config());
+    auto park = [this](std::chrono::microseconds timeout) { mcast_receiver_->wait_readable(timeout); };
+    const auto clock_start = reception_clock_start();
+    std::uint64_t next_cpu_sample = 1000;
+    
+    while (running_.load() && mcast_receiver_->is_open()) {
+        try {
+            // One recvmmsg per batch; each datagram keeps its own kernel timestamp
+            auto packets = mcast_receiver_->receive_batch();
+            if (packets.empty()) {
+                waiter.idle(park);
+                continue;
+            }
+            waiter.reset();
+            
+            std::uint64_t bytes = 0;
+            for (const auto& packet : packets) {
+                bytes += packet.length;
+            }
+            packets_received_.fetch_add(packets.size(), std::memory_order_relaxed);
+            bytes_received_.fetch_add(bytes, std::memory_order_relaxed);
+            
+            // The whole recvmmsg batch goes to the handler in one call
+            if (batch_handler_) {
+                batch_handler_(packets);
+            }
+            
+            // Truncated datagrams never reach the handler
+            packets_dropped_.store(mcast_receiver_->datagrams_truncated(), std::memory_order_relaxed);
+            
+            // Sample reception CPU time periodically
+            if (packets_received_.load(std::memory_order_relaxed) >= next_cpu_sample) {
+                sample_reception_cpu(clock_start);
+                next_cpu_sample += 1000;
+            }
+        } catch (const std::exception& e) {
+            MDFH_LOG_ERROR("KernelBypass", "Multicast reception error: ", e.what());
+            break;
+        }
+    }
+    
+    sample_reception_cpu(clock_start);
+    std::cout << "Boost.Asio multicast reception loop stopped" << std::endl;
+}
+
 #ifdef MDFH_ENABLE_DPDK
 // DPDK static members
 bool DPDKBypassClient::dpdk_initialized_ = false;
@@ -494,22 +631,19 @@ void DPDKBypassClient::disconnect() {
     }
 }
 
-void DPDKBypassClient::start_reception(PacketHandler handler) {
+void DPDKBypassClient::start_batch_reception(BatchPacketHandler handler) {
     if (!handler || running_.load() || !initialized_) {
         return;
     }
     
-    packet_handler_ = std::move(handler);
+    batch_handler_ = std::move(handler);
     running_ = true;
     
     reception_thread_ = std::thread([this]() {
+        pin_current_thread(config_.cpu_core, "DPDK rx");
         reception_loop();
+        reception_exited();
     });
-    
-    // Set CPU affinity for DPDK reception thread
-    if (config_.cpu_core > 0) {
-        set_cpu_affinity(config_.cpu_core);
-    }
 }
 
 void DPDKBypassClient::stop_reception() {
@@ -538,19 +672,23 @@ std::string DPDKBypassClient::backend_info() const {
 void DPDKBypassClient::reception_loop() {
     const std::uint16_t batch_size = static_cast<std::uint16_t>(config_.batch_size);
     std::vector<struct rte_mbuf*> packets(batch_size);
+    burst_.resize(batch_size);
     
     std::cout << "DPDK reception loop started on core " << rte_lcore_id() << std::endl;
     
+    // Poll mode: BUSY_SPIN keeps the core, parking sleeps between bursts
+    WaitStrategy waiter(config_.wait_config());
+    
     while (running_.load()) {
         // Receive packet batch
         std::uint16_t nb_rx = rte_eth_rx_burst(port_id_, queue_id_, 
                                                packets.data(), batch_size);
         
         if (nb_rx > 0) {
+            waiter.reset();
             process_packet_batch(packets.data(), nb_rx);
         } else {
-            // Small delay to prevent busy-waiting
-            rte_delay_us(config_.poll_timeout_us);
+            waiter.idle();
         }
     }
     
@@ -558,29 +696,37 @@ void DPDKBypassClient::reception_loop() {
 }
 
 void DPDKBypassClient::process_packet_batch(struct rte_mbuf** packets, std::uint16_t count) {
+    constexpr std::uint16_t PREFETCH_DISTANCE = 4;
+    
+    // One software timestamp for mbufs without a NIC stamp
+    const std::uint64_t burst_ts = get_timestamp_ns();
+    std::uint64_t bytes = 0;
+    
+    for (std::uint16_t i = 0; i < count && i < PREFETCH_DISTANCE; ++i) {
+        rte_prefetch0(rte_pktmbuf_mtod(packets[i], void*));
+    }
+    
     for (std::uint16_t i = 0; i < count; ++i) {
         struct rte_mbuf* mbuf = packets[i];
-        
-        // Extract packet data
-        const std::uint8_t* data = rte_pktmbuf_mtod(mbuf, const std::uint8_t*);
-        std::size_t length = rte_pktmbuf_pkt_len(mbuf);
+        if (i + PREFETCH_DISTANCE < count) {
+            rte_prefetch0(rte_pktmbuf_mtod(packets[i + PREFETCH_DISTANCE], void*));
+        }
         
         // Get hardware timestamp if available
         std::uint64_t timestamp_ns = (mbuf->ol_flags & RTE_MBUF_F_RX_TIMESTAMP) ? 
-                                     mbuf->timestamp : get_timestamp_ns();
-        
-        // Update statistics
-        packets_received_.fetch_add(1, std::memory_order_relaxed);
-        bytes_received_.fetch_add(length, std::memory_order_relaxed);
+                                     mbuf->timestamp : burst_ts;
         
-        // Create packet descriptor with mbuf context for zero-copy
-        PacketDesc packet(data, length, timestamp_ns, mbuf);
-        
-        // Call packet handler
-        packet_handler_(packet);
-        
-        // Note: packet will be released when release_packet() is called
+        // Descriptor keeps the mbuf as context; it is freed by release_packet()
+        std::size_t length = rte_pktmbuf_pkt_len(mbuf);
+        burst_[i] = PacketDesc(rte_pktmbuf_mtod(mbuf, const std::uint8_t*), length, timestamp_ns, mbuf);
+        bytes += length;
     }
+    
+    // Statistics are updated once per burst
+    packets_received_.fetch_add(count, std::memory_order_relaxed);
+    bytes_received_.fetch_add(bytes, std::memory_order_relaxed);
+    
+    batch_handler_({burst_.data(), count});
 }
 #endif // MDFH_ENABLE_DPDK
 
@@ -702,22 +848,19 @@ void SolarflareBypassClient::disconnect() {
     }
 }
 
-void SolarflareBypassClient::start_reception(PacketHandler handler) {
+void SolarflareBypassClient::start_batch_reception(BatchPacketHandler handler) {
     if (!handler || running_.load() || !initialized_) {
         return;
     }
     
-    packet_handler_ = std::move(handler);
+    batch_handler_ = std::move(handler);
     running_ = true;
     
     reception_thread_ = std::thread([this]() {
+        pin_current_thread(config_.cpu_core, "ef_vi rx");
         reception_loop();
+        reception_exited();
     });
-    
-    // Set CPU affinity for Solarflare reception thread
-    if (config_.cpu_core > 0) {
-        set_cpu_affinity(config_.cpu_core);
-    }
 }
 
 void SolarflareBypassClient::stop_reception() {
@@ -751,20 +894,29 @@ std::string SolarflareBypassClient::backend_info() const {
 void SolarflareBypassClient::reception_loop() {
     std::cout << "Solarflare reception loop started" << std::endl;
     
+    burst_.resize(config_.batch_size);
+    
+    WaitStrategy waiter(config_.wait_config());
+    
     while (running_.load()) {
-        process_events();
-        
-        // Small delay to prevent busy-waiting
-        usleep(config_.poll_timeout_us);
+        if (process_events() > 0) {
+            waiter.reset();
+        } else {
+            waiter.idle();
+        }
     }
     
     std::cout << "Solarflare reception loop stopped" << std::endl;
 }
 
-void SolarflareBypassClient::process_events() {
+int SolarflareBypassClient::process_events() {
     ef_event events[config_.batch_size];
     int n_events = ef_eventq_poll(vi_, events, config_.batch_size);
     
+    const std::uint64_t timestamp_ns = get_timestamp_ns();
+    std::size_t count = 0;
+    std::uint64_t bytes = 0;
+    
     for (int i = 0; i < n_events; ++i) {
         if (EF_EVENT_TYPE(events[i]) == EF_EVENT_TYPE_RX) {
             std::size_t buffer_id = EF_EVENT_RX_RQ_ID(events[i]);
@@ -775,23 +927,528 @@ void SolarflareBypassClient::process_events() {
             const std::uint8_t* data = static_cast<std::uint8_t*>(packet_buffer_) + 
                                       buffer_id * packet_size;
             
-            // Update statistics
-            packets_received_.fetch_add(1, std::memory_order_relaxed);
-            bytes_received_.fetch_add(length, std::memory_order_relaxed);
+            __builtin_prefetch(data);
             
-            // Create packet descriptor with buffer ID as context
-            PacketDesc packet(data, length, get_timestamp_ns(), 
-                            reinterpret_cast<void*>(buffer_id));
-            
-            // Call packet handler
-            packet_handler_(packet);
-            
-            // Note: buffer will be reposted when release_packet() is called
+            // Buffer ID is the context; the buffer is reposted by release_packet()
+            burst_[count++] = PacketDesc(data, length, timestamp_ns, reinterpret_cast<void*>(buffer_id));
+            bytes += length;
         }
     }
+    
+    if (count > 0) {
+        packets_received_.fetch_add(count, std::memory_order_relaxed);
+        bytes_received_.fetch_add(bytes, std::memory_order_relaxed);
+        batch_handler_({burst_.data(), count});
+    }
+    return n_events;
 }
 #endif // MDFH_ENABLE_SOLARFLARE
 
+#ifdef MDFH_ENABLE_IO_URING
+// IoUringBypassClient implementation
+namespace {
+
+constexpr std::uint16_t RECV_BUFFER_GROUP = 0;
+constexpr std::uint64_t RECV_USER_DATA = 1;
+constexpr unsigned SQ_ENTRIES = 64;             // Only recv (re-)arms are ever submitted
+constexpr unsigned SQ_THREAD_IDLE_MS = 1000;    // SQPOLL thread sleeps after this much idle time
+constexpr std::uint32_t MAX_BUFFER_RING_ENTRIES = 32768;    // Kernel limit for provided buffer rings
+
+int io_uring_setup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags, void* arg, std::size_t arg_size) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, arg_size));
+}
+
+int io_uring_register(int fd, unsigned opcode, void* arg, unsigned nr_args) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+// Fields shared with the kernel are accessed through atomic_ref with the
+// orderings liburing uses: acquire on the side the kernel writes, release on ours
+unsigned load_acquire(unsigned* p) { return std::atomic_ref<unsigned>(*p).load(std::memory_order_acquire); }
+void store_release(unsigned* p, unsigned v) { std::atomic_ref<unsigned>(*p).store(v, std::memory_order_release); }
+
+} // namespace
+
+struct IoUringBypassClient::Ring {
+    int fd = -1;
+    io_uring_params params{};
+    
+    // Submission queue
+    void* sq_ptr = MAP_FAILED;
+    std::size_t sq_size = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    std::size_t sqes_size = 0;
+    unsigned* sq_head = nullptr;
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_mask = nullptr;
+    unsigned* sq_flags = nullptr;
+    unsigned* sq_array = nullptr;
+    
+    // Completion queue (shares the SQ mapping with IORING_FEAT_SINGLE_MMAP)
+    void* cq_ptr = MAP_FAILED;
+    std::size_t cq_size = 0;
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned* cq_mask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    
+    // Provided buffer ring and the buffers it hands out. The ring is addressed
+    // as a plain io_uring_buf array: in C++ the UAPI flex-array wrapper puts
+    // io_uring_buf_ring::bufs at offset 8 instead of 0.
+    io_uring_buf* buf_ring = static_cast<io_uring_buf*>(MAP_FAILED);
+    std::size_t buf_ring_size = 0;
+    std::uint16_t buf_mask = 0;
+    std::uint16_t buf_tail = 0;
+    std::uint8_t* buffers = static_cast<std::uint8_t*>(MAP_FAILED);
+    std::size_t buffers_size = 0;
+    std::uint32_t buffer_size = 0;
+    bool buf_ring_registered = false;
+    
+    ~Ring() {
+        if (buf_ring_registered) {
+            io_uring_buf_reg reg{};
+            reg.bgid = RECV_BUFFER_GROUP;
+            io_uring_register(fd, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+        }
+        if (buffers != MAP_FAILED) munmap(buffers, buffers_size);
+        if (buf_ring != MAP_FAILED) munmap(buf_ring, buf_ring_size);
+        if (sqes != MAP_FAILED) munmap(sqes, sqes_size);
+        if (cq_ptr != MAP_FAILED && cq_ptr != sq_ptr) munmap(cq_ptr, cq_size);
+        if (sq_ptr != MAP_FAILED) munmap(sq_ptr, sq_size);
+        if (fd >= 0) ::close(fd);
+    }
+    
+    io_uring_sqe* get_sqe() {
+        unsigned tail = *sq_tail;
+        if (tail - load_acquire(sq_head) >= params.sq_entries) {
+            return nullptr;
+        }
+        unsigned index = tail & *sq_mask;
+        io_uring_sqe* sqe = &sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sq_array[index] = index;
+        return sqe;
+    }
+    
+    // Publishes one prepared SQE (waking the SQPOLL thread if it went idle)
+    int submit(bool sqpoll) {
+        store_release(sq_tail, *sq_tail + 1);
+        if (!sqpoll) {
+            return io_uring_enter(fd, 1, 0, 0, nullptr, 0);
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (std::atomic_ref<unsigned>(*sq_flags).load(std::memory_order_relaxed) & IORING_SQ_NEED_WAKEUP) {
+            return io_uring_enter(fd, 0, 0, IORING_ENTER_SQ_WAKEUP, nullptr, 0);
+        }
+        return 0;
+    }
+    
+    // Blocks until at least one completion is queued or the timeout expires
+    void wait_cqe(std::uint32_t timeout_us) {
+        if (*cq_head != load_acquire(cq_tail)) {
+            return;
+        }
+        __kernel_timespec ts{};
+        ts.tv_sec = timeout_us / 1'000'000;
+        ts.tv_nsec = static_cast<long long>(timeout_us % 1'000'000) * 1000;
+        io_uring_getevents_arg arg{};
+        arg.ts = reinterpret_cast<std::uint64_t>(&ts);
+        io_uring_enter(fd, 0, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+    }
+    
+    // Returns buffer bid to the kernel; visible once publish_buffers() runs
+    void add_buffer(std::uint16_t bid) {
+        // Write fields individually: bufs[0].resv is the shared tail
+        io_uring_buf* buf = &buf_ring[buf_tail & buf_mask];
+        buf->addr = reinterpret_cast<std::uint64_t>(buffers + static_cast<std::size_t>(bid) * buffer_size);
+        buf->len = buffer_size;
+        buf->bid = bid;
+        ++buf_tail;
+    }
+    
+    void publish_buffers() {
+        std::atomic_ref<std::uint16_t>(buf_ring[0].resv).store(buf_tail, std::memory_order_release);
+    }
+    
+    std::uint8_t* buffer(std::uint16_t bid) const {
+        return buffers + static_cast<std::size_t>(bid) * buffer_size;
+    }
+};
+
+// Packet contexts carry bid + 1 so that buffer 0 is not a null context
+inline void* buffer_context(std::uint16_t bid) {
+    return reinterpret_cast<void*>(static_cast<std::uintptr_t>(bid) + 1);
+}
+
+inline std::uint16_t context_buffer(void* context) {
+    return static_cast<std::uint16_t>(reinterpret_cast<std::uintptr_t>(context) - 1);
+}
+
+IoUringBypassClient::IoUringBypassClient() = default;
+
+IoUringBypassClient::~IoUringBypassClient() {
+    disconnect();
+}
+
+bool IoUringBypassClient::initialize(const BypassConfig& config) {
+    if (!config.is_valid()) {
+        std::cerr << "Invalid bypass configuration" << std::endl;
+        return false;
+    }
+    if (config.rx_ring_size > MAX_BUFFER_RING_ENTRIES) {
+        std::cerr << "io_uring: rx_ring_size " << config.rx_ring_size
+                  << " exceeds the provided buffer ring limit of " << MAX_BUFFER_RING_ENTRIES << std::endl;
+        return false;
+    }
+    if (config.io_uring_buffer_size == 0) {
+        std::cerr << "io_uring: io_uring_buffer_size must be > 0" << std::endl;
+        return false;
+    }
+    
+    config_ = config;
+    auto perf_config = config.perf_config;
+    perf_config.sample_memory = config.memory_placement();
+    perf_tracker_ = std::make_unique<PerformanceTracker>(perf_config);
+    ring_ = std::make_unique<Ring>();
+    
+    if (!setup_ring() || !setup_buffer_ring()) {
+        ring_.reset();
+        return false;
+    }
+    return true;
+}
+
+bool IoUringBypassClient::setup_ring() {
+    auto& ring = *ring_;
+    
+    if (config_.io_uring_sqpoll) {
+        ring.params = {};
+        ring.params.flags = IORING_SETUP_SQPOLL;
+        ring.params.sq_thread_idle = SQ_THREAD_IDLE_MS;
+        ring.fd = io_uring_setup(SQ_ENTRIES, &ring.params);
+        if (ring.fd < 0) {
+            // Unprivileged SQPOLL needs Linux 5.11+
+            std::cerr << "io_uring: SQPOLL unavailable (" << std::strerror(errno)
+                      << "), using io_uring_enter submission" << std::endl;
+        }
+    }
+    if (ring.fd < 0) {
+        ring.params = {};
+        ring.fd = io_uring_setup(SQ_ENTRIES, &ring.params);
+        if (ring.fd < 0) {
+            std::cerr << "io_uring_setup failed: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+    }
+    sqpoll_ = (ring.params.flags & IORING_SETUP_SQPOLL) != 0;
+    
+    if (!(ring.params.features & IORING_FEAT_EXT_ARG)) {
+        std::cerr << "io_uring: kernel lacks IORING_FEAT_EXT_ARG (needs Linux 5.11+)" << std::endl;
+        return false;
+    }
+    
+    const auto& p = ring.params;
+    ring.sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    ring.cq_size = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        ring.sq_size = ring.cq_size = std::max(ring.sq_size, ring.cq_size);
+    }
+    
+    ring.sq_ptr = mmap(nullptr, ring.sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ring.fd, IORING_OFF_SQ_RING);
+    if (ring.sq_ptr == MAP_FAILED) {
+        std::cerr << "io_uring: SQ ring mmap failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    ring.cq_ptr = single_mmap ? ring.sq_ptr
+                              : mmap(nullptr, ring.cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                     ring.fd, IORING_OFF_CQ_RING);
+    if (ring.cq_ptr == MAP_FAILED) {
+        std::cerr << "io_uring: CQ ring mmap failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    ring.sqes_size = p.sq_entries * sizeof(io_uring_sqe);
+    ring.sqes = static_cast<io_uring_sqe*>(mmap(nullptr, ring.sqes_size, PROT_READ | PROT_WRITE,
+                                                MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_SQES));
+    if (ring.sqes == MAP_FAILED) {
+        std::cerr << "io_uring: SQE array mmap failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    
+    auto* sq = static_cast<std::uint8_t*>(ring.sq_ptr);
+    ring.sq_head = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+    ring.sq_tail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+    ring.sq_mask = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+    ring.sq_flags = reinterpret_cast<unsigned*>(sq + p.sq_off.flags);
+    ring.sq_array = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+    
+    auto* cq = static_cast<std::uint8_t*>(ring.cq_ptr);
+    ring.cq_head = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+    ring.cq_tail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+    ring.cq_mask = reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+    ring.cqes = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+    return true;
+}
+
+bool IoUringBypassClient::setup_buffer_ring() {
+    auto& ring = *ring_;
+    const std::uint32_t entries = config_.rx_ring_size;
+    
+    // Buffer memory registered with the kernel up front (ZERO ALLOCATION IN HOT PATH)
+    ring.buffer_size = config_.io_uring_buffer_size;
+    ring.buffers_size = static_cast<std::size_t>(entries) * ring.buffer_size;
+    ring.buffers = static_cast<std::uint8_t*>(mmap(nullptr, ring.buffers_size, PROT_READ | PROT_WRITE,
+                                                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0));
+    if (ring.buffers == MAP_FAILED) {
+        std::cerr << "io_uring: buffer mmap failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    
+    ring.buf_ring_size = entries * sizeof(io_uring_buf);
+    ring.buf_ring = static_cast<io_uring_buf*>(mmap(nullptr, ring.buf_ring_size, PROT_READ | PROT_WRITE,
+                                                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0));
+    if (ring.buf_ring == MAP_FAILED) {
+        std::cerr << "io_uring: buffer ring mmap failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    
+    io_uring_buf_reg reg{};
+    reg.ring_addr = reinterpret_cast<std::uint64_t>(ring.buf_ring);
+    reg.ring_entries = entries;
+    reg.bgid = RECV_BUFFER_GROUP;
+    if (io_uring_register(ring.fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        std::cerr << "io_uring: buffer ring registration failed (needs Linux 5.19+): "
+                  << std::strerror(errno) << std::endl;
+        return false;
+    }
+    ring.buf_ring_registered = true;
+    
+    ring.buf_mask = static_cast<std::uint16_t>(entries - 1);
+    ring.buf_tail = 0;
+    for (std::uint32_t bid = 0; bid < entries; ++bid) {
+        ring.add_buffer(static_cast<std::uint16_t>(bid));
+    }
+    ring.publish_buffers();
+    buffers_outstanding_ = 0;
+    return true;
+}
+
+bool IoUringBypassClient::connect() {
+    if (!ring_) {
+        return false;
+    }
+    
+    try {
+        if (config_.transport == TransportType::UDP_MULTICAST) {
+            MulticastConfig mcast_config;
+            mcast_config.groups = {config_.host};
+            mcast_config.port = config_.port;
+            mcast_config.interface = config_.multicast_interface;
+            mcast_config.batch_size = 1;
+            mcast_config.timestamps = RxTimestampSource::USERSPACE;
+            mcast_receiver_ = std::make_unique<MulticastReceiver>(mcast_config);
+            mcast_receiver_->open();
+            socket_fd_ = mcast_receiver_->native_handle();
+        } else {
+            socket_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+            if (socket_fd_ < 0) {
+                throw std::system_error(errno, std::generic_category(), "socket");
+            }
+            auto addr = boost::asio::ip::make_address_v4(config_.host).to_bytes();
+            sockaddr_in sa{};
+            sa.sin_family = AF_INET;
+            sa.sin_port = htons(config_.port);
+            std::memcpy(&sa.sin_addr, addr.data(), addr.size());
+            if (::connect(socket_fd_, reinterpret_cast<sockaddr*>(&sa), sizeof(sa)) < 0) {
+                throw std::system_error(errno, std::generic_category(), "connect");
+            }
+            int one = 1;
+            ::setsockopt(socket_fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            std::cout << "Connected to " << config_.host << ":" << config_.port << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "io_uring connect failed: " << e.what() << std::endl;
+        close_socket();
+        return false;
+    }
+    
+    connected_ = true;
+    return true;
+}
+
+void IoUringBypassClient::close_socket() {
+    connected_ = false;
+    recv_armed_ = false;
+    if (mcast_receiver_) {
+        mcast_receiver_->close();
+        mcast_receiver_.reset();
+    } else if (socket_fd_ >= 0) {
+        ::close(socket_fd_);
+    }
+    socket_fd_ = -1;
+}
+
+void IoUringBypassClient::disconnect() {
+    stop_reception();
+    close_socket();
+}
+
+void IoUringBypassClient::start_batch_reception(BatchPacketHandler handler) {
+    if (!handler || running_.load() || !connected_.load()) {
+        return;
+    }
+    
+    batch_handler_ = std::move(handler);
+    running_ = true;
+    
+    reception_thread_ = std::thread([this]() {
+        pin_current_thread(config_.cpu_core, "io_uring rx");
+        reception_loop();
+        reception_exited();
+    });
+}
+
+void IoUringBypassClient::stop_reception() {
+    running_ = false;
+    if (reception_thread_.joinable()) {
+        reception_thread_.join();
+    }
+}
+
+void IoUringBypassClient::release_packet(void* context) {
+    if (!context || !ring_) {
+        return;
+    }
+    ring_->add_buffer(context_buffer(context));
+    ring_->publish_buffers();
+    --buffers_outstanding_;
+}
+
+std::string IoUringBypassClient::backend_info() const {
+    return std::string("io_uring (multishot recv, provided buffers") + (sqpoll_ ? ", SQPOLL)" : ")");
+}
+
+bool IoUringBypassClient::arm_recv() {
+    io_uring_sqe* sqe = ring_->get_sqe();
+    if (!sqe) {
+        return false;
+    }
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = socket_fd_;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = RECV_BUFFER_GROUP;
+    sqe->user_data = RECV_USER_DATA;
+    
+    if (ring_->submit(sqpoll_) < 0) {
+        MDFH_LOG_ERROR("IoUring", "io_uring_enter submit failed: ", std::strerror(errno));
+        return false;
+    }
+    recv_armed_ = true;
+    return true;
+}
+
+void IoUringBypassClient::reception_loop() {
+    std::cout << "io_uring reception loop started" << std::endl;
+    
+    auto& ring = *ring_;
+    const auto clock_start = reception_clock_start();
+    std::uint64_t next_cpu_sample = 1000;
+    
+    // Completions are handed over a batch_size burst at a time
+    burst_.resize(config_.batch_size);
+    std::size_t burst_count = 0;
+    std::uint64_t burst_bytes = 0;
+    auto deliver_burst = [&]() {
+        packets_received_.fetch_add(burst_count, std::memory_order_relaxed);
+        bytes_received_.fetch_add(burst_bytes, std::memory_order_relaxed);
+        batch_handler_({burst_.data(), burst_count});
+        burst_count = 0;
+        burst_bytes = 0;
+    };
+    
+    // Spinning polls the mapped completion queue without a syscall;
+    // parking blocks in io_uring_enter until a completion or the timeout
+    WaitStrategy waiter(config_.wait_config());
+    auto park = [&ring](std::chrono::microseconds timeout) {
+        ring.wait_cqe(static_cast<std::uint32_t>(timeout.count()));
+    };
+    
+    while (running_.load() && connected_.load()) {
+        // Multishot recv ends on ENOBUFS; re-arm once the handler has returned buffers
+        if (!recv_armed_ && buffers_outstanding_ < config_.rx_ring_size) {
+            MDFH_LOG_DEBUG("IoUring", "Re-arming multishot recv, ", buffers_outstanding_, " buffers still held");
+            if (!arm_recv()) {
+                break;
+            }
+        }
+        
+        unsigned head = *ring.cq_head;
+        const unsigned tail = load_acquire(ring.cq_tail);
+        if (head == tail) {
+            waiter.idle(park);
+            continue;
+        }
+        waiter.reset();
+        
+        // One timestamp per completion batch
+        const std::uint64_t timestamp_ns = get_timestamp_ns();
+        
+        // ENOBUFS completions only mean every buffer is still held by the
+        // handler; the data stays queued in the socket until recv is re-armed
+        for (; head != tail; ++head) {
+            const io_uring_cqe cqe = ring.cqes[head & *ring.cq_mask];
+            if (!(cqe.flags & IORING_CQE_F_MORE)) {
+                recv_armed_ = false;
+            }
+            
+            if (cqe.res > 0 && (cqe.flags & IORING_CQE_F_BUFFER)) {
+                auto bid = static_cast<std::uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+                ++buffers_outstanding_;
+                
+                burst_[burst_count++] = PacketDesc(ring.buffer(bid), static_cast<std::size_t>(cqe.res), timestamp_ns, buffer_context(bid));
+                burst_bytes += static_cast<std::uint64_t>(cqe.res);
+                if (burst_count == burst_.size()) {
+                    deliver_burst();
+                }
+            } else if (cqe.res == 0) {
+                // Nothing to deliver; hand a buffer the completion took straight back
+                if (cqe.flags & IORING_CQE_F_BUFFER) {
+                    ring.add_buffer(static_cast<std::uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+                    ring.publish_buffers();
+                }
+                // End of stream for TCP; for multicast just an empty datagram
+                if (config_.transport != TransportType::UDP_MULTICAST) {
+                    std::cout << "Server closed connection" << std::endl;
+                    connected_ = false;
+                }
+            } else if (cqe.res < 0 && cqe.res != -ENOBUFS) {
+                MDFH_LOG_ERROR("IoUring", "recv error: ", std::strerror(-cqe.res));
+                connected_ = false;
+            }
+        }
+        store_release(ring.cq_head, head);
+        if (burst_count > 0) {
+            deliver_burst();
+        }
+        
+        // Sample reception CPU time periodically
+        if (packets_received_.load(std::memory_order_relaxed) >= next_cpu_sample) {
+            sample_reception_cpu(clock_start);
+            next_cpu_sample += 1000;
+        }
+    }
+    
+    sample_reception_cpu(clock_start);
+    std::cout << "io_uring reception loop stopped" << std::endl;
+}
+#endif // MDFH_ENABLE_IO_URING
+
 // BypassIngestionClient implementation
 BypassIngestionClient::BypassIngestionClient(BypassConfig config)
     : config_(std::move(config)) {
@@ -821,7 +1478,7 @@ bool BypassIngestionClient::initialize() {
         return false;
     }
     
-    parser_ = std::make_unique<MessageParser>();
+    parser_ = std::make_unique<MessageParser>(config_.encoding);
     
     std::cout << "Kernel bypass client initialized: " << backend_info() << std::endl;
     return true;
@@ -848,10 +1505,19 @@ void BypassIngestionClient::start_ingestion(RingBuffer& ring, IngestionStats& st
     
     ring_buffer_ = &ring;
     stats_ = &stats;
+    tracker_ = bypass_client_->performance_tracker();
+    
+    // batch_handler() samples the I/O thread's counters every SAMPLE_INTERVAL
+    // bursts; publish the tail of the run when the thread stops
+    bypass_client_->set_reception_exit_handler([this]() {
+        if (io_counters_) {
+            io_counters_->sample(messages_decoded_);
+        }
+    });
     
     // Start packet reception with our handler
-    bypass_client_->start_reception([this](const PacketDesc& packet) {
-        packet_handler(packet);
+    bypass_client_->start_batch_reception([this](std::span<const PacketDesc> packets) {
+        batch_handler(packets);
     });
 }
 
@@ -888,37 +1554,99 @@ double BypassIngestionClient::cpu_utilization() const {
     return bypass_client_ ? bypass_client_->cpu_utilization() : 0.0;
 }
 
-void BypassIngestionClient::packet_handler(const PacketDesc& packet) {
-    if (!ring_buffer_ || !stats_ || !parser_) {
+void BypassIngestionClient::batch_handler(std::span<const PacketDesc> packets) {
+    if (!ring_buffer_ || !stats_ || !parser_ || packets.empty()) {
         return;
     }
     
-    // Record bytes received
-    stats_->record_bytes_received(packet.length);
+    // The handler runs on the reception thread; its counters open on first use
+    if (!io_counters_attached_) {
+        io_counters_attached_ = true;
+        io_counters_ = tracker_ ? tracker_->attach_thread("I/O") : nullptr;
+    }
+    
+    // Backends without a receive stamp share one for the whole burst
+    const std::uint64_t burst_ts = get_timestamp_ns();
+    std::uint64_t bytes = 0;
+    DecodeCounts counts;
     
-    // Parse packet data and push messages to ring buffer
-    if (config_.enable_zero_copy && packet.length >= config_.zero_copy_threshold) {
-        // Use zero-copy parsing
-        parser_->parse_bytes_zero_copy(packet.data, packet.length, *ring_buffer_, *stats_);
-    } else {
-        // Use regular parsing (with copy)
-        parser_->parse_bytes(packet.data, packet.length, *ring_buffer_, *stats_);
+    for (std::size_t i = 0; i < packets.size() && i < PREFETCH_DISTANCE; ++i) {
+        __builtin_prefetch(packets[i].data);
     }
     
-    // Manage packet lifecycle for zero-copy (LOCK-FREE HOT PATH)
-    if (config_.enable_zero_copy && packet.context) {
-        if (!try_add_pending_packet(packet.context)) {
-            // Ring buffer full, release immediately to prevent memory leak
-            if (bypass_client_) {
-                bypass_client_->release_packet(packet.context);
-            }
+    // Every packet of the burst becomes visible to the consumer with one publish
+    std::size_t traced = 0;
+    ring_buffer_->hold_commits();
+    for (std::size_t i = 0; i < packets.size(); ++i) {
+        if (i + PREFETCH_DISTANCE < packets.size()) {
+            __builtin_prefetch(packets[i + PREFETCH_DISTANCE].data);
+        }
+        
+        const auto& packet = packets[i];
+        std::uint64_t rx_ts = packet.timestamp_ns != 0 ? packet.timestamp_ns : burst_ts;
+        
+        // A sampled packet's first message carries its trace to the consumer
+        StageTimestamps* trace = nullptr;
+        if (tracker_ && traced < burst_traces_.size() && tracker_->sample_packet()) {
+            trace = &burst_traces_[traced];
+            *trace = StageTimestamps{};
+            trace->packet_rx = rx_ts;
+            trace->ring_pos = ring_buffer_->write_position();
+            trace->parse_start = get_timestamp_ns();
+        }
+        
+        auto packet_counts = parser_->decode(packet.data, packet.length, rx_ts, *ring_buffer_);
+        
+        if (trace && packet_counts.decoded > 0) {
+            trace->parse_end = get_timestamp_ns();
+            ++traced;
         }
-    } else {
-        // Release packet immediately if not using zero-copy
-        if (bypass_client_ && packet.context) {
-            bypass_client_->release_packet(packet.context);
+        counts.decoded += packet_counts.decoded;
+        counts.dropped += packet_counts.dropped;
+        counts.malformed += packet_counts.malformed;
+        bytes += packet.length;
+        
+        // The decoder has copied the data out; the buffer can go back
+        if (packet.context) {
+            retire_packet(packet.context);
         }
     }
+    ring_buffer_->publish();
+    
+    if (traced > 0) {
+        auto ring_push = get_timestamp_ns();
+        for (std::size_t i = 0; i < traced; ++i) {
+            burst_traces_[i].ring_push = ring_push;
+            tracker_->begin_trace(burst_traces_[i]);
+        }
+    }
+    
+    // Statistics are updated once per burst
+    stats_->record_bytes_received(bytes);
+    MessageParser::record_counts(counts, *stats_);
+    messages_decoded_ += counts.decoded;
+    if (io_counters_) {
+        io_counters_->maybe_sample(messages_decoded_);
+    }
+    
+    // Hand buffers back a batch at a time so backends with a fixed
+    // buffer pool (io_uring) never run dry
+    if (pending_write_pos_.load(std::memory_order_relaxed) - pending_read_pos_.load(std::memory_order_relaxed)
+            >= config_.batch_size) {
+        cleanup_processed_packets();
+    }
+}
+
+void BypassIngestionClient::retire_packet(void* context) {
+    // Zero-copy buffers are released in batches (LOCK-FREE HOT PATH)
+    if (config_.enable_zero_copy && try_add_pending_packet(context)) {
+        return;
+    }
+    
+    // Not zero-copy, or the pending ring is full: release immediately
+    if (bypass_client_) {
+        bypass_client_->release_packet(context);
+    }
 }
 
 void BypassIngestionClient::cleanup_processed_packets() {
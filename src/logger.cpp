@@ -0,0 +1,192 @@
+#include "mdfh/logger.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace mdfh {
+
+std::atomic<LogLevel> Logger::current_level_{LogLevel::INFO};
+std::atomic<std::ostream*> Logger::output_stream_{&std::cerr};
+
+namespace log_detail {
+
+LogQueue::LogQueue() : records_(std::make_unique<LogRecord[]>(CAPACITY)) {}
+
+namespace {
+
+// Idle backend sleep between polls; bounds the delay before a record appears
+constexpr auto POLL_INTERVAL = std::chrono::milliseconds(1);
+constexpr std::uint64_t WALL_OFFSET_REFRESH_NS = 1'000'000'000;
+
+const char* level_label(LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG: return "DEBUG";
+        case LogLevel::INFO:  return "INFO ";
+        case LogLevel::WARN:  return "WARN ";
+        case LogLevel::ERROR: return "ERROR";
+        case LogLevel::FATAL: return "FATAL";
+    }
+    return "UNKNOWN";
+}
+
+std::int64_t wall_clock_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// "YYYY-MM-DD HH:MM:SS.mmm [LEVEL] component: message"
+void format_record(std::ostream& os, const LogRecord& record, std::int64_t wall_offset_ns) {
+    auto wall_ns = static_cast<std::int64_t>(record.timestamp_ns) + wall_offset_ns;
+    auto seconds = static_cast<std::time_t>(wall_ns / 1'000'000'000);
+    auto ms = (wall_ns / 1'000'000) % 1000;
+    std::tm local{};
+    localtime_r(&seconds, &local);
+
+    os << std::put_time(&local, "%Y-%m-%d %H:%M:%S") << '.' << std::setfill('0') << std::setw(3) << ms
+       << std::setfill(' ') << " [" << level_label(record.level) << "] " << record.component << ": ";
+    record.format(os, record.payload.data());
+    os << '\n';
+}
+
+// Drains every thread's queue on one background thread. Never destroyed:
+// shutdown() runs at exit, after which records are written synchronously.
+class LogBackend {
+public:
+    static LogBackend& instance() {
+        static auto* backend = new LogBackend();
+        return *backend;
+    }
+
+    LogQueue* register_thread() {
+        std::lock_guard<std::mutex> lock(queues_mutex_);
+        queues_.push_back({std::make_unique<LogQueue>(), 0});
+        return queues_.back().queue.get();
+    }
+
+    // Returns once every record committed before the call has been written:
+    // the second drain pass to finish after the call started after it
+    void flush() {
+        auto target = passes_.load(std::memory_order_acquire) + 2;
+        while (passes_.load(std::memory_order_acquire) < target &&
+               !backend_stopped.load(std::memory_order_acquire)) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+    void write(const LogRecord& record) {
+        std::lock_guard<std::mutex> lock(output_mutex_);
+        auto* out = Logger::output_stream();
+        format_record(*out, record, wall_offset_ns_);
+        out->flush();
+    }
+
+private:
+    struct Entry {
+        std::unique_ptr<LogQueue> queue;
+        std::uint64_t reported_drops;
+    };
+
+    LogBackend()
+        : wall_offset_ns_(wall_clock_ns() - static_cast<std::int64_t>(get_timestamp_ns())),
+          wall_offset_at_ns_(get_timestamp_ns()) {
+        thread_ = std::thread([this]() { run(); });
+        std::atexit([]() { instance().shutdown(); });
+    }
+
+    void run() {
+        while (!stop_.load(std::memory_order_acquire)) {
+            if (drain() == 0) {
+                std::this_thread::sleep_for(POLL_INTERVAL);
+            }
+        }
+        // Whatever was queued before shutdown still gets written
+        while (drain() > 0) {
+        }
+    }
+
+    std::size_t drain() {
+        std::size_t written = 0;
+        std::lock_guard<std::mutex> lock(queues_mutex_);
+        std::lock_guard<std::mutex> output_lock(output_mutex_);
+        auto* out = Logger::output_stream();
+
+        // The wall clock is slewed by NTP against the monotonic one; follow it
+        auto now = get_timestamp_ns();
+        if (now - wall_offset_at_ns_ >= WALL_OFFSET_REFRESH_NS) {
+            wall_offset_ns_ = wall_clock_ns() - static_cast<std::int64_t>(now);
+            wall_offset_at_ns_ = now;
+        }
+
+        for (auto it = queues_.begin(); it != queues_.end();) {
+            auto& queue = *it->queue;
+            // Read before draining: a retired queue gets no more records
+            bool retired = queue.retired.load(std::memory_order_acquire);
+            while (const auto* record = queue.front()) {
+                format_record(buffer_, *record, wall_offset_ns_);
+                queue.pop();
+                ++written;
+            }
+
+            auto dropped = queue.dropped();
+            if (dropped != it->reported_drops) {
+                buffer_ << "Logger: " << (dropped - it->reported_drops) << " records dropped (queue full)\n";
+                it->reported_drops = dropped;
+            }
+
+            it = retired ? queues_.erase(it) : it + 1;
+        }
+
+        if (written > 0 || buffer_.tellp() > 0) {
+            *out << buffer_.str();
+            out->flush();
+            buffer_.str({});
+        }
+        passes_.fetch_add(1, std::memory_order_release);
+        return written;
+    }
+
+    // Later records take the synchronous path; the final drain picks up the rest
+    void shutdown() {
+        backend_stopped.store(true, std::memory_order_release);
+        stop_.store(true, std::memory_order_release);
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    std::int64_t wall_offset_ns_;                       // Wall clock minus get_timestamp_ns(), under output_mutex_
+    std::uint64_t wall_offset_at_ns_;                   // When it was last measured
+    std::mutex queues_mutex_;
+    std::vector<Entry> queues_;
+    std::mutex output_mutex_;
+    std::ostringstream buffer_;                         // Backend thread only
+    std::atomic<std::uint64_t> passes_{0};              // Completed drain() calls
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+} // namespace
+
+} // namespace log_detail
+
+log_detail::LogQueue* Logger::register_thread() {
+    return log_detail::LogBackend::instance().register_thread();
+}
+
+void Logger::write_now(const LogRecord& record) {
+    log_detail::LogBackend::instance().write(record);
+}
+
+void Logger::flush() {
+    if (!log_detail::backend_stopped.load(std::memory_order_acquire)) {
+        log_detail::LogBackend::instance().flush();
+    }
+}
+
+} // namespace mdfh
@@ -0,0 +1,336 @@
+#include "mdfh/metrics.hpp"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+namespace mdfh {
+
+namespace {
+
+// Largest UDP payload we send; snapshots beyond it are split at line ends
+constexpr std::size_t MAX_PUSH_DATAGRAM = 60000;
+
+constexpr std::array<double, 5> SUMMARY_QUANTILES = {0.5, 0.9, 0.99, 0.999, 0.9999};
+
+std::string escape_label_value(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        switch (c) {
+            case '\\': escaped += "\\\\"; break;
+            case '"': escaped += "\\\""; break;
+            case '\n': escaped += "\\n"; break;
+            default: escaped += c; break;
+        }
+    }
+    return escaped;
+}
+
+std::string render_labels(const MetricsRegistry::Labels& labels) {
+    std::string rendered;
+    for (const auto& [key, value] : labels) {
+        if (!rendered.empty()) {
+            rendered += ',';
+        }
+        rendered += key + "=\"" + escape_label_value(value) + '"';
+    }
+    return rendered;
+}
+
+void append_value(std::string& out, double value) {
+    char buf[32];
+    std::to_chars_result result;
+    if (std::isfinite(value) && value == std::floor(value) && std::fabs(value) < 9.007199254740992e15) {
+        result = std::to_chars(buf, buf + sizeof(buf), static_cast<std::int64_t>(value));
+    } else {
+        result = std::to_chars(buf, buf + sizeof(buf), value);
+    }
+    out.append(buf, result.ptr);
+}
+
+void append_sample(std::string& out, const std::string& name, const std::string& labels, double value) {
+    out += name;
+    if (!labels.empty()) {
+        out += '{';
+        out += labels;
+        out += '}';
+    }
+    out += ' ';
+    append_value(out, value);
+    out += '\n';
+}
+
+// One scrape: read the request head, answer with the current snapshot, close
+class HttpSession : public std::enable_shared_from_this<HttpSession> {
+public:
+    HttpSession(boost::asio::ip::tcp::socket socket, const MetricsRegistry& registry,
+                std::atomic<std::uint64_t>& scrapes)
+        : socket_(std::move(socket)), registry_(registry), scrapes_(scrapes) {}
+
+    void run() {
+        auto self = shared_from_this();
+        boost::asio::async_read_until(socket_, request_, "\r\n\r\n",
+            [self](const boost::system::error_code& ec, std::size_t) {
+                if (!ec) {
+                    self->respond();
+                }
+            });
+    }
+
+private:
+    void respond() {
+        std::istream request(&request_);
+        std::string method;
+        std::string target;
+        request >> method >> target;
+
+        std::string body;
+        const char* status = "200 OK";
+        if (method != "GET") {
+            status = "405 Method Not Allowed";
+        } else if (target == "/metrics" || target.starts_with("/metrics?")) {
+            body = registry_.render_prometheus();
+            scrapes_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            status = "404 Not Found";
+        }
+
+        response_ = std::string("HTTP/1.1 ") + status + "\r\n"
+                  + "Content-Type: text/plain; version=0.0.4\r\n"
+                  + "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                  + "Connection: close\r\n\r\n" + body;
+        auto self = shared_from_this();
+        boost::asio::async_write(socket_, boost::asio::buffer(response_),
+            [self](const boost::system::error_code&, std::size_t) {
+                boost::system::error_code ignored;
+                self->socket_.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignored);
+            });
+    }
+
+    boost::asio::ip::tcp::socket socket_;
+    boost::asio::streambuf request_{8192};
+    std::string response_;
+    const MetricsRegistry& registry_;
+    std::atomic<std::uint64_t>& scrapes_;
+};
+
+// Splits "host:port"; throws std::invalid_argument on a malformed address
+std::pair<std::string, std::string> split_address(const std::string& address) {
+    auto colon = address.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon + 1 == address.size()) {
+        throw std::invalid_argument("Invalid metrics push address: " + address + " (expected host:port)");
+    }
+    return {address.substr(0, colon), address.substr(colon + 1)};
+}
+
+} // namespace
+
+// MetricsRegistry implementation
+MetricsRegistry::Family& MetricsRegistry::family(const std::string& name, const std::string& help, MetricType type) {
+    auto it = family_index_.find(name);
+    if (it != family_index_.end()) {
+        auto& existing = families_[it->second];
+        if (existing.type != type) {
+            throw std::invalid_argument("Metric " + name + " is already registered with another type");
+        }
+        return existing;
+    }
+    family_index_.emplace(name, families_.size());
+    families_.push_back(Family{name, help, type, {}});
+    return families_.back();
+}
+
+MetricCounter& MetricsRegistry::counter(const std::string& name, const std::string& help, const Labels& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& counter = counters_.emplace_back();
+    family(name, help, MetricType::COUNTER).series.push_back(
+        {render_labels(labels), [&counter]() { return static_cast<double>(counter.value()); }, nullptr});
+    return counter;
+}
+
+MetricGauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const Labels& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& gauge = gauges_.emplace_back();
+    family(name, help, MetricType::GAUGE).series.push_back(
+        {render_labels(labels), [&gauge]() { return static_cast<double>(gauge.value()); }, nullptr});
+    return gauge;
+}
+
+void MetricsRegistry::counter_fn(const std::string& name, const std::string& help, const Labels& labels,
+                                 std::function<double()> read) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    family(name, help, MetricType::COUNTER).series.push_back({render_labels(labels), std::move(read), nullptr});
+}
+
+void MetricsRegistry::gauge_fn(const std::string& name, const std::string& help, const Labels& labels,
+                               std::function<double()> read) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    family(name, help, MetricType::GAUGE).series.push_back({render_labels(labels), std::move(read), nullptr});
+}
+
+void MetricsRegistry::histogram(const std::string& name, const std::string& help, const Labels& labels,
+                                const LatencyHistogram& histogram) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    family(name, help, MetricType::SUMMARY).series.push_back({render_labels(labels), {}, &histogram});
+}
+
+std::string MetricsRegistry::render_prometheus() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string out;
+    out.reserve(families_.size() * 256);
+
+    for (const auto& family : families_) {
+        out += "# HELP " + family.name + ' ' + family.help + '\n';
+        switch (family.type) {
+            case MetricType::COUNTER: out += "# TYPE " + family.name + " counter\n"; break;
+            case MetricType::GAUGE: out += "# TYPE " + family.name + " gauge\n"; break;
+            case MetricType::SUMMARY: out += "# TYPE " + family.name + " summary\n"; break;
+        }
+
+        for (const auto& series : family.series) {
+            if (!series.histogram) {
+                append_sample(out, family.name, series.labels, series.read());
+                continue;
+            }
+
+            // Quantiles come from one walk each; sum and count may be a few samples apart
+            const auto& histogram = *series.histogram;
+            auto separator = series.labels.empty() ? "" : ",";
+            for (double quantile : SUMMARY_QUANTILES) {
+                std::string labels = series.labels + separator + "quantile=\"";
+                append_value(labels, quantile);
+                labels += '"';
+                append_sample(out, family.name, labels,
+                              static_cast<double>(histogram.value_at_percentile(quantile)));
+            }
+            append_sample(out, family.name + "_sum", series.labels, static_cast<double>(histogram.sum()));
+            append_sample(out, family.name + "_count", series.labels, static_cast<double>(histogram.count()));
+        }
+    }
+    return out;
+}
+
+// MetricsConfig implementation
+bool MetricsConfig::is_valid() const {
+    if (!push_address.empty()) {
+        try {
+            split_address(push_address);
+        } catch (const std::invalid_argument&) {
+            return false;
+        }
+        return push_interval_ms > 0;
+    }
+    return true;
+}
+
+// MetricsExporter implementation
+MetricsExporter::MetricsExporter(const MetricsRegistry& registry, MetricsConfig config)
+    : registry_(registry), config_(std::move(config)) {}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+void MetricsExporter::add_reporter(std::chrono::milliseconds period, std::function<void()> report) {
+    reporters_.push_back({period, std::move(report), nullptr});
+}
+
+void MetricsExporter::start() {
+    using namespace boost::asio;
+
+    if (config_.http_port != 0) {
+        acceptor_.emplace(ctx_, ip::tcp::endpoint(ip::tcp::v4(), config_.http_port));
+        std::cout << "Serving metrics on http://0.0.0.0:" << config_.http_port << "/metrics" << std::endl;
+        accept();
+    }
+
+    if (!config_.push_address.empty()) {
+        auto [host, port] = split_address(config_.push_address);
+        ip::udp::resolver resolver(ctx_);
+        push_endpoint_ = *resolver.resolve(ip::udp::v4(), host, port).begin();
+        push_socket_.emplace(ctx_, ip::udp::v4());
+        push_timer_.emplace(ctx_);
+        std::cout << "Pushing metrics to " << push_endpoint_ << " every "
+                  << config_.push_interval_ms << "ms" << std::endl;
+        schedule_push();
+    }
+
+    for (auto& reporter : reporters_) {
+        reporter.timer = std::make_unique<steady_timer>(ctx_);
+        schedule_reporter(reporter);
+    }
+
+    thread_ = std::thread([this]() {
+        try {
+            ctx_.run();
+        } catch (const std::exception& e) {
+            std::cerr << "Metrics exporter error: " << e.what() << std::endl;
+        }
+    });
+}
+
+void MetricsExporter::stop() {
+    ctx_.stop();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void MetricsExporter::accept() {
+    acceptor_->async_accept([this](const boost::system::error_code& ec, boost::asio::ip::tcp::socket socket) {
+        if (ec == boost::asio::error::operation_aborted) {
+            return;
+        }
+        if (!ec) {
+            std::make_shared<HttpSession>(std::move(socket), registry_, scrapes_)->run();
+        }
+        accept();
+    });
+}
+
+void MetricsExporter::schedule_push() {
+    push_timer_->expires_after(std::chrono::milliseconds(config_.push_interval_ms));
+    push_timer_->async_wait([this](const boost::system::error_code& ec) {
+        if (ec) {
+            return;
+        }
+        push();
+        schedule_push();
+    });
+}
+
+void MetricsExporter::push() {
+    auto text = registry_.render_prometheus();
+
+    // Whole lines per datagram so the receiver can parse each one on its own
+    std::size_t begin = 0;
+    while (begin < text.size()) {
+        auto end = std::min(text.size(), begin + MAX_PUSH_DATAGRAM);
+        if (end < text.size()) {
+            auto newline = text.rfind('\n', end - 1);
+            if (newline != std::string::npos && newline >= begin) {
+                end = newline + 1;
+            }
+        }
+        boost::system::error_code ec;
+        push_socket_->send_to(boost::asio::buffer(text.data() + begin, end - begin), push_endpoint_, 0, ec);
+        begin = end;
+    }
+    pushes_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MetricsExporter::schedule_reporter(Reporter& reporter) {
+    reporter.timer->expires_after(reporter.period);
+    reporter.timer->async_wait([this, &reporter](const boost::system::error_code& ec) {
+        if (ec) {
+            return;
+        }
+        reporter.report();
+        schedule_reporter(reporter);
+    });
+}
+
+} // namespace mdfh
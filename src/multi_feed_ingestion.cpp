@@ -6,16 +6,78 @@
 #include <algorithm>
 #include <regex>
 #include <set>
+#include <array>
+#include <cctype>
+#include <filesystem>
 
 namespace mdfh {
 
 // FeedConfig implementation
 bool FeedConfig::is_valid() const {
+    if (transport == TransportType::UDP_MULTICAST) {
+        boost::system::error_code ec;
+        auto group = boost::asio::ip::make_address(host, ec);
+        if (ec || !group.is_multicast()) {
+            return false;
+        }
+    }
     return !name.empty() && !host.empty() && port > 0 && 
            heartbeat_interval_ms > 0 && timeout_multiplier > 0 &&
+           origin_id <= MAX_ORIGIN_ID && wait.is_valid() &&
            buffer_capacity > 0 && (buffer_capacity & (buffer_capacity - 1)) == 0; // power of 2
 }
 
+namespace {
+
+// Reads wait_strategy / spin_iterations / yield_iterations / park_timeout_us
+void load_wait_config(const YAML::Node& node, WaitConfig& wait) {
+    if (node["wait_strategy"]) {
+        wait.type = parse_wait_strategy_type(node["wait_strategy"].as<std::string>());
+    }
+    if (node["spin_iterations"]) {
+        wait.spin_iterations = node["spin_iterations"].as<std::uint32_t>();
+    }
+    if (node["yield_iterations"]) {
+        wait.yield_iterations = node["yield_iterations"].as<std::uint32_t>();
+    }
+    if (node["park_timeout_us"]) {
+        wait.park_timeout_us = node["park_timeout_us"].as<std::uint32_t>();
+    }
+}
+
+// Reads huge_pages / numa_node / prefault
+void load_memory_placement(const YAML::Node& node, MemoryPlacement& memory) {
+    if (node["huge_pages"]) {
+        memory.huge_pages = parse_huge_page_mode(node["huge_pages"].as<std::string>());
+    }
+    if (node["numa_node"]) {
+        memory.numa_node = node["numa_node"].as<int>();
+    }
+    if (node["prefault"]) {
+        memory.prefault = node["prefault"].as<bool>();
+    }
+}
+
+// Explicit node if given, else local to the CPU that uses the memory
+MemoryPlacement local_to(MemoryPlacement memory, int cpu_core) {
+    if (memory.numa_node < 0) {
+        memory.numa_node = numa_node_of_cpu(cpu_core);
+    }
+    return memory;
+}
+
+} // namespace
+
+FanInMode parse_fan_in_mode(const std::string& name) {
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    
+    if (lower == "relay") return FanInMode::RELAY;
+    if (lower == "direct") return FanInMode::DIRECT;
+    throw std::invalid_argument("Unknown fan-in mode: " + name);
+}
+
 // MultiFeedConfig implementation
 MultiFeedConfig MultiFeedConfig::from_yaml(const std::string& filename) {
     MultiFeedConfig config;
@@ -29,9 +91,19 @@ MultiFeedConfig MultiFeedConfig::from_yaml(const std::string& filename) {
             if (global["buffer_capacity"]) {
                 config.global_buffer_capacity = global["buffer_capacity"].as<std::uint32_t>();
             }
+            if (global["fan_in_mode"]) {
+                config.fan_in_mode = parse_fan_in_mode(global["fan_in_mode"].as<std::string>());
+            }
             if (global["dispatcher_threads"]) {
                 config.dispatcher_threads = global["dispatcher_threads"].as<std::uint32_t>();
             }
+            if (global["dispatcher_cores"]) {
+                config.dispatcher_cores = global["dispatcher_cores"].as<std::vector<std::uint32_t>>();
+            }
+            if (global["health_core"]) {
+                config.health_core = global["health_core"].as<int>();
+            }
+            load_memory_placement(global, config.memory);
             if (global["max_seconds"]) {
                 config.max_seconds = global["max_seconds"].as<std::uint32_t>();
             }
@@ -41,6 +113,72 @@ MultiFeedConfig MultiFeedConfig::from_yaml(const std::string& filename) {
             if (global["health_check_interval_ms"]) {
                 config.health_check_interval_ms = global["health_check_interval_ms"].as<std::uint32_t>();
             }
+            if (global["thread_counters"]) {
+                config.thread_counters = global["thread_counters"].as<bool>();
+            }
+            load_wait_config(global, config.consumer_wait);
+        }
+        
+        // Metrics export
+        if (yaml["metrics"]) {
+            auto metrics = yaml["metrics"];
+            if (metrics["http_port"]) {
+                config.metrics.http_port = metrics["http_port"].as<std::uint16_t>();
+            }
+            if (metrics["push"]) {
+                config.metrics.push_address = metrics["push"].as<std::string>();
+            }
+            if (metrics["push_interval_ms"]) {
+                config.metrics.push_interval_ms = metrics["push_interval_ms"].as<std::uint32_t>();
+            }
+        }
+        
+        // Conflation stage
+        if (yaml["conflation"]) {
+            auto conflation = yaml["conflation"];
+            if (conflation["max_keys"]) {
+                config.conflation.max_keys = conflation["max_keys"].as<std::uint32_t>();
+            }
+            if (conflation["key"]) {
+                config.conflation.key = parse_conflation_key(conflation["key"].as<std::string>());
+            }
+            if (conflation["tick_size"]) {
+                config.conflation.tick_size = conflation["tick_size"].as<double>();
+            }
+            if (conflation["poll_interval_ms"]) {
+                config.conflation.poll_interval_ms = conflation["poll_interval_ms"].as<std::uint32_t>();
+            }
+        }
+        
+        // Shared-memory ring
+        if (yaml["shm_ring"]) {
+            auto shm_ring = yaml["shm_ring"];
+            if (shm_ring["path"]) {
+                config.shm_ring.path = shm_ring["path"].as<std::string>();
+            }
+            if (shm_ring["capacity"]) {
+                config.shm_ring.capacity = shm_ring["capacity"].as<std::uint64_t>();
+            }
+            if (shm_ring["max_readers"]) {
+                config.shm_ring.max_readers = shm_ring["max_readers"].as<std::uint32_t>();
+            }
+        }
+        
+        // Tick journal
+        if (yaml["journal"]) {
+            auto journal = yaml["journal"];
+            if (journal["directory"]) {
+                config.journal.directory = journal["directory"].as<std::string>();
+            }
+            if (journal["segment_mb"]) {
+                config.journal.segment_bytes = journal["segment_mb"].as<std::uint64_t>() << 20;
+            }
+            if (journal["flush_interval_ms"]) {
+                config.journal.flush_interval_ms = journal["flush_interval_ms"].as<std::uint32_t>();
+            }
+            if (journal["index_stride"]) {
+                config.journal.index_stride = journal["index_stride"].as<std::uint32_t>();
+            }
         }
         
         // Feed configurations
@@ -49,6 +187,7 @@ MultiFeedConfig MultiFeedConfig::from_yaml(const std::string& filename) {
             for (const auto& feed_node : yaml["feeds"]) {
                 FeedConfig feed;
                 feed.origin_id = origin_id++;
+                feed.memory = config.memory;
                 
                 if (feed_node["name"]) {
                     feed.name = feed_node["name"].as<std::string>();
@@ -65,6 +204,9 @@ MultiFeedConfig MultiFeedConfig::from_yaml(const std::string& filename) {
                 if (feed_node["is_primary"]) {
                     feed.is_primary = feed_node["is_primary"].as<bool>();
                 }
+                if (feed_node["arbitration_group"]) {
+                    feed.arbitration_group = feed_node["arbitration_group"].as<std::string>();
+                }
                 if (feed_node["heartbeat_interval_ms"]) {
                     feed.heartbeat_interval_ms = feed_node["heartbeat_interval_ms"].as<std::uint32_t>();
                 }
@@ -74,6 +216,26 @@ MultiFeedConfig MultiFeedConfig::from_yaml(const std::string& filename) {
                 if (feed_node["buffer_capacity"]) {
                     feed.buffer_capacity = feed_node["buffer_capacity"].as<std::uint32_t>();
                 }
+                if (feed_node["encoding"]) {
+                    feed.encoding = parse_encoding_type(feed_node["encoding"].as<std::string>());
+                }
+                if (feed_node["transport"]) {
+                    feed.transport = parse_transport_type(feed_node["transport"].as<std::string>());
+                }
+                if (feed_node["interface"]) {
+                    feed.interface = feed_node["interface"].as<std::string>();
+                }
+                if (feed_node["timestamps"]) {
+                    feed.timestamps = parse_rx_timestamp_source(feed_node["timestamps"].as<std::string>());
+                }
+                load_wait_config(feed_node, feed.wait);
+                if (feed_node["io_core"]) {
+                    feed.io_core = feed_node["io_core"].as<int>();
+                }
+                if (feed_node["relay_core"]) {
+                    feed.relay_core = feed_node["relay_core"].as<int>();
+                }
+                load_memory_placement(feed_node, feed.memory);
                 
                 if (feed.is_valid()) {
                     config.feeds.push_back(std::move(feed));
@@ -140,85 +302,243 @@ bool MultiFeedConfig::is_valid() const {
     // Ensure power of 2 buffer capacity
     return global_buffer_capacity > 0 && 
            (global_buffer_capacity & (global_buffer_capacity - 1)) == 0 &&
-           dispatcher_threads > 0 && health_check_interval_ms > 0;
+           dispatcher_threads > 0 && health_check_interval_ms > 0 && consumer_wait.is_valid() &&
+           (!journal.enabled() || journal.is_valid()) && (!conflation.enabled() || conflation.is_valid()) &&
+           (!shm_ring.enabled() || shm_ring.is_valid()) && metrics.is_valid();
 }
 
 // MPSCRingBuffer implementation
-MPSCRingBuffer::MPSCRingBuffer(std::uint64_t capacity) 
+MPSCRingBuffer::MPSCRingBuffer(std::uint64_t capacity, const MemoryPlacement& placement) 
     : capacity_(capacity), mask_(capacity - 1) {
     if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
         throw std::invalid_argument("Capacity must be a power of 2");
     }
-    slots_.resize(capacity);
+    cells_ = PlacedArray<Cell>(capacity, placement);
+    
+    // Cell i is free for the producer that claims position i
+    for (std::uint64_t i = 0; i < capacity; ++i) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
 }
 
 bool MPSCRingBuffer::try_push(const MultiFeedSlot& slot) {
-    std::uint64_t write_pos = write_pos_.load(std::memory_order_relaxed);
-    std::uint64_t read_pos = read_pos_.load(std::memory_order_acquire);
+    Cell* cell;
+    std::uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
     
-    if (write_pos - read_pos >= capacity_) {
-        return false; // Buffer full
+    while (true) {
+        cell = &cells_[pos & mask_];
+        std::uint64_t seq = cell->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::int64_t>(seq) - static_cast<std::int64_t>(pos);
+        
+        if (diff == 0) {
+            // Cell is free - try to claim this position
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+            // CAS failure reloaded pos, retry with the new position
+        } else if (diff < 0) {
+            return false; // Buffer full - consumer has not released this cell yet
+        } else {
+            // Another producer claimed pos, catch up
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
     }
     
-    std::uint64_t expected = write_pos;
-    if (!write_pos_.compare_exchange_weak(expected, write_pos + 1, std::memory_order_acq_rel)) {
-        return false; // Another producer got there first
+    cell->data = slot;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    if (consumer_signal_) {
+        consumer_signal_->notify();
     }
-    
-    slots_[write_pos & mask_] = slot;
     return true;
 }
 
+std::uint64_t MPSCRingBuffer::try_push_n(const MultiFeedSlot* slots, std::uint64_t count) {
+    if (count == 0 || slots == nullptr) return 0;
+    
+    std::uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    std::uint64_t to_push;
+    
+    while (true) {
+        // The consumer releases cells in order, so the free space is bounded
+        // by its published position
+        std::uint64_t consumed = dequeue_pos_.load(std::memory_order_acquire);
+        std::uint64_t used = pos - consumed;
+        if (used >= capacity_) {
+            // Either full or pos is stale; a fresh load decides
+            std::uint64_t current = enqueue_pos_.load(std::memory_order_relaxed);
+            if (current == pos) {
+                return 0;
+            }
+            pos = current;
+            continue;
+        }
+        
+        to_push = std::min(count, capacity_ - used);
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + to_push, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    
+    for (std::uint64_t i = 0; i < to_push; ++i) {
+        Cell& cell = cells_[(pos + i) & mask_];
+        cell.data = slots[i];
+        cell.sequence.store(pos + i + 1, std::memory_order_release);
+    }
+    if (consumer_signal_) {
+        consumer_signal_->notify();
+    }
+    return to_push;
+}
+
 bool MPSCRingBuffer::try_pop(MultiFeedSlot& slot) {
-    std::uint64_t read_pos = read_pos_.load(std::memory_order_relaxed);
-    std::uint64_t write_pos = write_pos_.load(std::memory_order_acquire);
+    std::uint64_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    Cell& cell = cells_[pos & mask_];
     
-    if (read_pos >= write_pos) {
-        return false; // Buffer empty
+    // Payload is only visible once its producer has stamped the cell
+    if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+        return false; // Buffer empty or producer still writing
     }
     
-    slot = slots_[read_pos & mask_];
-    read_pos_.store(read_pos + 1, std::memory_order_release);
+    slot = cell.data;
+    cell.sequence.store(pos + capacity_, std::memory_order_release);
+    dequeue_pos_.store(pos + 1, std::memory_order_release);
     return true;
 }
 
+std::uint64_t MPSCRingBuffer::try_pop_n(MultiFeedSlot* slots, std::uint64_t max_count) {
+    if (max_count == 0 || slots == nullptr) return 0;
+    
+    std::uint64_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    std::uint64_t popped = 0;
+    
+    while (popped < max_count) {
+        Cell& cell = cells_[(pos + popped) & mask_];
+        if (cell.sequence.load(std::memory_order_acquire) != pos + popped + 1) {
+            break;
+        }
+        slots[popped] = cell.data;
+        cell.sequence.store(pos + popped + capacity_, std::memory_order_release);
+        ++popped;
+    }
+    
+    if (popped > 0) {
+        dequeue_pos_.store(pos + popped, std::memory_order_release);
+    }
+    return popped;
+}
+
 std::uint64_t MPSCRingBuffer::size() const {
-    std::uint64_t write_pos = write_pos_.load(std::memory_order_acquire);
-    std::uint64_t read_pos = read_pos_.load(std::memory_order_acquire);
-    return write_pos - read_pos;
+    std::uint64_t dequeue_pos = dequeue_pos_.load(std::memory_order_acquire);
+    std::uint64_t enqueue_pos = enqueue_pos_.load(std::memory_order_acquire);
+    return enqueue_pos >= dequeue_pos ? enqueue_pos - dequeue_pos : 0;
 }
 
 // FeedMonitor implementation
+namespace {
+
+std::int64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
 FeedMonitor::FeedMonitor(FeedConfig config) : config_(std::move(config)) {
-    last_message_time_.store(std::chrono::steady_clock::now());
+    local_.last_message_ns = steady_now_ns();
+    publish();
 }
 
 void FeedMonitor::record_message(const Msg& msg, std::uint64_t bytes) {
-    messages_received_.fetch_add(1, std::memory_order_relaxed);
-    bytes_received_.fetch_add(bytes, std::memory_order_relaxed);
-    last_message_time_.store(std::chrono::steady_clock::now(), std::memory_order_release);
+    local_.messages_received += 1;
+    local_.bytes_received += bytes;
+    local_.last_message_ns = steady_now_ns();
     
     // Track sequence gaps
-    std::lock_guard<std::mutex> lock(gap_mutex_);
-    if (!first_message_seen_) {
-        expected_sequence_ = msg.seq;
-        first_message_seen_ = true;
-    } else {
-        if (msg.seq != expected_sequence_) {
-            sequence_gaps_.fetch_add(1, std::memory_order_relaxed);
-        }
-        expected_sequence_ = msg.seq + 1;
+    if (first_message_seen_ && msg.seq != expected_sequence_) {
+        local_.sequence_gaps += 1;
     }
+    first_message_seen_ = true;
+    expected_sequence_ = msg.seq + 1;
+    local_.last_sequence = msg.seq;
     
-    last_sequence_.store(msg.seq, std::memory_order_release);
+    publish();
     
     // Update status to healthy if we were connecting
-    FeedStatus current = status_.load();
-    if (current == FeedStatus::CONNECTING) {
+    if (status_.load(std::memory_order_relaxed) == FeedStatus::CONNECTING) {
         status_.store(FeedStatus::HEALTHY, std::memory_order_release);
     }
 }
 
+void FeedMonitor::record_messages(std::span<const Slot> slots) {
+    if (slots.empty()) {
+        return;
+    }
+    
+    // Same rule as record_message(): every message that does not follow its
+    // predecessor counts as a gap. Branch-free, so a batch costs one pass.
+    std::uint64_t gaps = first_message_seen_ && slots.front().raw.seq != expected_sequence_;
+    for (std::size_t i = 1; i < slots.size(); ++i) {
+        gaps += slots[i].raw.seq != slots[i - 1].raw.seq + 1;
+    }
+    first_message_seen_ = true;
+    expected_sequence_ = slots.back().raw.seq + 1;
+    
+    auto now = get_timestamp_ns();
+    for (const auto& slot : slots) {
+        latency_.record(now > slot.rx_ts ? now - slot.rx_ts : 0);
+    }
+    
+    local_.messages_received += slots.size();
+    local_.bytes_received += slots.size() * sizeof(Msg);
+    local_.sequence_gaps += gaps;
+    local_.last_sequence = slots.back().raw.seq;
+    local_.last_message_ns = steady_now_ns();
+    
+    publish();
+    
+    if (status_.load(std::memory_order_relaxed) == FeedStatus::CONNECTING) {
+        status_.store(FeedStatus::HEALTHY, std::memory_order_release);
+    }
+}
+
+void FeedMonitor::record_dropped(std::uint64_t count) {
+    local_.messages_dropped += count;
+    publish();
+}
+
+void FeedMonitor::publish() {
+    auto seq = seq_.load(std::memory_order_relaxed);
+    seq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    
+    messages_received_.store(local_.messages_received, std::memory_order_relaxed);
+    bytes_received_.store(local_.bytes_received, std::memory_order_relaxed);
+    sequence_gaps_.store(local_.sequence_gaps, std::memory_order_relaxed);
+    messages_dropped_.store(local_.messages_dropped, std::memory_order_relaxed);
+    last_sequence_.store(local_.last_sequence, std::memory_order_relaxed);
+    last_message_ns_.store(local_.last_message_ns, std::memory_order_relaxed);
+    
+    seq_.store(seq + 2, std::memory_order_release);
+}
+
+FeedMonitor::Snapshot FeedMonitor::snapshot() const {
+    Snapshot snap;
+    std::uint64_t before;
+    std::uint64_t after;
+    do {
+        before = seq_.load(std::memory_order_acquire);
+        snap.messages_received = messages_received_.load(std::memory_order_relaxed);
+        snap.bytes_received = bytes_received_.load(std::memory_order_relaxed);
+        snap.sequence_gaps = sequence_gaps_.load(std::memory_order_relaxed);
+        snap.messages_dropped = messages_dropped_.load(std::memory_order_relaxed);
+        snap.last_sequence = last_sequence_.load(std::memory_order_relaxed);
+        snap.last_message_ns = last_message_ns_.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = seq_.load(std::memory_order_relaxed);
+    } while (before != after || (before & 1) != 0);
+    return snap;
+}
+
 void FeedMonitor::record_connection_established() {
     status_.store(FeedStatus::HEALTHY, std::memory_order_release);
 }
@@ -228,9 +548,8 @@ void FeedMonitor::record_connection_failed() {
 }
 
 void FeedMonitor::check_health() {
-    auto now = std::chrono::steady_clock::now();
-    auto last_msg = last_message_time_.load(std::memory_order_acquire);
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_msg);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::nanoseconds(steady_now_ns() - snapshot().last_message_ns));
     
     std::uint32_t timeout_ms = config_.heartbeat_interval_ms * config_.timeout_multiplier;
     
@@ -264,11 +583,15 @@ void FeedMonitor::print_stats() const {
         case FeedStatus::FAILED: status_str = "FAILED"; break;
     }
     
+    auto snap = snapshot();
     std::cout << "Feed " << config_.name << " [" << config_.host << ":" << config_.port << "] "
               << "Status: " << status_str << " | "
-              << "Messages: " << messages_received_.load() << " | "
-              << "Gaps: " << sequence_gaps_.load() << " | "
-              << "Last Seq: " << last_sequence_.load() << std::endl;
+              << "Messages: " << snap.messages_received << " | "
+              << "Gaps: " << snap.sequence_gaps << " | "
+              << "Drops: " << snap.messages_dropped << " | "
+              << "Last Seq: " << snap.last_sequence << " | "
+              << "Relay p50/p99/p99.99: " << latency_.value_at_percentile(0.50) << "/"
+              << latency_.value_at_percentile(0.99) << "/" << latency_.value_at_percentile(0.9999) << " ns" << std::endl;
 }
 
 // FeedWorker implementation
@@ -280,28 +603,55 @@ FeedWorker::FeedWorker(FeedConfig config) : config_(std::move(config)) {
     ing_config.host = config_.host;
     ing_config.port = config_.port;
     ing_config.buffer_capacity = config_.buffer_capacity;
+    ing_config.encoding = config_.encoding;
     
-    client_ = std::make_unique<NetworkClient>(ing_config);
-    parser_ = std::make_unique<MessageParser>();
-    local_buffer_ = std::make_unique<RingBuffer>(config_.buffer_capacity);
+    if (config_.transport == TransportType::UDP_MULTICAST) {
+        MulticastConfig mcast_config;
+        mcast_config.groups = {config_.host};
+        mcast_config.port = config_.port;
+        mcast_config.interface = config_.interface;
+        mcast_config.timestamps = config_.timestamps;
+        mcast_config.wait = config_.wait;
+        mcast_client_ = std::make_unique<MulticastReceiver>(mcast_config);
+    } else {
+        client_ = std::make_unique<NetworkClient>(ing_config);
+    }
+    parser_ = std::make_unique<MessageParser>(config_.encoding);
+    local_buffer_ = std::make_unique<RingBuffer>(config_.buffer_capacity, local_to(config_.memory, config_.io_core));
+    local_buffer_->set_consumer_signal(&relay_signal_);
 }
 
 FeedWorker::~FeedWorker() {
     stop();
 }
 
-void FeedWorker::start(MPSCRingBuffer& global_buffer) {
+void FeedWorker::start(MPSCRingBuffer& global_buffer, PerformanceTracker* counters) {
+    counters_ = counters;
     should_stop_.store(false);
     worker_thread_ = std::thread([this, &global_buffer]() {
-        worker_loop(global_buffer);
+        worker_loop(&global_buffer);
+    });
+}
+
+void FeedWorker::start_direct(WaitSignal& consumer_signal, PerformanceTracker* counters) {
+    // The consumer, not a relay loop, now parks on this buffer
+    local_buffer_->set_consumer_signal(&consumer_signal);
+    counters_ = counters;
+    should_stop_.store(false);
+    worker_thread_ = std::thread([this]() {
+        worker_loop(nullptr);
     });
 }
 
 void FeedWorker::stop() {
     should_stop_.store(true);
+    relay_signal_.notify();
     if (client_) {
         client_->stop();
     }
+    if (mcast_client_) {
+        mcast_client_->stop();
+    }
     if (worker_thread_.joinable()) {
         worker_thread_.join();
     }
@@ -311,40 +661,70 @@ bool FeedWorker::is_running() const {
     return worker_thread_.joinable() && !should_stop_.load();
 }
 
-void FeedWorker::worker_loop(MPSCRingBuffer& global_buffer) {
+void FeedWorker::worker_loop(MPSCRingBuffer* global_buffer) {
     try {
-        // Connect to feed
-        client_->connect();
+        // Connect to feed (or join its multicast group)
+        if (mcast_client_) {
+            mcast_client_->open();
+        } else {
+            client_->connect();
+        }
         monitor_->record_connection_established();
         
-        // Create a custom stats adapter that inherits from IngestionStats
-        class StatsAdapter : public IngestionStats {
-        private:
-            FeedMonitor* monitor_;
-        public:
-            explicit StatsAdapter(FeedMonitor* monitor) : monitor_(monitor) {}
-            
-            void record_message_processed(const Slot& slot) override {
-                IngestionStats::record_message_processed(slot);
-                monitor_->record_message(slot.raw, sizeof(Msg));
+        // Wire-level counters of the I/O loop; the monitor is fed once per
+        // batch by whoever drains the local buffer, never per message here
+        IngestionStats io_stats;
+        auto run_io = [this, &io_stats]() {
+            pin_current_thread(config_.io_core, config_.name + " I/O thread");
+            auto* counters = counters_ ? counters_->attach_thread(config_.name + " I/O") : nullptr;
+            if (mcast_client_) {
+                mcast_client_->run_io_loop(*local_buffer_, io_stats, *parser_, counters);
+            } else {
+                client_->run_io_loop(*local_buffer_, io_stats, *parser_, counters);
+            }
+            if (counters) {
+                counters->sample(io_stats.messages_received());
             }
         };
         
-        StatsAdapter stats_adapter(monitor_.get());
+        if (!global_buffer) {
+            // DIRECT mode: parse straight into the lane; monitor accounting
+            // happens in batches as the consumer drains it
+            run_io();
+            return;
+        }
         
-        // Start I/O thread for this feed
-        std::thread io_thread([this, &stats_adapter]() {
-            client_->run_io_loop(*local_buffer_, stats_adapter, *parser_);
-        });
+        // Start I/O thread for this feed; this thread becomes the relay
+        std::thread io_thread(run_io);
+        pin_current_thread(config_.relay_core, config_.name + " relay thread");
         
-        // Process messages from local buffer to global buffer
+        // Process messages from local buffer to global buffer; the I/O
+        // thread's commits wake the loop when it parks
+        WaitStrategy waiter(config_.wait, &relay_signal_);
+        auto* counters = counters_ ? counters_->attach_thread(config_.name + " relay") : nullptr;
+        std::uint64_t relayed = 0;
         while (!should_stop_.load()) {
-            process_local_messages(global_buffer);
-            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            auto count = process_local_messages(*global_buffer);
+            if (count > 0) {
+                relayed += count;
+                if (counters) {
+                    counters->maybe_sample(relayed);
+                }
+                waiter.reset();
+            } else {
+                waiter.idle();
+            }
+        }
+        if (counters) {
+            counters->sample(relayed);
         }
         
         // Clean up I/O thread
-        client_->stop();
+        if (mcast_client_) {
+            mcast_client_->stop();
+        } else {
+            client_->stop();
+        }
         if (io_thread.joinable()) {
             io_thread.join();
         }
@@ -355,42 +735,119 @@ void FeedWorker::worker_loop(MPSCRingBuffer& global_buffer) {
     }
 }
 
-void FeedWorker::process_local_messages(MPSCRingBuffer& global_buffer) {
-    Slot local_slot;
-    while (local_buffer_->try_pop(local_slot)) {
-        // Record message in monitor
-        monitor_->record_message(local_slot.raw, sizeof(Msg));
-        
-        // Create multi-feed slot and push to global buffer
-        MultiFeedSlot global_slot(local_slot, config_.origin_id, local_slot.raw.seq);
+std::uint64_t FeedWorker::drain_lane(MultiFeedSlot* slots, std::uint64_t max_count) {
+    auto lane = local_buffer_->peek(max_count);
+    if (lane.empty()) {
+        return 0;
+    }
+    
+    monitor_->record_messages(lane);
+    const auto origin = static_cast<std::uint16_t>(config_.origin_id);
+    for (std::size_t i = 0; i < lane.size(); ++i) {
+        slots[i] = MultiFeedSlot(lane[i], origin);
+    }
+    local_buffer_->release(lane.size());
+    return lane.size();
+}
+
+std::uint64_t FeedWorker::process_local_messages(MPSCRingBuffer& global_buffer) {
+    std::array<MultiFeedSlot, RELAY_BATCH_SIZE> global_slots;
+    
+    std::uint64_t relayed = 0;
+    std::uint64_t count;
+    while ((count = drain_lane(global_slots.data(), global_slots.size())) > 0) {
+        // Push the whole batch to the global buffer
+        std::uint64_t pushed = 0;
+        while (pushed < count) {
+            auto n = global_buffer.try_push_n(global_slots.data() + pushed, count - pushed);
+            if (n == 0) {
+                break;
+            }
+            pushed += n;
+        }
         
-        if (!global_buffer.try_push(global_slot)) {
-            // Global buffer full - could implement backpressure here
-            std::cerr << "Warning: Global buffer full, dropping message from " << config_.name << std::endl;
+        if (pushed < count) {
+            // Global buffer full: count the loss, the health summary reports it
+            monitor_->record_dropped(count - pushed);
         }
+        relayed += count;
     }
+    return relayed;
 }
 
 // FanInDispatcher implementation
 FanInDispatcher::FanInDispatcher(MultiFeedConfig config) : config_(std::move(config)) {
-    global_buffer_ = std::make_unique<MPSCRingBuffer>(config_.global_buffer_capacity);
-    
     // Create workers for each feed
     for (const auto& feed_config : config_.feeds) {
         workers_.push_back(std::make_unique<FeedWorker>(feed_config));
     }
+    
+    assign_shards();
+}
+
+void FanInDispatcher::assign_shards() {
+    // Routing unit: a lone feed, or every line of one arbitration group
+    std::vector<std::vector<std::size_t>> units;
+    std::unordered_map<std::string, std::size_t> group_units;
+    for (std::size_t i = 0; i < config_.feeds.size(); ++i) {
+        const auto& group = config_.feeds[i].arbitration_group;
+        if (!group.empty()) {
+            auto [it, inserted] = group_units.emplace(group, units.size());
+            if (!inserted) {
+                units[it->second].push_back(i);
+                continue;
+            }
+        }
+        units.push_back({i});
+    }
+    
+    // More shards than units would leave consumers with nothing to drain
+    auto shard_count = std::max<std::size_t>(1, std::min<std::size_t>(config_.dispatcher_threads, units.size()));
+    for (std::size_t i = 0; i < shard_count; ++i) {
+        auto shard = std::make_unique<Shard>();
+        if (config_.fan_in_mode == FanInMode::RELAY) {
+            // The consumer reads every cell; keep the buffer on its node
+            int consumer_core = i < config_.dispatcher_cores.size() ? static_cast<int>(config_.dispatcher_cores[i]) : -1;
+            shard->buffer = std::make_unique<MPSCRingBuffer>(config_.global_buffer_capacity,
+                                                             local_to(config_.memory, consumer_core));
+            shard->buffer->set_consumer_signal(&shard->consumer_signal);
+        }
+        shards_.push_back(std::move(shard));
+    }
+    
+    // Each unit goes to the shard with the fewest feeds so far
+    shard_by_worker_.resize(workers_.size());
+    for (const auto& unit : units) {
+        auto target = std::min_element(shards_.begin(), shards_.end(), [](const auto& a, const auto& b) {
+            return a->workers.size() < b->workers.size();
+        });
+        auto& shard = **target;
+        for (auto i : unit) {
+            const auto& feed = config_.feeds[i];
+            shard.workers.push_back(workers_[i].get());
+            if (!feed.arbitration_group.empty()) {
+                shard.arbiter.add_line(feed.origin_id, feed.arbitration_group);
+            }
+            shard_by_worker_[i] = static_cast<std::size_t>(target - shards_.begin());
+        }
+    }
 }
 
 FanInDispatcher::~FanInDispatcher() {
     stop();
 }
 
-void FanInDispatcher::start() {
+void FanInDispatcher::start(PerformanceTracker* counters) {
     should_stop_.store(false);
     
     // Start all feed workers
-    for (auto& worker : workers_) {
-        worker->start(*global_buffer_);
+    for (std::size_t i = 0; i < workers_.size(); ++i) {
+        auto& shard = *shards_[shard_by_worker_[i]];
+        if (shard.buffer) {
+            workers_[i]->start(*shard.buffer, counters);
+        } else {
+            workers_[i]->start_direct(shard.consumer_signal, counters);
+        }
     }
     
     // Start health monitoring thread
@@ -398,7 +855,8 @@ void FanInDispatcher::start() {
         health_monitor_loop();
     });
     
-    std::cout << "Started " << workers_.size() << " feed workers" << std::endl;
+    std::cout << "Started " << workers_.size() << " feed workers (" << config_.fan_in_mode << " fan-in, "
+              << shards_.size() << " consumer shard" << (shards_.size() == 1 ? "" : "s") << ")" << std::endl;
 }
 
 void FanInDispatcher::stop() {
@@ -415,8 +873,63 @@ void FanInDispatcher::stop() {
     }
 }
 
-bool FanInDispatcher::try_consume_message(MultiFeedSlot& slot) {
-    return global_buffer_->try_pop(slot);
+bool FanInDispatcher::try_consume_message(MultiFeedSlot& slot, std::size_t shard) {
+    return try_consume_messages(&slot, 1, shard) == 1;
+}
+
+std::uint64_t FanInDispatcher::try_consume_messages(MultiFeedSlot* slots, std::uint64_t max_count, std::size_t shard_index) {
+    auto& shard = *shards_[shard_index];
+    if (shard.arbiter.empty()) {
+        return drain(shard, slots, max_count);
+    }
+    
+    // Keep draining while whole batches turn out to be duplicates, so an
+    // empty result still means there is nothing left to consume
+    std::uint64_t count;
+    while ((count = drain(shard, slots, max_count)) > 0) {
+        std::uint64_t kept = 0;
+        for (std::uint64_t i = 0; i < count; ++i) {
+            if (shard.arbiter.accept(slots[i].origin_id, slots[i].raw.seq)) {
+                slots[kept++] = slots[i];
+            }
+        }
+        if (kept > 0) {
+            return kept;
+        }
+    }
+    return 0;
+}
+
+std::uint64_t FanInDispatcher::drain(Shard& shard, MultiFeedSlot* slots, std::uint64_t max_count) {
+    if (!shard.buffer) {
+        return drain_lanes(shard, slots, max_count);
+    }
+    return shard.buffer->try_pop_n(slots, max_count);
+}
+
+std::uint64_t FanInDispatcher::drain_lanes(Shard& shard, MultiFeedSlot* slots, std::uint64_t max_count) {
+    const std::size_t lanes = shard.workers.size();
+    if (lanes == 0 || max_count == 0) {
+        return 0;
+    }
+    
+    const std::uint64_t share = std::max<std::uint64_t>(1, max_count / lanes);
+    const std::size_t first = shard.next_lane;
+    shard.next_lane = (shard.next_lane + 1) % lanes;
+    
+    // Keep passing over the lanes while any of them still yields messages
+    std::uint64_t total = 0;
+    bool progress = true;
+    while (progress && total < max_count) {
+        progress = false;
+        for (std::size_t i = 0; i < lanes && total < max_count; ++i) {
+            auto& worker = *shard.workers[(first + i) % lanes];
+            auto n = worker.drain_lane(slots + total, std::min(share, max_count - total));
+            total += n;
+            progress |= n > 0;
+        }
+    }
+    return total;
 }
 
 void FanInDispatcher::print_health_summary() const {
@@ -424,7 +937,69 @@ void FanInDispatcher::print_health_summary() const {
     for (const auto& worker : workers_) {
         worker->monitor().print_stats();
     }
-    std::cout << "Global buffer size: " << global_buffer_->size() << "/" << global_buffer_->capacity() << std::endl;
+    for (const auto& worker : workers_) {
+        const auto& feed = worker->monitor().config();
+        if (feed.arbitration_group.empty()) {
+            continue;
+        }
+        auto line = line_stats(feed.origin_id);
+        std::cout << "Line " << feed.name << " [" << feed.arbitration_group << "] "
+                  << "Wins: " << line.wins << " | "
+                  << "Duplicates: " << line.duplicates << " | "
+                  << "Gaps filled: " << line.gaps_filled << std::endl;
+    }
+    for (std::size_t i = 0; i < shards_.size(); ++i) {
+        const auto& buffer = shards_[i]->buffer;
+        if (buffer) {
+            std::cout << "Shard " << i << " buffer size: " << buffer->size() << "/" << buffer->capacity() << std::endl;
+        }
+    }
+}
+
+void FanInDispatcher::register_metrics(MetricsRegistry& registry) const {
+    for (const auto& worker : workers_) {
+        const auto& monitor = worker->monitor();
+        const auto& feed = monitor.config();
+        MetricsRegistry::Labels labels = {{"feed", feed.name}};
+        registry.counter_fn("mdfh_feed_messages_received_total", "Messages relayed from the feed", labels,
+                            [&monitor]() { return static_cast<double>(monitor.snapshot().messages_received); });
+        registry.counter_fn("mdfh_feed_bytes_received_total", "Message bytes relayed from the feed", labels,
+                            [&monitor]() { return static_cast<double>(monitor.snapshot().bytes_received); });
+        registry.counter_fn("mdfh_feed_sequence_gaps_total", "Sequence gaps on the feed", labels,
+                            [&monitor]() { return static_cast<double>(monitor.snapshot().sequence_gaps); });
+        registry.counter_fn("mdfh_feed_messages_dropped_total", "Feed messages lost to a full shard buffer", labels,
+                            [&monitor]() { return static_cast<double>(monitor.snapshot().messages_dropped); });
+        registry.gauge_fn("mdfh_feed_status", "Feed status (0 connecting, 1 healthy, 2 degraded, 3 dead, 4 failed)",
+                          labels, [&monitor]() { return static_cast<double>(monitor.status()); });
+        registry.histogram("mdfh_feed_relay_latency_ns", "Receive-to-relay latency in nanoseconds", labels,
+                           monitor.latency());
+        
+        if (!feed.arbitration_group.empty()) {
+            MetricsRegistry::Labels line = {{"feed", feed.name}, {"group", feed.arbitration_group}};
+            auto origin = feed.origin_id;
+            registry.counter_fn("mdfh_line_wins_total", "Messages this line delivered first", line,
+                                [this, origin]() { return static_cast<double>(line_stats(origin).wins); });
+            registry.counter_fn("mdfh_line_duplicates_total", "Messages dropped as another line's duplicate", line,
+                                [this, origin]() { return static_cast<double>(line_stats(origin).duplicates); });
+        }
+    }
+    for (std::size_t i = 0; i < shards_.size(); ++i) {
+        const auto* buffer = shards_[i]->buffer.get();
+        if (buffer) {
+            registry.gauge_fn("mdfh_shard_buffer_depth", "Messages waiting in the shard's MPSC buffer",
+                              {{"shard", std::to_string(i)}},
+                              [buffer]() { return static_cast<double>(buffer->size()); });
+        }
+    }
+}
+
+LineStats FanInDispatcher::line_stats(std::uint32_t origin_id) const {
+    for (std::size_t i = 0; i < workers_.size(); ++i) {
+        if (config_.feeds[i].origin_id == origin_id) {
+            return shards_[shard_by_worker_[i]]->arbiter.line_stats(origin_id);
+        }
+    }
+    return {};
 }
 
 std::uint64_t FanInDispatcher::total_messages_received() const {
@@ -436,6 +1011,7 @@ std::uint64_t FanInDispatcher::total_messages_received() const {
 }
 
 void FanInDispatcher::health_monitor_loop() {
+    pin_current_thread(config_.health_core, "health monitor");
     while (!should_stop_.load()) {
         // Check health of all feeds
         for (auto& worker : workers_) {
@@ -473,8 +1049,84 @@ void FanInDispatcher::promote_backup_feeds() {
 
 // MultiFeedIngestionBenchmark implementation
 MultiFeedIngestionBenchmark::MultiFeedIngestionBenchmark(MultiFeedConfig config) 
-    : config_(std::move(config)) {
+    : config_(std::move(config))
+    , exporter_(metrics_, config_.metrics) {
     dispatcher_ = std::make_unique<FanInDispatcher>(config_);
+    
+    // Each shard journals what it consumes; shards get their own directory
+    // so every journal keeps a single appender
+    if (config_.journal.enabled()) {
+        auto shards = dispatcher_->shard_count();
+        for (std::size_t shard = 0; shard < shards; ++shard) {
+            JournalConfig journal = config_.journal;
+            if (shards > 1) {
+                journal.directory = (std::filesystem::path(journal.directory) / ("shard" + std::to_string(shard))).string();
+            }
+            journals_.push_back(std::make_unique<JournalWriter>(std::move(journal)));
+        }
+    }
+    
+    // One ring per shard keeps a single producer per ring; shards append .shardN
+    if (config_.shm_ring.enabled()) {
+        auto shards = dispatcher_->shard_count();
+        for (std::size_t shard = 0; shard < shards; ++shard) {
+            ShmRingConfig shm_ring = config_.shm_ring;
+            if (shards > 1) {
+                shm_ring.path += ".shard" + std::to_string(shard);
+            }
+            shm_rings_.push_back(std::make_unique<ShmRingWriter>(std::move(shm_ring)));
+        }
+    }
+    
+    for (std::size_t shard = 0; shard < dispatcher_->shard_count(); ++shard) {
+        shard_latency_.push_back(std::make_unique<LatencyHistogram>());
+        if (config_.conflation.enabled()) {
+            conflation_.push_back(std::make_unique<LastValueCache>(config_.conflation));
+        }
+    }
+    
+    // Counter registry only: no latency tracing on this path
+    if (config_.thread_counters) {
+        PerformanceConfig perf_config;
+        perf_config.enable_detailed_latency = false;
+        perf_config.max_samples = 0;
+        thread_counters_ = std::make_unique<PerformanceTracker>(perf_config);
+    }
+    
+    dispatcher_->register_metrics(metrics_);
+    for (std::size_t shard = 0; shard < shard_latency_.size(); ++shard) {
+        metrics_.histogram("mdfh_receive_to_consume_latency_ns", "Receive-to-consume latency in nanoseconds",
+                           {{"shard", std::to_string(shard)}}, *shard_latency_[shard]);
+    }
+    metrics_.counter_fn("mdfh_messages_processed_total", "Messages consumed across all shards", {},
+                        [this]() { return static_cast<double>(messages_processed()); });
+    for (std::size_t shard = 0; shard < conflation_.size(); ++shard) {
+        const auto& cache = *conflation_[shard];
+        MetricsRegistry::Labels labels{{"shard", std::to_string(shard)}};
+        metrics_.counter_fn("mdfh_conflation_updates_total", "Messages stored in the last-value cache", labels,
+                            [&cache]() { return static_cast<double>(cache.updates()); });
+        metrics_.counter_fn("mdfh_conflation_delivered_total", "Conflated values read by the slow consumer", labels,
+                            [&cache]() { return static_cast<double>(cache.delivered()); });
+        metrics_.counter_fn("mdfh_conflation_overflows_total", "Messages for new keys after max_keys was reached", labels,
+                            [&cache]() { return static_cast<double>(cache.overflows()); });
+        metrics_.gauge_fn("mdfh_conflation_keys", "Keys in the last-value cache", labels,
+                          [&cache]() { return static_cast<double>(cache.keys()); });
+    }
+    for (std::size_t shard = 0; shard < shm_rings_.size(); ++shard) {
+        const auto& ring = *shm_rings_[shard];
+        MetricsRegistry::Labels labels{{"shard", std::to_string(shard)}};
+        metrics_.counter_fn("mdfh_shm_ring_published_total", "Records published to the shared-memory ring", labels,
+                            [&ring]() { return static_cast<double>(ring.records_published()); });
+        metrics_.gauge_fn("mdfh_shm_ring_readers", "Readers attached to the shared-memory ring", labels,
+                          [&ring]() { return static_cast<double>(ring.readers()); });
+        metrics_.gauge_fn("mdfh_shm_ring_max_reader_lag", "Records the slowest shared-memory ring reader is behind",
+                          labels, [&ring]() { return static_cast<double>(ring.max_reader_lag()); });
+    }
+    if (!conflation_.empty()) {
+        metrics_.histogram("mdfh_conflated_staleness_ns", "Receive-to-read age of conflated values in nanoseconds",
+                           {}, conflated_staleness_);
+    }
+    exporter_.add_reporter(std::chrono::seconds(5), [this]() { dispatcher_->print_health_summary(); });
 }
 
 MultiFeedIngestionBenchmark::~MultiFeedIngestionBenchmark() = default;
@@ -483,32 +1135,107 @@ void MultiFeedIngestionBenchmark::run() {
     std::cout << "Starting multi-feed ingestion benchmark with " << config_.feeds.size() << " feeds" << std::endl;
     
     // Start dispatcher
-    dispatcher_->start();
+    exporter_.start();
+    dispatcher_->start(thread_counters_.get());
     
-    // Run consumer loop
-    consumer_loop();
+    if (!conflation_.empty()) {
+        conflated_reader_ = std::thread([this]() { conflated_reader_loop(); });
+    }
+    
+    // One consumer per shard; shard 0 runs here
+    std::vector<std::thread> consumers;
+    for (std::size_t shard = 1; shard < dispatcher_->shard_count(); ++shard) {
+        consumers.emplace_back([this, shard]() {
+            consumer_loop(shard);
+        });
+    }
+    consumer_loop(0);
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+    should_stop_.store(true, std::memory_order_release);
+    if (conflated_reader_.joinable()) {
+        conflated_reader_.join();
+    }
     
     // Stop dispatcher
+    exporter_.stop();
     dispatcher_->stop();
     
     // Print final statistics
     print_final_stats();
 }
 
-void MultiFeedIngestionBenchmark::consumer_loop() {
-    MultiFeedSlot slot;
-    auto last_health_print = std::chrono::steady_clock::now();
+void MultiFeedIngestionBenchmark::consumer_loop(std::size_t shard) {
+    if (shard < config_.dispatcher_cores.size()) {
+        pin_current_thread(static_cast<int>(config_.dispatcher_cores[shard]), "consumer shard " + std::to_string(shard));
+    }
+    
+    std::array<MultiFeedSlot, 256> slots;
+    WaitStrategy waiter(config_.consumer_wait, &dispatcher_->consumer_signal(shard));
+    JournalWriter* journal = shard < journals_.size() ? journals_[shard].get() : nullptr;
+    LatencyHistogram& latency = *shard_latency_[shard];
+    LastValueCache* cache = shard < conflation_.size() ? conflation_[shard].get() : nullptr;
+    ShmRingWriter* shm_ring = shard < shm_rings_.size() ? shm_rings_[shard].get() : nullptr;
+    auto* counters = thread_counters_ ? thread_counters_->attach_thread("consumer " + std::to_string(shard)) : nullptr;
+    std::uint64_t consumed = 0;
     
     while (should_continue()) {
-        if (dispatcher_->try_consume_message(slot)) {
-            messages_processed_.fetch_add(1, std::memory_order_relaxed);
+        auto count = dispatcher_->try_consume_messages(slots.data(), slots.size(), shard);
+        if (count > 0) {
+            auto now = get_timestamp_ns();
+            for (std::size_t i = 0; i < count; ++i) {
+                latency.record(now > slots[i].rx_ts ? now - slots[i].rx_ts : 0);
+            }
+            if (journal) {
+                journal->append(slots.data(), count);
+            }
+            if (shm_ring) {
+                shm_ring->publish(slots.data(), count);
+            }
+            if (cache) {
+                cache->update(slots.data(), count);
+            }
+            messages_processed_.fetch_add(count, std::memory_order_relaxed);
+            consumed += count;
+            if (counters) {
+                counters->maybe_sample(consumed);
+            }
+            waiter.reset();
+        } else {
+            waiter.idle();
         }
+    }
+    
+    if (counters) {
+        counters->sample(consumed);
+    }
+}
+
+void MultiFeedIngestionBenchmark::conflated_reader_loop() {
+    std::array<MultiFeedSlot, 256> slots;
+    auto interval = std::chrono::milliseconds(config_.conflation.poll_interval_ms);
+    
+    while (!should_stop_.load(std::memory_order_acquire)) {
+        std::this_thread::sleep_for(interval);
         
-        // Print health summary periodically
-        auto now = std::chrono::steady_clock::now();
-        if (std::chrono::duration_cast<std::chrono::seconds>(now - last_health_print).count() >= 5) {
-            dispatcher_->print_health_summary();
-            last_health_print = now;
+        // What changed since the last poll, at most as many values as there
+        // are keys. Under steady traffic the writer re-dirties keys behind
+        // the scan, so draining until collect() returns 0 would never end;
+        // whatever is left dirty is picked up next poll.
+        for (auto& cache : conflation_) {
+            auto budget = cache->keys();
+            while (budget > 0) {
+                auto count = cache->collect(slots.data(), std::min<std::uint64_t>(slots.size(), budget));
+                if (count == 0) {
+                    break;
+                }
+                budget -= count;
+                auto now = get_timestamp_ns();
+                for (std::size_t i = 0; i < count; ++i) {
+                    conflated_staleness_.record(now > slots[i].rx_ts ? now - slots[i].rx_ts : 0);
+                }
+            }
         }
     }
 }
@@ -535,7 +1262,50 @@ void MultiFeedIngestionBenchmark::print_final_stats() {
     std::cout << "Average processing rate: " << (total_processed / elapsed) << " msg/s" << std::endl;
     std::cout << "Average ingestion rate: " << (total_received / elapsed) << " msg/s" << std::endl;
     
+    // Each shard recorded into its own histogram; combine them for the report
+    LatencyHistogram latency;
+    for (const auto& shard : shard_latency_) {
+        latency.merge(*shard);
+    }
+    if (latency.count() > 0) {
+        std::cout << "Receive-to-consume latency (ns): p50 " << latency.value_at_percentile(0.50)
+                  << " | p99 " << latency.value_at_percentile(0.99)
+                  << " | p99.9 " << latency.value_at_percentile(0.999)
+                  << " | p99.99 " << latency.value_at_percentile(0.9999)
+                  << " | max " << latency.max() << std::endl;
+    }
+    
+    for (const auto& ring : shm_rings_) {
+        std::cout << "Shared-memory ring " << ring->config().path << ": " << ring->records_published()
+                  << " records, " << ring->readers() << " readers attached, max lag "
+                  << ring->max_reader_lag() << std::endl;
+    }
+    
+    for (std::size_t shard = 0; shard < conflation_.size(); ++shard) {
+        const auto& cache = *conflation_[shard];
+        std::cout << "Conflation shard " << shard << " (" << config_.conflation.key << "): "
+                  << cache.keys() << " keys, " << cache.updates() << " updates, "
+                  << cache.delivered() << " delivered, " << cache.overflows() << " overflows" << std::endl;
+    }
+    if (conflated_staleness_.count() > 0) {
+        std::cout << "Conflated value age at read (ns): p50 " << conflated_staleness_.value_at_percentile(0.50)
+                  << " | p99 " << conflated_staleness_.value_at_percentile(0.99)
+                  << " | max " << conflated_staleness_.max() << std::endl;
+    }
+    
+    for (std::size_t shard = 0; shard < journals_.size(); ++shard) {
+        auto& journal = *journals_[shard];
+        journal.close();
+        std::cout << "Journal " << journal.config().directory << ": " << journal.records_written()
+                  << " records, " << journal.segments_rolled() << " rolls, "
+                  << journal.roll_stalls() << " roll stalls, " << journal.syncs() << " syncs" << std::endl;
+    }
+    
     dispatcher_->print_health_summary();
+    
+    if (thread_counters_) {
+        thread_counters_->print_performance_report();
+    }
 }
 
 } // namespace mdfh 
\ No newline at end of file
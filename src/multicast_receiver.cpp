@@ -0,0 +1,282 @@
+#include "mdfh/multicast_receiver.hpp"
+#include "mdfh/performance_tracker.hpp"
+#include "mdfh/timing.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <thread>
+#include <ctime>
+
+#if defined(__linux__)
+#include <linux/net_tstamp.h>
+#include <poll.h>
+#include <cerrno>
+#define MDFH_HAVE_RECVMMSG 1
+#endif
+
+using namespace boost::asio;
+using udp = ip::udp;
+
+namespace mdfh {
+
+namespace {
+
+#ifdef MDFH_HAVE_RECVMMSG
+// Room for one SCM_TIMESTAMPNS or SCM_TIMESTAMPING record per datagram
+constexpr std::size_t CONTROL_SIZE = CMSG_SPACE(sizeof(timespec) * 3);
+
+std::uint64_t to_ns(const timespec& ts) {
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1'000'000'000ULL + static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+// Offset from CLOCK_REALTIME (kernel stamps) to the get_timestamp_ns() clock.
+// Sampled once per batch so slewing of either clock never accumulates.
+std::int64_t realtime_to_local_offset() {
+    timespec rt;
+    clock_gettime(CLOCK_REALTIME, &rt);
+    return static_cast<std::int64_t>(get_timestamp_ns()) - static_cast<std::int64_t>(to_ns(rt));
+}
+
+// Extracts the receive stamp from one datagram's control data (0 if absent)
+std::uint64_t read_rx_timestamp(msghdr& hdr) {
+    for (cmsghdr* cm = CMSG_FIRSTHDR(&hdr); cm != nullptr; cm = CMSG_NXTHDR(&hdr, cm)) {
+        if (cm->cmsg_level != SOL_SOCKET) {
+            continue;
+        }
+        if (cm->cmsg_type == SCM_TIMESTAMPNS) {
+            timespec ts;
+            std::memcpy(&ts, CMSG_DATA(cm), sizeof(ts));
+            return to_ns(ts);
+        }
+        if (cm->cmsg_type == SCM_TIMESTAMPING) {
+            // ts[0] software, ts[2] raw hardware
+            timespec ts[3];
+            std::memcpy(ts, CMSG_DATA(cm), sizeof(ts));
+            std::uint64_t hw = to_ns(ts[2]);
+            return hw != 0 ? hw : to_ns(ts[0]);
+        }
+    }
+    return 0;
+}
+#endif
+
+} // namespace
+
+// MulticastConfig implementation
+bool MulticastConfig::is_valid() const {
+    if (groups.empty() || !is_valid_port(port)) {
+        return false;
+    }
+    for (const auto& group : groups) {
+        boost::system::error_code ec;
+        auto addr = ip::make_address(group, ec);
+        if (ec || !addr.is_multicast()) {
+            return false;
+        }
+    }
+    return batch_size > 0 && max_datagram_size >= sizeof(Msg) && max_datagram_size <= 65536 && wait.is_valid();
+}
+
+RxTimestampSource parse_rx_timestamp_source(const std::string& name) {
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (lower == "userspace") return RxTimestampSource::USERSPACE;
+    if (lower == "kernel") return RxTimestampSource::KERNEL;
+    if (lower == "hardware") return RxTimestampSource::HARDWARE;
+    throw std::invalid_argument("Unknown timestamp source: " + name);
+}
+
+// MulticastReceiver implementation
+MulticastReceiver::MulticastReceiver(MulticastConfig config)
+    : config_(std::move(config)), socket_(ctx_) {
+
+    if (!config_.is_valid()) {
+        throw std::invalid_argument("Invalid multicast configuration");
+    }
+
+    // Every receive buffer is allocated up front (ZERO ALLOCATION IN HOT PATH)
+    buffers_.resize(static_cast<std::size_t>(config_.batch_size) * config_.max_datagram_size);
+    packets_.resize(config_.batch_size);
+#ifdef MDFH_HAVE_RECVMMSG
+    msgs_.resize(config_.batch_size);
+    iovecs_.resize(config_.batch_size);
+    control_.resize(config_.batch_size * CONTROL_SIZE);
+    for (std::size_t i = 0; i < msgs_.size(); ++i) {
+        iovecs_[i] = {buffers_.data() + i * config_.max_datagram_size, config_.max_datagram_size};
+        msgs_[i] = mmsghdr{};
+        msgs_[i].msg_hdr.msg_iov = &iovecs_[i];
+        msgs_[i].msg_hdr.msg_iovlen = 1;
+        msgs_[i].msg_hdr.msg_control = control_.data() + i * CONTROL_SIZE;
+    }
+#endif
+}
+
+MulticastReceiver::~MulticastReceiver() {
+    close();
+}
+
+void MulticastReceiver::open() {
+    socket_.open(udp::v4());
+    socket_.set_option(socket_base::reuse_address(true));
+    if (config_.socket_buffer_size > 0) {
+        socket_.set_option(socket_base::receive_buffer_size(static_cast<int>(config_.socket_buffer_size)));
+    }
+    socket_.bind(udp::endpoint(ip::address_v4::any(), config_.port));
+
+    auto interface_addr = ip::make_address_v4(config_.interface);
+    for (const auto& group : config_.groups) {
+        socket_.set_option(ip::multicast::join_group(ip::make_address_v4(group), interface_addr));
+    }
+
+    socket_.non_blocking(true);
+    enable_timestamps();
+    should_stop_ = false;
+
+    std::cout << "Joined " << config_.groups.size() << " multicast group(s) on port " << config_.port
+              << " (timestamps: " << active_timestamps_ << ")" << std::endl;
+}
+
+void MulticastReceiver::close() {
+    boost::system::error_code ec;
+    socket_.close(ec);
+}
+
+void MulticastReceiver::enable_timestamps() {
+    active_timestamps_ = RxTimestampSource::USERSPACE;
+#ifdef MDFH_HAVE_RECVMMSG
+    int fd = socket_.native_handle();
+
+    if (config_.timestamps == RxTimestampSource::HARDWARE) {
+        // Hardware stamps also need the NIC configured (SIOCSHWTSTAMP, e.g. hwstamp_ctl)
+        int flags = SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE
+                  | SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+        if (::setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == 0) {
+            active_timestamps_ = RxTimestampSource::HARDWARE;
+            return;
+        }
+        MDFH_LOG_WARN("Multicast", "SO_TIMESTAMPING unavailable, using kernel timestamps: ", std::strerror(errno));
+    }
+
+    if (config_.timestamps != RxTimestampSource::USERSPACE) {
+        int one = 1;
+        if (::setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &one, sizeof(one)) == 0) {
+            active_timestamps_ = RxTimestampSource::KERNEL;
+        } else {
+            MDFH_LOG_WARN("Multicast", "SO_TIMESTAMPNS unavailable, using userspace timestamps: ", std::strerror(errno));
+        }
+    }
+#else
+    if (config_.timestamps != RxTimestampSource::USERSPACE) {
+        MDFH_LOG_WARN("Multicast", "Kernel receive timestamps are only supported on Linux");
+    }
+#endif
+}
+
+std::span<const PacketDesc> MulticastReceiver::receive_batch() {
+    std::size_t count = 0;
+    std::uint64_t truncated = 0;
+
+#ifdef MDFH_HAVE_RECVMMSG
+    const std::size_t slot_size = config_.max_datagram_size;
+    for (auto& msg : msgs_) {
+        // recvmmsg shrinks msg_controllen to what it wrote
+        msg.msg_hdr.msg_controllen = CONTROL_SIZE;
+    }
+
+    int received = ::recvmmsg(socket_.native_handle(), msgs_.data(), static_cast<unsigned>(msgs_.size()),
+                              MSG_DONTWAIT, nullptr);
+    if (received < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+            return {};
+        }
+        throw boost::system::system_error(errno, boost::system::system_category(), "recvmmsg");
+    }
+
+    // One clock read per batch; stamps are converted with a per-batch offset
+    const std::uint64_t now = get_timestamp_ns();
+    const std::int64_t offset = active_timestamps_ == RxTimestampSource::USERSPACE ? 0 : realtime_to_local_offset();
+
+    for (int i = 0; i < received; ++i) {
+        auto& hdr = msgs_[i].msg_hdr;
+        if (hdr.msg_flags & MSG_TRUNC) {
+            ++truncated;
+            continue;
+        }
+        std::uint64_t kernel_ts = read_rx_timestamp(hdr);
+        std::uint64_t rx_ts = kernel_ts != 0 ? static_cast<std::uint64_t>(static_cast<std::int64_t>(kernel_ts) + offset) : now;
+        packets_[count++] = PacketDesc(buffers_.data() + i * slot_size, msgs_[i].msg_len, rx_ts);
+    }
+    datagrams_received_.fetch_add(static_cast<std::uint64_t>(received), std::memory_order_relaxed);
+#else
+    // Portable fallback: one non-blocking receive per datagram, userspace stamps
+    for (std::size_t i = 0; i < packets_.size(); ++i) {
+        boost::system::error_code ec;
+        std::uint8_t* slot = buffers_.data() + i * config_.max_datagram_size;
+        std::size_t n = socket_.receive(buffer(slot, config_.max_datagram_size), 0, ec);
+        if (ec == error::would_block || ec == error::try_again) {
+            break;
+        }
+        if (ec) {
+            if (ec == error::message_size) {
+                ++truncated;
+                continue;
+            }
+            throw boost::system::system_error(ec, "receive");
+        }
+        packets_[count++] = PacketDesc(slot, n, get_timestamp_ns());
+    }
+    datagrams_received_.fetch_add(count + truncated, std::memory_order_relaxed);
+#endif
+
+    if (truncated > 0) {
+        datagrams_truncated_.fetch_add(truncated, std::memory_order_relaxed);
+    }
+    return {packets_.data(), count};
+}
+
+bool MulticastReceiver::wait_readable(std::chrono::microseconds timeout) {
+#ifdef MDFH_HAVE_RECVMMSG
+    pollfd pfd{socket_.native_handle(), POLLIN, 0};
+    timespec ts{static_cast<time_t>(timeout.count() / 1'000'000), static_cast<long>(timeout.count() % 1'000'000) * 1000};
+    return ::ppoll(&pfd, 1, &ts, nullptr) > 0;
+#else
+    std::this_thread::sleep_for(timeout);
+    return true;
+#endif
+}
+
+void MulticastReceiver::run_io_loop(RingBuffer& ring, IngestionStats& stats, MessageParser& parser,
+                                    ThreadCounters* counters) {
+    // The kernel is the producer here, so parking means ppoll on the socket
+    WaitStrategy waiter(config_.wait);
+    auto park = [this](std::chrono::microseconds timeout) { wait_readable(timeout); };
+
+    while (!should_stop_.load(std::memory_order_acquire) && socket_.is_open()) {
+        try {
+            auto packets = receive_batch();
+            if (packets.empty()) {
+                waiter.idle(park);
+                continue;
+            }
+            waiter.reset();
+
+            for (const auto& packet : packets) {
+                // Datagrams carry whole messages; each is stamped with its own arrival time
+                stats.record_bytes_received(packet.length);
+                parser.parse_bytes(packet.data, packet.length, packet.timestamp_ns, ring, stats);
+            }
+            
+            if (counters) {
+                counters->maybe_sample(stats.messages_received());
+            }
+        }
+        catch (std::exception& e) {
+            std::cerr << "I/O error: " << e.what() << std::endl;
+            break;
+        }
+    }
+}
+
+} // namespace mdfh
@@ -2,20 +2,41 @@
 #include <algorithm>
 #include <iostream>
 #include <iomanip>
-#include <numeric>
 #include <stdexcept>
 
 #if defined(MDFH_HAVE_PERF_EVENT_H)
 #include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <sys/syscall.h>
 #include <unistd.h>
 #endif
 
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
 namespace mdfh {
 
+const char* latency_stage_name(LatencyStage stage) {
+    switch (stage) {
+        case LatencyStage::RX_TO_PARSE: return "rx->parse";
+        case LatencyStage::PARSE: return "parse";
+        case LatencyStage::RING_PUBLISH: return "ring publish";
+        case LatencyStage::RING_QUEUE: return "ring queue";
+        case LatencyStage::PROCESS: return "process";
+        case LatencyStage::COUNT: break;
+    }
+    return "unknown";
+}
+
 PerformanceTracker::PerformanceTracker(const PerformanceConfig& config)
     : config_(config) {
     
+    if (config_.sampling_rate == 0) {
+        config_.sampling_rate = 1;
+    }
+    
     // Pre-allocate circular buffer for timestamp samples (ZERO ALLOCATION IN HOT PATH)
     if (config_.enable_detailed_latency && config_.max_samples > 0) {
         // Ensure max_samples is power of 2 for efficient masking
@@ -28,50 +49,93 @@ PerformanceTracker::PerformanceTracker(const PerformanceConfig& config)
             }
         }
         
-        timestamp_samples_.resize(capacity);
+        timestamp_samples_ = PlacedArray<StageTimestamps>(capacity, config_.sample_memory);
         sample_mask_ = capacity - 1;
         
-        MDFH_LOG_DEBUG("PerformanceTracker", 
-                      "Pre-allocated " + std::to_string(capacity) + " timestamp samples");
+        MDFH_LOG_DEBUG("PerformanceTracker", "Pre-allocated ", capacity, " timestamp samples");
     }
     
-    if (config_.enable_cache_analysis) {
-        initialize();
+}
+
+PerformanceTracker::~PerformanceTracker() = default;
+
+ThreadCounters* PerformanceTracker::attach_thread(const std::string& name) {
+    if (!config_.enable_cache_analysis) {
+        return nullptr;
     }
+    
+    auto counters = std::make_unique<ThreadCounters>(name);
+    if (!counters->open()) {
+        std::cerr << "Warning: hardware counters unavailable for " << name
+                  << " (perf_event_open refused; check perf_event_paranoid)" << std::endl;
+        return nullptr;
+    }
+    
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    threads_.push_back(std::move(counters));
+    return threads_.back().get();
 }
 
-PerformanceTracker::~PerformanceTracker() {
-    if (perf_fd_) {
-        close_perf_counters();
+void PerformanceTracker::begin_trace(const StageTimestamps& timestamps) {
+    auto tail = trace_tail_.load(std::memory_order_relaxed);
+    if (tail - trace_head_.load(std::memory_order_acquire) >= MAX_PENDING_TRACES) {
+        // Consumer is not finishing traces; keep the stages we have
+        record_timestamp(timestamps);
+        return;
     }
+    pending_traces_[tail % MAX_PENDING_TRACES] = timestamps;
+    trace_tail_.store(tail + 1, std::memory_order_release);
 }
 
-bool PerformanceTracker::initialize() {
-#if defined(MDFH_HAVE_PERF_EVENT_H)
-    return setup_perf_counters();
-#else
-    if (config_.enable_cache_analysis) {
-        std::cerr << "Warning: Hardware performance counters not supported on this platform" << std::endl;
-        config_.enable_cache_analysis = false;
+void PerformanceTracker::complete_traces(std::uint64_t first_pos, std::uint64_t count,
+                                         std::uint64_t ring_pop, std::uint64_t process_end) {
+    auto head = trace_head_.load(std::memory_order_relaxed);
+    auto tail = trace_tail_.load(std::memory_order_acquire);
+    
+    for (; head != tail; ++head) {
+        auto trace = pending_traces_[head % MAX_PENDING_TRACES];
+        if (trace.ring_pos >= first_pos + count) {
+            break;
+        }
+        // Traces of messages consumed without tracing keep only the producer stages
+        if (trace.ring_pos >= first_pos) {
+            trace.ring_pop = ring_pop;
+            trace.process_end = process_end;
+        }
+        record_timestamp(trace);
     }
-    return false;
-#endif
+    trace_head_.store(head, std::memory_order_release);
 }
 
 void PerformanceTracker::record_timestamp(const StageTimestamps& timestamps) {
-    if (!config_.enable_detailed_latency || timestamp_samples_.empty()) {
+    if (!config_.enable_detailed_latency) {
         return;
     }
     
-    // Only sample based on sampling rate (ZERO ALLOCATION)
-    auto count = sample_count_.fetch_add(1, std::memory_order_relaxed);
-    if (count % config_.sampling_rate != 0) {
-        return;
+    // Write to pre-allocated circular buffer (ZERO ALLOCATION)
+    if (!timestamp_samples_.empty()) {
+        auto write_pos = sample_write_pos_.fetch_add(1, std::memory_order_relaxed);
+        timestamp_samples_[write_pos & sample_mask_] = timestamps;
     }
     
-    // Write to pre-allocated circular buffer (ZERO ALLOCATION)
-    auto write_pos = sample_write_pos_.fetch_add(1, std::memory_order_relaxed);
-    timestamp_samples_[write_pos & sample_mask_] = timestamps;
+    // Each stage spans two consecutive stamps
+    const std::array<std::uint64_t, LATENCY_STAGE_COUNT + 1> stamps = {
+        timestamps.packet_rx, timestamps.parse_start, timestamps.parse_end,
+        timestamps.ring_push, timestamps.ring_pop, timestamps.process_end
+    };
+    for (std::size_t stage = 0; stage < LATENCY_STAGE_COUNT; ++stage) {
+        if (stamps[stage] != 0 && stamps[stage + 1] != 0) {
+            auto begin = stamps[stage];
+            auto end = stamps[stage + 1];
+            stage_latency_[stage].record_shared(end > begin ? end - begin : 0);
+        }
+    }
+    
+    // Total latency from packet reception to processing end
+    if (timestamps.packet_rx != 0 && timestamps.process_end != 0) {
+        auto latency = timestamps.process_end > timestamps.packet_rx ? timestamps.process_end - timestamps.packet_rx : 0;
+        latency_.record_shared(latency);
+    }
 }
 
 std::vector<StageTimestamps> PerformanceTracker::get_current_samples() const {
@@ -94,73 +158,75 @@ std::vector<StageTimestamps> PerformanceTracker::get_current_samples() const {
     return result;
 }
 
-void PerformanceTracker::update_cache_stats() {
-    if (!config_.enable_cache_analysis || !perf_fd_) {
-        return;
-    }
-    
-#if defined(MDFH_HAVE_PERF_EVENT_H)
-    read_perf_counters();
-#endif
+PerformanceTracker::LatencyStats PerformanceTracker::get_latency_stats() const {
+    return latency_stats_from(latency_);
 }
 
-PerformanceTracker::LatencyStats PerformanceTracker::get_latency_stats() const {
+PerformanceTracker::LatencyStats PerformanceTracker::get_stage_latency_stats(LatencyStage stage) const {
+    return latency_stats_from(stage_histogram(stage));
+}
+
+PerformanceTracker::LatencyStats PerformanceTracker::latency_stats_from(const LatencyHistogram& latency) {
     LatencyStats stats{};
-    
-    // Get current samples from circular buffer
-    auto samples = get_current_samples();
-    stats.samples = samples.size();
+    stats.samples = latency.count();
     
     if (stats.samples == 0) {
         return stats;
     }
     
-    // Calculate latencies for each stage
-    std::vector<double> latencies;
-    latencies.reserve(stats.samples);
-    
-    for (const auto& ts : samples) {
-        // Total latency from packet reception to processing end
-        double latency = (ts.process_end - ts.packet_rx) / 1000.0;  // Convert to microseconds
-        latencies.push_back(latency);
-    }
-    
-    // Sort latencies for percentile calculation
-    std::sort(latencies.begin(), latencies.end());
-    
-    // Calculate percentiles
-    stats.p50 = calculate_percentile(latencies, 0.50);
-    stats.p90 = calculate_percentile(latencies, 0.90);
-    stats.p95 = calculate_percentile(latencies, 0.95);
-    stats.p99 = calculate_percentile(latencies, 0.99);
-    stats.p99_9 = calculate_percentile(latencies, 0.999);
-    
-    // Calculate mean
-    stats.mean = std::accumulate(latencies.begin(), latencies.end(), 0.0) / latencies.size();
+    // One pass over the histogram buckets per percentile; convert to microseconds
+    auto us = [&latency](double percentile) { return static_cast<double>(latency.value_at_percentile(percentile)) / 1000.0; };
+    stats.p50 = us(0.50);
+    stats.p90 = us(0.90);
+    stats.p95 = us(0.95);
+    stats.p99 = us(0.99);
+    stats.p99_9 = us(0.999);
+    stats.p99_99 = us(0.9999);
+    stats.mean = latency.mean() / 1000.0;
+    stats.max = static_cast<double>(latency.max()) / 1000.0;
     
     return stats;
 }
 
-PerformanceTracker::CacheMetrics PerformanceTracker::get_cache_metrics() const {
-    CacheMetrics metrics{};
-    
-    if (!config_.enable_cache_analysis) {
-        return metrics;
-    }
+std::vector<PerformanceTracker::ThreadMetrics> PerformanceTracker::get_thread_metrics() const {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
     
-    std::uint64_t total_refs = cache_stats_.cache_references.load();
-    if (total_refs == 0) {
-        return metrics;
+    std::vector<ThreadMetrics> metrics;
+    metrics.reserve(threads_.size());
+    for (const auto& thread : threads_) {
+        ThreadMetrics m;
+        m.name = thread->name();
+        m.messages = thread->messages();
+        m.counts = thread->totals();
+        m.times = thread->times();
+        for (std::size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+            m.available[i] = thread->available(static_cast<PerfEvent>(i));
+        }
+        m.user_rdpmc = thread->user_rdpmc();
+        metrics.push_back(std::move(m));
     }
-    
-    metrics.total_references = total_refs;
-    metrics.l1_miss_rate = static_cast<double>(cache_stats_.l1_misses.load()) / total_refs;
-    metrics.l2_miss_rate = static_cast<double>(cache_stats_.l2_misses.load()) / total_refs;
-    metrics.l3_miss_rate = static_cast<double>(cache_stats_.l3_misses.load()) / total_refs;
-    
     return metrics;
 }
 
+double PerformanceTracker::ThreadMetrics::ipc() const {
+    auto cycles = counts[static_cast<std::size_t>(PerfEvent::CYCLES)];
+    return cycles > 0 ? static_cast<double>(counts[static_cast<std::size_t>(PerfEvent::INSTRUCTIONS)]) / cycles : 0.0;
+}
+
+double PerformanceTracker::ThreadMetrics::per_message(PerfEvent event) const {
+    return messages > 0 ? static_cast<double>(counts[static_cast<std::size_t>(event)]) / messages : 0.0;
+}
+
+void PerformanceTracker::register_metrics(MetricsRegistry& registry) const {
+    registry.histogram("mdfh_sampled_latency_ns", "Receive-to-process latency of sampled packets in nanoseconds",
+                       {}, latency_);
+    for (std::size_t i = 0; i < static_cast<std::size_t>(LatencyStage::COUNT); ++i) {
+        auto stage = static_cast<LatencyStage>(i);
+        registry.histogram("mdfh_stage_latency_ns", "Per-stage latency of sampled packets in nanoseconds",
+                           {{"stage", latency_stage_name(stage)}}, stage_latency_[i]);
+    }
+}
+
 void PerformanceTracker::print_performance_report() const {
     std::cout << "\n=== Performance Analysis Report ===\n";
     
@@ -174,74 +240,276 @@ void PerformanceTracker::print_performance_report() const {
         std::cout << "  P95: " << latency_stats.p95 << "µs\n";
         std::cout << "  P99: " << latency_stats.p99 << "µs\n";
         std::cout << "  P99.9: " << latency_stats.p99_9 << "µs\n";
+        std::cout << "  P99.99: " << latency_stats.p99_99 << "µs\n";
+        std::cout << "  Max: " << latency_stats.max << "µs\n";
+        
+        std::cout << "\nStage Breakdown (microseconds):\n";
+        std::cout << "  " << std::left << std::setw(14) << "Stage" << std::right
+                  << std::setw(10) << "Samples" << std::setw(10) << "Mean" << std::setw(10) << "P50"
+                  << std::setw(10) << "P99" << std::setw(10) << "P99.9" << std::setw(10) << "Max" << "\n";
+        for (std::size_t i = 0; i < LATENCY_STAGE_COUNT; ++i) {
+            auto stage = static_cast<LatencyStage>(i);
+            auto stage_stats = get_stage_latency_stats(stage);
+            std::cout << "  " << std::left << std::setw(14) << latency_stage_name(stage) << std::right
+                      << std::setw(10) << stage_stats.samples << std::setw(10) << stage_stats.mean
+                      << std::setw(10) << stage_stats.p50 << std::setw(10) << stage_stats.p99
+                      << std::setw(10) << stage_stats.p99_9 << std::setw(10) << stage_stats.max << "\n";
+        }
+        
+        const auto& clock = TscClock::instance();
+        std::cout << "  Clock: " << (clock.enabled() ? "TSC (" : "clock_gettime");
+        if (clock.enabled()) {
+            std::cout << std::setprecision(3) << clock.ticks_per_ns() << " GHz)";
+        }
+        std::cout << "\n";
     }
     
     if (config_.enable_cache_analysis) {
-        auto cache_metrics = get_cache_metrics();
-        std::cout << "\nCache Performance:\n";
-        std::cout << "  Total References: " << cache_metrics.total_references << "\n";
-        std::cout << "  L1 Miss Rate: " << std::fixed << std::setprecision(4) 
-                  << (cache_metrics.l1_miss_rate * 100) << "%\n";
-        std::cout << "  L2 Miss Rate: " << (cache_metrics.l2_miss_rate * 100) << "%\n";
-        std::cout << "  L3 Miss Rate: " << (cache_metrics.l3_miss_rate * 100) << "%\n";
+        std::cout << "\nHardware Counters per Message:\n";
+        std::cout << "  " << std::left << std::setw(20) << "Thread" << std::right << std::setw(12) << "Messages"
+                  << std::setw(7) << "IPC";
+        for (std::size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+            std::cout << std::setw(14) << perf_event_name(static_cast<PerfEvent>(i));
+        }
+        std::cout << "\n";
+        
+        for (const auto& thread : get_thread_metrics()) {
+            std::cout << "  " << std::left << std::setw(20) << thread.name << std::right
+                      << std::setw(12) << thread.messages;
+            if (!thread.times.counted()) {
+                // Enabled but never on the PMU: zeros here would look like data
+                std::cout << "  not counted (no free counters for the group)\n";
+                continue;
+            }
+            std::cout << std::fixed << std::setprecision(2) << std::setw(7) << thread.ipc();
+            for (std::size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+                if (thread.available[i]) {
+                    std::cout << std::setw(14) << thread.per_message(static_cast<PerfEvent>(i));
+                } else {
+                    std::cout << std::setw(14) << "n/a";
+                }
+            }
+            std::cout << (thread.user_rdpmc ? "" : "  (read(2))");
+            if (thread.times.multiplexed()) {
+                std::cout << "  (scaled, counted " << std::setprecision(0) << thread.times.fraction() * 100.0 << "%)";
+            }
+            std::cout << "\n";
+        }
     }
 }
 
-#if defined(MDFH_HAVE_PERF_EVENT_H)
-bool PerformanceTracker::setup_perf_counters() {
-    struct perf_event_attr pe;
-    memset(&pe, 0, sizeof(pe));
-    pe.type = PERF_TYPE_HW;
-    pe.size = sizeof(pe);
-    pe.disabled = 1;
-    pe.exclude_kernel = 1;
-    pe.exclude_hv = 1;
-    
-    // Set up L1 cache misses
-    pe.config = PERF_COUNT_HW_CACHE_MISSES;
-    pe.config1 = PERF_COUNT_HW_CACHE_L1D;
-    perf_fd_ = reinterpret_cast<void*>(syscall(SYS_perf_event_open, &pe, 0, -1, -1, 0));
-    
-    if (perf_fd_ == nullptr) {
-        std::cerr << "Failed to set up performance counters" << std::endl;
+const char* perf_event_name(PerfEvent event) {
+    switch (event) {
+        case PerfEvent::CYCLES: return "cycles";
+        case PerfEvent::INSTRUCTIONS: return "instructions";
+        case PerfEvent::L1D_MISSES: return "l1d-misses";
+        case PerfEvent::LLC_MISSES: return "llc-misses";
+        case PerfEvent::DTLB_MISSES: return "dtlb-misses";
+        case PerfEvent::BRANCH_MISSES: return "branch-misses";
+        case PerfEvent::COUNT: break;
+    }
+    return "unknown";
+}
+
+// ThreadCounters implementation
+bool ThreadCounters::open() {
+    if (!group_.open()) {
         return false;
     }
-    
-    // Enable the counters
-    ioctl(reinterpret_cast<int>(perf_fd_), PERF_EVENT_IOC_ENABLE, 0);
+    baseline_ = group_.read();
+    baseline_times_ = group_.times();
     return true;
 }
 
-void PerformanceTracker::read_perf_counters() {
-    if (!perf_fd_) return;
+void ThreadCounters::sample(std::uint64_t messages) {
+    auto counts = group_.read();
+    auto now = group_.times();
+    PerfTimes times{now.enabled - baseline_times_.enabled, now.running - baseline_times_.running};
+    for (std::size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+        auto count = counts[i] - baseline_[i];
+        if (times.multiplexed()) {
+            count = static_cast<std::uint64_t>(static_cast<unsigned __int128>(count) * times.enabled / times.running);
+        }
+        totals_[i].store(count, std::memory_order_relaxed);
+    }
+    enabled_ns_.store(times.enabled, std::memory_order_relaxed);
+    running_ns_.store(times.running, std::memory_order_relaxed);
+    messages_.store(messages, std::memory_order_relaxed);
+}
+
+PerfTimes ThreadCounters::times() const {
+    return {enabled_ns_.load(std::memory_order_relaxed), running_ns_.load(std::memory_order_relaxed)};
+}
+
+PerfCounts ThreadCounters::totals() const {
+    PerfCounts counts;
+    for (std::size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+        counts[i] = totals_[i].load(std::memory_order_relaxed);
+    }
+    return counts;
+}
+
+// PerfCounterGroup implementation
+PerfCounterGroup::~PerfCounterGroup() {
+    close();
+}
+
+#if defined(MDFH_HAVE_PERF_EVENT_H)
+namespace {
+
+constexpr std::uint64_t hw_cache_read_miss(std::uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+struct EventSpec {
+    std::uint32_t type;
+    std::uint64_t config;
+};
+
+// Indexed by PerfEvent; CYCLES is the group leader
+constexpr std::array<EventSpec, PERF_EVENT_COUNT> EVENT_SPECS = {{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, hw_cache_read_miss(PERF_COUNT_HW_CACHE_L1D)},
+    {PERF_TYPE_HW_CACHE, hw_cache_read_miss(PERF_COUNT_HW_CACHE_LL)},
+    {PERF_TYPE_HW_CACHE, hw_cache_read_miss(PERF_COUNT_HW_CACHE_DTLB)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+}};
+
+int perf_event_open(perf_event_attr& attr, int group_fd) {
+    // pid 0, cpu -1: the calling thread on whichever CPU it runs
+    return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC));
+}
+
+} // namespace
+
+bool PerfCounterGroup::open() {
+    close();
+    
+    const auto page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    user_rdpmc_ = true;
     
-    std::uint64_t count;
-    if (read(reinterpret_cast<int>(perf_fd_), &count, sizeof(count)) == sizeof(count)) {
-        cache_stats_.l1_misses.store(count, std::memory_order_relaxed);
+    for (std::size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = EVENT_SPECS[i].type;
+        attr.config = EVENT_SPECS[i].config;
+        attr.disabled = i == 0 ? 1 : 0;     // The leader starts the whole group
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        // Shows whether the group was scheduled at all, and for how long
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        
+        int fd = perf_event_open(attr, i == 0 ? -1 : counters_[0].fd);
+        if (fd < 0) {
+            if (i == 0) {
+                return false;
+            }
+            continue;   // Event not supported here; the rest of the group still counts
+        }
+        counters_[i].fd = fd;
+        
+        // The mapped page publishes the hardware counter index for rdpmc
+        void* page = ::mmap(nullptr, page_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (page == MAP_FAILED) {
+            user_rdpmc_ = false;
+            continue;
+        }
+        counters_[i].page = page;
+        if (!static_cast<const perf_event_mmap_page*>(page)->cap_user_rdpmc) {
+            user_rdpmc_ = false;
+        }
     }
+    
+    ::ioctl(counters_[0].fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ::ioctl(counters_[0].fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
 }
 
-void PerformanceTracker::close_perf_counters() {
-    if (perf_fd_) {
-        ioctl(reinterpret_cast<int>(perf_fd_), PERF_EVENT_IOC_DISABLE, 0);
-        close(reinterpret_cast<int>(perf_fd_));
-        perf_fd_ = nullptr;
+void PerfCounterGroup::close() {
+    const auto page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    if (counters_[0].fd >= 0) {
+        ::ioctl(counters_[0].fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
     }
+    // Members before the leader
+    for (std::size_t i = PERF_EVENT_COUNT; i-- > 0;) {
+        auto& counter = counters_[i];
+        if (counter.page) {
+            ::munmap(counter.page, page_size);
+            counter.page = nullptr;
+        }
+        if (counter.fd >= 0) {
+            ::close(counter.fd);
+            counter.fd = -1;
+        }
+    }
+    user_rdpmc_ = false;
 }
-#else
-bool PerformanceTracker::setup_perf_counters() { return false; }
-void PerformanceTracker::read_perf_counters() {}
-void PerformanceTracker::close_perf_counters() {}
-#endif
 
-double PerformanceTracker::calculate_percentile(const std::vector<double>& latencies, double percentile) const {
-    if (latencies.empty()) return 0.0;
+PerfCounts PerfCounterGroup::read() const {
+    PerfCounts counts{};
+    for (std::size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+        if (counters_[i].fd >= 0) {
+            counts[i] = read_counter(counters_[i]);
+        }
+    }
+    return counts;
+}
+
+std::uint64_t PerfCounterGroup::read_counter(const Counter& counter) const {
+#if defined(__x86_64__)
+    // Seqlock protocol of perf_event_mmap_page: retry if the kernel
+    // rescheduled the counter while we read it
+    if (counter.page) {
+        const volatile auto* page = static_cast<const volatile perf_event_mmap_page*>(counter.page);
+        std::uint32_t seq;
+        std::uint64_t value;
+        bool valid;
+        do {
+            seq = page->lock;
+            std::atomic_signal_fence(std::memory_order_acquire);
+            
+            auto index = page->index;
+            valid = page->cap_user_rdpmc && index != 0;
+            value = static_cast<std::uint64_t>(page->offset);
+            if (valid) {
+                // Sign-extend the pmc_width-bit hardware count
+                auto shift = 64 - page->pmc_width;
+                auto pmc = static_cast<std::int64_t>(__rdpmc(static_cast<int>(index - 1)) << shift) >> shift;
+                value += static_cast<std::uint64_t>(pmc);
+            }
+            
+            std::atomic_signal_fence(std::memory_order_acquire);
+        } while (page->lock != seq);
+        
+        if (valid) {
+            return value;
+        }
+    }
+#endif
     
-    size_t index = static_cast<size_t>(latencies.size() * percentile);
-    if (index >= latencies.size()) {
-        index = latencies.size() - 1;
+    // Counter not on a PMU right now (or no rdpmc): ask the kernel
+    std::uint64_t values[3] = {};       // value, time enabled, time running
+    if (::read(counter.fd, values, sizeof(values)) != static_cast<ssize_t>(sizeof(values))) {
+        return 0;
     }
-    return latencies[index];
+    return values[0];
 }
 
+PerfTimes PerfCounterGroup::times() const {
+    std::uint64_t values[3] = {};
+    if (counters_[0].fd < 0 ||
+        ::read(counters_[0].fd, values, sizeof(values)) != static_cast<ssize_t>(sizeof(values))) {
+        return {};
+    }
+    return {values[1], values[2]};
+}
+#else
+bool PerfCounterGroup::open() { return false; }
+void PerfCounterGroup::close() {}
+PerfCounts PerfCounterGroup::read() const { return {}; }
+PerfTimes PerfCounterGroup::times() const { return {}; }
+std::uint64_t PerfCounterGroup::read_counter(const Counter&) const { return 0; }
+#endif
+
 } // namespace mdfh 
\ No newline at end of file
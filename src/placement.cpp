@@ -0,0 +1,234 @@
+#include "mdfh/placement.hpp"
+#include "mdfh/core.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace mdfh {
+
+namespace {
+
+constexpr std::size_t PAGE_4K = 4096;
+constexpr std::size_t PAGE_2M = 2u << 20;
+constexpr std::size_t PAGE_1G = 1u << 30;
+
+std::size_t round_up(std::size_t bytes, std::size_t page) {
+    return (bytes + page - 1) / page * page;
+}
+
+#if defined(__linux__)
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+// MAP_HUGETLB mapping from the pool of the given page size, nullptr if the pool is empty
+void* map_hugetlb(std::size_t bytes, std::size_t page) {
+    int log2_page = page == PAGE_1G ? 30 : 21;
+    void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (log2_page << MAP_HUGE_SHIFT), -1, 0);
+    return p == MAP_FAILED ? nullptr : p;
+}
+
+// 2MB-aligned regular mapping so THP can back it with whole huge pages
+void* map_aligned(std::size_t bytes, std::size_t alignment) {
+    std::size_t span = bytes + alignment;
+    void* raw = ::mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    auto base = reinterpret_cast<std::uintptr_t>(raw);
+    auto aligned = (base + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+    if (aligned > base) {
+        ::munmap(raw, aligned - base);
+    }
+    std::size_t tail = (base + span) - (aligned + bytes);
+    if (tail > 0) {
+        ::munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+    }
+    return reinterpret_cast<void*>(aligned);
+}
+#endif
+
+} // namespace
+
+// MappedRegion implementation
+MappedRegion::MappedRegion(std::size_t bytes, const MemoryPlacement& placement) {
+    if (bytes == 0) {
+        return;
+    }
+
+#if defined(__linux__)
+    HugePageMode mode = placement.huge_pages;
+
+    if (mode == HugePageMode::HUGE_1GB) {
+        size_ = round_up(bytes, PAGE_1G);
+        data_ = map_hugetlb(size_, PAGE_1G);
+        if (!data_) {
+            MDFH_LOG_WARN("Placement", "No 1GB huge pages available, trying 2MB");
+            mode = HugePageMode::HUGE_2MB;
+        }
+    }
+    if (!data_ && mode == HugePageMode::HUGE_2MB) {
+        size_ = round_up(bytes, PAGE_2M);
+        data_ = map_hugetlb(size_, PAGE_2M);
+        if (!data_) {
+            MDFH_LOG_WARN("Placement", "No 2MB huge pages available (vm.nr_hugepages), using transparent huge pages");
+            mode = HugePageMode::TRANSPARENT;
+        }
+    }
+    if (!data_ && mode == HugePageMode::TRANSPARENT) {
+        size_ = round_up(bytes, PAGE_2M);
+        data_ = map_aligned(size_, PAGE_2M);
+        if (data_ && ::madvise(data_, size_, MADV_HUGEPAGE) != 0) {
+            MDFH_LOG_WARN("Placement", "MADV_HUGEPAGE failed, using regular pages: ", std::strerror(errno));
+            mode = HugePageMode::NONE;
+        }
+    }
+    if (!data_) {
+        mode = HugePageMode::NONE;
+        size_ = round_up(bytes, PAGE_4K);
+        void* p = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            size_ = 0;
+            throw std::bad_alloc();
+        }
+        data_ = p;
+    }
+    backing_ = mode;
+
+    // Bind before the first touch so every page is allocated on the node
+    if (placement.numa_node >= 0) {
+        unsigned long mask[16] = {};
+        constexpr unsigned long bits = sizeof(unsigned long) * 8;
+        auto node = static_cast<unsigned long>(placement.numa_node);
+        if (node < sizeof(mask) * 8) {
+            mask[node / bits] |= 1UL << (node % bits);
+            if (::syscall(SYS_mbind, data_, size_, MPOL_BIND, mask, sizeof(mask) * 8, MPOL_MF_MOVE) != 0) {
+                MDFH_LOG_WARN("Placement", "mbind to NUMA node ", node, " failed: ", std::strerror(errno));
+            }
+        } else {
+            MDFH_LOG_WARN("Placement", "NUMA node ", node, " out of range, not binding");
+        }
+    }
+
+    if (placement.prefault) {
+        // Only hugetlb mappings are guaranteed huge pages; THP is best-effort
+        // and may back any part of the range with 4K pages, so touch each one
+        std::size_t step = mode == HugePageMode::HUGE_1GB ? PAGE_1G
+                         : mode == HugePageMode::HUGE_2MB ? PAGE_2M : PAGE_4K;
+        auto* bytes_ptr = static_cast<volatile std::uint8_t*>(data_);
+        for (std::size_t off = 0; off < size_; off += step) {
+            bytes_ptr[off] = 0;
+        }
+    }
+#else
+    (void)placement;
+    size_ = round_up(bytes, PAGE_4K);
+    data_ = ::operator new(size_, std::align_val_t{PAGE_4K});
+    std::memset(data_, 0, size_);
+#endif
+}
+
+MappedRegion::~MappedRegion() {
+    release();
+}
+
+void MappedRegion::release() {
+    if (!data_) {
+        return;
+    }
+#if defined(__linux__)
+    ::munmap(data_, size_);
+#else
+    ::operator delete(data_, std::align_val_t{PAGE_4K});
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+// Thread placement
+bool set_cpu_affinity(std::uint32_t cpu_core) {
+#ifdef __linux__
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu_core, &cpuset);
+
+    return sched_setaffinity(0, sizeof(cpuset), &cpuset) == 0;
+#else
+    // CPU affinity not supported on this platform
+    (void)cpu_core;
+    return true;
+#endif
+}
+
+void pin_current_thread(int cpu_core, const std::string& thread_name) {
+    if (cpu_core < 0) {
+        return;
+    }
+    if (!set_cpu_affinity(static_cast<std::uint32_t>(cpu_core))) {
+        MDFH_LOG_WARN("Placement", "Could not pin ", thread_name, " to core ", cpu_core, ": ", std::strerror(errno));
+    }
+}
+
+std::vector<int> current_cpu_affinity() {
+    std::vector<int> cpus;
+#if defined(__linux__)
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    if (sched_getaffinity(0, sizeof(cpuset), &cpuset) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &cpuset)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    return cpus;
+}
+
+int numa_node_of_cpu(int cpu_core) {
+#if defined(__linux__)
+    if (cpu_core < 0) {
+        return -1;
+    }
+    // The CPU's sysfs directory links to its node as "node<N>"
+    std::error_code ec;
+    std::filesystem::directory_iterator it("/sys/devices/system/cpu/cpu" + std::to_string(cpu_core), ec);
+    for (; !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+        auto name = it->path().filename().string();
+        if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+            std::all_of(name.begin() + 4, name.end(), [](unsigned char c) { return std::isdigit(c); })) {
+            return std::stoi(name.substr(4));
+        }
+    }
+#else
+    (void)cpu_core;
+#endif
+    return -1;
+}
+
+HugePageMode parse_huge_page_mode(const std::string& name) {
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (lower == "none" || lower == "off") return HugePageMode::NONE;
+    if (lower == "thp" || lower == "transparent") return HugePageMode::TRANSPARENT;
+    if (lower == "2mb" || lower == "huge_2mb") return HugePageMode::HUGE_2MB;
+    if (lower == "1gb" || lower == "huge_1gb") return HugePageMode::HUGE_1GB;
+    throw std::invalid_argument("Unknown huge page mode: " + name);
+}
+
+} // namespace mdfh
@@ -0,0 +1,382 @@
+#include "mdfh/replay.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mdfh {
+
+namespace {
+
+// libpcap file and link-layer constants
+constexpr std::uint32_t PCAP_MAGIC_US = 0xA1B2C3D4;
+constexpr std::uint32_t PCAP_MAGIC_NS = 0xA1B23C4D;
+constexpr std::uint32_t PCAPNG_MAGIC = 0x0A0D0D0A;
+constexpr std::size_t PCAP_FILE_HEADER = 24;
+constexpr std::size_t PCAP_RECORD_HEADER = 16;
+
+constexpr std::uint32_t LINKTYPE_NULL = 0;
+constexpr std::uint32_t LINKTYPE_ETHERNET = 1;
+constexpr std::uint32_t LINKTYPE_RAW_ALT = 12;
+constexpr std::uint32_t LINKTYPE_RAW = 101;
+constexpr std::uint32_t LINKTYPE_LINUX_SLL = 113;
+constexpr std::uint32_t LINKTYPE_LINUX_SLL2 = 276;
+
+constexpr std::uint16_t ETHERTYPE_IPV4 = 0x0800;
+constexpr std::uint16_t ETHERTYPE_IPV6 = 0x86DD;
+constexpr std::uint16_t ETHERTYPE_VLAN = 0x8100;
+constexpr std::uint16_t ETHERTYPE_QINQ = 0x88A8;
+
+constexpr std::uint8_t IPPROTO_TCP_ID = 6;
+constexpr std::uint8_t IPPROTO_UDP_ID = 17;
+
+std::uint16_t load_be16(const std::uint8_t* p) {
+    return static_cast<std::uint16_t>((p[0] << 8) | p[1]);
+}
+
+std::uint32_t load_u32(const std::uint8_t* p, bool swapped) {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return swapped ? __builtin_bswap32(v) : v;
+}
+
+// UDP or TCP payload of one captured frame; false for anything else
+// (non-IP, fragments, other protocols, empty segments, other ports)
+bool extract_payload(const std::uint8_t* frame, std::size_t len, std::uint32_t link_type,
+                     std::uint16_t port, std::span<const std::uint8_t>& payload) {
+    std::size_t offset = 0;
+    std::uint16_t ethertype = 0;
+
+    switch (link_type) {
+        case LINKTYPE_ETHERNET:
+            if (len < 14) return false;
+            ethertype = load_be16(frame + 12);
+            offset = 14;
+            while (ethertype == ETHERTYPE_VLAN || ethertype == ETHERTYPE_QINQ) {
+                if (len < offset + 4) return false;
+                ethertype = load_be16(frame + offset + 2);
+                offset += 4;
+            }
+            break;
+        case LINKTYPE_LINUX_SLL:
+            if (len < 16) return false;
+            ethertype = load_be16(frame + 14);
+            offset = 16;
+            break;
+        case LINKTYPE_LINUX_SLL2:
+            if (len < 20) return false;
+            ethertype = load_be16(frame);
+            offset = 20;
+            break;
+        case LINKTYPE_RAW:
+        case LINKTYPE_RAW_ALT:
+            if (len < 1) return false;
+            ethertype = (frame[0] >> 4) == 6 ? ETHERTYPE_IPV6 : ETHERTYPE_IPV4;
+            break;
+        case LINKTYPE_NULL:
+            // 4-byte address family in the capturing host's byte order: 2 is AF_INET
+            if (len < 4) return false;
+            ethertype = (frame[0] == 2 || frame[3] == 2) ? ETHERTYPE_IPV4 : ETHERTYPE_IPV6;
+            offset = 4;
+            break;
+        default:
+            return false;
+    }
+
+    const std::uint8_t* ip = frame + offset;
+    std::size_t ip_len = len - offset;
+    std::size_t l4 = 0;
+    std::size_t ip_end = 0;
+    std::uint8_t protocol = 0;
+
+    if (ethertype == ETHERTYPE_IPV4) {
+        if (ip_len < 20 || (ip[0] >> 4) != 4) return false;
+        if (load_be16(ip + 6) & 0x3FFF) return false;   // Fragment (MF set or non-zero offset)
+        l4 = static_cast<std::size_t>(ip[0] & 0x0F) * 4;
+        ip_end = std::min<std::size_t>(load_be16(ip + 2), ip_len);   // Drops Ethernet padding
+        protocol = ip[9];
+    } else if (ethertype == ETHERTYPE_IPV6) {
+        if (ip_len < 40 || (ip[0] >> 4) != 6) return false;
+        l4 = 40;
+        ip_end = std::min<std::size_t>(40 + load_be16(ip + 4), ip_len);
+        protocol = ip[6];   // Extension headers are not followed
+    } else {
+        return false;
+    }
+
+    std::size_t begin = 0;
+    std::size_t end = ip_end;
+    if (protocol == IPPROTO_UDP_ID) {
+        if (ip_end < l4 + 8) return false;
+        if (port != 0 && load_be16(ip + l4 + 2) != port) return false;
+        begin = l4 + 8;
+        end = std::min<std::size_t>(ip_end, l4 + load_be16(ip + l4 + 4));
+    } else if (protocol == IPPROTO_TCP_ID) {
+        if (ip_end < l4 + 20) return false;
+        if (port != 0 && load_be16(ip + l4 + 2) != port) return false;
+        begin = l4 + static_cast<std::size_t>(ip[l4 + 12] >> 4) * 4;
+    } else {
+        return false;
+    }
+
+    if (begin >= end) {
+        return false;   // Pure ACKs and other empty segments
+    }
+    payload = {ip + begin, end - begin};
+    return true;
+}
+
+} // namespace
+
+std::ostream& operator<<(std::ostream& os, ReplayFormat format) {
+    switch (format) {
+        case ReplayFormat::AUTO: return os << "AUTO";
+        case ReplayFormat::JOURNAL: return os << "JOURNAL";
+        case ReplayFormat::PCAP: return os << "PCAP";
+    }
+    return os << "UNKNOWN_REPLAY_FORMAT";
+}
+
+std::ostream& operator<<(std::ostream& os, const ReplayConfig& config) {
+    os << config.path << " (" << config.format << ", ";
+    if (config.speed > 0.0) {
+        os << config.speed << "x";
+    } else {
+        os << "max rate";
+    }
+    if (config.loop) {
+        os << ", looped";
+    }
+    return os << ")";
+}
+
+ReplayFormat parse_replay_format(const std::string& name) {
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (lower == "auto") return ReplayFormat::AUTO;
+    if (lower == "journal") return ReplayFormat::JOURNAL;
+    if (lower == "pcap") return ReplayFormat::PCAP;
+    throw std::invalid_argument("Unknown replay format: " + name);
+}
+
+// ReplayPacer implementation
+void ReplayPacer::wait_until(std::chrono::steady_clock::time_point due) {
+    auto now = std::chrono::steady_clock::now();
+    if (due - now > std::chrono::milliseconds(1)) {
+        std::this_thread::sleep_for(due - now - std::chrono::milliseconds(1));
+    }
+    while (std::chrono::steady_clock::now() < due) {
+        // Intentionally empty - busy wait for precision
+    }
+}
+
+// ReplaySource implementation
+ReplaySource::ReplaySource(ReplayConfig config)
+    : config_(std::move(config))
+    , format_(config_.format)
+    , pacer_(config_.speed) {
+    if (!config_.enabled() || !config_.is_valid()) {
+        throw std::invalid_argument("Invalid replay configuration");
+    }
+    if (format_ == ReplayFormat::AUTO) {
+        format_ = std::filesystem::is_directory(config_.path) ? ReplayFormat::JOURNAL : ReplayFormat::PCAP;
+    }
+
+    if (format_ == ReplayFormat::JOURNAL) {
+        journal_ = std::make_unique<JournalReader>(config_.path);
+        if (journal_->segment_count() == 0) {
+            throw std::runtime_error("Replay: no journal segments in " + config_.path);
+        }
+    } else {
+        open_pcap();
+    }
+}
+
+ReplaySource::~ReplaySource() {
+    if (pcap_) {
+        ::munmap(const_cast<std::uint8_t*>(pcap_), pcap_bytes_);
+    }
+}
+
+void ReplaySource::open_pcap() {
+    int fd = ::open(config_.path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Replay: cannot open " + config_.path + ": " + std::strerror(errno));
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < PCAP_FILE_HEADER) {
+        ::close(fd);
+        throw std::runtime_error("Replay: " + config_.path + " is too short for a pcap file");
+    }
+    pcap_bytes_ = static_cast<std::size_t>(st.st_size);
+    void* map = ::mmap(nullptr, pcap_bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        throw std::runtime_error("Replay: cannot map " + config_.path + ": " + std::strerror(errno));
+    }
+    pcap_ = static_cast<const std::uint8_t*>(map);
+    ::madvise(map, pcap_bytes_, MADV_SEQUENTIAL);
+
+    // The destructor won't run if the constructor throws, so unmap here
+    auto reject = [this](const std::string& why) {
+        ::munmap(const_cast<std::uint8_t*>(pcap_), pcap_bytes_);
+        pcap_ = nullptr;
+        throw std::runtime_error("Replay: " + config_.path + why);
+    };
+
+    std::uint32_t magic = load_u32(pcap_, false);
+    if (magic == PCAP_MAGIC_US || magic == PCAP_MAGIC_NS) {
+        swapped_ = false;
+    } else if (__builtin_bswap32(magic) == PCAP_MAGIC_US || __builtin_bswap32(magic) == PCAP_MAGIC_NS) {
+        swapped_ = true;
+        magic = __builtin_bswap32(magic);
+    } else if (magic == PCAPNG_MAGIC) {
+        reject(" is pcapng; convert it with 'editcap -F pcap' first");
+    } else {
+        reject(" is not a pcap file");
+    }
+    nanosecond_ = magic == PCAP_MAGIC_NS;
+    link_type_ = load_u32(pcap_ + 20, swapped_) & 0x0FFFFFFF;   // Upper bits hold FCS flags
+    pcap_offset_ = PCAP_FILE_HEADER;
+}
+
+void ReplaySource::reset_position() {
+    segment_ = 0;
+    record_ = 0;
+    pcap_offset_ = PCAP_FILE_HEADER;
+    pass_events_ = 0;
+    has_pending_ = false;
+    pacer_.restart();
+}
+
+void ReplaySource::rewind() {
+    reset_position();
+    finished_ = false;
+}
+
+bool ReplaySource::read_next(ReplayEvent& event) {
+    bool ok = format_ == ReplayFormat::JOURNAL ? read_journal(event) : read_pcap(event);
+    if (ok) {
+        ++pass_events_;
+    }
+    return ok;
+}
+
+bool ReplaySource::read_journal(ReplayEvent& event) {
+    while (segment_ < journal_->segment_count()) {
+        auto records = journal_->records(segment_);
+        while (record_ < records.size()) {
+            const auto& record = records[record_++];
+            if (config_.origin_id >= 0 && record.origin_id != config_.origin_id) {
+                continue;
+            }
+            event.timestamp_ns = record.rx_ts;
+            event.bytes = {reinterpret_cast<const std::uint8_t*>(&record.raw), sizeof(Msg)};
+            event.messages = 1;
+            return true;
+        }
+        ++segment_;
+        record_ = 0;
+    }
+    return false;
+}
+
+bool ReplaySource::read_pcap(ReplayEvent& event) {
+    while (pcap_offset_ + PCAP_RECORD_HEADER <= pcap_bytes_) {
+        const std::uint8_t* header = pcap_ + pcap_offset_;
+        std::uint64_t seconds = load_u32(header, swapped_);
+        std::uint64_t fraction = load_u32(header + 4, swapped_);
+        std::size_t captured = load_u32(header + 8, swapped_);
+        if (pcap_offset_ + PCAP_RECORD_HEADER + captured > pcap_bytes_) {
+            MDFH_LOG_WARN("Replay", config_.path, " ends in a truncated packet");
+            pcap_offset_ = pcap_bytes_;
+            break;
+        }
+        const std::uint8_t* frame = header + PCAP_RECORD_HEADER;
+        pcap_offset_ += PCAP_RECORD_HEADER + captured;
+
+        std::span<const std::uint8_t> payload;
+        if (!extract_payload(frame, captured, link_type_, config_.port, payload)) {
+            ++skipped_packets_;
+            continue;
+        }
+        event.timestamp_ns = seconds * 1'000'000'000ULL + (nanosecond_ ? fraction : fraction * 1000);
+        event.bytes = payload;
+        event.messages = static_cast<std::uint32_t>(std::max<std::size_t>(1, payload.size() / sizeof(Msg)));
+        return true;
+    }
+    return false;
+}
+
+bool ReplaySource::take(ReplayEvent& event) {
+    if (read_next(event)) {
+        return true;
+    }
+    ++passes_;
+    // An empty pass (nothing matched the filters) would loop forever
+    if (config_.loop && pass_events_ > 0) {
+        reset_position();
+        if (read_next(event)) {
+            return true;
+        }
+    }
+    finished_ = true;
+    return false;
+}
+
+std::size_t ReplaySource::next_batch(std::span<ReplayEvent> out) {
+    if (out.empty() || finished_) {
+        return 0;
+    }
+    if (!has_pending_) {
+        if (!take(pending_)) {
+            return 0;
+        }
+        has_pending_ = true;
+    }
+
+    // Long recorded gaps return early so the caller can check its stop conditions
+    std::chrono::steady_clock::time_point now;
+    if (!pacer_.unpaced()) {
+        auto due = pacer_.deadline(pending_.timestamp_ns);
+        now = std::chrono::steady_clock::now();
+        if (due - now > MAX_WAIT) {
+            std::this_thread::sleep_for(MAX_WAIT);
+            return 0;
+        }
+        ReplayPacer::wait_until(due);
+        now = std::max(due, std::chrono::steady_clock::now());
+    }
+
+    std::size_t count = 0;
+    out[count++] = pending_;
+    has_pending_ = false;
+
+    while (count < out.size()) {
+        ReplayEvent event;
+        if (!take(event)) {
+            break;
+        }
+        if (!pacer_.unpaced() && pacer_.deadline(event.timestamp_ns) > now) {
+            pending_ = event;
+            has_pending_ = true;
+            break;
+        }
+        out[count++] = event;
+    }
+
+    events_replayed_ += count;
+    return count;
+}
+
+} // namespace mdfh
@@ -24,51 +24,12 @@
 
 namespace mdfh {
 
-// Logger implementation
-LogLevel Logger::current_level_ = LogLevel::INFO;
-std::ostream* Logger::output_stream_ = &std::cerr;
-
-void Logger::log(LogLevel level, const std::string& component, const std::string& message) {
-    if (level < current_level_) {
-        return;  // Skip logging if below current level
-    }
-    
-    static std::mutex log_mutex;  // Thread-safe logging
-    std::lock_guard<std::mutex> lock(log_mutex);
-    
-    *output_stream_ << get_timestamp() << " [" << level_to_string(level) << "] " 
-                   << component << ": " << message << std::endl;
-}
-
-std::string Logger::get_timestamp() {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
-    
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-    ss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-    return ss.str();
-}
-
-std::string Logger::level_to_string(LogLevel level) {
-    switch (level) {
-        case LogLevel::DEBUG: return "DEBUG";
-        case LogLevel::INFO:  return "INFO ";
-        case LogLevel::WARN:  return "WARN ";
-        case LogLevel::ERROR: return "ERROR";
-        case LogLevel::FATAL: return "FATAL";
-    }
-    return "UNKNOWN";
-}
-
-RingBuffer::RingBuffer(std::uint64_t capacity) 
+RingBuffer::RingBuffer(std::uint64_t capacity, const MemoryPlacement& placement) 
     : capacity_(capacity), mask_(capacity - 1) {
     validate_capacity(capacity);
-    slots_.resize(capacity);
+    slots_ = PlacedArray<Slot>(capacity, placement);
     
-    MDFH_LOG_DEBUG("RingBuffer", "Created ring buffer with capacity " + std::to_string(capacity));
+    MDFH_LOG_DEBUG("RingBuffer", "Created ring buffer with capacity ", capacity);
 }
 
 void RingBuffer::validate_capacity(std::uint64_t capacity) const {
@@ -84,37 +45,24 @@ void RingBuffer::validate_capacity(std::uint64_t capacity) const {
 }
 
 bool RingBuffer::try_push(const Slot& slot) {
-    auto write = write_pos_.load(std::memory_order_relaxed);
-    auto read = read_pos_.load(std::memory_order_acquire);
+    auto write = producer_pos();
     
-    if ((write - read) >= capacity_) {
+    if (free_slots(write, 1) == 0) {
         return false;  // Buffer full
     }
     
     slots_[write & mask_] = slot;  // Single producer, no need for atomic store
-    std::atomic_thread_fence(std::memory_order_release);
-    write_pos_.store(write + 1, std::memory_order_release);
-    
-    // Update high water mark - gated to reduce contention
-    auto current_size = (write + 1) - read;
-    auto current_hwm = high_water_mark_.load(std::memory_order_relaxed);
-    if (UNLIKELY(current_size > current_hwm)) {
-        high_water_mark_.store(current_size, std::memory_order_relaxed);
-    }
-    
+    publish_to(write + 1);
     return true;
 }
 
 bool RingBuffer::try_pop(Slot& slot) {
     auto read = read_pos_.load(std::memory_order_relaxed);
-    auto write = write_pos_.load(std::memory_order_acquire);
     
-    if (read == write) {
+    if (readable_slots(read) == 0) {
         return false;  // Buffer empty
     }
     
-    // Acquire fence to ensure we see producer's writes to slot before reading
-    std::atomic_thread_fence(std::memory_order_acquire);
     slot = slots_[read & mask_];  // Single consumer, no need for atomic load
     read_pos_.store(read + 1, std::memory_order_release);
     return true;
@@ -130,37 +78,75 @@ std::uint64_t RingBuffer::high_water_mark() const {
     return high_water_mark_.load(std::memory_order_acquire);
 }
 
-void RingBuffer::advance_write_pos(std::uint64_t count) {
+std::span<Slot> RingBuffer::claim(std::uint64_t count) {
+    auto write = producer_pos();
+    
+    // Limit to free space and to the contiguous run before the array wraps
+    auto index = write & mask_;
+    auto contiguous = std::min(count, capacity_ - index);
+    auto available_space = free_slots(write, contiguous);
+    
+    claimed_ = std::min(contiguous, available_space);
+    return {slots_.data() + index, static_cast<std::size_t>(claimed_)};
+}
+
+void RingBuffer::commit(std::uint64_t count) {
     if (count == 0) return;
     
-    auto old_write = write_pos_.load(std::memory_order_relaxed);
-    auto new_write = old_write + count;
+    if (UNLIKELY(count > claimed_)) {
+        MDFH_LOG_ERROR("RingBuffer", "Cannot commit more slots than claimed");
+        throw std::logic_error("Cannot commit more slots than claimed");
+    }
+    claimed_ = 0;
     
-    // Validate that we're not advancing beyond capacity
-    auto read = read_pos_.load(std::memory_order_acquire);
-    if ((new_write - read) > capacity_) {
-        MDFH_LOG_ERROR("RingBuffer", "Cannot advance write position beyond capacity");
-        throw std::runtime_error("Cannot advance write position beyond capacity");
+    if (holding_) {
+        held_ += count;
+        return;
+    }
+    publish_to(producer_pos() + count);
+}
+
+void RingBuffer::hold_commits() {
+    holding_ = true;
+}
+
+void RingBuffer::publish() {
+    holding_ = false;
+    if (held_ > 0) {
+        publish_to(producer_pos());
     }
+}
+
+std::span<const Slot> RingBuffer::peek(std::uint64_t max_count) {
+    auto read = read_pos_.load(std::memory_order_relaxed);
     
-    write_pos_.store(new_write, std::memory_order_release);
+    // Limit to available items and to the contiguous run before the array wraps
+    auto index = read & mask_;
+    auto contiguous = std::min(readable_slots(read), capacity_ - index);
     
-    // Update high water mark - gated to reduce contention
-    auto current_size = new_write - read;
-    auto current_hwm = high_water_mark_.load(std::memory_order_relaxed);
-    if (UNLIKELY(current_size > current_hwm)) {
-        high_water_mark_.store(current_size, std::memory_order_relaxed);
+    peeked_ = std::min(max_count, contiguous);
+    return {slots_.data() + index, static_cast<std::size_t>(peeked_)};
+}
+
+void RingBuffer::release(std::uint64_t count) {
+    if (count == 0) return;
+    
+    if (UNLIKELY(count > peeked_)) {
+        MDFH_LOG_ERROR("RingBuffer", "Cannot release more slots than peeked");
+        throw std::logic_error("Cannot release more slots than peeked");
     }
+    peeked_ = 0;
+    
+    // Release store hands the slots back to the producer after our reads
+    auto read = read_pos_.load(std::memory_order_relaxed);
+    read_pos_.store(read + count, std::memory_order_release);
 }
 
 std::uint64_t RingBuffer::try_push_bulk(const Slot* slots, std::uint64_t count) {
     if (count == 0 || slots == nullptr) return 0;
     
-    auto write = write_pos_.load(std::memory_order_relaxed);
-    auto read = read_pos_.load(std::memory_order_acquire);
-    
-    auto available_space = capacity_ - (write - read);
-    auto to_push = std::min(count, available_space);
+    auto write = producer_pos();
+    auto to_push = std::min(count, free_slots(write, count));
     
     if (to_push == 0) {
         return 0;  // Buffer full
@@ -171,16 +157,7 @@ std::uint64_t RingBuffer::try_push_bulk(const Slot* slots, std::uint64_t count)
         slots_[(write + i) & mask_] = slots[i];
     }
     
-    std::atomic_thread_fence(std::memory_order_release);
-    write_pos_.store(write + to_push, std::memory_order_release);
-    
-    // Update high water mark - gated to reduce contention
-    auto current_size = (write + to_push) - read;
-    auto current_hwm = high_water_mark_.load(std::memory_order_relaxed);
-    if (UNLIKELY(current_size > current_hwm)) {
-        high_water_mark_.store(current_size, std::memory_order_relaxed);
-    }
-    
+    publish_to(write + to_push);
     return to_push;
 }
 
@@ -188,18 +165,12 @@ std::uint64_t RingBuffer::try_pop_bulk(Slot* slots, std::uint64_t max_count) {
     if (max_count == 0 || slots == nullptr) return 0;
     
     auto read = read_pos_.load(std::memory_order_relaxed);
-    auto write = write_pos_.load(std::memory_order_acquire);
-    
-    auto available_items = write - read;
-    auto to_pop = std::min(max_count, available_items);
+    auto to_pop = std::min(max_count, readable_slots(read));
     
     if (to_pop == 0) {
         return 0;  // Buffer empty
     }
     
-    // Acquire fence to ensure we see producer's writes before reading
-    std::atomic_thread_fence(std::memory_order_acquire);
-    
     // Copy slots in bulk
     for (std::uint64_t i = 0; i < to_pop; ++i) {
         slots[i] = slots_[(read + i) & mask_];
@@ -210,10 +181,9 @@ std::uint64_t RingBuffer::try_pop_bulk(Slot* slots, std::uint64_t max_count) {
 }
 
 bool RingBuffer::try_push_with_prefetch(const Slot& slot) {
-    auto write = write_pos_.load(std::memory_order_relaxed);
-    auto read = read_pos_.load(std::memory_order_acquire);
+    auto write = producer_pos();
     
-    if ((write - read) >= capacity_) {
+    if (free_slots(write, 1) == 0) {
         return false;  // Buffer full
     }
     
@@ -222,24 +192,14 @@ bool RingBuffer::try_push_with_prefetch(const Slot& slot) {
     PREFETCH_WRITE(&slots_[next_write_idx]);
     
     slots_[write & mask_] = slot;  // Single producer, no need for atomic store
-    std::atomic_thread_fence(std::memory_order_release);
-    write_pos_.store(write + 1, std::memory_order_release);
-    
-    // Update high water mark - gated to reduce contention
-    auto current_size = (write + 1) - read;
-    auto current_hwm = high_water_mark_.load(std::memory_order_relaxed);
-    if (UNLIKELY(current_size > current_hwm)) {
-        high_water_mark_.store(current_size, std::memory_order_relaxed);
-    }
-    
+    publish_to(write + 1);
     return true;
 }
 
 bool RingBuffer::try_pop_with_prefetch(Slot& slot) {
     auto read = read_pos_.load(std::memory_order_relaxed);
-    auto write = write_pos_.load(std::memory_order_acquire);
     
-    if (read == write) {
+    if (readable_slots(read) == 0) {
         return false;  // Buffer empty
     }
     
@@ -247,8 +207,6 @@ bool RingBuffer::try_pop_with_prefetch(Slot& slot) {
     auto next_read_idx = (read + 1) & mask_;
     PREFETCH_READ(&slots_[next_read_idx]);
     
-    // Acquire fence to ensure we see producer's writes to slot before reading
-    std::atomic_thread_fence(std::memory_order_acquire);
     slot = slots_[read & mask_];  // Single consumer, no need for atomic load
     read_pos_.store(read + 1, std::memory_order_release);
     return true;
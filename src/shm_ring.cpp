@@ -0,0 +1,284 @@
+#include "mdfh/shm_ring.hpp"
+#include "mdfh/multi_feed_ingestion.hpp"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+
+namespace mdfh {
+
+namespace {
+
+constexpr std::size_t PAGE_BYTES = 4096;
+constexpr long HUGETLBFS_MAGIC_NUMBER = 0x958458f6;
+
+using SlotWords = std::array<std::uint64_t, 4>;
+static_assert(sizeof(SlotWords) == sizeof(MultiFeedSlot), "MultiFeedSlot must be four words");
+static_assert(sizeof(ShmRingHeader) <= PAGE_BYTES, "ShmRingHeader must fit in the first page");
+
+std::size_t round_up(std::size_t bytes, std::size_t unit) {
+    return (bytes + unit - 1) / unit * unit;
+}
+
+std::runtime_error io_error(const std::string& what, const std::string& path) {
+    return std::runtime_error("Shared-memory ring: " + what + " " + path + ": " + std::strerror(errno));
+}
+
+// True if pid no longer exists (its cursor slot can be reclaimed)
+bool process_gone(std::uint32_t pid) {
+    return ::kill(static_cast<pid_t>(pid), 0) != 0 && errno == ESRCH;
+}
+
+} // namespace
+
+bool ShmRingConfig::is_valid() const {
+    return capacity > 0 && (capacity & (capacity - 1)) == 0 && max_readers > 0 && max_readers <= 4096;
+}
+
+// ShmRingMapping implementation
+ShmRingMapping::~ShmRingMapping() {
+    if (data_) {
+        ::munmap(data_, size_);
+    }
+}
+
+ShmRingCursor* ShmRingMapping::cursors() const {
+    return reinterpret_cast<ShmRingCursor*>(static_cast<std::uint8_t*>(data_) + header().cursors_offset);
+}
+
+ShmRingCell* ShmRingMapping::cells() const {
+    return reinterpret_cast<ShmRingCell*>(static_cast<std::uint8_t*>(data_) + header().cells_offset);
+}
+
+// ShmRingWriter implementation
+ShmRingWriter::ShmRingWriter(ShmRingConfig config)
+    : config_(std::move(config)), mask_(config_.capacity - 1) {
+    if (!config_.enabled() || !config_.is_valid()) {
+        throw std::invalid_argument("Invalid shared-memory ring configuration");
+    }
+
+    // A fresh inode: readers still mapping the previous ring are not corrupted
+    if (::unlink(config_.path.c_str()) != 0 && errno != ENOENT) {
+        throw io_error("cannot replace", config_.path);
+    }
+    int fd = ::open(config_.path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0660);
+    if (fd < 0) {
+        throw io_error("cannot create", config_.path);
+    }
+
+    std::size_t cursors_offset = PAGE_BYTES;
+    std::size_t cells_offset = cursors_offset + round_up(config_.max_readers * sizeof(ShmRingCursor), PAGE_BYTES);
+    std::size_t bytes = cells_offset + config_.capacity * sizeof(ShmRingCell);
+
+    // hugetlbfs files must be a whole number of its pages
+    struct statfs fs{};
+    if (::fstatfs(fd, &fs) == 0 && static_cast<long>(fs.f_type) == HUGETLBFS_MAGIC_NUMBER) {
+        bytes = round_up(bytes, static_cast<std::size_t>(fs.f_bsize));
+    }
+
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        ::close(fd);
+        throw io_error("cannot size", config_.path);
+    }
+
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;
+#endif
+    void* map = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, flags, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        throw io_error("cannot map", config_.path);
+    }
+    mapping_ = ShmRingMapping(map, bytes);
+
+    auto* header = std::construct_at(static_cast<ShmRingHeader*>(map));
+    header->version = ShmRingHeader::VERSION;
+    header->record_size = sizeof(MultiFeedSlot);
+    header->capacity = config_.capacity;
+    header->max_readers = config_.max_readers;
+    header->producer_pid = static_cast<std::uint32_t>(::getpid());
+    header->cursors_offset = cursors_offset;
+    header->cells_offset = cells_offset;
+    header->write_pos.store(0, std::memory_order_relaxed);
+    header->closed.store(0, std::memory_order_relaxed);
+
+    auto* cursors = mapping_.cursors();
+    for (std::uint32_t i = 0; i < config_.max_readers; ++i) {
+        std::construct_at(cursors + i);
+    }
+    auto* cells = mapping_.cells();
+    for (std::uint64_t i = 0; i < config_.capacity; ++i) {
+        std::construct_at(cells + i);
+    }
+
+    // Readers check the magic before anything else
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header->magic, ShmRingHeader::MAGIC, sizeof(header->magic));
+}
+
+ShmRingWriter::~ShmRingWriter() {
+    mapping_.header().closed.store(1, std::memory_order_release);
+}
+
+void ShmRingWriter::publish(const MultiFeedSlot* slots, std::uint64_t count) {
+    auto* cells = mapping_.cells();
+    for (std::uint64_t i = 0; i < count; ++i) {
+        auto position = write_pos_ + i;
+        auto& cell = cells[position & mask_];
+        auto words = std::bit_cast<SlotWords>(slots[i]);
+
+        cell.sequence.store(2 * position + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t w = 0; w < words.size(); ++w) {
+            cell.value[w].store(words[w], std::memory_order_relaxed);
+        }
+        cell.sequence.store(2 * position + 2, std::memory_order_release);
+    }
+
+    write_pos_ += count;
+    mapping_.header().write_pos.store(write_pos_, std::memory_order_release);
+}
+
+std::uint64_t ShmRingWriter::records_published() const {
+    return mapping_.header().write_pos.load(std::memory_order_relaxed);
+}
+
+std::uint32_t ShmRingWriter::readers() const {
+    std::uint32_t attached = 0;
+    auto* cursors = mapping_.cursors();
+    for (std::uint32_t i = 0; i < config_.max_readers; ++i) {
+        attached += cursors[i].pid.load(std::memory_order_relaxed) != 0 ? 1 : 0;
+    }
+    return attached;
+}
+
+std::uint64_t ShmRingWriter::max_reader_lag() const {
+    auto head = records_published();
+    std::uint64_t lag = 0;
+    auto* cursors = mapping_.cursors();
+    for (std::uint32_t i = 0; i < config_.max_readers; ++i) {
+        if (cursors[i].pid.load(std::memory_order_relaxed) != 0) {
+            auto position = cursors[i].position.load(std::memory_order_relaxed);
+            lag = std::max(lag, head > position ? head - position : 0);
+        }
+    }
+    return lag;
+}
+
+// ShmRingReader implementation
+ShmRingReader::ShmRingReader(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0) {
+        throw io_error("cannot open", path);
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < PAGE_BYTES) {
+        ::close(fd);
+        throw std::runtime_error("Shared-memory ring: " + path + " is not a ring");
+    }
+    auto bytes = static_cast<std::size_t>(st.st_size);
+    void* map = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        throw io_error("cannot map", path);
+    }
+    mapping_ = ShmRingMapping(map, bytes);
+
+    const auto& header = mapping_.header();
+    if (std::memcmp(header.magic, ShmRingHeader::MAGIC, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("Shared-memory ring: " + path + " is not a ring (or is still being created)");
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header.version != ShmRingHeader::VERSION || header.record_size != sizeof(MultiFeedSlot) ||
+        header.cells_offset + header.capacity * sizeof(ShmRingCell) > bytes) {
+        throw std::runtime_error("Shared-memory ring: " + path + " has an incompatible layout");
+    }
+    capacity_ = header.capacity;
+    mask_ = capacity_ - 1;
+
+    auto pid = static_cast<std::uint32_t>(::getpid());
+    auto* cursors = mapping_.cursors();
+    for (std::uint32_t i = 0; i < header.max_readers && !cursor_; ++i) {
+        auto owner = cursors[i].pid.load(std::memory_order_relaxed);
+        if ((owner == 0 || process_gone(owner)) &&
+            cursors[i].pid.compare_exchange_strong(owner, pid, std::memory_order_acq_rel)) {
+            cursor_ = &cursors[i];
+        }
+    }
+    if (!cursor_) {
+        throw std::runtime_error("Shared-memory ring: all " + std::to_string(header.max_readers) +
+                                 " reader slots of " + path + " are taken");
+    }
+
+    position_ = mapping_.header().write_pos.load(std::memory_order_acquire);
+    cursor_->position.store(position_, std::memory_order_relaxed);
+    cursor_->lost.store(0, std::memory_order_relaxed);
+}
+
+ShmRingReader::~ShmRingReader() {
+    if (cursor_) {
+        cursor_->pid.store(0, std::memory_order_release);
+    }
+}
+
+std::uint64_t ShmRingReader::poll(MultiFeedSlot* out, std::uint64_t max_count) {
+    auto& header = mapping_.header();
+    auto skip_to_newest = [&]() {
+        auto head = header.write_pos.load(std::memory_order_acquire);
+        lost_ += head - position_;
+        ++laps_;
+        position_ = head;
+        cursor_->lost.store(lost_, std::memory_order_relaxed);
+    };
+
+    auto head = header.write_pos.load(std::memory_order_acquire);
+    if (head - position_ > capacity_) {
+        skip_to_newest();
+        head = position_;
+    }
+
+    auto* cells = mapping_.cells();
+    auto available = std::min(max_count, head - position_);
+    std::uint64_t copied = 0;
+    while (copied < available) {
+        const auto& cell = cells[position_ & mask_];
+        auto expected = 2 * position_ + 2;
+
+        SlotWords words;
+        auto before = cell.sequence.load(std::memory_order_acquire);
+        for (std::size_t w = 0; w < words.size(); ++w) {
+            words[w] = cell.value[w].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        auto after = cell.sequence.load(std::memory_order_relaxed);
+
+        // The producer reused the cell for a later position during the copy
+        if (before != expected || after != expected) {
+            skip_to_newest();
+            break;
+        }
+        out[copied++] = std::bit_cast<MultiFeedSlot>(words);
+        ++position_;
+    }
+
+    cursor_->position.store(position_, std::memory_order_relaxed);
+    return copied;
+}
+
+bool ShmRingReader::finished() const {
+    const auto& header = mapping_.header();
+    return header.closed.load(std::memory_order_acquire) != 0 &&
+           position_ >= header.write_pos.load(std::memory_order_acquire);
+}
+
+} // namespace mdfh
@@ -1,5 +1,26 @@
 #include "mdfh/simulator.hpp"
 #include <iostream>
+#include <algorithm>
+#include <cstring>
+
+#if defined(__linux__)
+#include <sys/socket.h>
+#include <linux/errqueue.h>
+#include <poll.h>
+#include <cerrno>
+#define MDFH_HAVE_SENDMMSG 1
+
+// Older headers predate MSG_ZEROCOPY (Linux 4.14)
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+#ifndef SO_EE_ORIGIN_ZEROCOPY
+#define SO_EE_ORIGIN_ZEROCOPY 5
+#endif
+#endif
 
 using namespace boost::asio;
 using tcp = ip::tcp;
@@ -16,12 +37,28 @@ std::ostream& operator<<(std::ostream& os, const SimulatorConfig& cfg) {
     if (cfg.transport == TransportType::UDP_MULTICAST) {
         os << "  Multicast Address: " << cfg.mcast_addr << "\n";
         os << "  Interface: " << cfg.interface << "\n";
+        for (const auto& group : cfg.extra_mcast_groups) {
+            os << "  Extra Group: " << group << "\n";
+        }
+        os << "  MTU: " << cfg.mtu << " bytes\n";
+    }
+    if (cfg.zero_copy_threshold > 0) {
+        os << "  Zero-Copy: batches >= " << cfg.zero_copy_threshold << " bytes\n";
     }
     os << "  Rate: " << cfg.rate << " msgs/sec\n";
     os << "  Batch Size: " << cfg.batch_size << " msgs\n";
     os << "  Base Price: $" << cfg.base_price << "\n";
     os << "  Price Jitter: ±$" << cfg.price_jitter << "\n";
     os << "  Max Quantity: " << cfg.max_quantity << "\n";
+    if (cfg.traffic.arrivals != ArrivalModel::UNIFORM || cfg.traffic.instruments > 1) {
+        os << "  Traffic: " << cfg.traffic << "\n";
+    }
+    if (cfg.pregenerate_seconds > 0) {
+        os << "  Replay: " << cfg.pregenerate_seconds << " seconds pre-generated\n";
+    }
+    if (cfg.recording.enabled()) {
+        os << "  Recording: " << cfg.recording << "\n";
+    }
     if (cfg.max_seconds > 0) {
         os << "  Max Duration: " << cfg.max_seconds << " seconds\n";
     }
@@ -32,7 +69,8 @@ std::ostream& operator<<(std::ostream& os, const SimulatorConfig& cfg) {
 }
 
 // MarketDataGenerator implementation
-MarketDataGenerator::MarketDataGenerator(const SimulatorConfig& config) {
+MarketDataGenerator::MarketDataGenerator(const SimulatorConfig& config)
+    : instrument_sampler_(config.traffic.instruments, config.traffic.zipf_exponent) {
     reset(config);
 }
 
@@ -40,16 +78,32 @@ void MarketDataGenerator::reset(const SimulatorConfig& config) {
     rng_.seed(config.seed);
     price_dist_ = std::uniform_real_distribution<double>(-config.price_jitter, config.price_jitter);
     qty_dist_ = std::uniform_int_distribution<std::int32_t>(1, config.max_quantity);
-    current_price_ = config.base_price;
+    instrument_sampler_ = InstrumentSampler(config.traffic.instruments, config.traffic.zipf_exponent);
     sequence_ = 0;
+    
+    // Instrument 0 starts at base_price; the others are spread from half to
+    // twice it with their own RNG so single-instrument runs are unchanged
+    prices_.assign(instrument_sampler_.count(), config.base_price);
+    std::mt19937_64 spread_rng(config.seed + 1);
+    std::uniform_real_distribution<double> spread(0.5, 2.0);
+    for (std::size_t k = 1; k < prices_.size(); ++k) {
+        prices_[k] = config.base_price * spread(spread_rng);
+    }
 }
 
-void MarketDataGenerator::generate_batch(std::vector<Msg>& batch) {
-    for (auto& msg : batch) {
-        current_price_ += price_dist_(rng_);
+void MarketDataGenerator::generate_batch(std::span<Msg> batch, std::span<std::uint32_t> instruments) {
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        auto instrument = instrument_sampler_(rng_);
+        if (!instruments.empty()) {
+            instruments[i] = instrument;
+        }
+        
+        // Each instrument walks on its own
+        double& price = prices_[instrument];
+        price += price_dist_(rng_);
         // Ensure price doesn't go negative
-        if (current_price_ < 0.01) {
-            current_price_ = 0.01;
+        if (price < 0.01) {
+            price = 0.01;
         }
         
         std::int32_t qty = qty_dist_(rng_);
@@ -58,15 +112,206 @@ void MarketDataGenerator::generate_batch(std::vector<Msg>& batch) {
             qty = -qty;
         }
         
-        msg = Msg{++sequence_, current_price_, qty};
+        batch[i] = Msg{++sequence_, price, qty};
+    }
+}
+
+namespace {
+
+// Bytes of IPv4 + UDP header subtracted from the MTU
+constexpr std::size_t IP_UDP_HEADER_SIZE = 28;
+
+// Linux limits on one sendmmsg/sendmsg call
+constexpr std::size_t MAX_MSGS_PER_SYSCALL = 1024;
+constexpr std::size_t MAX_IOV_PER_MSG = 1024;
+
+// Appends buf to a gather list, merging it into the previous entry when the
+// two are adjacent in memory (per-message spans of one encoded batch)
+void append_gather(std::vector<boost::asio::const_buffer>& iov, std::span<const std::uint8_t> buf) {
+    if (!iov.empty()) {
+        auto& last = iov.back();
+        const auto* last_end = static_cast<const std::uint8_t*>(last.data()) + last.size();
+        if (last_end == buf.data()) {
+            last = boost::asio::const_buffer(last.data(), last.size() + buf.size());
+            return;
+        }
+    }
+    iov.emplace_back(buf.data(), buf.size());
+}
+
+std::size_t gather_size(std::span<const boost::asio::const_buffer> iov) {
+    std::size_t bytes = 0;
+    for (const auto& b : iov) {
+        bytes += b.size();
+    }
+    return bytes;
+}
+
+#ifdef MDFH_HAVE_SENDMMSG
+// const_buffer and iovec agree on {pointer, length}; copy into a real iovec
+// array rather than relying on layout compatibility
+void to_iovec(std::span<const boost::asio::const_buffer> src, iovec* dst) {
+    for (std::size_t i = 0; i < src.size(); ++i) {
+        dst[i].iov_base = const_cast<void*>(src[i].data());
+        dst[i].iov_len = src[i].size();
+    }
+}
+#endif
+
+} // namespace
+
+// ZeroCopyTracker implementation
+void ZeroCopyTracker::enable(int fd, std::uint32_t threshold) {
+    fd_ = -1;
+    threshold_ = threshold;
+    if (threshold == 0) {
+        return;
+    }
+#ifdef MDFH_HAVE_SENDMMSG
+    int one = 1;
+    if (::setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == 0) {
+        fd_ = fd;
+        return;
+    }
+    MDFH_LOG_WARN("Simulator", "SO_ZEROCOPY unavailable, using copying sends: ", std::strerror(errno));
+#else
+    (void)fd;
+    MDFH_LOG_WARN("Simulator", "MSG_ZEROCOPY is only supported on Linux, using copying sends");
+#endif
+}
+
+int ZeroCopyTracker::send_flags(std::size_t bytes) const {
+#ifdef MDFH_HAVE_SENDMMSG
+    return (fd_ >= 0 && bytes >= threshold_) ? MSG_ZEROCOPY : 0;
+#else
+    (void)bytes;
+    return 0;
+#endif
+}
+
+void ZeroCopyTracker::reap(bool wait_all) {
+#ifdef MDFH_HAVE_SENDMMSG
+    while (outstanding_ > 0) {
+        char control[128];
+        msghdr msg{};
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        
+        if (::recvmsg(fd_, &msg, MSG_ERRQUEUE) < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                if (!wait_all) {
+                    return;
+                }
+                // Completions arrive as POLLERR on the error queue
+                pollfd pfd{fd_, 0, 0};
+                ::poll(&pfd, 1, 100);
+                continue;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            MDFH_LOG_ERROR("Simulator", "MSG_ZEROCOPY completion read failed: ", std::strerror(errno));
+            outstanding_ = 0;
+            return;
+        }
+        
+        for (cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm != nullptr; cm = CMSG_NXTHDR(&msg, cm)) {
+            auto* err = reinterpret_cast<sock_extended_err*>(CMSG_DATA(cm));
+            if (err->ee_errno == 0 && err->ee_origin == SO_EE_ORIGIN_ZEROCOPY) {
+                // Notification covers send ids [ee_info, ee_data]
+                std::uint64_t completed = static_cast<std::uint32_t>(err->ee_data - err->ee_info) + 1ull;
+                outstanding_ -= std::min(completed, outstanding_);
+            }
+        }
+    }
+#else
+    (void)wait_all;
+    outstanding_ = 0;
+#endif
+}
+
+// Transport default batch implementation
+void Transport::send_batch(std::span<const std::span<const std::uint8_t>> buffers) {
+    for (const auto& buf : buffers) {
+        send(buf);
     }
 }
 
 // TCPTransport implementation
-TCPTransport::TCPTransport(tcp::socket socket) : socket_(std::move(socket)) {}
+TCPTransport::TCPTransport(tcp::socket socket, std::uint32_t zero_copy_threshold) : socket_(std::move(socket)) {
+    iov_.reserve(64);
+    zero_copy_.enable(socket_.native_handle(), zero_copy_threshold);
+}
+
+void TCPTransport::send(std::span<const std::uint8_t> data) {
+    iov_.clear();
+    append_gather(iov_, data);
+    write_gathered();
+}
 
-void TCPTransport::send(const std::vector<std::uint8_t>& data) {
-    boost::asio::write(socket_, boost::asio::buffer(data));
+void TCPTransport::send_batch(std::span<const std::span<const std::uint8_t>> buffers) {
+    // One writev for the whole batch; contiguous buffers collapse into one iovec
+    iov_.clear();
+    for (const auto& buf : buffers) {
+        append_gather(iov_, buf);
+    }
+    write_gathered();
+}
+
+void TCPTransport::write_gathered() {
+    std::size_t bytes = gather_size(iov_);
+    int flags = zero_copy_.send_flags(bytes);
+    
+#ifdef MDFH_HAVE_SENDMMSG
+    if (flags != 0) {
+        // sendmsg loop so MSG_ZEROCOPY can be passed; asio::write cannot
+        iovec iov[MAX_IOV_PER_MSG];
+        std::size_t first = 0;
+        std::size_t skip = 0;   // bytes of iov_[first] already sent
+        while (first < iov_.size()) {
+            std::size_t count = std::min(iov_.size() - first, MAX_IOV_PER_MSG);
+            to_iovec(std::span(iov_).subspan(first, count), iov);
+            iov[0].iov_base = static_cast<std::uint8_t*>(iov[0].iov_base) + skip;
+            iov[0].iov_len -= skip;
+            
+            msghdr msg{};
+            msg.msg_iov = iov;
+            msg.msg_iovlen = count;
+            ssize_t sent = ::sendmsg(socket_.native_handle(), &msg, flags);
+            if (sent < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno == ENOBUFS) {
+                    // Out of optmem for pinned pages: finish this call with copies
+                    flags = 0;
+                    continue;
+                }
+                throw boost::system::system_error(errno, boost::system::system_category(), "sendmsg");
+            }
+            if (flags != 0) {
+                zero_copy_.record_sends(1);
+            }
+            
+            // Advance past fully written buffers
+            auto remaining = static_cast<std::size_t>(sent);
+            while (remaining > 0) {
+                std::size_t left = iov_[first].size() - skip;
+                if (remaining < left) {
+                    skip += remaining;
+                    break;
+                }
+                remaining -= left;
+                skip = 0;
+                ++first;
+            }
+        }
+        zero_copy_.reap(!stable_buffers_);
+        return;
+    }
+#endif
+    
+    boost::asio::write(socket_, iov_);
 }
 
 bool TCPTransport::is_connected() const {
@@ -76,7 +321,16 @@ bool TCPTransport::is_connected() const {
 // UDPMulticastTransport implementation
 UDPMulticastTransport::UDPMulticastTransport(boost::asio::io_context& ctx, const SimulatorConfig& config)
     : socket_(ctx, udp::endpoint(udp::v4(), 0))
-    , endpoint_(ip::address::from_string(config.mcast_addr), config.port) {
+    , max_payload_(config.mtu > IP_UDP_HEADER_SIZE ? config.mtu - IP_UDP_HEADER_SIZE : 0) {
+    
+    if (max_payload_ == 0) {
+        throw std::invalid_argument("MTU too small for UDP: " + std::to_string(config.mtu));
+    }
+    
+    endpoints_.emplace_back(ip::address::from_string(config.mcast_addr), config.port);
+    for (const auto& group : config.extra_mcast_groups) {
+        endpoints_.emplace_back(ip::address::from_string(group), config.port);
+    }
     
     // Set up multicast interface if specified
     if (config.interface != "0.0.0.0") {
@@ -85,10 +339,115 @@ UDPMulticastTransport::UDPMulticastTransport(boost::asio::io_context& ctx, const
             socket_.set_option(ip::multicast::outbound_interface(interface_addr.to_v4()));
         }
     }
+    
+    iov_.reserve(256);
+    datagrams_.reserve(256);
+#ifdef MDFH_HAVE_SENDMMSG
+    msgs_.resize(MAX_MSGS_PER_SYSCALL);
+#endif
+    zero_copy_.enable(socket_.native_handle(), config.zero_copy_threshold);
+}
+
+void UDPMulticastTransport::send(std::span<const std::uint8_t> data) {
+    // A single buffer is sent as-is (one unit, one datagram per group)
+    std::span<const std::uint8_t> unit[] = {data};
+    send_batch(unit);
+}
+
+void UDPMulticastTransport::send_batch(std::span<const std::span<const std::uint8_t>> buffers) {
+    pack(buffers);
+    send_datagrams();
+}
+
+void UDPMulticastTransport::pack(std::span<const std::span<const std::uint8_t>> buffers) {
+    iov_.clear();
+    datagrams_.clear();
+    
+    std::size_t payload = 0;
+    for (const auto& buf : buffers) {
+        // Start a new datagram when this unit would overflow the MTU; a unit
+        // larger than the MTU gets a datagram of its own (IP fragments it)
+        if (datagrams_.empty() || payload + buf.size() > max_payload_
+            || datagrams_.back().iov_count == MAX_IOV_PER_MSG) {
+            datagrams_.push_back({iov_.size(), 0});
+            payload = 0;
+        }
+        
+        auto before = iov_.size();
+        if (datagrams_.back().iov_count == 0) {
+            iov_.emplace_back(buf.data(), buf.size());
+        } else {
+            append_gather(iov_, buf);
+        }
+        datagrams_.back().iov_count += iov_.size() - before;
+        payload += buf.size();
+    }
 }
 
-void UDPMulticastTransport::send(const std::vector<std::uint8_t>& data) {
-    socket_.send_to(boost::asio::buffer(data), endpoint_);
+void UDPMulticastTransport::send_datagrams() {
+    if (datagrams_.empty()) {
+        return;
+    }
+    
+#ifdef MDFH_HAVE_SENDMMSG
+    // Every datagram goes to every group from one sendmmsg stream
+    const std::size_t total = datagrams_.size() * endpoints_.size();
+    if (native_iov_.size() < iov_.size()) {
+        native_iov_.resize(iov_.size());
+    }
+    to_iovec(iov_, native_iov_.data());
+    
+    std::size_t next = 0;
+    bool copy_only = false;     // set once a MSG_ZEROCOPY send was refused in this call
+    while (next < total) {
+        std::size_t count = std::min(total - next, MAX_MSGS_PER_SYSCALL);
+        std::size_t largest = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto& dgram = datagrams_[(next + i) / endpoints_.size()];
+            const auto& endpoint = endpoints_[(next + i) % endpoints_.size()];
+            
+            msgs_[i] = mmsghdr{};
+            msgs_[i].msg_hdr.msg_name = const_cast<sockaddr*>(endpoint.data());
+            msgs_[i].msg_hdr.msg_namelen = static_cast<socklen_t>(endpoint.size());
+            msgs_[i].msg_hdr.msg_iov = native_iov_.data() + dgram.first_iov;
+            msgs_[i].msg_hdr.msg_iovlen = dgram.iov_count;
+            largest = std::max(largest, gather_size(std::span(iov_).subspan(dgram.first_iov, dgram.iov_count)));
+        }
+        
+        // The threshold applies per datagram: a batch of small datagrams is copied
+        int flags = copy_only ? 0 : zero_copy_.send_flags(largest);
+        int sent = ::sendmmsg(socket_.native_handle(), msgs_.data(), static_cast<unsigned>(count), flags);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if ((errno == ENOBUFS || errno == EMSGSIZE) && flags != 0) {
+                // Out of optmem for pinned pages, or a datagram gathered from
+                // more buffers than an skb has page frags: release what is
+                // pinned and finish this call with copies
+                zero_copy_.reap(true);
+                copy_only = true;
+                continue;
+            }
+            throw boost::system::system_error(errno, boost::system::system_category(), "sendmmsg");
+        }
+        if (flags != 0) {
+            zero_copy_.record_sends(static_cast<std::uint64_t>(sent));
+        }
+        next += static_cast<std::size_t>(sent);
+    }
+    
+    if (zero_copy_.enabled()) {
+        zero_copy_.reap(!stable_buffers_);
+    }
+#else
+    for (const auto& dgram : datagrams_) {
+        auto gather = std::span(iov_).subspan(dgram.first_iov, dgram.iov_count);
+        for (const auto& endpoint : endpoints_) {
+            socket_.send_to(gather, endpoint);
+        }
+    }
+#endif
 }
 
 bool UDPMulticastTransport::is_connected() const {
@@ -100,7 +459,18 @@ MarketDataSimulator::MarketDataSimulator(SimulatorConfig config)
     : config_(std::move(config))
     , generator_(config_)
     , encoder_(create_encoder(config_.encoding, config_.encoding_config))
-    , rate_limiter_(config_.rate, config_.batch_size) {}
+    , rate_limiter_(config_.rate > 0 ? config_.rate : 1, config_.batch_size)
+    , batch_(config_.batch_size)
+    , encoded_buffer_(encoder_->max_encoded_size(config_.batch_size))
+    , message_ends_(config_.batch_size)
+    , message_spans_(config_.batch_size) {
+    // The uniform model is the rate limiter's even spacing; the others
+    // schedule every message, which needs a rate to scale to
+    if (config_.traffic.arrivals != ArrivalModel::UNIFORM && config_.rate > 0) {
+        arrivals_ = std::make_unique<ArrivalProcess>(config_.traffic, config_.rate, config_.seed);
+        arrival_ns_.resize(config_.batch_size);
+    }
+}
 
 void MarketDataSimulator::set_transport(std::unique_ptr<Transport> transport) {
     transport_ = std::move(transport);
@@ -113,20 +483,41 @@ void MarketDataSimulator::run() {
     
     std::cout << config_ << std::endl;
     
-    std::vector<Msg> batch(config_.batch_size);
-    std::vector<std::uint8_t> encoded_buffer;
-    encoded_buffer.reserve(config_.batch_size * sizeof(Msg) * 2); // Extra space for protocol overhead
+    if (config_.recording.enabled()) {
+        recording_ = std::make_unique<ReplaySource>(config_.recording);
+        recording_events_.resize(config_.batch_size);
+        // The mapped recording outlives every send
+        transport_->set_stable_buffers(true);
+    } else if (config_.pregenerate_seconds > 0) {
+        pregenerate_traffic();
+    }
     
     timer_.reset();
     
     while (should_continue() && transport_->is_connected()) {
-        send_batch();
+        if (recording_) {
+            if (!play_recording_batch()) {
+                break;
+            }
+        } else if (traffic_.batch_count() > 0) {
+            replay_batch();
+        } else {
+            send_batch();
+        }
     }
     
     std::cout << "\nSimulation completed:\n";
     std::cout << "  Messages sent: " << messages_sent_ << "\n";
     std::cout << "  Duration: " << timer_.elapsed_seconds() << " seconds\n";
     std::cout << "  Actual rate: " << (messages_sent_ / timer_.elapsed_seconds()) << " msgs/sec\n";
+    if (recording_) {
+        std::cout << "  Recorded events: " << recording_->events_replayed() << " over "
+                  << recording_->passes() << " passes";
+        if (recording_->skipped_packets() > 0) {
+            std::cout << " (" << recording_->skipped_packets() << " packets without payload skipped)";
+        }
+        std::cout << "\n";
+    }
 }
 
 bool MarketDataSimulator::should_continue() const {
@@ -139,27 +530,159 @@ bool MarketDataSimulator::should_continue() const {
     return true;
 }
 
+void MarketDataSimulator::throttle() {
+    // Wait for the right time to send (rate 0 sends as fast as the transport allows);
+    // modeled arrivals are paced per message instead
+    if (config_.rate > 0 && !arrivals_) {
+        rate_limiter_.wait_for_next_tick();
+    }
+}
+
+void MarketDataSimulator::send_messages(const std::uint8_t* base, std::size_t begin, std::span<const std::size_t> ends) {
+    // Hand the transport message boundaries so it can pack datagrams without splitting one
+    for (std::size_t i = 0; i < ends.size(); ++i) {
+        message_spans_[i] = {base + begin, ends[i] - begin};
+        begin = ends[i];
+    }
+    transport_->send_batch(std::span(message_spans_).first(ends.size()));
+}
+
+void MarketDataSimulator::send_paced(const std::uint8_t* base, std::size_t begin, std::span<const std::size_t> ends,
+                                     std::span<const std::uint64_t> arrivals, std::uint64_t offset_ns) {
+    // Wait for the next message, then send it with every later one already due
+    std::size_t i = 0;
+    while (i < ends.size()) {
+        auto due = pacer_.deadline(arrivals[i] + offset_ns);
+        ReplayPacer::wait_until(due);
+        auto now = std::max(due, std::chrono::steady_clock::now());
+        
+        std::size_t j = i + 1;
+        while (j < ends.size() && pacer_.deadline(arrivals[j] + offset_ns) <= now) {
+            ++j;
+        }
+        send_messages(base, i == 0 ? begin : ends[i - 1], ends.subspan(i, j - i));
+        i = j;
+    }
+}
+
 void MarketDataSimulator::send_batch() {
-    // Wait for the right time to send
-    rate_limiter_.wait_for_next_tick();
+    throttle();
     
-    // Generate market data
-    std::vector<Msg> batch(config_.batch_size);
-    generator_.generate_batch(batch);
-    
-    // Encode messages
-    std::vector<std::uint8_t> encoded_data;
-    encoder_->encode_inplace(batch, encoded_data);
+    // Generate and encode into the reused buffers (NO ALLOCATION)
+    generator_.generate_batch(batch_);
+    encoder_->encode_into(batch_, encoded_buffer_, message_ends_);
     
     // Send over transport
-    transport_->send(encoded_data);
+    if (arrivals_) {
+        for (auto& arrival : arrival_ns_) {
+            arrival = arrivals_->next_ns();
+        }
+        send_paced(encoded_buffer_.data(), 0, message_ends_, arrival_ns_, 0);
+    } else {
+        send_messages(encoded_buffer_.data(), 0, message_ends_);
+    }
+    
+    messages_sent_ += batch_.size();
+}
+
+void MarketDataSimulator::replay_batch() {
+    throttle();
+    
+    auto first = replay_index_ * config_.batch_size;
+    auto ends = std::span<const std::size_t>(traffic_.message_ends).subspan(first, config_.batch_size);
+    if (!traffic_.arrival_ns.empty()) {
+        auto arrivals = std::span<const std::uint64_t>(traffic_.arrival_ns).subspan(first, config_.batch_size);
+        send_paced(traffic_.bytes.data(), traffic_.batch_offsets[replay_index_], ends, arrivals, pass_offset_ns_);
+    } else {
+        send_messages(traffic_.bytes.data(), traffic_.batch_offsets[replay_index_], ends);
+    }
+    if (++replay_index_ == traffic_.batch_count()) {
+        replay_index_ = 0;
+        // The next pass continues the modeled timeline
+        pass_offset_ns_ += traffic_.duration_ns;
+    }
     
     messages_sent_ += config_.batch_size;
 }
 
+void MarketDataSimulator::pregenerate_traffic() {
+    // A rate of 0 has no natural duration, so size it at the default rate
+    std::uint64_t rate = config_.rate > 0 ? config_.rate : SimulatorConfig{}.rate;
+    std::uint64_t messages = rate * config_.pregenerate_seconds;
+    if (config_.max_messages > 0) {
+        messages = std::min(messages, config_.max_messages);
+    }
+    std::uint64_t batches = std::max<std::uint64_t>(1, (messages + config_.batch_size - 1) / config_.batch_size);
+    
+    Timer timer;
+    traffic_.bytes.resize(batches * encoder_->max_encoded_size(config_.batch_size));
+    traffic_.batch_offsets.clear();
+    traffic_.batch_offsets.reserve(batches + 1);
+    traffic_.batch_offsets.push_back(0);
+    traffic_.message_ends.resize(batches * config_.batch_size);
+    traffic_.arrival_ns.clear();
+    if (arrivals_) {
+        traffic_.arrival_ns.resize(batches * config_.batch_size);
+        for (auto& arrival : traffic_.arrival_ns) {
+            arrival = arrivals_->next_ns();
+        }
+        // Where a second pass would have started
+        traffic_.duration_ns = arrivals_->next_ns();
+    }
+    
+    std::size_t offset = 0;
+    for (std::uint64_t i = 0; i < batches; ++i) {
+        generator_.generate_batch(batch_);
+        auto ends = std::span(traffic_.message_ends).subspan(i * config_.batch_size, config_.batch_size);
+        offset += encoder_->encode_into(batch_, std::span<std::uint8_t>(traffic_.bytes).subspan(offset), ends);
+        for (auto& end : ends) {
+            end += traffic_.batch_offsets.back();
+        }
+        traffic_.batch_offsets.push_back(offset);
+    }
+    traffic_.bytes.resize(offset);
+    traffic_.bytes.shrink_to_fit();
+    replay_index_ = 0;
+    
+    // The arena outlives every send, so zero-copy transports need not wait for completions
+    transport_->set_stable_buffers(true);
+    
+    // Note: replay loops the same sequence numbers, so receivers see a reset per pass
+    std::cout << "Pre-generated " << batches * config_.batch_size << " messages ("
+              << (offset / 1024.0 / 1024.0) << " MB) in " << timer.elapsed_seconds() << " seconds\n" << std::endl;
+}
+
+bool MarketDataSimulator::play_recording_batch() {
+    // Pacing comes from the recorded timestamps, not the rate limiter
+    auto count = recording_->next_batch(recording_events_);
+    if (count == 0) {
+        return !recording_->finished();
+    }
+    auto events = std::span<const ReplayEvent>(recording_events_).first(count);
+    
+    // Journaled messages need encoding unless the wire format is binary;
+    // everything else goes out straight from the mapping
+    if (recording_->format() == ReplayFormat::JOURNAL && config_.encoding != EncodingType::BINARY) {
+        for (std::size_t i = 0; i < count; ++i) {
+            std::memcpy(static_cast<void*>(&batch_[i]), events[i].bytes.data(), sizeof(Msg));
+        }
+        encoder_->encode_into(std::span<const Msg>(batch_).first(count), encoded_buffer_, std::span(message_ends_).first(count));
+        send_messages(encoded_buffer_.data(), 0, std::span<const std::size_t>(message_ends_).first(count));
+        messages_sent_ += count;
+        return true;
+    }
+    
+    for (std::size_t i = 0; i < count; ++i) {
+        message_spans_[i] = events[i].bytes;
+        messages_sent_ += events[i].messages;
+    }
+    transport_->send_batch(std::span(message_spans_).first(count));
+    return true;
+}
+
 // Factory functions
-std::unique_ptr<Transport> create_tcp_transport(tcp::socket socket) {
-    return std::make_unique<TCPTransport>(std::move(socket));
+std::unique_ptr<Transport> create_tcp_transport(tcp::socket socket, const SimulatorConfig& config) {
+    return std::make_unique<TCPTransport>(std::move(socket), config.zero_copy_threshold);
 }
 
 std::unique_ptr<Transport> create_udp_transport(boost::asio::io_context& ctx, const SimulatorConfig& config) {
@@ -0,0 +1,101 @@
+#include "mdfh/timing.hpp"
+
+#if defined(MDFH_HAVE_TSC)
+#include <cpuid.h>
+#endif
+
+namespace mdfh {
+
+namespace {
+
+#if defined(MDFH_HAVE_TSC)
+constexpr std::uint64_t CALIBRATION_NS = 10'000'000;
+
+// CPUID.80000007H:EDX[8]: the TSC ticks at a constant rate in every P/C-state
+bool has_invariant_tsc() {
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return (edx & (1u << 8)) != 0;
+}
+
+struct ClockPair {
+    std::uint64_t tsc;
+    std::uint64_t ns;
+};
+
+// Monotonic time paired with the TSC at the midpoint of the clock_gettime call
+ClockPair read_clock_pair() {
+    unsigned aux;
+    auto before = __rdtscp(&aux);
+    auto ns = get_monotonic_ns();
+    auto after = __rdtscp(&aux);
+    return {before + (after - before) / 2, ns};
+}
+#endif
+
+} // namespace
+
+TscClock::TscClock() {
+#if defined(MDFH_HAVE_TSC)
+    if (!has_invariant_tsc()) {
+        return;
+    }
+
+    // The first reads fault in the vDSO and skew a short window; discard them
+    for (int i = 0; i < 1000; ++i) {
+        read_clock_pair();
+    }
+
+    auto start = read_clock_pair();
+    ClockPair end;
+    do {
+        end = read_clock_pair();
+    } while (end.ns - start.ns < CALIBRATION_NS);
+
+    if (end.tsc <= start.tsc) {
+        return;
+    }
+
+    auto ticks = end.tsc - start.tsc;
+    auto ns = end.ns - start.ns;
+    calibration_tsc_ = start.tsc;
+    calibration_ns_ = start.ns;
+    reanchor_ticks_ = static_cast<std::uint64_t>(static_cast<unsigned __int128>(REANCHOR_NS) * ticks / ns);
+    mult_.store(static_cast<std::uint64_t>((static_cast<unsigned __int128>(ns) << MULT_SHIFT) / ticks),
+                std::memory_order_relaxed);
+    base_tsc_.store(end.tsc, std::memory_order_relaxed);
+    base_ns_.store(end.ns, std::memory_order_relaxed);
+    enabled_ = true;
+#endif
+}
+
+std::uint64_t TscClock::reanchor(std::uint64_t seq) const {
+#if defined(MDFH_HAVE_TSC)
+    if (!seq_.compare_exchange_strong(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+        return get_monotonic_ns();
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // The longer the baseline, the smaller the scale error the midpoint
+    // jitter of a single pair leaves
+    auto now = read_clock_pair();
+    if (now.tsc > calibration_tsc_ && now.ns > calibration_ns_) {
+        auto ticks = now.tsc - calibration_tsc_;
+        auto ns = now.ns - calibration_ns_;
+        mult_.store(static_cast<std::uint64_t>((static_cast<unsigned __int128>(ns) << MULT_SHIFT) / ticks),
+                    std::memory_order_relaxed);
+    }
+    base_tsc_.store(now.tsc, std::memory_order_relaxed);
+    base_ns_.store(now.ns, std::memory_order_relaxed);
+
+    seq_.store(seq + 2, std::memory_order_release);
+    return now.ns;
+#else
+    (void)seq;
+    return get_monotonic_ns();
+#endif
+}
+
+} // namespace mdfh
@@ -0,0 +1,135 @@
+#include "mdfh/traffic_model.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace mdfh {
+
+std::ostream& operator<<(std::ostream& os, ArrivalModel model) {
+    switch (model) {
+        case ArrivalModel::UNIFORM: return os << "UNIFORM";
+        case ArrivalModel::POISSON: return os << "POISSON";
+        case ArrivalModel::HAWKES: return os << "HAWKES";
+        case ArrivalModel::MICROBURST: return os << "MICROBURST";
+    }
+    return os << "UNKNOWN_ARRIVAL_MODEL";
+}
+
+ArrivalModel parse_arrival_model(const std::string& name) {
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (lower == "uniform") return ArrivalModel::UNIFORM;
+    if (lower == "poisson") return ArrivalModel::POISSON;
+    if (lower == "hawkes") return ArrivalModel::HAWKES;
+    if (lower == "microburst") return ArrivalModel::MICROBURST;
+    throw std::invalid_argument("Unknown arrival model: " + name);
+}
+
+bool TrafficModelConfig::is_valid() const {
+    return hawkes_branching >= 0.0 && hawkes_branching < 1.0 && hawkes_decay_us > 0.0 &&
+           burst_messages > 0 && instruments > 0 && zipf_exponent >= 0.0;
+}
+
+std::ostream& operator<<(std::ostream& os, const TrafficModelConfig& config) {
+    os << config.arrivals;
+    switch (config.arrivals) {
+        case ArrivalModel::HAWKES:
+            os << " (branching " << config.hawkes_branching << ", decay " << config.hawkes_decay_us << " us)";
+            break;
+        case ArrivalModel::MICROBURST:
+            os << " (" << config.burst_messages << " msgs in " << config.burst_us << " us)";
+            break;
+        default:
+            break;
+    }
+    if (config.instruments > 1) {
+        os << ", " << config.instruments << " instruments (Zipf " << config.zipf_exponent << ")";
+    }
+    return os;
+}
+
+// ArrivalProcess implementation
+ArrivalProcess::ArrivalProcess(const TrafficModelConfig& config, double rate, std::uint64_t seed)
+    : model_(config.arrivals)
+    , rng_(seed)
+    , mean_gap_ns_(1e9 / rate) {
+    if (!(rate > 0.0) || !config.is_valid()) {
+        throw std::invalid_argument("ArrivalProcess needs a positive rate and a valid traffic model");
+    }
+
+    // Stationary Hawkes rate is mu / (1 - branching), so scale mu to hit the target
+    double rate_per_ns = rate / 1e9;
+    decay_per_ns_ = 1.0 / (config.hawkes_decay_us * 1e3);
+    baseline_per_ns_ = rate_per_ns * (1.0 - config.hawkes_branching);
+    jump_per_ns_ = config.hawkes_branching * decay_per_ns_;
+
+    burst_messages_ = config.burst_messages;
+    burst_period_ns_ = burst_messages_ * mean_gap_ns_;
+    burst_gap_ns_ = config.burst_us * 1e3 / burst_messages_;
+}
+
+double ArrivalProcess::open_unit() {
+    // (0, 1]: keeps log() finite
+    return 1.0 - unit_(rng_);
+}
+
+std::uint64_t ArrivalProcess::next_ns() {
+    auto now = static_cast<std::uint64_t>(time_ns_);
+
+    switch (model_) {
+        case ArrivalModel::UNIFORM:
+            time_ns_ += mean_gap_ns_;
+            break;
+
+        case ArrivalModel::POISSON:
+            time_ns_ += -std::log(open_unit()) * mean_gap_ns_;
+            break;
+
+        case ArrivalModel::HAWKES: {
+            // Exact simulation for the exponential kernel (Dassios & Zhao 2013):
+            // the next arrival is the earlier of a baseline arrival and one
+            // triggered by the decaying excitation
+            double baseline_gap = -std::log(open_unit()) / baseline_per_ns_;
+            double excited_gap = std::numeric_limits<double>::infinity();
+            if (excitation_per_ns_ > 0.0) {
+                double d = 1.0 + decay_per_ns_ * std::log(open_unit()) / excitation_per_ns_;
+                if (d > 0.0) {
+                    excited_gap = -std::log(d) / decay_per_ns_;
+                }
+            }
+            double gap = std::min(baseline_gap, excited_gap);
+            excitation_per_ns_ = excitation_per_ns_ * std::exp(-decay_per_ns_ * gap) + jump_per_ns_;
+            time_ns_ += gap;
+            break;
+        }
+
+        case ArrivalModel::MICROBURST:
+            if (++burst_index_ == burst_messages_) {
+                // Next burst starts one period later, or right away if bursts overlap
+                burst_index_ = 0;
+                burst_start_ns_ = std::max(burst_start_ns_ + burst_period_ns_, time_ns_ + burst_gap_ns_);
+                time_ns_ = burst_start_ns_;
+            } else {
+                time_ns_ = burst_start_ns_ + burst_index_ * burst_gap_ns_;
+            }
+            break;
+    }
+    return now;
+}
+
+// InstrumentSampler implementation
+InstrumentSampler::InstrumentSampler(std::uint32_t instruments, double exponent)
+    : count_(std::max<std::uint32_t>(1, instruments)) {
+    std::vector<double> weights(count_);
+    for (std::uint32_t k = 0; k < count_; ++k) {
+        weights[k] = 1.0 / std::pow(static_cast<double>(k + 1), exponent);
+    }
+    dist_ = std::discrete_distribution<std::uint32_t>(weights.begin(), weights.end());
+}
+
+} // namespace mdfh
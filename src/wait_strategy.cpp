@@ -0,0 +1,57 @@
+#include "mdfh/wait_strategy.hpp"
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <ctime>
+#endif
+
+namespace mdfh {
+
+// WaitSignal implementation
+void WaitSignal::wait(std::uint32_t key, std::chrono::microseconds timeout) {
+#if defined(__linux__)
+    // Returns at once if a producer bumped the epoch since prepare_wait()
+    timespec ts{static_cast<time_t>(timeout.count() / 1'000'000), static_cast<long>(timeout.count() % 1'000'000) * 1000};
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&epoch_), FUTEX_WAIT_PRIVATE, key, &ts, nullptr, 0);
+#else
+    if (epoch_.load(std::memory_order_acquire) == key) {
+        std::this_thread::sleep_for(timeout);
+    }
+#endif
+}
+
+void WaitSignal::wake() {
+    epoch_.fetch_add(1, std::memory_order_release);
+#if defined(__linux__)
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&epoch_), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+// WaitStrategy implementation
+void WaitStrategy::yield() {
+    std::this_thread::yield();
+}
+
+void WaitStrategy::sleep(std::chrono::microseconds timeout) {
+    std::this_thread::sleep_for(timeout);
+}
+
+WaitStrategyType parse_wait_strategy_type(const std::string& name) {
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (lower == "spin" || lower == "busy_spin") return WaitStrategyType::BUSY_SPIN;
+    if (lower == "yield" || lower == "spin_yield") return WaitStrategyType::SPIN_YIELD;
+    if (lower == "park" || lower == "spin_park") return WaitStrategyType::SPIN_PARK;
+    throw std::invalid_argument("Unknown wait strategy: " + name);
+}
+
+} // namespace mdfh